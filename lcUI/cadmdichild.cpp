@@ -15,6 +15,7 @@ using namespace lc::viewer;
 
 CadMdiChild::CadMdiChild(QWidget* parent) :
     QWidget(parent),
+    _openTimer(new QTimer(this)),
     _activeLayer(nullptr) {
 
     if (this->objectName().isEmpty()) {
@@ -38,6 +39,10 @@ CadMdiChild::CadMdiChild(QWidget* parent) :
     QObject::connect(_viewerProxy, &LCADViewerProxy::mouseReleaseEvent, this, &CadMdiChild::mouseReleaseEvent);
     QObject::connect(_viewerProxy, &LCADViewerProxy::mouseMoveEvent, this, &CadMdiChild::mouseMoveEvent);
     QObject::connect(_viewerProxy, &LCADViewerProxy::selectionChangeEvent, this, &CadMdiChild::selectionChangeEvent);
+
+    // Chunks of the file being opened are added between two paints, the UI stays responsive during the load
+    _openTimer->setInterval(20);
+    QObject::connect(_openTimer, &QTimer::timeout, this, &CadMdiChild::updateOpen);
 }
 
 CadMdiChild::~CadMdiChild() {
@@ -101,7 +106,10 @@ bool CadMdiChild::openFile() {
         //TODO: if more than once, ask which one to choose
         newDocument();
         _filename = file.toStdString();
-        _fileType = lc::persistence::File::open(_document, _filename, availableLibraries.begin()->first);
+        _progressiveOpen.reset(new lc::persistence::ProgressiveOpen(_document, _filename, availableLibraries.begin()->first));
+        _openTimer->start();
+        emit openingChanged(true);
+        updateOpen();
     }
     else {
         QMessageBox::critical(nullptr, "Open error", "Unknown file extension ." + fileInfo.suffix());
@@ -111,6 +119,32 @@ bool CadMdiChild::openFile() {
     return true;
 }
 
+void CadMdiChild::updateOpen() {
+    if(_progressiveOpen == nullptr) {
+        _openTimer->stop();
+        return;
+    }
+
+    try {
+        if(!_progressiveOpen->update()) {
+            return;
+        }
+
+        _fileType = _progressiveOpen->type();
+    }
+    catch(const std::exception& e) {
+        QMessageBox::critical(nullptr, "Open error", e.what());
+    }
+
+    _openTimer->stop();
+    _progressiveOpen.reset();
+    emit openingChanged(false);
+}
+
+bool CadMdiChild::isOpening() const {
+    return _progressiveOpen != nullptr;
+}
+
 void CadMdiChild::saveFile() {
     if (_filename == "")saveAsFile();
     else lc::persistence::File::save(_document, _filename, _fileType);// @TODO Needs to fix it later
@@ -2,6 +2,7 @@
 #include <QVBoxLayout>
 #include <QWidget>
 #include <QKeyEvent>
+#include <QTimer>
 #include "lcadviewerproxy.h"
 #include "cad/meta/color.h"
 #include <cad/storage/storagemanager.h>
@@ -39,8 +40,8 @@ public:
 
     /**
      * \brief Load existing file.
-     * \param path Path to file
-     * \return bool True if the file was correctly opened, false otherwise.
+     * The entities are shown while the file is read in the background.
+     * \return bool True if the file is being opened, false otherwise.
      */
     bool openFile();
 
@@ -50,6 +51,12 @@ public:
      */
     void setDestroyCallback(kaguya::LuaRef destroyCallback);
 
+    /**
+     * \brief Return true while a file is being opened
+     * The document must not be edited and the undo stack must not be used until then.
+     */
+    bool isOpening() const;
+
     void keyPressEvent(QKeyEvent* event);
     lc::meta::Block_CSPtr activeViewport() const {
         return _viewerProxy->activeViewport();
@@ -65,6 +72,9 @@ public slots:
     void saveFile();
     void saveAsFile();
 
+private slots:
+    void updateOpen();
+
 signals:
 
     void keyPressed(QKeyEvent* event);
@@ -76,6 +86,11 @@ signals:
     void mouseReleaseEvent();
     void selectionChangeEvent();
 
+    /**
+     * \brief Emitted when a file starts or stops being opened
+     */
+    void openingChanged(bool opening);
+
 public:
     QWidget* view() const;
 
@@ -130,6 +145,8 @@ public:
 private:
     std::string _filename;
     lc::persistence::File::Type _fileType = lc::persistence::File::Type::LIBDXFRW_DXF_R2000;
+    std::unique_ptr<lc::persistence::ProgressiveOpen> _progressiveOpen;
+    QTimer* _openTimer;
 
     kaguya::LuaRef _destroyCallback;
 
@@ -104,6 +104,7 @@ LCADViewer::~LCADViewer()
 {
     deletePainters();
     _document->commitProcessEvent().disconnect<LCADViewer, &LCADViewer::on_commitProcessEvent>(this);
+    _document->batchEntityEvent().disconnect<LCADViewer, &LCADViewer::on_batchEntityEvent>(this);
 }
 
 void LCADViewer::initializeGL()
@@ -161,6 +162,7 @@ void LCADViewer::setDocument(std::shared_ptr<lc::storage::Document> document, me
 
     _document = document;
     _document->commitProcessEvent().connect<LCADViewer, &LCADViewer::on_commitProcessEvent>(this);
+    _document->batchEntityEvent().connect<LCADViewer, &LCADViewer::on_batchEntityEvent>(this);
     _docCanvas->selectionChanged().connect<LCADViewer, &LCADViewer::_selectionChanged>(this);
 
     if(_docCanvas != nullptr)
@@ -184,6 +186,10 @@ void LCADViewer::on_commitProcessEvent(const lc::event::CommitProcessEvent& even
     update();
 }
 
+void LCADViewer::on_batchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    update();
+}
+
 void LCADViewer::_selectionChanged() {
     _dragManager->onSelectionChanged();
     emit selectionChangeEvent();
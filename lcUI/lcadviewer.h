@@ -154,6 +154,11 @@ private:
 
     void on_commitProcessEvent(const lc::event::CommitProcessEvent& event);
 
+    /**
+     * @brief Repaint entities added outside of an operation, like the chunks of a file being opened
+     */
+    void on_batchEntityEvent(const lc::event::BatchEntityEvent& event);
+
     /* for panning */
     bool _altKeyActive;
     // For selection
@@ -155,8 +155,14 @@ void addLCBindings(lua_State *L) {
                                    );
 
     state["lc"]["TempEntities"].setClass(kaguya::UserdataMetatable<drawable::TempEntities>()
+                                         .addFunction("addEntities", &drawable::TempEntities::addEntities)
                                          .addFunction("addEntity", &drawable::TempEntities::addEntity)
+                                         .addFunction("clear", &drawable::TempEntities::clear)
+                                         .addFunction("offset", &drawable::TempEntities::offset)
+                                         .addFunction("removeEntities", &drawable::TempEntities::removeEntities)
                                          .addFunction("removeEntity", &drawable::TempEntities::removeEntity)
+                                         .addFunction("setOffset", &drawable::TempEntities::setOffset)
+                                         .addFunction("size", &drawable::TempEntities::size)
                                         );
 
     state["lc"]["MetaInfoManager"].setClass(kaguya::UserdataMetatable<lc::ui::MetaInfoManager>()
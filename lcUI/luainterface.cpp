@@ -11,13 +11,28 @@
 using namespace lc::ui;
 
 LuaInterface::LuaInterface() :
-    _pluginManager(_L.state(), "gui") {
+    _pluginManager(_L.state(), "gui"),
+    _scheduler(_L.state()) {
+
+    _scheduler.startedEvent().connect<LuaInterface, &LuaInterface::onJobStarted>(this);
+
+    // Custom entities are regenerated in jobs, without blocking the UI
+    _jobTimer.setInterval(0);
+    QObject::connect(&_jobTimer, &QTimer::timeout, [this]() {
+        if(!_scheduler.step()) {
+            _jobTimer.stop();
+        }
+    });
 }
 
 LuaInterface::~LuaInterface() {
+    _jobTimer.stop();
     _events.clear();
 
+    lc::lua::LuaCustomEntityManager::getInstance().setScheduler(nullptr);
     lc::lua::LuaCustomEntityManager::getInstance().removePlugins();
+
+    _scheduler.startedEvent().disconnect<LuaInterface, &LuaInterface::onJobStarted>(this);
 }
 
 void LuaInterface::initLua(QMainWindow* mainWindow) {
@@ -25,6 +40,9 @@ void LuaInterface::initLua(QMainWindow* mainWindow) {
     lcLua.setF_openFileDialog(&LuaInterface::openFileDialog);
     lcLua.addLuaLibs();
     lcLua.importLCKernel();
+    lcLua.setProfiler(&_profiler);
+    _scheduler.setProfiler(&_profiler);
+    lc::lua::LuaCustomEntityManager::getInstance().setScheduler(&_scheduler);
 
     luaOpenGUIBridge(_L.state());
 
@@ -67,6 +85,10 @@ void LuaInterface::hideUI(bool hidden) {
     _L["hideUI"] = hidden;
 }
 
+void LuaInterface::onJobStarted(unsigned int id) {
+    _jobTimer.start();
+}
+
 lua_State* LuaInterface::luaState() {
     return _L.state();
 }
@@ -155,6 +177,14 @@ void LuaInterface::registerGlobalFunctions(QMainWindow* mainWindow) {
     _L.dostring("add_command = function(command, callback) mainWindow:cliCommand():addCommand(command, callback) end");
     _L.dostring("run_command = function(command) mainWindow:cliCommand():runCommand(command) end");
     _L.dostring("add_command('CLEAR', function() mainWindow:cliCommand():clear() end)");
+    _L.dostring("add_command('PROFILESTART', function() "
+                "profilerReset() "
+                "local child = mainWindow:cadMdiChild() "
+                "if child then profilerWatch(child:document()) end "
+                "profilerStart() "
+                "message('Profiler started') "
+                "end)");
+    _L.dostring("add_command('PROFILESTOP', function() profilerStop() message(profilerReport()) end)");
     _L.dostring("CreateDialogWidget = function(widgetName) return gui.DialogWidget(widgetName,mainWindow) end");
 
     _L.dostring("luaInterface:registerEvent('finishOperation', finish_operation)");
@@ -16,7 +16,10 @@ extern "C"
 #include <QTextStream>
 #include <QtUiTools/QUiLoader>
 #include <QCoreApplication>
+#include <QTimer>
 #include <managers/pluginmanager.h>
+#include <managers/luajobscheduler.h>
+#include <utils/luaprofiler.h>
 
 #include <kaguya/kaguya.hpp>
 #include "lua/guibridge.h"
@@ -85,9 +88,17 @@ private:
      */
     void registerGlobalFunctions(QMainWindow* mainWindow);
 
+    /**
+     * \brief Resume the jobs from the event loop until they are finished
+     */
+    void onJobStarted(unsigned int id);
+
 private:
     kaguya::State _L;
     lc::lua::PluginManager _pluginManager;
+    lc::lua::LuaProfiler _profiler;
+    lc::lua::LuaJobScheduler _scheduler;
+    QTimer _jobTimer;
     kaguya::LuaRef _operation;
     std::map<std::string, std::vector<kaguya::LuaRef>> _events;
 };
@@ -115,6 +115,11 @@ MainWindow::~MainWindow()
 }
 
 void MainWindow::runOperation(kaguya::LuaRef operation, const std::string& init_method) {
+    // The document is only editable once the file is completely opened
+    if (_cadMdiChild.isOpening()) {
+        return;
+    }
+
     _cliCommand.setFocus();
     _luaInterface.finishOperation();
     _cadMdiChild.viewer()->setOperationActive(true);
@@ -205,6 +210,7 @@ void MainWindow::ConnectInputEvents()
     QObject::connect(&_cadMdiChild, &CadMdiChild::selectionChangeEvent, this, &MainWindow::selectionChanged);
     QObject::connect(&_cadMdiChild, &CadMdiChild::keyPressEventx, this, &MainWindow::triggerKeyPressed);
     QObject::connect(&_cadMdiChild, &CadMdiChild::keyPressed, &_cliCommand, &widgets::CliCommand::onKeyPressed);
+    QObject::connect(&_cadMdiChild, &CadMdiChild::openingChanged, this, &MainWindow::openingChanged);
 
     // CliCommand connections
     QObject::connect(&_cliCommand, &widgets::CliCommand::coordinateEntered, this, &MainWindow::triggerCoordinateEntered);
@@ -546,6 +552,14 @@ void MainWindow::triggerKeyPressed(int key)
     }
 }
 
+void MainWindow::openingChanged(bool opening)
+{
+    _layers.setEnabled(!opening);
+    findMenuItemByObjectName("actionUndo")->setEnabled(!opening);
+    findMenuItemByObjectName("actionRedo")->setEnabled(!opening);
+    findMenuItemByObjectName("actionClear_Undoable_Stack")->setEnabled(!opening);
+}
+
 void MainWindow::triggerCoordinateEntered(lc::geo::Coordinate coordinate)
 {
     kaguya::State state(_luaInterface.luaState());
@@ -620,17 +634,29 @@ void MainWindow::openFile()
 // Edit slots
 void MainWindow::undo()
 {
+    if (_cadMdiChild.isOpening()) {
+        return;
+    }
+
     _cadMdiChild.undoManager()->undo();
     _cadMdiChild.viewer()->update();
 }
 
 void MainWindow::clearUndoableStack()
 {
+    if (_cadMdiChild.isOpening()) {
+        return;
+    }
+
     _cadMdiChild.undoManager()->removeUndoables();
 }
 
 void MainWindow::redo()
 {
+    if (_cadMdiChild.isOpening()) {
+        return;
+    }
+
     _cadMdiChild.undoManager()->redo();
     _cadMdiChild.viewer()->update();
 }
@@ -685,11 +711,7 @@ void MainWindow::selectionChanged() {
     std::vector<lc::entity::CADEntity_CSPtr> selectedEntities = _cadMdiChild.selection();
     PropertyEditor* propertyEditor = PropertyEditor::GetPropertyEditor(this);
 
-    propertyEditor->clear(selectedEntities);
-
-    for (lc::entity::CADEntity_CSPtr selectedEntity : selectedEntities) {
-        propertyEditor->addEntity(selectedEntity);
-    }
+    propertyEditor->setSelection(selectedEntities);
 
     if (selectedEntities.size() == 0) {
         propertyEditor->hide();
@@ -215,6 +215,7 @@ public slots:
     void triggerMouseMoved();
     void triggerSelectionChanged();
     void triggerKeyPressed(int key);
+    void openingChanged(bool opening);
 
     // CliCommand slots
     void triggerCoordinateEntered(lc::geo::Coordinate coordinate);
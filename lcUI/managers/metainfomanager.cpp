@@ -1,5 +1,7 @@
 #include "metainfomanager.h"
 
+#include <cad/meta/metapool.h>
+
 using namespace lc;
 using namespace ui;
 
@@ -17,7 +19,7 @@ meta::MetaInfo_CSPtr MetaInfoManager::metaInfo() {
     metaInfo = addMetaType(metaInfo, _lineWidth);
     metaInfo = addMetaType(metaInfo, _color);
 
-    return metaInfo;
+    return meta::MetaPool::instance().intern(metaInfo);
 }
 
 meta::MetaInfo_SPtr MetaInfoManager::addMetaType(meta::MetaInfo_SPtr metaInfo, meta::EntityMetaType_CSPtr metaType) {
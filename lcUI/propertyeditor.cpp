@@ -3,6 +3,7 @@
 #include "widgets/guiAPI/entitypickervisitor.h"
 #include <QVBoxLayout>
 #include <QScrollArea>
+#include <unordered_set>
 
 #include "widgets/guiAPI/numbergui.h"
 #include "widgets/guiAPI/coordinategui.h"
@@ -23,7 +24,8 @@ std::map<lc::ui::MainWindow*, PropertyEditor*> PropertyEditor::instances;
 PropertyEditor::PropertyEditor(lc::ui::MainWindow* mainWindow)
     :
     QDockWidget("Property Editor", mainWindow),
-    InputGUIContainer("property_editor", mainWindow)
+    InputGUIContainer("property_editor", mainWindow),
+    _currentEntity(0)
 {
     QScrollArea* parentWidget = new QScrollArea(this);
 
@@ -40,6 +42,12 @@ PropertyEditor::PropertyEditor(lc::ui::MainWindow* mainWindow)
     widget->setStyleSheet("QTreeWidget::item{ border : 1px solid rgb(156, 220, 31); margin-left: 2; padding-left: 5px;} QTreeView::item:selected {border : 3px solid rgb(156, 220, 31)}");
     widget->setColumnWidth(0, 200);
 
+    _treeWidget = widget;
+    _summaryItem = new QTreeWidgetItem();
+    _summaryItem->setHidden(true);
+    widget->addTopLevelItem(_summaryItem);
+    QObject::connect(widget, &QTreeWidget::itemExpanded, this, &PropertyEditor::onItemExpanded);
+
     parentWidget->setWidget(widget);
     this->setWidget(parentWidget);
 
@@ -58,71 +66,174 @@ PropertyEditor* PropertyEditor::GetPropertyEditor(lc::ui::MainWindow* mainWindow
     return instances[mainWindow];
 }
 
-void PropertyEditor::clear(std::vector<lc::entity::CADEntity_CSPtr> selectedEntities) {
-    QTreeWidget* guicontainer = this->widget()->findChild<QTreeWidget*>("guiContainer");
+void PropertyEditor::setSelection(const std::vector<lc::entity::CADEntity_CSPtr>& selectedEntities) {
+    _treeWidget->setUpdatesEnabled(false);
 
-    for (std::set<unsigned long>::iterator iter = _selectedEntities.begin(); iter != _selectedEntities.end();) {
-        bool found = false;
+    clear(selectedEntities);
 
-        for (lc::entity::CADEntity_CSPtr cadEnt : selectedEntities) {
-            if (cadEnt->id() == *iter) {
-                found = true;
-                break;
-            }
+    for (const auto& entity : selectedEntities) {
+        addEntity(entity);
+    }
+
+    if (_selectedEntities.size() <= AUTO_EXPAND_LIMIT) {
+        for (auto& selected : _selectedEntities) {
+            createEntityWidgets(selected.first);
+            selected.second.group->setExpanded(true);
         }
+    }
 
-        if (!found) {
-            for (const std::string& keyStr : _entityProperties[*iter]) {
-                removeInputGUI(keyStr, false);
-            }
+    updateSummary();
+    _treeWidget->setUpdatesEnabled(true);
+}
 
-            guicontainer->removeItemWidget(_entityGroup[*iter], 0);
-            guicontainer->takeTopLevelItem(guicontainer->indexOfTopLevelItem(_entityGroup[*iter]));
-            delete _entityGroup[*iter];
+void PropertyEditor::clear(std::vector<lc::entity::CADEntity_CSPtr> selectedEntities) {
+    std::unordered_set<unsigned long> selectedIDs;
+    for (const auto& entity : selectedEntities) {
+        selectedIDs.insert(entity->id());
+    }
 
-            _entityProperties.erase(*iter);
-            _entityGroup.erase(*iter);
-            iter = _selectedEntities.erase(iter);
+    std::vector<unsigned long> removedIDs;
+    for (const auto& selected : _selectedEntities) {
+        if (selectedIDs.find(selected.first) == selectedIDs.end()) {
+            removedIDs.push_back(selected.first);
         }
-        else {
-            ++iter;
+    }
+
+    if (!removedIDs.empty() && removedIDs.size() == _selectedEntities.size()) {
+        // Nothing is kept, remove all the groups from the end, the summary is the first item
+        for (const auto& entityProperties : _entityProperties) {
+            for (const std::string& keyStr : entityProperties.second) {
+                removeInputGUI(keyStr, false);
+            }
+        }
+
+        while (_treeWidget->topLevelItemCount() > 1) {
+            delete _treeWidget->takeTopLevelItem(_treeWidget->topLevelItemCount() - 1);
         }
+
+        _entityProperties.clear();
+        _selectedEntities.clear();
+        _widgetKeyToEntity.clear();
+        return;
+    }
+
+    for (auto entityID : removedIDs) {
+        removeEntity(entityID);
     }
 }
 
 void PropertyEditor::addEntity(lc::entity::CADEntity_CSPtr entity) {
-    QTreeWidget* guicontainer = this->widget()->findChild<QTreeWidget*>("guiContainer");
+    auto it = _selectedEntities.find(entity->id());
+    if (it != _selectedEntities.end()) {
+        it->second.entity = entity;
+        return;
+    }
+
+    // Get entity information
+    api::EntityPickerVisitor entityVisitor;
+    entity->dispatch(entityVisitor);
+    std::string entityType = entityVisitor.getEntityInformation();
+
+    QTreeWidgetItem* treeItem = new QTreeWidgetItem();
+    treeItem->setText(0, QString(entityType.c_str()) + QString(" #") + QString::number(entity->id()));
+    treeItem->setData(0, Qt::UserRole, QVariant::fromValue<qulonglong>(entity->id()));
+    treeItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    _treeWidget->addTopLevelItem(treeItem);
+
+    _selectedEntities[entity->id()] = {entity, entityType, treeItem, false};
+    _entityProperties[entity->id()] = std::vector<std::string>();
+}
 
-    if (_selectedEntities.find(entity->id()) == _selectedEntities.end()) {
-        _selectedEntities.insert(entity->id());
-        _entityProperties[entity->id()] = std::vector<std::string>();
+void PropertyEditor::removeEntity(unsigned long entityID) {
+    auto it = _selectedEntities.find(entityID);
+    if (it == _selectedEntities.end()) {
+        return;
+    }
+
+    for (const std::string& keyStr : _entityProperties[entityID]) {
+        removeInputGUI(keyStr, false);
+        _widgetKeyToEntity.erase(keyStr);
+    }
+
+    // Removes the item and its widgets from the tree
+    delete it->second.group;
+
+    _entityProperties.erase(entityID);
+    _selectedEntities.erase(it);
+}
+
+void PropertyEditor::onItemExpanded(QTreeWidgetItem* item) {
+    if (item == _summaryItem || item->parent() != nullptr) {
+        return;
+    }
+
+    createEntityWidgets(item->data(0, Qt::UserRole).toULongLong());
+}
 
-        // Get entity information
-        api::EntityPickerVisitor entityVisitor;
-        entity->dispatch(entityVisitor);
-        QString entityInfo = QString(entityVisitor.getEntityInformation().c_str()) + QString(" #") + QString::number(entity->id());
-        QTreeWidgetItem* treeItem = new QTreeWidgetItem();
-        _entityGroup[entity->id()] = treeItem;
-        guicontainer->addTopLevelItem(treeItem);
-        guicontainer->setItemWidget(treeItem, 0, new QLabel(entityInfo));
-        treeItem->setExpanded(true);
+void PropertyEditor::createEntityWidgets(unsigned long entityID) {
+    auto it = _selectedEntities.find(entityID);
+    if (it == _selectedEntities.end() || it->second.widgetsCreated) {
+        return;
     }
 
-    createPropertiesWidgets(entity->id(), entity->availableProperties());
+    it->second.widgetsCreated = true;
+    it->second.group->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+
+    auto entity = it->second.entity;
+    _currentEntity = entityID;
+    createPropertiesWidgets(entityID, entity->availableProperties());
     createCustomWidgets(entity);
     createLayerAndMetaTypeWidgets(entity);
 }
 
+void PropertyEditor::updateSummary() {
+    qDeleteAll(_summaryItem->takeChildren());
+
+    if (_selectedEntities.empty()) {
+        _summaryItem->setHidden(true);
+        return;
+    }
+
+    std::map<std::string, size_t> entityTypes;
+    lc::meta::Layer_CSPtr layer;
+    bool sameLayer = true;
+
+    for (const auto& selected : _selectedEntities) {
+        entityTypes[selected.second.type]++;
+
+        auto entityLayer = selected.second.entity->layer();
+        if (layer == nullptr) {
+            layer = entityLayer;
+        }
+        else if (entityLayer != layer) {
+            sameLayer = false;
+        }
+    }
+
+    _summaryItem->setText(0, QString::number(_selectedEntities.size()) + QString(" entities selected"));
+
+    QString layerName = sameLayer && layer != nullptr ? QString(layer->name().c_str()) : QString("varies");
+    new QTreeWidgetItem(_summaryItem, QStringList({"Layer", layerName}));
+
+    for (const auto& entityType : entityTypes) {
+        new QTreeWidgetItem(_summaryItem, QStringList({entityType.first.c_str(), QString::number(entityType.second)}));
+    }
+
+    _summaryItem->setHidden(false);
+    _summaryItem->setExpanded(true);
+}
+
 bool PropertyEditor::addWidget(const std::string& key, api::InputGUI* guiWidget) {
-    if (_entityGroup.find(_currentEntity) == _entityGroup.end()) {
+    auto selected = _selectedEntities.find(_currentEntity);
+    if (selected == _selectedEntities.end()) {
         return false;
     }
-    QTreeWidget* guicontainer = this->widget()->findChild<QTreeWidget*>("guiContainer");
+    QTreeWidget* guicontainer = _treeWidget;
 
     bool success = InputGUIContainer::addWidget(key, guiWidget);
     if (success) {
         QTreeWidgetItem* entityChildItem = new QTreeWidgetItem();
-        _entityGroup[_currentEntity]->addChild(entityChildItem);
+        selected->second.group->addChild(entityChildItem);
         guicontainer->setItemWidget(entityChildItem, 0, new QLabel(guiWidget->label().c_str()));
         guiWidget->hideLabel();
         guicontainer->setItemWidget(entityChildItem, 1, guiWidget);
@@ -4,6 +4,7 @@
 #include "widgets/guiAPI/inputguicontainer.h"
 #include "widgets/guiAPI/inputgui.h"
 #include <QTreeWidget>
+#include <unordered_map>
 #include "mainwindow.h"
 
 namespace lc
@@ -12,6 +13,10 @@ namespace ui
 {
 /**
 * \brief Property Editor widget
+*
+* The editor shows a summary of the selection (entity types, common layer) followed by one group per entity.
+* The property widgets of an entity are created the first time its group is expanded, only small selections
+* are expanded automatically. Selection changes only process the entities added or removed.
 */
 class PropertyEditor : public QDockWidget, public api::InputGUIContainer
 {
@@ -25,6 +30,13 @@ public:
     */
     static PropertyEditor* GetPropertyEditor(lc::ui::MainWindow* mainWindow = nullptr);
 
+    /**
+    * \brief Update the editor for the new selection
+    * Groups of entities which are still selected are kept, with their widgets.
+    * \param vector of currently selected entities
+    */
+    void setSelection(const std::vector<lc::entity::CADEntity_CSPtr>& selectedEntities);
+
     /**
     * \brief Clear widgets and groups that were present before but not in the passed in new selected entities
     * \param vector of currently selected entities
@@ -32,7 +44,7 @@ public:
     void clear(std::vector<lc::entity::CADEntity_CSPtr> selectedEntities);
 
     /**
-    * \brief Add property widgets for the entity
+    * \brief Add the group of the entity, its property widgets are created when the group is expanded
     * \param CADEntity shared pointer entity
     */
     void addEntity(lc::entity::CADEntity_CSPtr entity);
@@ -50,13 +62,50 @@ public:
     */
     void propertyChanged(const std::string& key);
 
+private slots:
+    /**
+    * \brief Create the property widgets of an entity group when it is expanded for the first time
+    * \param pointer to expanded item
+    */
+    void onItemExpanded(QTreeWidgetItem* item);
+
 private:
+    /**
+    * \brief Entity shown in the editor
+    */
+    struct SelectedEntity {
+        lc::entity::CADEntity_CSPtr entity;
+        std::string type;
+        QTreeWidgetItem* group;
+        bool widgetsCreated;
+    };
+
+    // Selections up to this size have their property widgets created immediately
+    static const size_t AUTO_EXPAND_LIMIT = 10;
+
     /**
     * \brief Constructor of property editor (private because singleton)
     * \param pointer to MainWindow
     */
     PropertyEditor(lc::ui::MainWindow* mainWindow = nullptr);
 
+    /**
+    * \brief Remove the group and the widgets of an entity
+    * \param unsigned long entity ID
+    */
+    void removeEntity(unsigned long entityID);
+
+    /**
+    * \brief Create the property widgets of an entity, if not done yet
+    * \param unsigned long entity ID
+    */
+    void createEntityWidgets(unsigned long entityID);
+
+    /**
+    * \brief Update the summary of the selection, properties which are not shared show "varies"
+    */
+    void updateSummary();
+
     /**
     * \brief Helper function to create property widgets for the given entity properties map
     * \param unsigned long entity ID
@@ -94,10 +143,11 @@ private:
 private:
     static std::map<lc::ui::MainWindow*,PropertyEditor*> instances;
     std::map<unsigned long, std::vector<std::string>> _entityProperties;
-    std::map<unsigned long, QTreeWidgetItem*> _entityGroup;
-    std::set<unsigned long> _selectedEntities;
+    std::unordered_map<unsigned long, SelectedEntity> _selectedEntities;
     std::map<std::string, unsigned long> _widgetKeyToEntity;
     unsigned long _currentEntity;
+    QTreeWidget* _treeWidget;
+    QTreeWidgetItem* _summaryItem;
     ui::MetaInfoManager_SPtr _metaInfoManager;
 };
 }
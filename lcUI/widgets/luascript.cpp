@@ -9,28 +9,86 @@ LuaScript::LuaScript(lc::ui::MainWindow* mainWindow) :
     ui(new Ui::LuaScript),
     _mainWindow(mainWindow),
     _mdiChild(mainWindow->cadMdiChild()),
-    _cliCommand(mainWindow->cliCommand()) {
+    _cliCommand(mainWindow->cliCommand()),
+    _scheduler(luaState.state()),
+    _job(0) {
     ui->setupUi(this);
 
+    _scheduler.startedEvent().connect<LuaScript, &LuaScript::onJobStarted>(this);
+    _scheduler.progressEvent().connect<LuaScript, &LuaScript::onJobProgress>(this);
+    _scheduler.finishedEvent().connect<LuaScript, &LuaScript::onJobFinished>(this);
+
+    _jobTimer.setInterval(0);
+    connect(&_jobTimer, &QTimer::timeout, this, &LuaScript::stepJobs);
+
     auto lcLua = lc::lua::LCLua(luaState.state());
     lcLua.setF_openFileDialog(&LuaInterface::openFileDialog);
     lcLua.addLuaLibs();
     lcLua.importLCKernel();
+    lcLua.setProfiler(&_profiler);
+    _scheduler.setProfiler(&_profiler);
     luaOpenGUIBridge(luaState.state());
     registerGlobalFunctions(luaState);
 }
 
 LuaScript::~LuaScript() {
+    _jobTimer.stop();
+
+    _scheduler.startedEvent().disconnect<LuaScript, &LuaScript::onJobStarted>(this);
+    _scheduler.progressEvent().disconnect<LuaScript, &LuaScript::onJobProgress>(this);
+    _scheduler.finishedEvent().disconnect<LuaScript, &LuaScript::onJobFinished>(this);
+
     delete ui;
 }
 
 
 void LuaScript::on_luaRun_clicked() {
+    if(_scheduler.status(_job) == lc::lua::LuaJobScheduler::JobStatus::Running) {
+        _scheduler.cancel(_job);
+        return;
+    }
+
     auto lcLua = lc::lua::LCLua(luaState.state());
     lcLua.setDocument(_mdiChild->document());
+    _profiler.watch(_mdiChild->document());
 
-    auto out = lcLua.runString(ui->luaInput->toPlainText().toStdString().c_str());
-    _cliCommand->write(out);
+    _job = _scheduler.runString(ui->luaInput->toPlainText().toStdString().c_str(), _mdiChild->document());
+
+    if(_scheduler.status(_job) == lc::lua::LuaJobScheduler::JobStatus::Failed) {
+        _cliCommand->write(_scheduler.error(_job));
+    }
+}
+
+void LuaScript::stepJobs() {
+    if(!_scheduler.step()) {
+        _jobTimer.stop();
+    }
+}
+
+void LuaScript::onJobStarted(unsigned int id) {
+    ui->luaRun->setText(tr("Cancel"));
+    _jobTimer.start();
+}
+
+void LuaScript::onJobProgress(unsigned int id, double progress) {
+    if(id == _job) {
+        ui->luaRun->setText(tr("Cancel (%1%)").arg(static_cast<int>(progress * 100)));
+    }
+}
+
+void LuaScript::onJobFinished(unsigned int id, lc::lua::LuaJobScheduler::JobStatus status) {
+    if(id != _job) {
+        return;
+    }
+
+    ui->luaRun->setText(tr("Run"));
+
+    if(status == lc::lua::LuaJobScheduler::JobStatus::Failed) {
+        _cliCommand->write(_scheduler.error(id));
+    }
+    else if(status == lc::lua::LuaJobScheduler::JobStatus::Cancelled) {
+        _cliCommand->write("Script cancelled");
+    }
 }
 
 void LuaScript::on_open_clicked() {
@@ -5,11 +5,13 @@
 #include <QMdiSubWindow>
 #include <QFileDialog>
 #include <QTextStream>
+#include <QTimer>
 #include <mainwindow.h>
 #include "cadmdichild.h"
 #include "clicommand.h"
 
 #include <lclua.h>
+#include <managers/luajobscheduler.h>
 
 namespace Ui {
 class LuaScript;
@@ -21,6 +23,8 @@ namespace widgets {
 /**
  * \brief Widget that allows to enter and run Lua code.
  * This widget runs the code on the selected window in CadMdiChild and display the output in the command line.
+ * The code runs as a job of a LuaJobScheduler resumed from the event loop, the window stays responsive
+ * and the run button cancels the script while it is running.
  */
 class LuaScript : public QWidget {
     Q_OBJECT
@@ -38,10 +42,15 @@ public:
 private slots:
 
     /**
-     * \brief Run script
+     * \brief Run script, or cancel it if it's already running
      */
     void on_luaRun_clicked();
 
+    /**
+     * \brief Resume the running scripts for one slice
+     */
+    void stepJobs();
+
     /**
      * \brief Open file
      */
@@ -58,12 +67,23 @@ private:
      */
     void registerGlobalFunctions(kaguya::State& luaState);
 
+    void onJobStarted(unsigned int id);
+
+    void onJobProgress(unsigned int id, double progress);
+
+    void onJobFinished(unsigned int id, lc::lua::LuaJobScheduler::JobStatus status);
+
 private:
     Ui::LuaScript* ui;
     lc::ui::MainWindow* _mainWindow;
     CadMdiChild* _mdiChild;
     CliCommand* _cliCommand;
     kaguya::State luaState;
+
+    lc::lua::LuaJobScheduler _scheduler;
+    QTimer _jobTimer;
+    unsigned int _job;
+    lc::lua::LuaProfiler _profiler;
 };
 }
 }
@@ -25,7 +25,7 @@ function CopyOperation:_init(widget)
         self.origin = nil
         self.destination = nil
 
-        self.tempEntities = {}
+        self.previewed = false
 
         luaInterface:registerEvent('point', self)
         luaInterface:registerEvent('mouseMove', self)
@@ -59,19 +59,15 @@ end
 
 function CopyOperation:tempCopy(point)
     if(self.origin ~= nil) then
-        local window = mainWindow:cadMdiChild()
-        for k, entity in pairs(self.tempEntities) do
-            window:tempEntities():removeEntity(entity)
-        end
-        self.tempEntities = {}
+        local tempEntities = mainWindow:cadMdiChild():tempEntities()
 
-        local offset = point:sub(self.origin)
-
-        for k, entity in pairs(self.selection) do
-            local newEntity = entity:copy(offset)
-            window:tempEntities():addEntity(newEntity)
-            table.insert(self.tempEntities, newEntity)
+        -- The selection is added once, moving the mouse only changes the offset of the preview
+        if(not self.previewed) then
+            tempEntities:addEntities(self.selection)
+            self.previewed = true
         end
+
+        tempEntities:setOffset(point:sub(self.origin))
     end
 end
 
@@ -94,8 +90,9 @@ function CopyOperation:close()
     if(not self.finished) then
         self.finished = true
         local window = mainWindow:cadMdiChild()
-        for k, entity in pairs(self.tempEntities) do
-            window:tempEntities():removeEntity(entity)
+        if(self.previewed) then
+            window:tempEntities():removeEntities(self.selection)
+            window:tempEntities():setOffset(lc.geo.Coordinate(0, 0))
         end
 
         luaInterface:deleteEvent('mouseMove', self)
@@ -23,7 +23,7 @@ function MoveOperation:_init(id)
 
     if(#self.selection > 0) then
         self.origin = nil
-        self.tempEntities = {}
+        self.previewed = false
 
         luaInterface:registerEvent('point', self)
         luaInterface:registerEvent('mouseMove', self)
@@ -66,19 +66,15 @@ end
 
 function MoveOperation:tempMove(point)
     if(self.origin ~= nil) then
-        local window = mainWindow:cadMdiChild()
-        for k, entity in pairs(self.tempEntities) do
-            window:tempEntities():removeEntity(entity)
-        end
-        self.tempEntities = {}
-
-        local offset = point:sub(self.origin)
+        local tempEntities = mainWindow:cadMdiChild():tempEntities()
 
-        for k, entity in pairs(self.selection) do
-            local newEntity = entity:move(offset)
-            window:tempEntities():addEntity(newEntity)
-            table.insert(self.tempEntities, newEntity)
+        -- The selection is added once, moving the mouse only changes the offset of the preview
+        if(not self.previewed) then
+            tempEntities:addEntities(self.selection)
+            self.previewed = true
         end
+
+        tempEntities:setOffset(point:sub(self.origin))
     end
 end
 
@@ -87,8 +83,9 @@ function MoveOperation:close()
         local window = mainWindow:cadMdiChild()
         self.finished = true
 
-        for k, entity in pairs(self.tempEntities) do
-            window:tempEntities():removeEntity(entity)
+        if(self.previewed) then
+            window:tempEntities():removeEntities(self.selection)
+            window:tempEntities():setOffset(lc.geo.Coordinate(0, 0))
         end
 
         luaInterface:deleteEvent('mouseMove', self)
@@ -129,8 +129,8 @@ end
 function TrimOperation:selectionChanged()
     self.selection = mainWindow:cadMdiChild():selection()
     --print(#self.selection)
-    local intersect = lc.maths.IntersectMany(self.selection)
-    self.intersectionPoints = intersect:result()
+    local document = mainWindow:cadMdiChild():document()
+    self.intersectionPoints = document:intersectionIndex():intersectMany(self.selection)
 	--print(#self.intersectionPoints)
 	for k, point in pairs(self.intersectionPoints) do
 		print("point")
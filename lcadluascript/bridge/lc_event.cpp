@@ -5,6 +5,7 @@
 #include <cad/events/replacelayerevent.h>
 #include <cad/events/removeentityevent.h>
 #include <cad/events/replaceentityevent.h>
+#include <cad/events/batchentityevent.h>
 #include <cad/events/addlinepatternevent.h>
 #include <cad/events/removelinepatternevent.h>
 #include <cad/events/replacelinepatternevent.h>
@@ -56,6 +57,12 @@ void import_lc_event_namespace(kaguya::State& state) {
             .addFunction("entity", &lc::event::ReplaceEntityEvent::entity)
                                                        );
 
+    state["lc"]["event"]["BatchEntityEvent"].setClass(kaguya::UserdataMetatable<lc::event::BatchEntityEvent>()
+            .setConstructors<lc::event::BatchEntityEvent(std::vector<lc::entity::CADEntity_CSPtr>, std::vector<lc::entity::CADEntity_CSPtr>)>()
+            .addFunction("added", &lc::event::BatchEntityEvent::added)
+            .addFunction("removed", &lc::event::BatchEntityEvent::removed)
+                                                     );
+
     state["lc"]["event"]["AddLinePatternEvent"].setClass(kaguya::UserdataMetatable<lc::event::AddLinePatternEvent>()
             .setConstructors<lc::event::AddLinePatternEvent(const lc::meta::DxfLinePatternByValue_CSPtr)>()
             .addFunction("linePattern", &lc::event::AddLinePatternEvent::linePattern)
@@ -6,6 +6,7 @@
 #include <cad/operations/linepatternops.h>
 #include <cad/operations/blockops.h>
 #include <cad/operations/entitybuilder.h>
+#include <cad/operations/transaction.h>
 #include "lc_operation.h"
 
 void import_lc_operation_namespace(kaguya::State& state) {
@@ -29,6 +30,14 @@ void import_lc_operation_namespace(kaguya::State& state) {
             .addFunction("undo", &lc::operation::Builder::undo)
                                                 );
 
+    state["lc"]["operation"]["Transaction"].setClass(kaguya::UserdataMetatable<lc::operation::Transaction, lc::operation::DocumentOperation>()
+            .setConstructors<lc::operation::Transaction(lc::storage::Document_SPtr, const std::string &)>()
+            .addFunction("append", &lc::operation::Transaction::append)
+            .addFunction("operationCount", &lc::operation::Transaction::operationCount)
+            .addFunction("redo", &lc::operation::Transaction::redo)
+            .addFunction("undo", &lc::operation::Transaction::undo)
+                                                    );
+
     state["lc"]["operation"]["Base"].setClass(kaguya::UserdataMetatable<lc::operation::Base>()
             .addFunction("process", &lc::operation::Base::process)
                                              );
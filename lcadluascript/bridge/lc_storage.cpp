@@ -5,6 +5,8 @@
 #include <cad/storage/document.h>
 #include <cad/storage/storagemanager.h>
 #include <cad/storage/documentimpl.h>
+#include <cad/storage/intersectionindex.h>
+#include <cad/storage/memoryreport.h>
 #include "lc_storage.h"
 
 void import_lc_storage_namespace(kaguya::State& state) {
@@ -31,7 +33,7 @@ void import_lc_storage_namespace(kaguya::State& state) {
             .addFunction("clear", &lc::storage::QuadTree<lc::entity::CADEntity_CSPtr>::clear)
             .addFunction("entityByID", &lc::storage::QuadTree<lc::entity::CADEntity_CSPtr>::entityByID)
             .addFunction("erase", &lc::storage::QuadTree<lc::entity::CADEntity_CSPtr>::erase)
-            .addFunction("insert", &lc::storage::QuadTree<lc::entity::CADEntity_CSPtr>::insert)
+            .addFunction("insert", static_cast<void(lc::storage::QuadTree<lc::entity::CADEntity_CSPtr>::*)(const std::shared_ptr<const class lc::entity::CADEntity>)>(&lc::storage::QuadTree<lc::entity::CADEntity_CSPtr>::insert))
             .addFunction("test", &lc::storage::QuadTree<lc::entity::CADEntity_CSPtr>::test)
                                                );
 
@@ -48,7 +50,7 @@ void import_lc_storage_namespace(kaguya::State& state) {
             .addFunction("entitiesWithinAndCrossingAreaFast", &lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::entitiesWithinAndCrossingAreaFast)
             .addFunction("entityByID", &lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::entityByID)
             .addFunction("getEntityPathsNearCoordinate", &lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::getEntityPathsNearCoordinate)
-            .addFunction("insert", &lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::insert)
+            .addFunction("insert", static_cast<void(lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::*)(lc::entity::CADEntity_CSPtr)>(&lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::insert))
             .addFunction("optimise", &lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::optimise)
             .addFunction("remove", &lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>::remove)
                                                       );
@@ -61,6 +63,7 @@ void import_lc_storage_namespace(kaguya::State& state) {
             .addFunction("entitiesByLayer", &lc::storage::StorageManager::entitiesByLayer)
             .addFunction("entityByID", &lc::storage::StorageManager::entityByID)
             .addFunction("entityContainer", &lc::storage::StorageManager::entityContainer)
+            .addFunction("insertEntities", &lc::storage::StorageManager::insertEntities)
             .addFunction("insertEntity", &lc::storage::StorageManager::insertEntity)
             .addFunction("insertEntityContainer", &lc::storage::StorageManager::insertEntityContainer)
             .addFunction("layerByName", &lc::storage::StorageManager::layerByName)
@@ -76,14 +79,24 @@ void import_lc_storage_namespace(kaguya::State& state) {
             .addFunction("addDocumentMetaType", &lc::storage::Document::addDocumentMetaType)
             .addFunction("allLayers", &lc::storage::Document::allLayers)
             .addFunction("allMetaTypes", &lc::storage::Document::allMetaTypes)
+            .addFunction("applyBatch", &lc::storage::Document::applyBatch)
+            .addFunction("batch", &lc::storage::Document::batch)
             .addFunction("blocks", &lc::storage::Document::blocks)
+            .addFunction("boundingBoxesInArea", &lc::storage::Document::boundingBoxesInArea)
+            .addFunction("countInArea", &lc::storage::Document::countInArea)
+            .addFunction("eachEntity", &lc::storage::Document::eachEntity)
+            .addFunction("eachInArea", &lc::storage::Document::eachInArea)
             .addFunction("entitiesByBlock", &lc::storage::Document::entitiesByBlock)
             .addFunction("entitiesByLayer", &lc::storage::Document::entitiesByLayer)
             .addFunction("entityContainer", &lc::storage::Document::entityContainer)
+            .addFunction("entityIDsInArea", &lc::storage::Document::entityIDsInArea)
             .addFunction("insertEntity", &lc::storage::Document::insertEntity)
+            .addFunction("intersectionIndex", &lc::storage::Document::intersectionIndex)
             .addFunction("layerByName", &lc::storage::Document::layerByName)
             .addFunction("linePatternByName", &lc::storage::Document::linePatternByName)
             .addFunction("linePatterns", &lc::storage::Document::linePatterns)
+            .addFunction("loadAll", &lc::storage::Document::loadAll)
+            .addFunction("loadArea", &lc::storage::Document::loadArea)
             .addFunction("removeDocumentMetaType", &lc::storage::Document::removeDocumentMetaType)
             .addFunction("removeEntity", &lc::storage::Document::removeEntity)
             .addFunction("replaceDocumentMetaType", &lc::storage::Document::replaceDocumentMetaType)
@@ -95,20 +108,47 @@ void import_lc_storage_namespace(kaguya::State& state) {
             .addFunction("addDocumentMetaType", &lc::storage::DocumentImpl::addDocumentMetaType)
             .addFunction("allLayers", &lc::storage::DocumentImpl::allLayers)
             .addFunction("allMetaTypes", &lc::storage::DocumentImpl::allMetaTypes)
+            .addFunction("applyBatch", &lc::storage::DocumentImpl::applyBatch)
+            .addFunction("batch", &lc::storage::DocumentImpl::batch)
             .addFunction("blocks", &lc::storage::DocumentImpl::blocks)
+            .addFunction("boundingBoxesInArea", &lc::storage::DocumentImpl::boundingBoxesInArea)
+            .addFunction("countInArea", &lc::storage::DocumentImpl::countInArea)
+            .addFunction("eachEntity", &lc::storage::DocumentImpl::eachEntity)
+            .addFunction("eachInArea", &lc::storage::DocumentImpl::eachInArea)
             .addFunction("entitiesByBlock", &lc::storage::DocumentImpl::entitiesByBlock)
             .addFunction("entitiesByLayer", &lc::storage::DocumentImpl::entitiesByLayer)
             .addFunction("entityContainer", &lc::storage::DocumentImpl::entityContainer)
+            .addFunction("entityIDsInArea", &lc::storage::DocumentImpl::entityIDsInArea)
             .addFunction("insertEntity", &lc::storage::DocumentImpl::insertEntity)
+            .addFunction("intersectionIndex", &lc::storage::DocumentImpl::intersectionIndex)
             .addFunction("layerByName", &lc::storage::DocumentImpl::layerByName)
             .addFunction("linePatternByName", &lc::storage::DocumentImpl::linePatternByName)
             .addFunction("linePatterns", &lc::storage::DocumentImpl::linePatterns)
+            .addFunction("loadAll", &lc::storage::DocumentImpl::loadAll)
+            .addFunction("loadArea", &lc::storage::DocumentImpl::loadArea)
             .addFunction("removeDocumentMetaType", &lc::storage::DocumentImpl::removeDocumentMetaType)
             .addFunction("removeEntity", &lc::storage::DocumentImpl::removeEntity)
             .addFunction("replaceDocumentMetaType", &lc::storage::DocumentImpl::replaceDocumentMetaType)
             .addFunction("waitingCustomEntities", &lc::storage::DocumentImpl::waitingCustomEntities)
                                                    );
 
+    state["lc"]["storage"]["IntersectionIndex"].setClass(kaguya::UserdataMetatable<lc::storage::IntersectionIndex>()
+            .addFunction("clear", &lc::storage::IntersectionIndex::clear)
+            .addFunction("intersectMany", &lc::storage::IntersectionIndex::intersectMany)
+            .addFunction("intersections", &lc::storage::IntersectionIndex::intersections)
+            .addFunction("intersectionsWithDocument", &lc::storage::IntersectionIndex::intersectionsWithDocument)
+            .addFunction("size", &lc::storage::IntersectionIndex::size)
+                                                        );
+
+    state["lc"]["storage"]["MemoryReport"].setClass(kaguya::UserdataMetatable<lc::storage::MemoryReport>()
+            .setConstructors<lc::storage::MemoryReport(), lc::storage::MemoryReport(const lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr>&)>()
+            .addFunction("add", &lc::storage::MemoryReport::add)
+            .addFunction("attributesCount", &lc::storage::MemoryReport::attributesCount)
+            .addFunction("entityCount", &lc::storage::MemoryReport::entityCount)
+            .addFunction("toString", &lc::storage::MemoryReport::toString)
+            .addFunction("totalBytes", &lc::storage::MemoryReport::totalBytes)
+                                                   );
+
     state["lc"]["storage"]["UndoManager"].setClass(kaguya::UserdataMetatable<lc::storage::UndoManager>()
             .addFunction("canRedo", &lc::storage::UndoManager::canRedo)
             .addFunction("canUndo", &lc::storage::UndoManager::canUndo)
@@ -118,9 +158,10 @@ void import_lc_storage_namespace(kaguya::State& state) {
                                                   );
 
     state["lc"]["storage"]["UndoManagerImpl"].setClass(kaguya::UserdataMetatable<lc::storage::UndoManagerImpl, lc::storage::UndoManager>()
-            .setConstructors<lc::storage::UndoManagerImpl(unsigned int)>()
+            .setConstructors<lc::storage::UndoManagerImpl(unsigned int), lc::storage::UndoManagerImpl(unsigned int, size_t)>()
             .addFunction("canRedo", &lc::storage::UndoManagerImpl::canRedo)
             .addFunction("canUndo", &lc::storage::UndoManagerImpl::canUndo)
+            .addFunction("memoryUsage", &lc::storage::UndoManagerImpl::memoryUsage)
             .addFunction("on_CommitProcessEvent", &lc::storage::UndoManagerImpl::on_CommitProcessEvent)
             .addFunction("redo", &lc::storage::UndoManagerImpl::redo)
             .addFunction("removeUndoables", &lc::storage::UndoManagerImpl::removeUndoables)
@@ -136,6 +177,7 @@ void import_lc_storage_namespace(kaguya::State& state) {
             .addFunction("entitiesByLayer", &lc::storage::StorageManagerImpl::entitiesByLayer)
             .addFunction("entityByID", &lc::storage::StorageManagerImpl::entityByID)
             .addFunction("entityContainer", &lc::storage::StorageManagerImpl::entityContainer)
+            .addFunction("insertEntities", &lc::storage::StorageManagerImpl::insertEntities)
             .addFunction("insertEntity", &lc::storage::StorageManagerImpl::insertEntity)
             .addFunction("insertEntityContainer", &lc::storage::StorageManagerImpl::insertEntityContainer)
             .addFunction("layerByName", &lc::storage::StorageManagerImpl::layerByName)
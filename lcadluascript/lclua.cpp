@@ -2,6 +2,7 @@
 #include "lclua.h"
 #include <utils/timer.h>
 #include <managers/luacustomentitymanager.h>
+#include <managers/luaworkerpool.h>
 #include <kaguya/kaguya.hpp>
 #include <bridge/lc.h>
 #include <bridge/lc_geo.h>
@@ -72,6 +73,30 @@ void LCLua::setDocument(const lc::storage::Document_SPtr& document) {
     state["document"] = document;
 }
 
+void LCLua::setProfiler(LuaProfiler* profiler) {
+    auto L = _L;
+    kaguya::State state(_L);
+
+    state["profilerFolded"].setFunction([profiler]() {
+        return profiler->folded();
+    });
+    state["profilerReport"].setFunction([profiler]() {
+        return profiler->report();
+    });
+    state["profilerReset"].setFunction([profiler]() {
+        profiler->reset();
+    });
+    state["profilerStart"].setFunction([profiler, L]() {
+        profiler->start(L);
+    });
+    state["profilerStop"].setFunction([profiler]() {
+        profiler->stop();
+    });
+    state["profilerWatch"].setFunction([profiler](const lc::storage::Document_SPtr& document) {
+        profiler->watch(document);
+    });
+}
+
 std::string LCLua::runString(const char* code) {
     std::string out;
 
@@ -121,4 +146,12 @@ void LCLua::importLCKernel() {
     import_lc_maths_namespace(state);
     import_lc_event_namespace(state);
     import_lc_operation_namespace(state);
+
+    state["lc"]["LuaWorkerPool"].setClass(kaguya::UserdataMetatable<LuaWorkerPool>()
+                                          .setConstructors<LuaWorkerPool(), LuaWorkerPool(unsigned int)>()
+                                          .addFunction("generate", &LuaWorkerPool::generate)
+                                          .addFunction("load", &LuaWorkerPool::load)
+                                          .addFunction("map", &LuaWorkerPool::map)
+                                          .addFunction("size", &LuaWorkerPool::size)
+                                         );
 }
@@ -7,6 +7,7 @@ extern "C" {
 }
 
 #include <cad/storage/document.h>
+#include "utils/luaprofiler.h"
 
 namespace lc {
 namespace lua {
@@ -24,6 +25,13 @@ public:
 
     void setDocument(const lc::storage::Document_SPtr& document);
 
+    /**
+     * @brief Add the profilerStart, profilerStop, profilerReset, profilerReport, profilerFolded and profilerWatch functions
+     * profilerWatch(document) counts the commits and the entities added to a document while the profiler runs.
+     * @param profiler Profiler controlled by the scripts, it needs to outlive the Lua state
+     */
+    void setProfiler(LuaProfiler* profiler);
+
     std::string runString(const char* code);
 
     void setF_openFileDialog(FILE* (* f_openFileDialog)(bool, const char*, const char*));
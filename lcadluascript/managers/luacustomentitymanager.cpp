@@ -6,7 +6,21 @@
 
 using namespace lc::lua;
 
-LuaCustomEntityManager::LuaCustomEntityManager() {
+namespace {
+/**
+ * @brief Return the main thread of the Lua state of a thread
+ */
+lua_State* mainThread(lua_State* L) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+    auto thread = lua_tothread(L, -1);
+    lua_pop(L, 1);
+
+    return thread;
+}
+}
+
+LuaCustomEntityManager::LuaCustomEntityManager() :
+    _scheduler(nullptr) {
     storage::DocumentList::getInstance().newWaitingCustomEntityEvent().connect<LuaCustomEntityManager, &LuaCustomEntityManager::onNewWaitingEntity>(this);
 }
 
@@ -29,7 +43,7 @@ void LuaCustomEntityManager::onNewWaitingEntity(const lc::event::NewWaitingCusto
         return;
     }
 
-    it->second(event.insert());
+    callPlugin(it->second, event.insert());
 }
 
 void LuaCustomEntityManager::registerPlugin(const std::string& name, kaguya::LuaRef onNewWaitingEntityFunction) {
@@ -39,11 +53,46 @@ void LuaCustomEntityManager::registerPlugin(const std::string& name, kaguya::Lua
 
     _plugins[name] = onNewWaitingEntityFunction;
 
-    for(auto entity : storage::DocumentList::getInstance().waitingCustomEntities(name)) {
-        onNewWaitingEntityFunction(entity);
+    // Entities of a document are recreated with a single commit.
+    // The plugin is called directly, a job would run after the end of the batch.
+    std::map<storage::Document_SPtr, std::vector<entity::Insert_CSPtr>> waitingEntities;
+    for(const auto& entity : storage::DocumentList::getInstance().waitingCustomEntities(name)) {
+        waitingEntities[entity->document()].push_back(entity);
+    }
+
+    for(const auto& document : waitingEntities) {
+        auto recreate = [&]() {
+            for(const auto& entity : document.second) {
+                onNewWaitingEntityFunction(entity);
+            }
+        };
+
+        if(document.first != nullptr) {
+            document.first->batch(recreate);
+        }
+        else {
+            recreate();
+        }
     }
 }
 
 void LuaCustomEntityManager::removePlugins() {
     _plugins.clear();
-}
\ No newline at end of file
+}
+
+void LuaCustomEntityManager::setScheduler(LuaJobScheduler* scheduler) {
+    _scheduler = scheduler;
+}
+
+void LuaCustomEntityManager::callPlugin(kaguya::LuaRef function, const lc::entity::Insert_CSPtr& insert) {
+    // The job can only be created in the state of the scheduler, plugins of other states are called directly
+    if(_scheduler == nullptr || mainThread(function.state()) != mainThread(_scheduler->state())) {
+        function(insert);
+        return;
+    }
+
+    auto L = _scheduler->state();
+    function.push(L);
+    kaguya::util::push_args(L, insert);
+    _scheduler->runFunction(1, insert->document());
+}
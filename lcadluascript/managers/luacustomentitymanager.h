@@ -2,6 +2,7 @@
 
 #include <lclua.h>
 #include <kaguya/kaguya.hpp>
+#include "luajobscheduler.h"
 
 namespace lc {
 namespace lua {
@@ -23,6 +24,7 @@ public:
      * @brief Register a new plugin which handle custom entities
      * @param name Name of the plugin
      * @param onNewWaitingEntityFunction Function called when there are entities which needs to be recreated by the plugin
+     * The entities already waiting for the plugin are recreated immediately, with one commit per document.
      */
     void registerPlugin(const std::string& name, kaguya::LuaRef onNewWaitingEntityFunction);
 
@@ -32,12 +34,24 @@ public:
      */
     void removePlugins();
 
+    /**
+     * @brief Regenerate the custom entities in jobs of the given scheduler instead of blocking
+     * @param scheduler Scheduler, nullptr to call the plugins directly
+     */
+    void setScheduler(LuaJobScheduler* scheduler);
+
 private:
     LuaCustomEntityManager();
 
     void onNewWaitingEntity(const lc::event::NewWaitingCustomEntityEvent& event);
 
+    /**
+     * @brief Call the function of a plugin for an entity waiting to be recreated
+     */
+    void callPlugin(kaguya::LuaRef function, const lc::entity::Insert_CSPtr& insert);
+
     std::map<std::string, kaguya::LuaRef> _plugins;
+    LuaJobScheduler* _scheduler;
 };
 }
 }
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include "luajobscheduler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace lc::lua;
+
+namespace {
+// Address used as registry key of the table containing the job threads
+const char JOB_THREADS_KEY = 0;
+
+// Amount of finished jobs which status is kept
+const size_t MAX_FINISHED_JOBS = 100;
+
+/**
+ * @brief Check if the running function can yield
+ * Yielding is not possible when a C function called back Lua, for example inside document:batch()
+ */
+bool canYield(lua_State* L) {
+    lua_Debug ar;
+
+    for (int level = 0; lua_getstack(L, level, &ar) != 0; level++) {
+        lua_getinfo(L, "S", &ar);
+
+        if (strcmp(ar.what, "C") == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Return the scheduler which created the thread, or nullptr
+ * Coroutines created by the scripts inherit the hook, they shouldn't be preempted.
+ */
+LuaJobScheduler* jobScheduler(lua_State* L) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &JOB_THREADS_KEY);
+    lua_pushthread(L);
+    lua_rawget(L, -2);
+
+    auto scheduler = static_cast<LuaJobScheduler*>(lua_touserdata(L, -1));
+    lua_pop(L, 2);
+
+    return scheduler;
+}
+}
+
+LuaJobScheduler::LuaJobScheduler(lua_State* L, int instructionsPerSlice) :
+    _L(L),
+    _instructionsPerSlice(instructionsPerSlice),
+    _profiler(nullptr),
+    _nextID(1),
+    _runningJob(nullptr) {
+
+    // Weak table, threads are kept alive by the references of the jobs
+    lua_newtable(_L);
+    lua_newtable(_L);
+    lua_pushstring(_L, "k");
+    lua_setfield(_L, -2, "__mode");
+    lua_setmetatable(_L, -2);
+    lua_rawsetp(_L, LUA_REGISTRYINDEX, &JOB_THREADS_KEY);
+
+    lua_pushlightuserdata(_L, this);
+    lua_pushcclosure(_L, &LuaJobScheduler::luaJobProgress, 1);
+    lua_setglobal(_L, "jobProgress");
+}
+
+LuaJobScheduler::~LuaJobScheduler() {
+    for (auto& job : _jobs) {
+        luaL_unref(_L, LUA_REGISTRYINDEX, job.second.threadRef);
+    }
+
+    lua_pushnil(_L);
+    lua_setglobal(_L, "jobProgress");
+}
+
+unsigned int LuaJobScheduler::runString(const char* code, const lc::storage::Document_SPtr& document) {
+    if (luaL_loadstring(_L, code) != LUA_OK) {
+        auto id = _nextID++;
+        _jobs[id] = {nullptr, LUA_NOREF, document, nullptr, 0, false, false, JobStatus::Running, 0., lua_tostring(_L, -1), 0, false};
+        lua_pop(_L, 1);
+
+        finish(id, JobStatus::Failed);
+        return id;
+    }
+
+    return createJob(0, document);
+}
+
+unsigned int LuaJobScheduler::runFunction(int nargs, const lc::storage::Document_SPtr& document) {
+    return createJob(nargs, document);
+}
+
+unsigned int LuaJobScheduler::createJob(int nargs, const lc::storage::Document_SPtr& document) {
+    auto thread = lua_newthread(_L);
+
+    lua_rawgetp(_L, LUA_REGISTRYINDEX, &JOB_THREADS_KEY);
+    lua_pushvalue(_L, -2);
+    lua_pushlightuserdata(_L, this);
+    lua_rawset(_L, -3);
+    lua_pop(_L, 1);
+
+    int threadRef = luaL_ref(_L, LUA_REGISTRYINDEX);
+
+    // Move the function and its arguments to the new thread
+    lua_xmove(_L, thread, nargs + 1);
+
+    lc::operation::Transaction_SPtr transaction;
+    if (document != nullptr) {
+        transaction = std::make_shared<lc::operation::Transaction>(document, "Lua script");
+    }
+
+    auto id = _nextID++;
+    _jobs[id] = {thread, threadRef, document, transaction, nargs, false, false, JobStatus::Running, 0., "", 0, false};
+    hook(_jobs[id]);
+    startedEvent()(id);
+
+    return id;
+}
+
+bool LuaJobScheduler::step() {
+    // Jobs are removed when they finish, and the events can create new ones which wait for the next step
+    auto lastID = _nextID;
+    auto it = _jobs.begin();
+
+    while (it != _jobs.end() && it->first < lastID) {
+        auto id = it->first;
+        resume(id, it->second);
+        it = _jobs.upper_bound(id);
+    }
+
+    return runningJobs() > 0;
+}
+
+void LuaJobScheduler::runAll() {
+    while (step()) {
+    }
+}
+
+void LuaJobScheduler::resume(unsigned int id, Job& job) {
+    if (job.cancelRequested) {
+        finish(id, JobStatus::Cancelled);
+        return;
+    }
+
+    int nargs = job.started ? 0 : job.nargs;
+    job.started = true;
+    job.instructionsLeft = _instructionsPerSlice;
+
+    if (job.profiled != profiling()) {
+        hook(job);
+    }
+
+    int status = LUA_OK;
+    auto resumeThread = [&]() {
+        _runningJob = &job;
+#if LUA_VERSION_NUM >= 504
+        int nresults;
+        status = lua_resume(job.thread, nullptr, nargs, &nresults);
+#else
+        status = lua_resume(job.thread, nullptr, nargs);
+#endif
+        _runningJob = nullptr;
+
+        if (status != LUA_OK && status != LUA_YIELD) {
+            auto message = lua_tostring(job.thread, -1);
+            throw std::runtime_error(message == nullptr ? "Unknown error" : message);
+        }
+    };
+
+    try {
+        if (job.document != nullptr) {
+            job.document->batchInto(job.transaction, resumeThread);
+        }
+        else {
+            resumeThread();
+        }
+    }
+    catch (const std::runtime_error& e) {
+        job.error = e.what();
+        finish(id, JobStatus::Failed);
+        return;
+    }
+
+    if (status == LUA_YIELD) {
+        // Values given to coroutine.yield() are ignored
+        lua_settop(job.thread, 0);
+        return;
+    }
+
+    job.progress = 1.;
+    finish(id, JobStatus::Finished);
+}
+
+void LuaJobScheduler::finish(unsigned int id, JobStatus status) {
+    auto it = _jobs.find(id);
+    if (it == _jobs.end()) {
+        return;
+    }
+
+    auto job = std::move(it->second);
+    _jobs.erase(it);
+
+    if (job.threadRef != LUA_NOREF) {
+        luaL_unref(_L, LUA_REGISTRYINDEX, job.threadRef);
+    }
+
+    // The operations of failed and cancelled jobs are discarded with the transaction
+    if (status == JobStatus::Finished && job.transaction != nullptr && job.transaction->operationCount() > 0) {
+        try {
+            job.transaction->execute();
+        }
+        catch (const std::exception& e) {
+            job.error = e.what();
+            status = JobStatus::Failed;
+        }
+    }
+
+    job.thread = nullptr;
+    job.threadRef = LUA_NOREF;
+    job.document = nullptr;
+    job.transaction = nullptr;
+    job.status = status;
+
+    _finishedJobs[id] = std::move(job);
+    while (_finishedJobs.size() > MAX_FINISHED_JOBS) {
+        _finishedJobs.erase(_finishedJobs.begin());
+    }
+
+    finishedEvent()(id, status);
+}
+
+const LuaJobScheduler::Job* LuaJobScheduler::findJob(unsigned int id) const {
+    auto it = _jobs.find(id);
+    if (it != _jobs.end()) {
+        return &it->second;
+    }
+
+    it = _finishedJobs.find(id);
+    return it == _finishedJobs.end() ? nullptr : &it->second;
+}
+
+void LuaJobScheduler::cancel(unsigned int id) {
+    auto it = _jobs.find(id);
+
+    if (it != _jobs.end()) {
+        it->second.cancelRequested = true;
+    }
+}
+
+void LuaJobScheduler::cancelAll() {
+    for (auto& job : _jobs) {
+        job.second.cancelRequested = true;
+    }
+}
+
+LuaJobScheduler::JobStatus LuaJobScheduler::status(unsigned int id) const {
+    auto job = findJob(id);
+    return job == nullptr ? JobStatus::Unknown : job->status;
+}
+
+double LuaJobScheduler::progress(unsigned int id) const {
+    auto job = findJob(id);
+    return job == nullptr ? 0. : job->progress;
+}
+
+std::string LuaJobScheduler::error(unsigned int id) const {
+    auto job = findJob(id);
+    return job == nullptr ? "" : job->error;
+}
+
+size_t LuaJobScheduler::runningJobs() const {
+    return _jobs.size();
+}
+
+void LuaJobScheduler::setProfiler(LuaProfiler* profiler) {
+    _profiler = profiler;
+
+    for (auto& job : _jobs) {
+        hook(job.second);
+    }
+}
+
+void LuaJobScheduler::hook(Job& job) {
+    job.profiled = profiling();
+    lua_sethook(job.thread, &LuaJobScheduler::countHook, job.profiled ? LuaProfiler::hookMask() : LUA_MASKCOUNT, hookCount());
+}
+
+bool LuaJobScheduler::profiling() const {
+    return _profiler != nullptr && _profiler->isRunning();
+}
+
+int LuaJobScheduler::hookCount() const {
+    if (!profiling()) {
+        return _instructionsPerSlice;
+    }
+
+    return std::min(_profiler->instructionsPerSample(), _instructionsPerSlice);
+}
+
+void LuaJobScheduler::countHook(lua_State* L, lua_Debug* ar) {
+    auto scheduler = jobScheduler(L);
+
+    // Coroutines created by the job inherit the hook
+    if (scheduler == nullptr || scheduler->_runningJob == nullptr || scheduler->_runningJob->thread != L) {
+        return;
+    }
+
+    auto& job = *scheduler->_runningJob;
+    auto count = lua_gethookcount(L);
+
+    // The profiler was started or stopped by the job
+    if (job.profiled != scheduler->profiling()) {
+        scheduler->hook(job);
+    }
+
+    if (job.profiled) {
+        scheduler->_profiler->onHook(L, ar);
+    }
+
+    if (ar->event != LUA_HOOKCOUNT) {
+        return;
+    }
+
+    job.instructionsLeft -= count;
+
+    // A job which can't yield now yields at the next hook
+    if (job.instructionsLeft <= 0 && canYield(L)) {
+        lua_yield(L, 0);
+    }
+}
+
+int LuaJobScheduler::luaJobProgress(lua_State* L) {
+    auto scheduler = static_cast<LuaJobScheduler*>(lua_touserdata(L, lua_upvalueindex(1)));
+    auto progress = luaL_checknumber(L, 1);
+
+    for (auto& job : scheduler->_jobs) {
+        if (job.second.thread == L) {
+            job.second.progress = progress;
+            scheduler->progressEvent()(job.first, progress);
+            break;
+        }
+    }
+
+    return 0;
+}
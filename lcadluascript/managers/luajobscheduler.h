@@ -0,0 +1,219 @@
+#pragma once
+
+extern "C" {
+#include "lua.h"
+#include "lualib.h"
+#include "lauxlib.h"
+}
+
+#include <map>
+#include <string>
+#include <cad/storage/document.h>
+#include <cad/operations/transaction.h>
+#include <nano-signal-slot/nano_signal_slot.hpp>
+#include "../utils/luaprofiler.h"
+
+namespace lc {
+namespace lua {
+/**
+ * @brief Run Lua scripts as coroutines without blocking the caller
+ * Each job runs in its own Lua thread. A count hook yields the job after a given amount of instructions,
+ * step() resumes every job for one slice and returns, so the UI event loop can call it from a timer.
+ * While a profiler runs, the hook is called at each sample of the profiler and the job yields once the instructions
+ * of its slice are used.
+ * Scripts can also yield with coroutine.yield() and report their progress with jobProgress(fraction).
+ *
+ * When a job has a document, the operations it executes are collected in a single transaction with
+ * Document::batchInto(). The transaction is executed with one commit when the job finishes, and discarded when the job
+ * fails or is cancelled. The job doesn't see its own modifications in the document until then.
+ * The hook doesn't yield while a C function is on the stack (for example a callback of document:batch()),
+ * the job is then preempted at the next hook outside of it.
+ *
+ * Finished jobs are forgotten after a while, the status of the last ones stays available.
+ */
+class LuaJobScheduler {
+public:
+    enum class JobStatus {
+        Unknown,
+        Running,
+        Finished,
+        Failed,
+        Cancelled
+    };
+
+    /**
+     * @brief Create a scheduler
+     * @param L Lua state in which the jobs are created
+     * @param instructionsPerSlice Amount of instructions executed before a job yields
+     */
+    LuaJobScheduler(lua_State* L, int instructionsPerSlice = 100000);
+
+    ~LuaJobScheduler();
+
+    LuaJobScheduler(LuaJobScheduler const&) = delete;
+
+    void operator=(LuaJobScheduler const&) = delete;
+
+    /**
+     * @brief Create a job running Lua code
+     * @param code Lua code
+     * @param document Document modified by the job, its operations are committed when it finishes
+     * @return Job ID, the job fails without running if the code can't be compiled
+     */
+    unsigned int runString(const char* code, const lc::storage::Document_SPtr& document = nullptr);
+
+    /**
+     * @brief Create a job calling a function
+     * The function and its arguments needs to be pushed on the stack of state(), they are popped.
+     * @param nargs Number of arguments
+     * @param document Document modified by the job
+     * @return Job ID
+     */
+    unsigned int runFunction(int nargs, const lc::storage::Document_SPtr& document = nullptr);
+
+    /**
+     * @brief Resume each running job for one slice
+     * @return true if jobs are still running
+     */
+    bool step();
+
+    /**
+     * @brief Run the jobs until they are all finished
+     * Used when there is no event loop, in the command line interface.
+     */
+    void runAll();
+
+    /**
+     * @brief Cancel a job, it is stopped before its next slice
+     */
+    void cancel(unsigned int id);
+
+    /**
+     * @brief Cancel all the jobs
+     */
+    void cancelAll();
+
+    JobStatus status(unsigned int id) const;
+
+    /**
+     * @brief Last progress reported by the job, between 0 and 1
+     */
+    double progress(unsigned int id) const;
+
+    /**
+     * @brief Error message of a failed job
+     */
+    std::string error(unsigned int id) const;
+
+    /**
+     * @brief Return the amount of running jobs
+     */
+    size_t runningJobs() const;
+
+    /**
+     * @brief Return the Lua state in which the jobs are created
+     */
+    lua_State* state() const {
+        return _L;
+    }
+
+    /**
+     * @brief Forward the hook events of the jobs to a profiler
+     * The jobs have their own hook, the call and return events are only enabled while the profiler runs.
+     * @param profiler Profiler, nullptr to remove it
+     */
+    void setProfiler(LuaProfiler* profiler);
+
+    /**
+     * @brief Event called when a job is created
+     * Used to start resuming the jobs from the event loop.
+     */
+    Nano::Signal<void(unsigned int)>& startedEvent() {
+        return _startedEvent;
+    }
+
+    /**
+     * @brief Event called when a job reports its progress
+     */
+    Nano::Signal<void(unsigned int, double)>& progressEvent() {
+        return _progressEvent;
+    }
+
+    /**
+     * @brief Event called when a job is finished, failed or cancelled
+     */
+    Nano::Signal<void(unsigned int, JobStatus)>& finishedEvent() {
+        return _finishedEvent;
+    }
+
+private:
+    struct Job {
+        lua_State* thread;
+        int threadRef;
+        lc::storage::Document_SPtr document;
+        lc::operation::Transaction_SPtr transaction;
+        int nargs;
+        bool started;
+        bool cancelRequested;
+        JobStatus status;
+        double progress;
+        std::string error;
+        int instructionsLeft;
+        bool profiled;
+    };
+
+    /**
+     * @brief Create a job for the function on the top of the stack of the main state
+     */
+    unsigned int createJob(int nargs, const lc::storage::Document_SPtr& document);
+
+    /**
+     * @brief Resume a job for one slice
+     */
+    void resume(unsigned int id, Job& job);
+
+    /**
+     * @brief Release the thread of a running job, execute its operations if it finished and emit the finished event
+     * The job is moved to the finished jobs.
+     */
+    void finish(unsigned int id, JobStatus status);
+
+    /**
+     * @brief Return a running or finished job, nullptr if it's unknown
+     */
+    const Job* findJob(unsigned int id) const;
+
+    /**
+     * @brief Set the hook of a job, according to the state of the profiler
+     */
+    void hook(Job& job);
+
+    bool profiling() const;
+
+    /**
+     * @brief Amount of instructions between two calls of the hook
+     */
+    int hookCount() const;
+
+    static void countHook(lua_State* L, lua_Debug* ar);
+
+    /**
+     * @brief Lua function jobProgress(fraction)
+     */
+    static int luaJobProgress(lua_State* L);
+
+    lua_State* _L;
+    int _instructionsPerSlice;
+    LuaProfiler* _profiler;
+
+    unsigned int _nextID;
+    std::map<unsigned int, Job> _jobs;
+    std::map<unsigned int, Job> _finishedJobs;
+    Job* _runningJob;
+
+    Nano::Signal<void(unsigned int)> _startedEvent;
+    Nano::Signal<void(unsigned int, double)> _progressEvent;
+    Nano::Signal<void(unsigned int, JobStatus)> _finishedEvent;
+};
+}
+}
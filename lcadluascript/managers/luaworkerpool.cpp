@@ -0,0 +1,199 @@
+#include "luaworkerpool.h"
+
+#include <stdexcept>
+#include <kaguya/kaguya.hpp>
+#include <cad/primitive/insert.h>
+#include <cad/tools/threadpool.h>
+#include <bridge/lc.h>
+#include <bridge/lc_geo.h>
+#include <bridge/lc_meta.h>
+#include <bridge/lc_entity.h>
+#include <bridge/lc_builder.h>
+#include <bridge/lc_maths.h>
+
+using namespace lc::lua;
+
+namespace {
+// Only the libraries without access to the system
+const luaL_Reg workerLibs[] = {
+    {"_G", luaopen_base},
+    {LUA_TABLIBNAME, luaopen_table},
+    {LUA_STRLIBNAME, luaopen_string},
+    {LUA_MATHLIBNAME, luaopen_math},
+    {nullptr, nullptr}
+};
+
+lua_State* newWorkerState() {
+    auto L = luaL_newstate();
+
+    for (auto lib = workerLibs; lib->func != nullptr; lib++) {
+        luaL_requiref(L, lib->name, lib->func, 1);
+        lua_pop(L, 1);
+    }
+
+    // The base library can still read files
+    lua_pushnil(L);
+    lua_setglobal(L, "dofile");
+    lua_pushnil(L);
+    lua_setglobal(L, "loadfile");
+
+    // Precompiled chunks can crash the interpreter, load() only accepts text
+    luaL_dostring(L, "local baseLoad = load "
+                     "function load(chunk, name, mode, ...) return baseLoad(chunk, name, 't', ...) end");
+
+    kaguya::State state(L);
+    import_lc_namespace(state);
+    import_lc_geo_namespace(state);
+    import_lc_meta_namespace(state);
+    import_lc_entity_namespace(state);
+    import_lc_builder_namespace(state);
+    import_lc_maths_namespace(state);
+
+    return L;
+}
+
+/**
+ * @brief Pop the error on the top of the stack
+ */
+std::string popError(lua_State* L) {
+    auto message = lua_tostring(L, -1);
+    std::string error = message == nullptr ? "Unknown error" : message;
+    lua_pop(L, 1);
+
+    return error;
+}
+}
+
+LuaWorkerPool::LuaWorkerPool(unsigned int numWorkers) {
+    if (numWorkers == 0) {
+        numWorkers = tools::ThreadPool::instance().concurrency();
+    }
+
+    _workers.reserve(numWorkers);
+    for (unsigned int i = 0; i < numWorkers; i++) {
+        auto worker = std::unique_ptr<Worker>(new Worker());
+        worker->L = newWorkerState();
+        _workers.push_back(std::move(worker));
+    }
+}
+
+LuaWorkerPool::~LuaWorkerPool() {
+    for (auto& worker : _workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        lua_close(worker->L);
+    }
+}
+
+std::string LuaWorkerPool::load(const std::string& code) {
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(_workers.size());
+
+    for (size_t i = 0; i < _workers.size(); i++) {
+        locks.emplace_back(_workers[i]->mutex);
+
+        if (luaL_loadbufferx(_workers[i]->L, code.c_str(), code.size(), code.c_str(), "t") != LUA_OK) {
+            auto error = popError(_workers[i]->L);
+
+            // Discard the chunks compiled by the previous workers
+            while (i > 0) {
+                lua_pop(_workers[--i]->L, 1);
+            }
+
+            return error;
+        }
+    }
+
+    for (size_t i = 0; i < _workers.size(); i++) {
+        if (lua_pcall(_workers[i]->L, 0, 0, 0) != LUA_OK) {
+            auto error = popError(_workers[i]->L);
+
+            for (i++; i < _workers.size(); i++) {
+                lua_pop(_workers[i]->L, 1);
+            }
+
+            return error;
+        }
+    }
+
+    return "";
+}
+
+std::vector<lc::entity::CADEntity_CSPtr> LuaWorkerPool::generate(const std::string& function, size_t count) {
+    return run(function, count, [](lua_State* L, size_t i) {
+        lua_pushinteger(L, i + 1);
+    });
+}
+
+std::vector<lc::entity::CADEntity_CSPtr> LuaWorkerPool::map(const std::string& function,
+                                                             const std::vector<entity::CADEntity_CSPtr>& entities) {
+    return run(function, entities.size(), [&entities](lua_State* L, size_t i) {
+        auto insert = std::dynamic_pointer_cast<const entity::Insert>(entities[i]);
+
+        if (insert != nullptr) {
+            kaguya::lua_type_traits<entity::Insert_CSPtr>::push(L, insert);
+        }
+        else {
+            kaguya::lua_type_traits<entity::CADEntity_CSPtr>::push(L, entities[i]);
+        }
+    });
+}
+
+std::vector<lc::entity::CADEntity_CSPtr> LuaWorkerPool::run(const std::string& function,
+                                                             size_t count,
+                                                             const std::function<void(lua_State*, size_t)>& pushArgument) {
+    // Each call keeps its own results to return them in order
+    std::vector<std::vector<entity::CADEntity_CSPtr>> results(count);
+
+    tools::ThreadPool::instance().parallelFor(count, 1, [&](size_t begin, size_t end) {
+        Worker* worker;
+        auto lock = acquire(worker);
+        auto L = worker->L;
+
+        for (size_t i = begin; i < end; i++) {
+            lua_getglobal(L, function.c_str());
+            pushArgument(L, i);
+
+            if (lua_pcall(L, 1, 1, 0) != LUA_OK) {
+                throw std::runtime_error(function + ": " + popError(L));
+            }
+
+            if (lua_type(L, -1) == LUA_TTABLE) {
+                results[i] = kaguya::lua_type_traits<std::vector<entity::CADEntity_CSPtr>>::get(L, -1);
+            }
+            else if (!lua_isnil(L, -1)) {
+                results[i].push_back(kaguya::lua_type_traits<entity::CADEntity_CSPtr>::get(L, -1));
+            }
+
+            lua_pop(L, 1);
+        }
+    });
+
+    size_t total = 0;
+    for (const auto& result : results) {
+        total += result.size();
+    }
+
+    std::vector<entity::CADEntity_CSPtr> entities;
+    entities.reserve(total);
+
+    for (auto& result : results) {
+        entities.insert(entities.end(), std::make_move_iterator(result.begin()), std::make_move_iterator(result.end()));
+    }
+
+    return entities;
+}
+
+std::unique_lock<std::mutex> LuaWorkerPool::acquire(Worker*& worker) {
+    for (auto& candidate : _workers) {
+        std::unique_lock<std::mutex> lock(candidate->mutex, std::try_to_lock);
+
+        if (lock.owns_lock()) {
+            worker = candidate.get();
+            return lock;
+        }
+    }
+
+    // More calls than workers, when several threads use the pool
+    worker = _workers.front().get();
+    return std::unique_lock<std::mutex>(worker->mutex);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+extern "C" {
+#include "lua.h"
+#include "lualib.h"
+#include "lauxlib.h"
+}
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cad/base/cadentity.h>
+
+namespace lc {
+namespace lua {
+/**
+ * @brief Pool of Lua states used to generate entities in parallel
+ * Each worker is an independent Lua state with the lc.geo, lc.maths, lc.meta, lc.entity and lc.builder bindings,
+ * without access to documents, files or the GUI. Functions loaded in the workers should only build entities
+ * from their arguments, the entities are returned to the caller which adds them to the document in a single batch.
+ * The calls are spread over the kernel ThreadPool.
+ */
+class LuaWorkerPool {
+public:
+    /**
+     * @brief Create the workers
+     * @param numWorkers Number of Lua states, 0 to use one per thread of the kernel ThreadPool
+     */
+    explicit LuaWorkerPool(unsigned int numWorkers = 0);
+
+    ~LuaWorkerPool();
+
+    LuaWorkerPool(LuaWorkerPool const&) = delete;
+
+    void operator=(LuaWorkerPool const&) = delete;
+
+    /**
+     * @brief Run code in every worker, usually to define the generation functions
+     * The code is compiled by all the workers before it runs in any of them, code which can't be compiled
+     * doesn't change the workers. Precompiled chunks are refused.
+     * @return Error message, empty if the code was loaded
+     */
+    std::string load(const std::string& code);
+
+    /**
+     * @brief Call a global function of the workers for each index in [1, count]
+     * The function returns an entity, a table of entities or nil.
+     * @return Entities returned by the calls, in the order of the indexes
+     * @throw std::runtime_error if a call fails
+     */
+    std::vector<entity::CADEntity_CSPtr> generate(const std::string& function, size_t count);
+
+    /**
+     * @brief Call a global function of the workers for each entity
+     * Inserts are given as Insert, the other entities as CADEntity.
+     * @return Entities returned by the calls, in the order of the given entities
+     * @throw std::runtime_error if a call fails
+     */
+    std::vector<entity::CADEntity_CSPtr> map(const std::string& function, const std::vector<entity::CADEntity_CSPtr>& entities);
+
+    /**
+     * @brief Return the amount of workers
+     */
+    size_t size() const {
+        return _workers.size();
+    }
+
+private:
+    struct Worker {
+        lua_State* L;
+        std::mutex mutex;
+    };
+
+    /**
+     * @brief Call the function count times, pushArgument pushes the argument of the call i
+     */
+    std::vector<entity::CADEntity_CSPtr> run(const std::string& function,
+                                             size_t count,
+                                             const std::function<void(lua_State*, size_t)>& pushArgument);
+
+    /**
+     * @brief Lock a free worker, or wait for one if all of them are in use
+     */
+    std::unique_lock<std::mutex> acquire(Worker*& worker);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+}
+}
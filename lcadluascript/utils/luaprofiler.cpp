@@ -0,0 +1,332 @@
+#include "luaprofiler.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <cad/tools/poolallocator.h>
+
+using namespace lc::lua;
+
+namespace {
+// Hooks don't have user data, only one profiler can run at a time
+LuaProfiler* activeProfiler = nullptr;
+
+// Time without any event and without running C function, considered as spent outside of Lua
+const double IDLE_TIME = 0.01;
+}
+
+LuaProfiler::LuaProfiler(int instructionsPerSample) :
+    _instructionsPerSample(instructionsPerSample),
+    _running(false),
+    _lastSample(0.),
+    _lastEvent(0.),
+    _commits(0),
+    _entitiesAdded(0),
+    _allocationsAtStart(0),
+    _allocations(0) {
+}
+
+LuaProfiler::~LuaProfiler() {
+    stop();
+
+    for (const auto& document : _documents) {
+        document->commitProcessEvent().disconnect<LuaProfiler, &LuaProfiler::on_commitProcessEvent>(this);
+        document->batchEntityEvent().disconnect<LuaProfiler, &LuaProfiler::on_batchEntityEvent>(this);
+    }
+}
+
+void LuaProfiler::start(lua_State* L) {
+    if (activeProfiler != nullptr && activeProfiler != this) {
+        throw std::runtime_error("Another Lua profiler is running");
+    }
+
+    if (!_running) {
+        _running = true;
+        _lastSample = lua_microtime();
+        _lastEvent = _lastSample;
+        _allocationsAtStart = tools::Pool::statistics().allocations;
+        activeProfiler = this;
+    }
+
+    _states.insert(L);
+    lua_sethook(L, &LuaProfiler::profilerHook, hookMask(), _instructionsPerSample);
+}
+
+void LuaProfiler::stop() {
+    if (!_running) {
+        return;
+    }
+
+    for (auto L : _states) {
+        lua_sethook(L, nullptr, 0, 0);
+    }
+    _states.clear();
+    _openCalls.clear();
+
+    _allocations += tools::Pool::statistics().allocations - _allocationsAtStart;
+    _running = false;
+    activeProfiler = nullptr;
+}
+
+void LuaProfiler::watch(const lc::storage::Document_SPtr& document) {
+    if (std::find(_documents.begin(), _documents.end(), document) != _documents.end()) {
+        return;
+    }
+
+    document->commitProcessEvent().connect<LuaProfiler, &LuaProfiler::on_commitProcessEvent>(this);
+    document->batchEntityEvent().connect<LuaProfiler, &LuaProfiler::on_batchEntityEvent>(this);
+    _documents.push_back(document);
+}
+
+int LuaProfiler::hookMask() {
+    return LUA_MASKCOUNT | LUA_MASKCALL | LUA_MASKRET;
+}
+
+void LuaProfiler::profilerHook(lua_State* L, lua_Debug* ar) {
+    if (activeProfiler != nullptr) {
+        activeProfiler->onHook(L, ar);
+    }
+}
+
+void LuaProfiler::onHook(lua_State* L, lua_Debug* ar) {
+    if (!_running) {
+        return;
+    }
+
+    // Skip the time spent outside of Lua, between two scripts or two slices of a job
+    auto now = lua_microtime();
+    if (now - _lastEvent > IDLE_TIME && _openCalls.find(L) == _openCalls.end()) {
+        _lastSample += now - _lastEvent;
+    }
+    _lastEvent = now;
+
+    switch (ar->event) {
+        case LUA_HOOKCOUNT:
+            sample(L, now);
+            break;
+
+        case LUA_HOOKCALL:
+#ifdef LUA_HOOKTAILCALL
+        case LUA_HOOKTAILCALL:
+#endif
+            onCall(L, ar, now);
+            break;
+
+        case LUA_HOOKRET:
+            onReturn(L, ar, now);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void LuaProfiler::sample(lua_State* L, double now) {
+    auto elapsed = now - _lastSample;
+    _lastSample = now;
+
+    std::vector<std::string> frames;
+    lua_Debug ar;
+
+    for (int level = 0; lua_getstack(L, level, &ar) != 0; level++) {
+        lua_getinfo(L, "Sn", &ar);
+        frames.push_back(frameName(ar));
+    }
+
+    if (frames.empty()) {
+        return;
+    }
+
+    // Folded stacks start with the outermost frame
+    std::string stack;
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+        if (!stack.empty()) {
+            stack += ';';
+        }
+        stack += *it;
+    }
+    _stacks[stack] += elapsed;
+
+    _functions[frames.front()].exclusive += elapsed;
+
+    // Recursive functions are counted once
+    std::set<std::string> inStack(frames.begin(), frames.end());
+    for (const auto& frame : inStack) {
+        _functions[frame].inclusive += elapsed;
+    }
+}
+
+void LuaProfiler::onCall(lua_State* L, lua_Debug* ar, double now) {
+    lua_getinfo(L, "Sn", ar);
+
+    if (strcmp(ar->what, "C") == 0) {
+        _openCalls[L].push_back({stackDepth(L), frameName(*ar), now});
+    }
+}
+
+void LuaProfiler::onReturn(lua_State* L, lua_Debug* ar, double now) {
+    lua_getinfo(L, "S", ar);
+
+    if (strcmp(ar->what, "C") != 0) {
+        return;
+    }
+
+    auto it = _openCalls.find(L);
+    if (it == _openCalls.end()) {
+        return;
+    }
+
+    auto& openCalls = it->second;
+    auto depth = stackDepth(L);
+
+    // Calls interrupted by an error don't return
+    while (!openCalls.empty() && openCalls.back().depth > depth) {
+        openCalls.pop_back();
+    }
+
+    if (!openCalls.empty() && openCalls.back().depth == depth) {
+        auto& binding = _bindings[openCalls.back().name];
+        binding.calls++;
+        binding.time += now - openCalls.back().start;
+        openCalls.pop_back();
+    }
+
+    // Threads of finished jobs and coroutines are never seen again
+    if (openCalls.empty()) {
+        _openCalls.erase(it);
+    }
+}
+
+void LuaProfiler::on_commitProcessEvent(const lc::event::CommitProcessEvent& event) {
+    if (_running) {
+        _commits++;
+    }
+}
+
+void LuaProfiler::on_batchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    if (_running) {
+        _entitiesAdded += event.added().size();
+    }
+}
+
+std::string LuaProfiler::frameName(lua_Debug& ar) {
+    std::string name;
+
+    if (strcmp(ar.what, "C") == 0) {
+        name = std::string("[C] ") + (ar.name != nullptr ? ar.name : "?");
+    }
+    else if (strcmp(ar.what, "main") == 0) {
+        name = std::string("main ") + ar.short_src;
+    }
+    else {
+        name = std::string(ar.name != nullptr ? ar.name : "anonymous") + " " + ar.short_src + ":" + std::to_string(ar.linedefined);
+    }
+
+    // ';' separates the frames in the folded format
+    std::replace(name.begin(), name.end(), ';', ',');
+    return name;
+}
+
+int LuaProfiler::stackDepth(lua_State* L) {
+    lua_Debug ar;
+    int depth = 0;
+
+    while (lua_getstack(L, depth, &ar) != 0) {
+        depth++;
+    }
+
+    return depth;
+}
+
+void LuaProfiler::reset() {
+    _stacks.clear();
+    _functions.clear();
+    _bindings.clear();
+    _openCalls.clear();
+
+    _commits = 0;
+    _entitiesAdded = 0;
+    _allocations = 0;
+    _allocationsAtStart = tools::Pool::statistics().allocations;
+    _lastSample = lua_microtime();
+    _lastEvent = _lastSample;
+}
+
+size_t LuaProfiler::entitiesAllocated() const {
+    auto allocations = _allocations;
+
+    if (_running) {
+        allocations += tools::Pool::statistics().allocations - _allocationsAtStart;
+    }
+
+    return allocations;
+}
+
+std::string LuaProfiler::folded() const {
+    std::vector<std::pair<std::string, long long>> stacks;
+    stacks.reserve(_stacks.size());
+
+    for (const auto& stack : _stacks) {
+        auto microseconds = std::llround(stack.second * 1000000.);
+        if (microseconds > 0) {
+            stacks.emplace_back(stack.first, microseconds);
+        }
+    }
+
+    std::sort(stacks.begin(), stacks.end());
+
+    std::ostringstream stream;
+    for (const auto& stack : stacks) {
+        stream << stack.first << " " << stack.second << "\n";
+    }
+
+    return stream.str();
+}
+
+std::string LuaProfiler::report() const {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3);
+
+    std::vector<std::pair<std::string, FunctionTime>> functions(_functions.begin(), _functions.end());
+    std::sort(functions.begin(), functions.end(), [](const std::pair<std::string, FunctionTime>& a,
+                                                     const std::pair<std::string, FunctionTime>& b) {
+        return a.second.inclusive > b.second.inclusive;
+    });
+
+    stream << std::left << std::setw(48) << "Function"
+           << std::right << std::setw(16) << "Inclusive (ms)"
+           << std::setw(16) << "Exclusive (ms)" << "\n";
+
+    for (const auto& function : functions) {
+        stream << std::left << std::setw(48) << function.first
+               << std::right << std::setw(16) << function.second.inclusive * 1000.
+               << std::setw(16) << function.second.exclusive * 1000. << "\n";
+    }
+
+    std::vector<std::pair<std::string, BindingCalls>> bindings(_bindings.begin(), _bindings.end());
+    std::sort(bindings.begin(), bindings.end(), [](const std::pair<std::string, BindingCalls>& a,
+                                                   const std::pair<std::string, BindingCalls>& b) {
+        return a.second.time > b.second.time;
+    });
+
+    stream << "\n" << std::left << std::setw(48) << "C function"
+           << std::right << std::setw(16) << "Calls"
+           << std::setw(16) << "Time (ms)" << "\n";
+
+    for (const auto& binding : bindings) {
+        stream << std::left << std::setw(48) << binding.first
+               << std::right << std::setw(16) << binding.second.calls
+               << std::setw(16) << binding.second.time * 1000. << "\n";
+    }
+
+    stream << "\n"
+           << "Document commits:   " << _commits << "\n"
+           << "Entities added:     " << _entitiesAdded << "\n"
+           << "Entities allocated: " << entitiesAllocated() << "\n";
+
+    return stream.str();
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+extern "C" {
+#include "lua.h"
+#include "lualib.h"
+#include "lauxlib.h"
+}
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cad/storage/document.h>
+
+namespace lc {
+namespace lua {
+/**
+ * @brief Sampling profiler for the Lua scripts
+ * A count hook samples the Lua stack every given amount of instructions, the time elapsed since the previous sample
+ * is added to the sampled stack. Calls to C functions, which are the bindings of the kernel, are counted and timed
+ * with call and return hooks. The commits and the entities added to the watched documents are counted too.
+ *
+ * The stacks can be exported in the folded format used by flamegraph.pl, with the time in microseconds.
+ */
+class LuaProfiler {
+public:
+    /**
+     * @brief Time spent in a Lua function
+     */
+    struct FunctionTime {
+        double inclusive; /*!< Time in the function and the functions it called, in seconds */
+        double exclusive; /*!< Time in the function itself, in seconds */
+    };
+
+    /**
+     * @brief Calls of a C function
+     */
+    struct BindingCalls {
+        size_t calls;
+        double time; /*!< Time spent in the function, in seconds */
+    };
+
+    /**
+     * @brief Create a profiler
+     * @param instructionsPerSample Amount of Lua instructions between two samples
+     */
+    explicit LuaProfiler(int instructionsPerSample = 1000);
+
+    ~LuaProfiler();
+
+    LuaProfiler(LuaProfiler const&) = delete;
+
+    void operator=(LuaProfiler const&) = delete;
+
+    /**
+     * @brief Start profiling a Lua state
+     * Replaces the hook of the state. Threads created afterwards inherit it.
+     * @throw std::runtime_error if another profiler is running
+     */
+    void start(lua_State* L);
+
+    /**
+     * @brief Stop profiling the states given to start()
+     */
+    void stop();
+
+    bool isRunning() const {
+        return _running;
+    }
+
+    int instructionsPerSample() const {
+        return _instructionsPerSample;
+    }
+
+    /**
+     * @brief Count the commits and the entities added to a document while the profiler runs
+     */
+    void watch(const lc::storage::Document_SPtr& document);
+
+    /**
+     * @brief Hook mask needed by the profiler, used by the owners of other hooks to forward their events
+     */
+    static int hookMask();
+
+    /**
+     * @brief Handle a hook event
+     * Called by the profiler hook, or by other hooks forwarding their events.
+     */
+    void onHook(lua_State* L, lua_Debug* ar);
+
+    /**
+     * @brief Remove all the collected data
+     */
+    void reset();
+
+    /**
+     * @brief Return the sampled stacks in the folded format, one stack per line with its time in microseconds
+     */
+    std::string folded() const;
+
+    /**
+     * @brief Return a summary of the functions, bindings and counters
+     */
+    std::string report() const;
+
+    const std::map<std::string, FunctionTime>& functions() const {
+        return _functions;
+    }
+
+    const std::map<std::string, BindingCalls>& bindings() const {
+        return _bindings;
+    }
+
+    size_t commits() const {
+        return _commits;
+    }
+
+    size_t entitiesAdded() const {
+        return _entitiesAdded;
+    }
+
+    /**
+     * @brief Amount of entities allocated in the entity pool while the profiler ran
+     */
+    size_t entitiesAllocated() const;
+
+private:
+    struct OpenCall {
+        int depth;
+        std::string name;
+        double start;
+    };
+
+    void sample(lua_State* L, double now);
+
+    void onCall(lua_State* L, lua_Debug* ar, double now);
+
+    void onReturn(lua_State* L, lua_Debug* ar, double now);
+
+    void on_commitProcessEvent(const lc::event::CommitProcessEvent& event);
+
+    void on_batchEntityEvent(const lc::event::BatchEntityEvent& event);
+
+    static void profilerHook(lua_State* L, lua_Debug* ar);
+
+    static std::string frameName(lua_Debug& ar);
+
+    static int stackDepth(lua_State* L);
+
+    int _instructionsPerSample;
+    bool _running;
+    std::set<lua_State*> _states;
+    std::vector<lc::storage::Document_SPtr> _documents;
+
+    double _lastSample;
+    double _lastEvent;
+    std::unordered_map<std::string, double> _stacks;
+    std::map<std::string, FunctionTime> _functions;
+    std::map<std::string, BindingCalls> _bindings;
+    std::unordered_map<lua_State*, std::vector<OpenCall>> _openCalls;
+
+    size_t _commits;
+    size_t _entitiesAdded;
+    size_t _allocationsAtStart;
+    size_t _allocations;
+};
+}
+}
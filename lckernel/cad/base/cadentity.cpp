@@ -4,41 +4,38 @@
 using namespace lc;
 using namespace entity;
 
+CADEntity::CADEntity() :
+    ID(),
+    _attributes(EntityAttributes::get(nullptr, nullptr, nullptr)) {
+}
+
 CADEntity::CADEntity(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) :
     ID(),
-    _layer(std::move(layer)),
-    _metaInfo(std::move(metaInfo)),
-    _block(std::move(block))
+    _attributes(EntityAttributes::get(layer, metaInfo, block))
 {
 }
 
 CADEntity::CADEntity(const CADEntity_CSPtr& cadEntity) :
     ID(),
-    _layer(cadEntity->_layer),
-    _metaInfo(cadEntity->_metaInfo),
-    _block(cadEntity->_block) {
+    _attributes(cadEntity->_attributes) {
 }
 
 CADEntity::CADEntity(const CADEntity_CSPtr& cadEntity, bool sameID) :
     ID(sameID ? cadEntity->id() : 0),
-    _layer(cadEntity->_layer),
-    _metaInfo(cadEntity->_metaInfo),
-    _block(cadEntity->_block) {
+    _attributes(cadEntity->_attributes) {
 }
 
 CADEntity::CADEntity(const lc::builder::CADEntityBuilder& builder) :
     ID(builder.id()),
-    _layer(builder.layer()),
-    _metaInfo(builder.metaInfo()),
-    _block(builder.block()) {
+    _attributes(EntityAttributes::get(builder.layer(), builder.metaInfo(), builder.block())) {
 }
 
 meta::Layer_CSPtr CADEntity::layer() const {
-    return _layer;
+    return _attributes->layer();
 }
 
 meta::Block_CSPtr CADEntity::block() const {
-    return _block;
+    return _attributes->block();
 }
 
 PropertiesMap CADEntity::availableProperties() const {
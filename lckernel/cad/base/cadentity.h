@@ -10,6 +10,7 @@
 #include <cad/meta/block.h>
 #include "cad/const.h"
 #include "cad/base/id.h"
+#include "cad/base/entityattributes.h"
 #include "cad/base/metainfo.h"
 #include "cad/base/visitor.h"
 #include "cad/interface/metatype.h"
@@ -51,6 +52,17 @@ typedef boost::variant<AngleProperty, double, bool, lc::geo::Coordinate, std::st
 
 typedef std::map<std::string, EntityProperty> PropertiesMap;
 
+/**
+ * @brief Tag of the entity families the document needs to handle specially.
+ * Allows the storage to classify entities without going through RTTI for each of them.
+ */
+enum class EntityTag {
+    Generic,
+    Insert, // Insert of a regular block
+    CustomEntityInsert, // Insert of a custom entity block, waiting for a plugin to manage it
+    CustomEntity // Custom entity managed by a plugin
+};
+
 /**
  *Class that all CAD entities must inherit
  *
@@ -59,7 +71,7 @@ class CADEntity : public ID, virtual public Visitable {
     friend class lc::builder::CADEntityBuilder;
 
 public:
-    CADEntity() = default;
+    CADEntity();
 
     /*!
      * \brief CADEntity Constructor
@@ -148,8 +160,9 @@ public:
     */
     template<typename T>
     const std::shared_ptr<const T> metaInfo(const std::string& metaName) const {
-        if (_metaInfo && (_metaInfo->find(metaName) != _metaInfo->end())) {
-            auto a=_metaInfo->at(metaName);
+        const auto& metaInfo = _attributes->metaInfo();
+        if (metaInfo && (metaInfo->find(metaName) != metaInfo->end())) {
+            auto a=metaInfo->at(metaName);
             auto b=std::dynamic_pointer_cast<const T>(a);
             return b;
         }
@@ -158,7 +171,7 @@ public:
     }
 
     meta::MetaInfo_CSPtr metaInfo() const {
-        return _metaInfo;
+        return _attributes->metaInfo();
     }
 
     void accept(GeoEntityVisitor &v) const override {
@@ -173,6 +186,21 @@ public:
      */
     meta::Block_CSPtr block() const;
 
+    /**
+     * @brief Return the layer, meta info and block of this entity, shared with the other entities using them
+     */
+    const EntityAttributes_CSPtr& attributes() const {
+        return _attributes;
+    }
+
+    /**
+     * @brief Return the tag of this entity family
+     * @return EntityTag::Generic unless the entity needs special handling in the document
+     */
+    virtual EntityTag entityTag() const {
+        return EntityTag::Generic;
+    }
+
     /* Entity Propperties Related Code*/
 
     virtual PropertiesMap availableProperties() const;
@@ -183,9 +211,7 @@ protected:
     CADEntity(const lc::builder::CADEntityBuilder& builder);
 
 private:
-    meta::Layer_CSPtr _layer;
-    meta::MetaInfo_CSPtr _metaInfo;
-    meta::Block_CSPtr _block;
+    EntityAttributes_CSPtr _attributes;
 };
 
 DECLARE_SHORT_SHARED_PTR(CADEntity)
@@ -0,0 +1,111 @@
+#include "entityattributes.h"
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+using namespace lc;
+using namespace entity;
+
+namespace {
+struct AttributesKey {
+    const void* layer;
+    const void* metaInfo;
+    const void* block;
+
+    bool operator==(const AttributesKey& other) const {
+        return layer == other.layer && metaInfo == other.metaInfo && block == other.block;
+    }
+};
+
+struct AttributesKeyHash {
+    size_t operator()(const AttributesKey& key) const {
+        std::hash<const void*> hash;
+        auto result = hash(key.layer);
+        result = result * 31 + hash(key.metaInfo);
+        return result * 31 + hash(key.block);
+    }
+};
+
+/**
+ * @brief Attributes in use, an entry is removed when its attributes are destroyed
+ */
+struct AttributesTable {
+    std::mutex mutex;
+    std::unordered_map<AttributesKey, std::weak_ptr<const EntityAttributes>, AttributesKeyHash> attributes;
+};
+
+/**
+ * @brief Return the table of attributes
+ * It is never destroyed, entities can be released during the destruction of static objects.
+ */
+AttributesTable& attributesTable() {
+    static auto table = new AttributesTable();
+    return *table;
+}
+
+/**
+ * @brief Last attributes used by a thread
+ * While the attributes exist they hold their layer, meta info and block, so the key can't match other objects.
+ */
+struct LastAttributes {
+    AttributesKey key;
+    std::weak_ptr<const EntityAttributes> attributes;
+};
+
+thread_local LastAttributes lastAttributes = {{nullptr, nullptr, nullptr}, {}};
+}
+
+EntityAttributes::EntityAttributes(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) :
+    _layer(std::move(layer)),
+    _metaInfo(std::move(metaInfo)),
+    _block(std::move(block)) {
+}
+
+EntityAttributes::~EntityAttributes() {
+    AttributesKey key = {_layer.get(), _metaInfo.get(), _block.get()};
+    auto& table = attributesTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    // The combination can already be used again by new attributes
+    auto it = table.attributes.find(key);
+    if (it != table.attributes.end() && it->second.expired()) {
+        table.attributes.erase(it);
+    }
+}
+
+EntityAttributes_CSPtr EntityAttributes::get(const meta::Layer_CSPtr& layer,
+                                             const meta::MetaInfo_CSPtr& metaInfo,
+                                             const meta::Block_CSPtr& block) {
+    AttributesKey key = {layer.get(), metaInfo.get(), block.get()};
+
+    if (lastAttributes.key == key) {
+        if (auto attributes = lastAttributes.attributes.lock()) {
+            return attributes;
+        }
+    }
+
+    EntityAttributes_CSPtr attributes;
+    {
+        auto& table = attributesTable();
+        std::lock_guard<std::mutex> lock(table.mutex);
+
+        auto& entry = table.attributes[key];
+        attributes = entry.lock();
+
+        if (attributes == nullptr) {
+            attributes = std::make_shared<const EntityAttributes>(layer, metaInfo, block);
+            entry = attributes;
+        }
+    }
+
+    lastAttributes.key = key;
+    lastAttributes.attributes = attributes;
+    return attributes;
+}
+
+size_t EntityAttributes::count() {
+    auto& table = attributesTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.attributes.size();
+}
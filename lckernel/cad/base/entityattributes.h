@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include "cad/const.h"
+#include "cad/base/metainfo.h"
+#include "cad/meta/block.h"
+#include "cad/meta/layer.h"
+
+namespace lc {
+namespace entity {
+class EntityAttributes;
+DECLARE_SHORT_SHARED_PTR(EntityAttributes)
+
+/**
+ * @brief Layer, meta info and block of an entity
+ *
+ * Most entities of a drawing share a handful of combinations, each combination is stored once and
+ * entities only hold a pointer to it. Copying an entity updates a single reference counter instead of three.
+ * Attributes are immutable, the same instance is returned for the same combination as long as it is used.
+ */
+class EntityAttributes {
+public:
+    /**
+     * @brief Return the shared attributes of a combination
+     * The last combination used by each thread is cached, entities transformed in a row usually share it.
+     */
+    static EntityAttributes_CSPtr get(const meta::Layer_CSPtr& layer,
+                                      const meta::MetaInfo_CSPtr& metaInfo,
+                                      const meta::Block_CSPtr& block);
+
+    /**
+     * @brief Return the amount of combinations currently used
+     */
+    static size_t count();
+
+    EntityAttributes(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block);
+
+    ~EntityAttributes();
+
+    EntityAttributes(const EntityAttributes&) = delete;
+    EntityAttributes& operator=(const EntityAttributes&) = delete;
+
+    const meta::Layer_CSPtr& layer() const {
+        return _layer;
+    }
+
+    const meta::MetaInfo_CSPtr& metaInfo() const {
+        return _metaInfo;
+    }
+
+    const meta::Block_CSPtr& block() const {
+        return _block;
+    }
+
+private:
+    const meta::Layer_CSPtr _layer;
+    const meta::MetaInfo_CSPtr _metaInfo;
+    const meta::Block_CSPtr _block;
+};
+}
+}
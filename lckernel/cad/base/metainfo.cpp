@@ -4,6 +4,19 @@
 using namespace lc::meta;
 
 std::shared_ptr<MetaInfo> MetaInfo::add(EntityMetaType_CSPtr mt) {
-    this->emplace(mt->metaTypeID(), mt);
+    auto inserted = this->emplace(mt->metaTypeID(), mt).second;
+
+    if (inserted) {
+        if (auto color = std::dynamic_pointer_cast<const MetaColor>(mt)) {
+            _color = color;
+        }
+        else if (auto lineWidth = std::dynamic_pointer_cast<const MetaLineWidth>(mt)) {
+            _lineWidth = lineWidth;
+        }
+        else if (auto linePattern = std::dynamic_pointer_cast<const DxfLinePattern>(mt)) {
+            _linePattern = linePattern;
+        }
+    }
+
     return shared_from_this();
 }
@@ -11,11 +11,15 @@
 #include <string>
 #include "cad/interface/metatype.h"
 #include "cad/meta/dxflinepattern.h"
+#include "cad/meta/metacolor.h"
+#include "cad/meta/metalinewidth.h"
 
 namespace lc {
 namespace meta {
 /**
  * Container to hold meta data for an entity
+ * The color, line width and line pattern are also kept in fixed slots, which avoids a string lookup
+ * for the meta types needed to draw each entity. The slots are only filled by add().
  */
 /// @todo Container to store meta information on an entity
 class MetaInfo
@@ -25,12 +29,38 @@ public:
     // Convenience function to add a MetaType to the MetaInfo map
     std::shared_ptr<MetaInfo> add(EntityMetaType_CSPtr mt);
 
+    /**
+     * @brief Return the color, nullptr if not set
+     */
+    const MetaColor_CSPtr& color() const {
+        return _color;
+    }
+
+    /**
+     * @brief Return the line width, nullptr if not set
+     */
+    const MetaLineWidth_CSPtr& lineWidth() const {
+        return _lineWidth;
+    }
+
+    /**
+     * @brief Return the line pattern, nullptr if not set
+     */
+    const DxfLinePattern_CSPtr& linePattern() const {
+        return _linePattern;
+    }
+
     // std::shared_ptr<MetaInfo> add(std::string name, MetaType_CSPtr mi);
     virtual ~MetaInfo() = default;
 
     static std::shared_ptr<MetaInfo> create() {
         return std::make_shared<lc::meta::MetaInfo>();
     }
+
+private:
+    MetaColor_CSPtr _color;
+    MetaLineWidth_CSPtr _lineWidth;
+    DxfLinePattern_CSPtr _linePattern;
 };
 
 DECLARE_SHORT_SHARED_PTR(MetaInfo)
@@ -1,5 +1,6 @@
 #include "arc.h"
 #include <cad/primitive/arc.h>
+#include <cad/tools/poolallocator.h>
 
 using namespace lc::builder;
 
@@ -51,7 +52,9 @@ ArcBuilder* ArcBuilder::setIsCCW(bool isCCW) {
 lc::entity::Arc_CSPtr ArcBuilder::build() {
     checkValues(true);
 
-    return entity::Arc_CSPtr(new entity::Arc(*this));
+    return lc::tools::constructPooled<lc::entity::Arc>([&](void* memory) {
+        return new (memory) lc::entity::Arc(*this);
+    });
 }
 
 void ArcBuilder::copy(entity::Arc_CSPtr entity) {
@@ -24,9 +24,9 @@ public:
     };
 
     void copy(entity::CADEntity_CSPtr entity) {
-        _layer = entity->_layer;
-        _block = entity->_block;
-        _metaInfo = entity->_metaInfo;
+        _layer = entity->layer();
+        _block = entity->block();
+        _metaInfo = entity->metaInfo();
 
         if (_id == nullptr) {
             _id = new entity::ID(entity->id());
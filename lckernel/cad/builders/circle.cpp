@@ -2,6 +2,7 @@
 #include <cad/primitive/circle.h>
 #include <cad/math/lcmath.h>
 #include <cmath>
+#include <cad/tools/poolallocator.h>
 
 lc::builder::CircleBuilder::CircleBuilder() {
     // creating the temporary line pattern
@@ -205,7 +206,9 @@ lc::entity::Circle_CSPtr lc::builder::CircleBuilder::build()
 
     if (tempEntity)
     {
-        lc::entity::Circle_CSPtr new_circle = entity::Circle_CSPtr(new entity::Circle(*this));
+        lc::entity::Circle_CSPtr new_circle = lc::tools::constructPooled<lc::entity::Circle>([&](void* memory) {
+            return new (memory) lc::entity::Circle(*this);
+        });
         lc::meta::MetaInfo_CSPtr metaInfo = new_circle->metaInfo();
         lc::meta::MetaInfo_SPtr newMetaInfo = lc::meta::MetaInfo::create();
 
@@ -242,7 +245,9 @@ lc::entity::Circle_CSPtr lc::builder::CircleBuilder::build()
     }
     else
     {
-        return entity::Circle_CSPtr(new entity::Circle(*this));;
+        return lc::tools::constructPooled<lc::entity::Circle>([&](void* memory) {
+            return new (memory) lc::entity::Circle(*this);
+        });
     }
 }
 
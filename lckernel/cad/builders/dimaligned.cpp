@@ -1,5 +1,6 @@
 #include "dimaligned.h"
 #include <cad/primitive/dimaligned.h>
+#include <cad/tools/poolallocator.h>
 
 const lc::geo::Coordinate& lc::builder::DimAlignedBuilder::definitionPoint2() const {
     return _definitionPoint2;
@@ -39,5 +40,7 @@ void lc::builder::DimAlignedBuilder::dimAuto(lc::geo::Coordinate p2,
 
 lc::entity::DimAligned_CSPtr lc::builder::DimAlignedBuilder::build() {
     checkValues(true);
-    return lc::entity::DimAligned_CSPtr(new lc::entity::DimAligned(*this));
+    return lc::tools::constructPooled<lc::entity::DimAligned>([&](void* memory) {
+        return new (memory) lc::entity::DimAligned(*this);
+    });
 }
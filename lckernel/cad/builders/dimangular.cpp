@@ -1,5 +1,6 @@
 #include "dimangular.h"
 #include <cad/primitive/dimangular.h>
+#include <cad/tools/poolallocator.h>
 
 const lc::geo::Coordinate& lc::builder::DimAngularBuilder::defLine11() const {
     return _defLine11;
@@ -46,5 +47,7 @@ void lc::builder::DimAngularBuilder::dimAuto(const lc::geo::Coordinate& center,
 
 lc::entity::DimAngular_CSPtr lc::builder::DimAngularBuilder::build() {
     checkValues(true);
-    return lc::entity::DimAngular_CSPtr(new lc::entity::DimAngular(*this));
+    return lc::tools::constructPooled<lc::entity::DimAngular>([&](void* memory) {
+        return new (memory) lc::entity::DimAngular(*this);
+    });
 }
@@ -1,5 +1,6 @@
 #include "dimdiametric.h"
 #include <cad/primitive/dimdiametric.h>
+#include <cad/tools/poolallocator.h>
 
 lc::builder::DimDiametricBuilder::DimDiametricBuilder() {
     _leader = 0;
@@ -23,5 +24,7 @@ void lc::builder::DimDiametricBuilder::setDefinitionPoint2(const lc::geo::Coordi
 
 lc::entity::DimDiametric_CSPtr lc::builder::DimDiametricBuilder::build() {
     checkValues(true);
-    return lc::entity::DimDiametric_CSPtr(new lc::entity::DimDiametric(*this));
+    return lc::tools::constructPooled<lc::entity::DimDiametric>([&](void* memory) {
+        return new (memory) lc::entity::DimDiametric(*this);
+    });
 }
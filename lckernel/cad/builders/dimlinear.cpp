@@ -1,5 +1,6 @@
 #include "dimlinear.h"
 #include <cad/primitive/dimlinear.h>
+#include <cad/tools/poolallocator.h>
 
 lc::builder::DimLinearBuilder::DimLinearBuilder() {
     _angle = 0;
@@ -8,7 +9,9 @@ lc::builder::DimLinearBuilder::DimLinearBuilder() {
 
 lc::entity::DimLinear_CSPtr lc::builder::DimLinearBuilder::build() const {
     checkValues(true);
-    return lc::entity::DimLinear_CSPtr(new lc::entity::DimLinear(*this));
+    return lc::tools::constructPooled<lc::entity::DimLinear>([&](void* memory) {
+        return new (memory) lc::entity::DimLinear(*this);
+    });
 }
 
 double lc::builder::DimLinearBuilder::angle() const {
@@ -1,5 +1,6 @@
 #include "dimradial.h"
 #include <cad/primitive/dimradial.h>
+#include <cad/tools/poolallocator.h>
 
 lc::builder::DimRadialBuilder::DimRadialBuilder() {
     _leader = 0;
@@ -23,7 +24,9 @@ void lc::builder::DimRadialBuilder::setDefinitionPoint2(const lc::geo::Coordinat
 
 lc::entity::DimRadial_CSPtr lc::builder::DimRadialBuilder::build() const {
     checkValues(true);
-    return lc::entity::DimRadial_CSPtr(new lc::entity::DimRadial(*this));
+    return lc::tools::constructPooled<lc::entity::DimRadial>([&](void* memory) {
+        return new (memory) lc::entity::DimRadial(*this);
+    });
 }
 
 void lc::builder::DimRadialBuilder::dimAuto(lc::geo::Coordinate definitionPoint, lc::geo::Coordinate definitionPoint2) {
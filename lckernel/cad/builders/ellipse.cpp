@@ -1,11 +1,14 @@
 #include "ellipse.h"
 #include <cad/primitive/ellipse.h>
+#include <cad/tools/poolallocator.h>
 
 using namespace lc::builder;
 
 lc::entity::Ellipse_CSPtr EllipseBuilder::build() {
     checkValues(true);
-    return lc::entity::Ellipse_CSPtr(new lc::entity::Ellipse(*this));
+    return lc::tools::constructPooled<lc::entity::Ellipse>([&](void* memory) {
+        return new (memory) lc::entity::Ellipse(*this);
+    });
 }
 
 const lc::geo::Coordinate& EllipseBuilder::center() const {
@@ -1,5 +1,6 @@
 #include "insert.h"
 #include <cad/primitive/insert.h>
+#include <cad/tools/poolallocator.h>
 
 using namespace lc;
 using namespace builder;
@@ -38,7 +39,9 @@ entity::Insert_CSPtr InsertBuilder::build() {
     if(!checkValues()) {
         throw std::runtime_error("Missing values");
     }
-    return entity::Insert_CSPtr(new entity::Insert(*this));
+    return lc::tools::constructPooled<lc::entity::Insert>([&](void* memory) {
+        return new (memory) lc::entity::Insert(*this);
+    });
 }
 
 const geo::Coordinate& InsertBuilder::coordinate() const {
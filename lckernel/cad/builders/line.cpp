@@ -1,5 +1,6 @@
 #include "line.h"
 #include <cad/primitive/line.h>
+#include <cad/tools/poolallocator.h>
 
 using namespace lc::builder;
 
@@ -36,7 +37,9 @@ double LineBuilder::getLineAngle(lc::entity::CADEntity_CSPtr entity) const {
 
 lc::entity::Line_CSPtr LineBuilder::build() {
     checkValues(true);
-    return entity::Line_CSPtr(new entity::Line(*this));
+    return lc::tools::constructPooled<lc::entity::Line>([&](void* memory) {
+        return new (memory) lc::entity::Line(*this);
+    });
 }
 
 void LineBuilder::copy(entity::Line_CSPtr entity) {
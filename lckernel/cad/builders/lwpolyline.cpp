@@ -3,6 +3,7 @@
 #include "cad/interface/metatype.h"
 #include "cad/math/lcmath.h"
 #include <math.h>
+#include <cad/tools/poolallocator.h>
 
 lc::builder::LWPolylineBuilder::LWPolylineBuilder()
     :
@@ -106,7 +107,9 @@ const std::vector<lc::builder::LWBuilderVertex>& lc::builder::LWPolylineBuilder:
 lc::entity::LWPolyline_CSPtr lc::builder::LWPolylineBuilder::build()
 {
     checkValues(true);
-    return lc::entity::LWPolyline_CSPtr(new lc::entity::LWPolyline(*this));
+    return lc::tools::constructPooled<lc::entity::LWPolyline>([&](void* memory) {
+        return new (memory) lc::entity::LWPolyline(*this);
+    });
 }
 
 void lc::builder::LWPolylineBuilder::removeVertex(int index)
@@ -1,5 +1,6 @@
 #include "point.h"
 #include <cad/primitive/point.h>
+#include <cad/tools/poolallocator.h>
 
 using namespace lc;
 using namespace builder;
@@ -19,5 +20,7 @@ PointBuilder* PointBuilder::setCoordinate(const geo::Coordinate& coordinate) {
 
 entity::Point_CSPtr PointBuilder::build() {
     checkValues(true);
-    return entity::Point_CSPtr(new entity::Point(*this));
+    return lc::tools::constructPooled<lc::entity::Point>([&](void* memory) {
+        return new (memory) lc::entity::Point(*this);
+    });
 }
@@ -1,5 +1,6 @@
 #include "spline.h"
 #include <cad/primitive/spline.h>
+#include <cad/tools/poolallocator.h>
 
 lc::builder::SplineBuilder::SplineBuilder() {
     _degree = 2;
@@ -71,7 +72,9 @@ void lc::builder::SplineBuilder::addFitPoint(lc::geo::Coordinate fitPoint) {
 lc::entity::Spline_CSPtr lc::builder::SplineBuilder::build() const {
     checkValues(true);
 
-    return lc::entity::Spline_CSPtr(new lc::entity::Spline(*this));
+    return lc::tools::constructPooled<lc::entity::Spline>([&](void* memory) {
+        return new (memory) lc::entity::Spline(*this);
+    });
 }
 
 const std::vector<lc::geo::Coordinate>& lc::builder::SplineBuilder::controlPoints() const {
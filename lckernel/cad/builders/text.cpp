@@ -1,5 +1,6 @@
 #include "text.h"
 #include <cad/primitive/text.h>
+#include <cad/tools/poolallocator.h>
 
 using namespace lc::builder;
 
@@ -127,7 +128,9 @@ bool TextBuilder::italic() const {
 
 lc::entity::Text_CSPtr TextBuilder::build() {
     checkValues(true);
-    return entity::Text_CSPtr(new entity::Text(*this));
+    return lc::tools::constructPooled<lc::entity::Text>([&](void* memory) {
+        return new (memory) lc::entity::Text(*this);
+    });
 }
 
 void TextBuilder::copy(lc::entity::Text_CSPtr entity) {
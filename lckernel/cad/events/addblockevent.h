@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cad/meta/block.h>
+
+namespace lc {
+namespace event {
+/**
+ * \brief Event that gets emitted when a block was added to the document
+ */
+class AddBlockEvent {
+public:
+    AddBlockEvent(const meta::Block_CSPtr block) : _block(block) {
+    }
+
+    /*!
+     * \brief Return block data
+     * \return Block
+     */
+    meta::Block_CSPtr block() const {
+        return _block;
+    }
+
+private:
+    const meta::Block_CSPtr _block;
+};
+}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+
+namespace lc {
+namespace event {
+/**
+ * Event that gets emitted once when a batch of entities was added to, removed from or replaced in the document
+ * A replaced entity is listed in removed() with its old version and in added() with its new version
+ * @param added
+ * @param removed
+ */
+class BatchEntityEvent {
+public:
+    BatchEntityEvent(std::vector<entity::CADEntity_CSPtr> added, std::vector<entity::CADEntity_CSPtr> removed) :
+        _added(std::move(added)),
+        _removed(std::move(removed)) {
+    }
+
+    /*!
+     * \brief Returns the entities added to the document
+     * \return std::vector<CADEntity_CSPtr>
+     */
+    const std::vector<entity::CADEntity_CSPtr>& added() const {
+        return _added;
+    }
+
+    /*!
+     * \brief Returns the entities removed from the document
+     * \return std::vector<CADEntity_CSPtr>
+     */
+    const std::vector<entity::CADEntity_CSPtr>& removed() const {
+        return _removed;
+    }
+
+private:
+    const std::vector<entity::CADEntity_CSPtr> _added;
+    const std::vector<entity::CADEntity_CSPtr> _removed;
+};
+}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cad/meta/block.h>
+
+namespace lc {
+namespace event {
+/**
+ * \brief Event that gets emitted when a block of the document was replaced
+ */
+class ReplaceBlockEvent {
+public:
+    ReplaceBlockEvent(const meta::Block_CSPtr oldBlock, const meta::Block_CSPtr newBlock)
+        : _oldBlock(oldBlock), _newBlock(newBlock) {
+    }
+
+    meta::Block_CSPtr oldBlock() const {
+        return _oldBlock;
+    }
+
+    meta::Block_CSPtr newBlock() const {
+        return _newBlock;
+    }
+
+private:
+    const meta::Block_CSPtr _oldBlock;
+    const meta::Block_CSPtr _newBlock;
+};
+}
+}
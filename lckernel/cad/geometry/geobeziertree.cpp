@@ -0,0 +1,149 @@
+#include "geobeziertree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace lc;
+using namespace geo;
+
+namespace {
+// Maximal amount of levels stored in a tree, a cubic tree of this depth uses 3kB
+const short MAX_CACHED_DEPTH = 5;
+
+// Subdivisions stop at this depth, even when the parts are still larger than BBHEURISTIC2
+const short MAX_SUBDIVISION_DEPTH = 40;
+
+// Each level pops one pair and pushes four
+const size_t STACK_SIZE = 3 * MAX_SUBDIVISION_DEPTH + 4;
+
+struct CurvePair {
+    BezierPoints curve1;
+    BezierPoints curve2;
+    int node1;
+    int node2;
+    short depth;
+};
+}
+
+BezierPoints::BezierPoints(const std::vector<Coordinate>& controlPoints) :
+    count(controlPoints.size()) {
+
+    if (count < 3 || count > points.size()) {
+        throw std::runtime_error("Only quadratic and cubic beziers are supported");
+    }
+
+    std::copy(controlPoints.begin(), controlPoints.end(), points.begin());
+}
+
+Area BezierPoints::hull() const {
+    auto minX = points[0].x();
+    auto minY = points[0].y();
+    auto maxX = minX;
+    auto maxY = minY;
+
+    for (size_t i = 1; i < count; i++) {
+        minX = std::min(minX, points[i].x());
+        minY = std::min(minY, points[i].y());
+        maxX = std::max(maxX, points[i].x());
+        maxY = std::max(maxY, points[i].y());
+    }
+
+    return Area(Coordinate(minX, minY), Coordinate(maxX, maxY));
+}
+
+void BezierPoints::splitHalf(BezierPoints& first, BezierPoints& second) const {
+    // de Casteljau, each row holds the middles of the previous one
+    std::array<Coordinate, 4> row = points;
+
+    first.count = count;
+    second.count = count;
+
+    for (size_t level = 0; level < count; level++) {
+        first.points[level] = row[0];
+        second.points[count - 1 - level] = row[count - 1 - level];
+
+        for (size_t i = 0; i + level + 1 < count; i++) {
+            row[i] = (row[i] + row[i + 1]) / 2;
+        }
+    }
+}
+
+BezierTree::BezierTree(const BezierBase& bezier) :
+    _curve(bezier.getCP()),
+    _depth(0) {
+
+    auto hull = _curve.hull();
+    auto size = std::max(hull.width(), hull.height());
+
+    // Each level halves the size of the parts, no need to store parts smaller than the tolerance
+    while (_depth < MAX_CACHED_DEPTH && size > BBHEURISTIC2 / 2) {
+        size /= 2;
+        _depth++;
+    }
+
+    _bounds.resize((static_cast<size_t>(1) << (_depth + 1)) - 1, Area());
+    build(0, _curve, 0);
+}
+
+void BezierTree::build(size_t node, const BezierPoints& curve, short level) {
+    _bounds[node] = curve.hull();
+
+    if (level < _depth) {
+        BezierPoints first;
+        BezierPoints second;
+        curve.splitHalf(first, second);
+
+        build(2 * node + 1, first, level + 1);
+        build(2 * node + 2, second, level + 1);
+    }
+}
+
+int BezierTree::firstChild(int node) const {
+    if (node < 0) {
+        return -1;
+    }
+
+    auto child = 2 * static_cast<size_t>(node) + 1;
+    return child < _bounds.size() ? static_cast<int>(child) : -1;
+}
+
+void BezierTree::intersect(const BezierTree& tree1, const BezierTree& tree2, std::vector<Coordinate>& result) {
+    std::array<CurvePair, STACK_SIZE> stack;
+    size_t size = 0;
+
+    stack[size++] = {tree1._curve, tree2._curve, 0, 0, 0};
+
+    while (size > 0) {
+        auto pair = stack[--size];
+
+        auto bounds1 = pair.node1 >= 0 ? tree1._bounds[pair.node1] : pair.curve1.hull();
+        auto bounds2 = pair.node2 >= 0 ? tree2._bounds[pair.node2] : pair.curve2.hull();
+
+        if (!bounds1.overlaps(bounds2)) {
+            continue;
+        }
+
+        if ((bounds1.height() + bounds2.height() <= BBHEURISTIC2 && bounds1.width() + bounds2.width() <= BBHEURISTIC2) ||
+            pair.depth >= MAX_SUBDIVISION_DEPTH) {
+            result.push_back(pair.curve1.points[1]);
+            continue;
+        }
+
+        BezierPoints parts1[2];
+        BezierPoints parts2[2];
+        pair.curve1.splitHalf(parts1[0], parts1[1]);
+        pair.curve2.splitHalf(parts2[0], parts2[1]);
+
+        auto child1 = tree1.firstChild(pair.node1);
+        auto child2 = tree2.firstChild(pair.node2);
+        short depth = pair.depth + 1;
+
+        // Pushed in reverse, so the parts are visited in the order of the curves
+        for (int j = 1; j >= 0; j--) {
+            for (int i = 1; i >= 0; i--) {
+                stack[size++] = {parts1[i], parts2[j], child1 < 0 ? -1 : child1 + i, child2 < 0 ? -1 : child2 + j, depth};
+            }
+        }
+    }
+}
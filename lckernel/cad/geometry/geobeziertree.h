@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "cad/const.h"
+#include "geoarea.h"
+#include "geocoordinate.h"
+#include "geobezierbase.h"
+
+namespace lc {
+namespace geo {
+/**
+ * @brief Control points of a quadratic or cubic bezier, stored by value
+ * Used to subdivide a bezier without allocating a new BezierBase for each part.
+ */
+struct BezierPoints {
+    std::array<Coordinate, 4> points;
+    size_t count;
+
+    BezierPoints() :
+        count(0) {
+    }
+
+    explicit BezierPoints(const std::vector<Coordinate>& controlPoints);
+
+    /**
+     * @brief Return the box of the control points
+     * The curve is inside the convex hull of its control points, so inside this box.
+     */
+    Area hull() const;
+
+    /**
+     * @brief Split the curve at t = 0.5
+     */
+    void splitHalf(BezierPoints& first, BezierPoints& second) const;
+};
+
+/**
+ * @brief Subdivision tree of a bezier
+ *
+ * The boxes of the first levels of subdivision are computed once and stored in a flat array,
+ * the amount of levels depends on the size of the curve.
+ * Intersecting two trees reuses these boxes and subdivides further on the stack, without any allocation.
+ * A tree is immutable once built, it can be shared between threads.
+ */
+class BezierTree {
+public:
+    explicit BezierTree(const BezierBase& bezier);
+
+    /**
+     * @brief Return the box containing the curve
+     */
+    const Area& bounds() const {
+        return _bounds.front();
+    }
+
+    /**
+     * @brief Add the intersections of two beziers to result
+     * Both curves are subdivided until the boxes of the overlapping parts are smaller than BBHEURISTIC2,
+     * the middle of these parts are returned.
+     */
+    static void intersect(const BezierTree& tree1, const BezierTree& tree2, std::vector<Coordinate>& result);
+
+private:
+    void build(size_t node, const BezierPoints& curve, short level);
+
+    /**
+     * @brief Return the index of the first child of a node, -1 if the node isn't subdivided in the tree
+     */
+    int firstChild(int node) const;
+
+    BezierPoints _curve;
+    short _depth;
+
+    // Complete binary tree, the children of node i are 2i + 1 and 2i + 2
+    std::vector<Area> _bounds;
+};
+}
+}
@@ -80,6 +80,7 @@ Coordinate Spline::nearestPointOnEntity(const Coordinate &coord) const {
 
 void Spline::populateCurve() {
     tinyspline::BSpline splineCurve;
+    std::atomic_store(&_bezierTrees, std::shared_ptr<const std::vector<BezierTree>>());
 
     try {
         auto nbControlPoints = _controlPoints.size();
@@ -138,10 +139,31 @@ void Spline::populateCurve() {
     }
 }
 
-const std::vector<BB_CSPtr> Spline::beziers() const {
+const std::vector<BB_CSPtr>& Spline::beziers() const {
     return _beziers;
 }
 
+const std::vector<BezierTree>& Spline::bezierTrees() const {
+    auto trees = std::atomic_load(&_bezierTrees);
+
+    if (!trees) {
+        // Threads racing here build the same trees, only one set is kept
+        auto newTrees = std::make_shared<std::vector<BezierTree>>();
+        newTrees->reserve(_beziers.size());
+        for (const auto& bezier : _beziers) {
+            newTrees->emplace_back(*bezier);
+        }
+
+        std::shared_ptr<const std::vector<BezierTree>> expected;
+        trees = newTrees;
+        if (!std::atomic_compare_exchange_strong(&_bezierTrees, &expected, trees)) {
+            trees = expected;
+        }
+    }
+
+    return *trees;
+}
+
 void Spline::trimAtPoint(const geo::Coordinate& c) {
     /// @todo implement
 }
@@ -2,11 +2,13 @@
 
 #include "geobase.h"
 #include "geocoordinate.h"
+#include <memory>
 #include <vector>
 #include "cad/base/visitor.h"
 #include "cad/geometry/geobezierbase.h"
 #include "cad/geometry/geobezier.h"
 #include "cad/geometry/geobeziercubic.h"
+#include "cad/geometry/geobeziertree.h"
 
 namespace lc {
 namespace geo {
@@ -95,7 +97,13 @@ public:
      * @return bool closed
      */
     bool closed() const;
-    const std::vector<BB_CSPtr> beziers() const;
+    const std::vector<BB_CSPtr>& beziers() const;
+
+    /**
+     * @brief Return the subdivision trees of the beziers, used for intersections
+     * The trees are built on first use and shared by the copies of this spline.
+     */
+    const std::vector<BezierTree>& bezierTrees() const;
     void trimAtPoint(const geo::Coordinate& c);
 
     /**
@@ -143,6 +151,7 @@ private:
     const double _nZ;  // normal vector z coordinate
 
     std::vector<BB_CSPtr> _beziers;
+    mutable std::shared_ptr<const std::vector<BezierTree>> _bezierTrees;
     const splineflag _flags;
 };
 }
@@ -3,8 +3,10 @@
 // Modified from
 // https:://github.com/boostorg/log/blob/develop/example/advanced_usage/main.cpp
 
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #if BOOST_VERSION >= 106100 /// @todo fix version
 #include <boost/core/null_deleter.hpp>
 #else
@@ -30,7 +32,19 @@ namespace keywords = boost::log::keywords;
 //Class starts here..
 //Singleton class
 //Making Supports to console,plain logs
-typedef sinks::synchronous_sink<sinks::text_ostream_backend> text_sink;
+//Records are formatted and written by a dedicated thread, the default queue of the frontend is lock-free
+typedef sinks::asynchronous_sink<sinks::text_ostream_backend> text_sink;
+
+namespace {
+std::vector<boost::shared_ptr<text_sink>> activeSinks;
+
+void stopSinks() {
+    for (auto& sink : activeSinks) {
+        sink->stop();
+        sink->flush();
+    }
+}
+}
 
 template< typename CharT, typename TraitsT >
 inline std::basic_ostream< CharT, TraitsT >& operator<< (
@@ -61,6 +75,13 @@ Logger* Logger::Instance() {
 
     return instance;
 }
+
+void Logger::flush() {
+    for (auto& sink : activeSinks) {
+        sink->flush();
+    }
+}
+
 void Logger::enableFileSink() {
     //First sink.. detail ;; to file
     boost::shared_ptr<text_sink> pSink(new text_sink);
@@ -68,6 +89,7 @@ void Logger::enableFileSink() {
     boost::shared_ptr<std::ofstream> pStream(new std::ofstream("sample.log"));
     pBackend->add_stream(pStream);
     logging::core::get()->add_sink(pSink);
+    activeSinks.push_back(pSink);
     pSink->set_formatter(expr::stream
                          << expr::attr<unsigned int>("LineID")
                          << "[" << expr::format_date_time<boost::posix_time::ptime>("TimeStamp", "%d.%m.%y %H.%M.%S.%f")
@@ -94,6 +116,7 @@ void Logger::enableConsoleSink() {
                                            );
     pBackend->add_stream(pStream);
     logging::core::get()->add_sink(pSink);
+    activeSinks.push_back(pSink);
     pSink->set_formatter(expr::stream
                          << "[" << expr::attr<SeverityLevel>("Severity")
                          << "]: " << expr::if_(expr::has_attr("Tag"))
@@ -111,6 +134,8 @@ Logger::Logger() {
     //Creating sinks
     enableFileSink();
     enableConsoleSink();
+    //Write pending records before exiting
+    std::atexit(stopSinks);
     //Enable attrs
     logging::add_common_attributes();
     BOOST_LOG_SCOPED_THREAD_ATTR("Uptime", attrs::timer());
@@ -16,10 +16,20 @@ enum SeverityLevel {
     LOG_SEVERITY_ERROR, // Fatal errors that interrupt the program or the current process
 };
 
+/**
+ * @brief Logger of LibreCAD
+ * Records are written by a background thread, the logging thread only pushes them to a lock-free queue.
+ * Pending records are written when the program exits or when flush() is called.
+ */
 class Logger {
 public:
     static Logger* Instance();
 
+    /**
+     * @brief Wait until all pending records are written
+     */
+    void flush();
+
 private:
     void enableFileSink();
     void enableConsoleSink();
@@ -33,8 +43,24 @@ private:
 
 #define LOGGER lc::log::Logger::Instance()
 
-#define LOG_TRACE BOOST_LOG_SEV(lcGlobalLogger::get(), lc::log::LOG_SEVERITY_TRACE)
-#define LOG_DEBUG BOOST_LOG_SEV(lcGlobalLogger::get(), lc::log::LOG_SEVERITY_DEBUG)
-#define LOG_INFO BOOST_LOG_SEV(lcGlobalLogger::get(), lc::log::LOG_SEVERITY_INFO)
-#define LOG_WARNING BOOST_LOG_SEV(lcGlobalLogger::get(), lc::log::LOG_SEVERITY_WARNING)
-#define LOG_ERROR BOOST_LOG_SEV(lcGlobalLogger::get(), lc::log::LOG_SEVERITY_ERROR)
+/**
+ * Records below this severity are removed at compile time, the streamed expressions are not evaluated.
+ * Trace and debug records are only kept in debug builds unless LC_LOG_MIN_SEVERITY is defined.
+ */
+#ifndef LC_LOG_MIN_SEVERITY
+#ifdef NDEBUG
+#define LC_LOG_MIN_SEVERITY lc::log::LOG_SEVERITY_INFO
+#else
+#define LC_LOG_MIN_SEVERITY lc::log::LOG_SEVERITY_TRACE
+#endif
+#endif
+
+#define LC_LOG_SEV(severity) \
+    if (severity < LC_LOG_MIN_SEVERITY) {} \
+    else BOOST_LOG_SEV(lcGlobalLogger::get(), severity)
+
+#define LOG_TRACE LC_LOG_SEV(lc::log::LOG_SEVERITY_TRACE)
+#define LOG_DEBUG LC_LOG_SEV(lc::log::LOG_SEVERITY_DEBUG)
+#define LOG_INFO LC_LOG_SEV(lc::log::LOG_SEVERITY_INFO)
+#define LOG_WARNING LC_LOG_SEV(lc::log::LOG_SEVERITY_WARNING)
+#define LOG_ERROR LC_LOG_SEV(lc::log::LOG_SEVERITY_ERROR)
@@ -1,5 +1,10 @@
 #include "intersect.h"
 #include "cad/math/intersectionhandler.h"
+#include "cad/tools/threadpool.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
 
 using namespace lc;
 using namespace lc::maths;
@@ -501,6 +506,148 @@ void Intersect::geovisit(const geo::Spline& S1, const geo::Spline& S2) {
     }
 }
 
+namespace {
+// Minimal amount of candidate pairs intersected by a thread
+const size_t MIN_PAIR_CHUNK_SIZE = 256;
+
+typedef std::pair<size_t, size_t> CandidatePair;
+
+std::vector<geo::Area> boundingBoxes(const std::vector<entity::CADEntity_CSPtr>& entities, double tolerance) {
+    std::vector<geo::Area> boxes;
+    boxes.reserve(entities.size());
+
+    for (const auto& entity : entities) {
+        boxes.push_back(entity->boundingBox().increaseBy(tolerance));
+    }
+
+    return boxes;
+}
+
+/**
+ * @brief Return the pairs of boxes which overlap, sorted
+ * The boxes are swept along the x axis, each box is only compared with the boxes starting before it ends.
+ * @param boxes1 First set of boxes
+ * @param boxes2 Second set of boxes, nullptr to find the overlapping pairs within the first set
+ * @return Pairs of indices in boxes1 and boxes2 (or boxes1, the first index being the smallest)
+ */
+std::vector<CandidatePair> overlappingPairs(const std::vector<geo::Area>& boxes1, const std::vector<geo::Area>* boxes2) {
+    // Index of the set and of the box in the set
+    std::vector<CandidatePair> order;
+    order.reserve(boxes1.size() + (boxes2 ? boxes2->size() : 0));
+
+    for (size_t i = 0; i < boxes1.size(); i++) {
+        order.emplace_back(0, i);
+    }
+    if (boxes2) {
+        for (size_t i = 0; i < boxes2->size(); i++) {
+            order.emplace_back(1, i);
+        }
+    }
+
+    auto box = [&](const CandidatePair& item) -> const geo::Area& {
+        return item.first == 0 ? boxes1[item.second] : (*boxes2)[item.second];
+    };
+
+    std::sort(order.begin(), order.end(), [&](const CandidatePair& a, const CandidatePair& b) {
+        return box(a).minP().x() < box(b).minP().x();
+    });
+
+    std::vector<CandidatePair> pairs;
+    for (size_t i = 0; i < order.size(); i++) {
+        const auto& current = box(order[i]);
+
+        for (size_t j = i + 1; j < order.size() && box(order[j]).minP().x() <= current.maxP().x(); j++) {
+            if ((boxes2 && order[i].first == order[j].first) || !current.overlaps(box(order[j]))) {
+                continue;
+            }
+
+            if (!boxes2) {
+                pairs.emplace_back(std::min(order[i].second, order[j].second), std::max(order[i].second, order[j].second));
+            }
+            else if (order[i].first == 0) {
+                pairs.emplace_back(order[i].second, order[j].second);
+            }
+            else {
+                pairs.emplace_back(order[j].second, order[i].second);
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+/**
+ * @brief Intersect the candidate pairs on the thread pool
+ * Each thread accumulates the points of a sub-range of pairs, the sub-ranges are merged in order
+ * so the result doesn't depend on the amount of threads.
+ */
+std::vector<geo::Coordinate> intersectPairs(const std::vector<entity::CADEntity_CSPtr>& entities1,
+                                            const std::vector<entity::CADEntity_CSPtr>& entities2,
+                                            const std::vector<CandidatePair>& pairs,
+                                            Intersect::Method method,
+                                            double tolerance) {
+    std::mutex mutex;
+    std::map<size_t, std::vector<geo::Coordinate>> chunks;
+
+    tools::ThreadPool::instance().parallelFor(pairs.size(), MIN_PAIR_CHUNK_SIZE, [&](size_t begin, size_t end) {
+        Intersect intersect(method, tolerance);
+
+        for (size_t i = begin; i < end; i++) {
+            visitorDispatcher<bool, GeoEntityVisitor>(intersect,
+                                                      *entities1[pairs[i].first].get(),
+                                                      *entities2[pairs[i].second].get());
+        }
+
+        auto points = intersect.result();
+        std::lock_guard<std::mutex> lock(mutex);
+        chunks[begin] = std::move(points);
+    });
+
+    std::vector<geo::Coordinate> result;
+    for (auto& chunk : chunks) {
+        result.insert(result.end(), chunk.second.begin(), chunk.second.end());
+    }
+
+    return result;
+}
+
+/**
+ * @brief Intersect all the pairs on the thread pool, used when the intersections can be outside of the bounding boxes
+ * The pairs are not stored, each thread processes a sub-range of entities1 against entities2.
+ */
+std::vector<geo::Coordinate> intersectAllPairs(const std::vector<entity::CADEntity_CSPtr>& entities1,
+                                               const std::vector<entity::CADEntity_CSPtr>& entities2,
+                                               bool sameSet,
+                                               Intersect::Method method,
+                                               double tolerance) {
+    std::mutex mutex;
+    std::map<size_t, std::vector<geo::Coordinate>> chunks;
+    auto minChunkSize = std::max<size_t>(1, MIN_PAIR_CHUNK_SIZE / std::max<size_t>(1, entities2.size()));
+
+    tools::ThreadPool::instance().parallelFor(entities1.size(), minChunkSize, [&](size_t begin, size_t end) {
+        Intersect intersect(method, tolerance);
+
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = sameSet ? i + 1 : 0; j < entities2.size(); j++) {
+                visitorDispatcher<bool, GeoEntityVisitor>(intersect, *entities1[i].get(), *entities2[j].get());
+            }
+        }
+
+        auto points = intersect.result();
+        std::lock_guard<std::mutex> lock(mutex);
+        chunks[begin] = std::move(points);
+    });
+
+    std::vector<geo::Coordinate> result;
+    for (auto& chunk : chunks) {
+        result.insert(result.end(), chunk.second.begin(), chunk.second.end());
+    }
+
+    return result;
+}
+}
+
 /***
  *    ~|~ _ _|_ _  _ _ _  __|_|\/| _  _
  *    _|_| | | (/_| _\(/_(_ | |  |(_|| |\/
@@ -514,15 +661,12 @@ IntersectMany::IntersectMany(std::vector<entity::CADEntity_CSPtr> entities, Inte
 }
 
 std::vector<lc::geo::Coordinate> IntersectMany::result() const {
-    Intersect intersect(_method, _tolerance);
-    if (_entities.size() > 1) {
-        for (size_t outer = 0; outer < (_entities.size() - 1); outer++) {
-            for (size_t inner = outer + 1; inner < _entities.size(); inner++) {
-                visitorDispatcher<bool, lc::GeoEntityVisitor>(intersect, *_entities.at(outer).get(), *_entities.at(inner).get());
-            }
-        }
+    if (_method == Intersect::OnPath) {
+        return intersectAllPairs(_entities, _entities, true, _method, _tolerance);
     }
-    return intersect.result();
+
+    auto pairs = overlappingPairs(boundingBoxes(_entities, _tolerance), nullptr);
+    return intersectPairs(_entities, _entities, pairs, _method, _tolerance);
 }
 
 /***
@@ -540,22 +684,12 @@ IntersectAgainstOthers::IntersectAgainstOthers(std::vector<entity::CADEntity_CSP
 }
 
 std::vector<lc::geo::Coordinate> IntersectAgainstOthers::result() const {
-    Intersect intersect(_method, _tolerance);
-    /*** @todo fixme unused
-    for (auto &other : _others) {
-        for (auto &entity : _entities) {
-               visitorDispatcher<bool, lc::GeoEntityVisitor>(intersect, *other.get(), *entity.get());
-        }
+    if (_method == Intersect::OnPath) {
+        return intersectAllPairs(_others, _entities, false, _method, _tolerance);
     }
-    */
-#ifdef __GNUC__
-    std::cerr << __PRETTY_FUNCTION__ << " requires implementation" << std::endl;
-#elif _MSC_VER
-    std::cerr << __FUNCSIG__ << " requires implementation" << std::endl;
-#else
-    std::cerr << "Intersection function requires implementation" << std::endl;
-#endif // __GNUC__
 
-    return intersect.result();
+    auto otherBoxes = boundingBoxes(_others, _tolerance);
+    auto entityBoxes = boundingBoxes(_entities, _tolerance);
+    auto pairs = overlappingPairs(otherBoxes, &entityBoxes);
+    return intersectPairs(_others, _entities, pairs, _method, _tolerance);
 }
-
@@ -208,6 +208,9 @@ private:
 
 /**
   * @brief calculate intersection points of many entities
+  * With Intersect::OnEntity, only the entities with overlapping bounding boxes are intersected.
+  * The pairs are intersected on the kernel thread pool, the points are returned in the same order
+  * as when intersecting all the pairs one after the other.
   * @note Can we make this into a general template ???
   * @sa Intersect
   */
@@ -225,8 +228,9 @@ private:
 };
 
 /**
-  * @brief calculate intersection points of many entities
-  * @note Can we make this into a general template ???
+  * @brief calculate intersection points of a set of entities with an other set
+  * Intersections between entities of the same set are ignored.
+  * Computed the same way as IntersectMany.
   * @sa Intersect
   */
 class IntersectAgainstOthers {
@@ -1,5 +1,8 @@
 #include "cad/math/intersectionhandler.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace lc;
 using namespace maths;
 std::vector<geo::Coordinate> Intersection::LineLine(const Equation& l1,
@@ -60,13 +63,23 @@ std::vector<geo::Coordinate> Intersection::bezierLine(const geo::BB_CSPtr& B, co
     std::vector<geo::Coordinate> ret;
     std::vector<double> roots;
 
-    auto pts = B->getCP();
+    // Control points in the coordinates of the line, the line being the x axis
+    auto rotate_angle = -(V.end() - V.start()).angle();
+    auto cps = B->getCP();
+    bool above = false;
+    bool below = false;
+    for(auto& cp : cps) {
+        cp = (cp - V.start()).rotate(rotate_angle);
+        above = above || cp.y() >= 0;
+        below = below || cp.y() <= 0;
+    }
 
-    if(pts.size()==3) {
-        auto ml = geo::Vector(V.start() - V.start(), V.end() - V.start());
-        auto rotate_angle = -ml.Angle1();
-        auto cps = B->move(-V.start())->rotate(ml.start(), rotate_angle)->getCP();
+    // The curve is within the convex hull of the control points, it can't cross the line if they are all on one side
+    if(!above || !below) {
+        return ret;
+    }
 
+    if(cps.size()==3) {
         auto t2 = cps[0].y() - 2*cps[1].y() + cps[2].y();
         auto t1 = 2*(cps[1].y() - cps[0].y())/t2;
         auto coeff = cps[0].y()/t2;
@@ -74,10 +87,6 @@ std::vector<geo::Coordinate> Intersection::bezierLine(const geo::BB_CSPtr& B, co
         roots = lc::maths::Math::quadraticSolver({t1, coeff});
     }
     else {
-        auto ml = geo::Vector(V.start() - V.start(), V.end() - V.start());
-        auto rotate_angle = -ml.Angle1();
-        auto cps = B->move(-V.start())->rotate(ml.start(), rotate_angle)->getCP();
-
         auto t3 = -cps[0].y() + 3*cps[1].y() - 3*cps[2].y() + cps[3].y();
         auto t2 = (3*cps[0].y() - 6*cps[1].y() + 3*cps[2].y())/t3;
         auto t1 = (-3*cps[0].y() +3*cps[1].y())/t3;
@@ -107,6 +116,18 @@ std::vector<geo::Coordinate> Intersection::bezierCircle(const geo::BB_CSPtr& B,
 
     auto points = B->getCP();
 
+    // The curve is within the box of its control points, it can't cross the circle if the box is
+    // outside of the circle or inside of it
+    auto hull = geo::BezierPoints(points).hull();
+    auto nearest = geo::Coordinate(std::max(hull.minP().x(), std::min(C.center().x(), hull.maxP().x())),
+                                   std::max(hull.minP().y(), std::min(C.center().y(), hull.maxP().y())));
+    auto farthest = geo::Coordinate(std::max(std::abs(hull.minP().x() - C.center().x()), std::abs(hull.maxP().x() - C.center().x())),
+                                    std::max(std::abs(hull.minP().y() - C.center().y()), std::abs(hull.maxP().y() - C.center().y())));
+    if(nearest.distanceTo(C.center()) > C.radius() + LCTOLERANCE ||
+       farthest.magnitude() < C.radius() - LCTOLERANCE) {
+        return ret;
+    }
+
     if(points.size()== 3) {
 
         auto r = C.radius();
@@ -218,31 +239,10 @@ std::vector<geo::Coordinate> Intersection::bezierEllipse(const geo::BB_CSPtr& B,
 
 std::vector<geo::Coordinate> Intersection::bezierBezier(const geo::BB_CSPtr& B1, const geo::BB_CSPtr& B2) {
     std::vector<geo::Coordinate> ret;
-    bezBez(B1,B2, ret);
+    geo::BezierTree::intersect(geo::BezierTree(*B1), geo::BezierTree(*B2), ret);
     return ret;
 }
 
-void Intersection::bezBez(const geo::BB_CSPtr& B1,const geo::BB_CSPtr& B2, std::vector<geo::Coordinate>&ret) {
-    auto bb1 = B1->boundingBox();
-    auto bb2 = B2->boundingBox();
-
-    if(!bb1.overlaps(bb2)) {
-        return;
-    }
-
-    if(bb1.height() + bb2.height() <= BBHEURISTIC2 && bb1.width() + bb2.width() <= BBHEURISTIC2) {
-        ret.push_back(B1->getCP().at(1));
-        return;
-    }
-
-    auto b1split = B1->splitHalf();
-    auto b2split = B2->splitHalf();
-    bezBez(b1split[0], b2split[0], ret);
-    bezBez(b1split[1], b2split[0], ret);
-    bezBez(b1split[0], b2split[1], ret);
-    bezBez(b1split[1], b2split[1], ret);
-}
-
 std::vector<geo::Coordinate> Intersection::bezCircleIntersect(const lc::geo::BB_CSPtr& bez,
         const geo::Coordinate &ec,
         double rx, double ry) {
@@ -304,7 +304,7 @@ std::vector<geo::Coordinate> Intersection::bezCircleIntersect(const lc::geo::BB_
 
 std::vector<geo::Coordinate> Intersection::splineLine(const geo::Spline& B, const geo::Vector& V) {
     std::vector<geo::Coordinate> ret;
-    auto beziers = B.beziers();
+    const auto& beziers = B.beziers();
     for(const auto& bezier : beziers) {
         auto vecret = bezierLine(bezier, V);
         ret.insert(ret.end(), vecret.begin(), vecret.end());
@@ -314,7 +314,7 @@ std::vector<geo::Coordinate> Intersection::splineLine(const geo::Spline& B, cons
 
 std::vector<geo::Coordinate> Intersection::splineCircle(const geo::Spline& B, const geo::Circle& C) {
     std::vector<geo::Coordinate> ret;
-    auto beziers = B.beziers();
+    const auto& beziers = B.beziers();
     for(const auto & bezier : beziers) {
         auto vecret = bezierCircle(bezier, C);
         ret.insert(ret.end(), vecret.begin(), vecret.end());
@@ -324,7 +324,7 @@ std::vector<geo::Coordinate> Intersection::splineCircle(const geo::Spline& B, co
 
 std::vector<geo::Coordinate> Intersection::splineArc(const geo::Spline& B, const geo::Arc& A) {
     std::vector<geo::Coordinate> ret;
-    auto beziers = B.beziers();
+    const auto& beziers = B.beziers();
     for(const auto & bezier : beziers) {
         auto vecret = bezierArc(bezier, A);
         ret.insert(ret.end(), vecret.begin(), vecret.end());
@@ -334,7 +334,7 @@ std::vector<geo::Coordinate> Intersection::splineArc(const geo::Spline& B, const
 
 std::vector<geo::Coordinate> Intersection::splineEllipse(const geo::Spline& B, const geo::Ellipse& E) {
     std::vector<geo::Coordinate> ret;
-    auto beziers = B.beziers();
+    const auto& beziers = B.beziers();
     for(const auto & bezier : beziers) {
         auto vecret = bezierEllipse(bezier, E);
         ret.insert(ret.end(), vecret.begin(), vecret.end());
@@ -344,12 +344,13 @@ std::vector<geo::Coordinate> Intersection::splineEllipse(const geo::Spline& B, c
 
 std::vector<geo::Coordinate> Intersection::splineSpline(const geo::Spline& B1, const geo::Spline& B2) {
     std::vector<geo::Coordinate> ret;
-    auto beziers = B1.beziers();
-    auto beziers2 = B2.beziers();
-    for(const auto & bezier : beziers) {
-        for(const auto & bezier2 : beziers2) {
-            auto vecret = bezierBezier(bezier, bezier2);
-            ret.insert(ret.end(), vecret.begin(), vecret.end());
+    const auto& trees = B1.bezierTrees();
+    const auto& trees2 = B2.bezierTrees();
+    for(const auto & tree : trees) {
+        for(const auto & tree2 : trees2) {
+            if(tree.bounds().overlaps(tree2.bounds())) {
+                geo::BezierTree::intersect(tree, tree2, ret);
+            }
         }
     }
     return ret;
@@ -357,10 +358,11 @@ std::vector<geo::Coordinate> Intersection::splineSpline(const geo::Spline& B1, c
 
 std::vector<geo::Coordinate> Intersection::splineBezier(const geo::Spline& B1, const geo::BB_CSPtr& B2) {
     std::vector<geo::Coordinate> ret;
-    auto beziers = B1.beziers();
-    for(const auto & bezier : beziers) {
-        auto vecret = bezierBezier(bezier, B2);
-        ret.insert(ret.end(), vecret.begin(), vecret.end());
+    geo::BezierTree tree2(*B2);
+    for(const auto & tree : B1.bezierTrees()) {
+        if(tree.bounds().overlaps(tree2.bounds())) {
+            geo::BezierTree::intersect(tree, tree2, ret);
+        }
     }
     return ret;
 }
@@ -6,6 +6,7 @@
 #include "cad/geometry/geobezierbase.h"
 #include "cad/geometry/geobezier.h"
 #include "cad/geometry/geobeziercubic.h"
+#include "cad/geometry/geobeziertree.h"
 #include "cad/geometry/geovector.h"
 #include "cad/geometry/geocircle.h"
 #include "cad/geometry/geoarc.h"
@@ -36,7 +37,6 @@ public:
             const geo::Coordinate& ec,
             double rx, double ry);
 private:
-    static void bezBez(const geo::BB_CSPtr& B1, const geo::BB_CSPtr& B2, std::vector<geo::Coordinate>&ret);
 };
 }
 }
@@ -0,0 +1,154 @@
+#include "metapool.h"
+#include "layer.h"
+
+#include <algorithm>
+#include <functional>
+#include <typeinfo>
+
+using namespace lc::meta;
+
+namespace {
+void appendDouble(std::string& key, double value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Return a key which is equal for meta types of the same class with the same value
+ * The ID of the meta types is rounded and ignores the alpha of the colors, the exact values are used instead.
+ */
+std::string valueKey(const EntityMetaType& metaType) {
+    auto key = std::string(typeid(metaType).name()) + "|";
+
+    if (auto color = dynamic_cast<const MetaColorByValue*>(&metaType)) {
+        appendDouble(key, color->red());
+        appendDouble(key, color->green());
+        appendDouble(key, color->blue());
+        appendDouble(key, color->alpha());
+    }
+    else if (auto lineWidth = dynamic_cast<const MetaLineWidthByValue*>(&metaType)) {
+        appendDouble(key, lineWidth->width());
+    }
+    else {
+        key += metaType.id();
+    }
+
+    return key;
+}
+}
+
+MetaPool& MetaPool::instance() {
+    static MetaPool pool;
+    return pool;
+}
+
+size_t MetaPool::KeyHash::operator()(const std::vector<const EntityMetaType*>& key) const {
+    size_t hash = key.size();
+
+    for (auto metaType : key) {
+        hash ^= std::hash<const EntityMetaType*>()(metaType) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+
+    return hash;
+}
+
+EntityMetaType_CSPtr MetaPool::intern(const EntityMetaType_CSPtr& metaType) {
+    if (metaType == nullptr) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return internMetaType(metaType);
+}
+
+EntityMetaType_CSPtr MetaPool::internMetaType(const EntityMetaType_CSPtr& metaType) {
+    if (std::dynamic_pointer_cast<const DxfLinePatternByValue>(metaType) != nullptr ||
+        std::dynamic_pointer_cast<const Layer>(metaType) != nullptr) {
+        return metaType;
+    }
+
+    auto& entry = _metaTypes[valueKey(*metaType)];
+    auto existing = entry.lock();
+
+    if (existing != nullptr) {
+        return existing;
+    }
+
+    entry = metaType;
+    return metaType;
+}
+
+MetaInfo_CSPtr MetaPool::intern(const MetaInfo_CSPtr& metaInfo) {
+    if (metaInfo == nullptr || metaInfo->empty()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<EntityMetaType_CSPtr> metaTypes;
+    std::vector<const EntityMetaType*> key;
+    metaTypes.reserve(metaInfo->size());
+    key.reserve(metaInfo->size());
+
+    for (const auto& item : *metaInfo) {
+        metaTypes.push_back(internMetaType(item.second));
+        key.push_back(metaTypes.back().get());
+    }
+
+    // Each meta type ID is present once, the interned pointers identify the content
+    std::sort(key.begin(), key.end());
+
+    auto& entry = _metaInfos[key];
+    auto existing = entry.lock();
+    if (existing != nullptr) {
+        return existing;
+    }
+
+    // The shared instance must hold the interned meta types, their address is part of the key
+    MetaInfo_CSPtr result = metaInfo;
+    for (size_t i = 0; i < metaTypes.size(); i++) {
+        auto it = metaInfo->find(metaTypes[i]->metaTypeID());
+        if (it == metaInfo->end() || it->second != metaTypes[i]) {
+            auto copy = MetaInfo::create();
+            for (const auto& metaType : metaTypes) {
+                copy->add(metaType);
+            }
+            result = copy;
+            break;
+        }
+    }
+
+    entry = result;
+
+    if (_metaInfos.size() >= _purgeSize) {
+        purge();
+    }
+
+    return result;
+}
+
+size_t MetaPool::metaInfoCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _metaInfos.size();
+}
+
+void MetaPool::purge() {
+    for (auto it = _metaInfos.begin(); it != _metaInfos.end();) {
+        if (it->second.expired()) {
+            it = _metaInfos.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (auto it = _metaTypes.begin(); it != _metaTypes.end();) {
+        if (it->second.expired()) {
+            it = _metaTypes.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    _purgeSize = std::max<size_t>(1024, _metaInfos.size() * 2);
+}
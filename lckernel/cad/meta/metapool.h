@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cad/base/metainfo.h"
+
+namespace lc {
+namespace meta {
+/**
+ * @brief Pool of immutable meta types and meta infos
+ *
+ * Entities of a drawing usually share a handful of different colors, line widths and line patterns.
+ * The pool returns a single shared instance for equal meta types and for meta infos containing the same
+ * meta types, instead of keeping an instance per entity.
+ *
+ * Meta types are equal when they have the same class and the same exact value.
+ * Layers and line patterns by value are part of a document and are never merged, meta infos referencing
+ * the same instance are.
+ * The pool only keeps weak references, unused instances are freed. It can be used from any thread.
+ */
+class MetaPool {
+public:
+    static MetaPool& instance();
+
+    MetaPool(const MetaPool&) = delete;
+    MetaPool& operator=(const MetaPool&) = delete;
+
+    /**
+     * @brief Return the shared instance of a meta type
+     */
+    EntityMetaType_CSPtr intern(const EntityMetaType_CSPtr& metaType);
+
+    /**
+     * @brief Return the shared instance of a meta info
+     * The meta info must not be modified after this call.
+     * @return nullptr if metaInfo is nullptr or empty
+     */
+    MetaInfo_CSPtr intern(const MetaInfo_CSPtr& metaInfo);
+
+    /**
+     * @brief Return the amount of meta infos in the pool, including the ones which are not used anymore
+     */
+    size_t metaInfoCount() const;
+
+private:
+    MetaPool() = default;
+
+    struct KeyHash {
+        size_t operator()(const std::vector<const EntityMetaType*>& key) const;
+    };
+
+    EntityMetaType_CSPtr internMetaType(const EntityMetaType_CSPtr& metaType);
+    void purge();
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, std::weak_ptr<const EntityMetaType>> _metaTypes;
+    std::unordered_map<std::vector<const EntityMetaType*>, std::weak_ptr<const MetaInfo>, KeyHash> _metaInfos;
+    size_t _purgeSize = 1024;
+};
+}
+}
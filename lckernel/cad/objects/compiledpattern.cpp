@@ -0,0 +1,328 @@
+#include "compiledpattern.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cad/geometry/georegion.h"
+#include "cad/primitive/line.h"
+#include "cad/primitive/lwpolyline.h"
+
+using namespace lc;
+using namespace objects;
+
+namespace {
+// Largest amount of tiles a line can cross before it repeats, lines repeating less often are drawn tile by tile
+const int MAX_REPEAT_TILES = 32;
+const double PARALLEL_TOLERANCE = 1e-6;
+
+/**
+ * @brief Extended Euclid, return the gcd of a and b and x, y so that a * x + b * y = gcd
+ */
+int extendedGcd(int a, int b, int& x, int& y) {
+    if (b == 0) {
+        x = a < 0 ? -1 : 1;
+        y = 0;
+        return std::abs(a);
+    }
+
+    int x1;
+    int y1;
+    auto gcd = extendedGcd(b, a % b, x1, y1);
+    x = y1;
+    y = x1 - (a / b) * y1;
+    return gcd;
+}
+
+void addDashes(const PatternLineFamily& family,
+               double scale,
+               const geo::Coordinate& base,
+               const geo::Coordinate& direction,
+               double begin,
+               double end,
+               std::vector<geo::Vector>& segments) {
+    double period = 0;
+    for (auto dash : family.dashes) {
+        period += std::abs(dash);
+    }
+    period *= scale;
+
+    if (period <= 0) {
+        segments.emplace_back(base + direction * begin, base + direction * end);
+        return;
+    }
+
+    for (auto repeat = std::floor(begin / period); repeat * period < end; repeat++) {
+        auto position = repeat * period;
+
+        for (auto dash : family.dashes) {
+            auto length = std::abs(dash) * scale;
+
+            if (dash > 0) {
+                auto dashBegin = std::max(position, begin);
+                auto dashEnd = std::min(position + length, end);
+
+                if (dashBegin < dashEnd) {
+                    segments.emplace_back(base + direction * dashBegin, base + direction * dashEnd);
+                }
+            }
+
+            position += length;
+        }
+    }
+}
+}
+
+CompiledPattern::CompiledPattern(const std::vector<entity::CADEntity_CSPtr>& entities,
+                                 const geo::Coordinate& tileSize) :
+    _tileSize(tileSize) {
+
+    for (const auto& entity : entities) {
+        std::vector<entity::CADEntity_CSPtr> parts;
+
+        if (auto polyline = std::dynamic_pointer_cast<const entity::LWPolyline>(entity)) {
+            parts = polyline->asEntities();
+        }
+        else {
+            parts.push_back(entity);
+        }
+
+        for (const auto& part : parts) {
+            auto line = std::dynamic_pointer_cast<const entity::Line>(part);
+
+            if (line != nullptr && compileLine(line->start(), line->end())) {
+                continue;
+            }
+
+            _tileEntitiesBounds = _tileEntities.empty() ? part->boundingBox() : _tileEntitiesBounds.merge(part->boundingBox());
+            _tileEntities.push_back(part);
+        }
+    }
+}
+
+bool CompiledPattern::compileLine(const geo::Coordinate& start, const geo::Coordinate& end) {
+    auto direction = end - start;
+    auto length = direction.magnitude();
+
+    if (length < LCTOLERANCE) {
+        return true;
+    }
+
+    auto width = _tileSize.x();
+    auto height = _tileSize.y();
+
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // Find the shortest translation of the tile grid along the line, which is the period of the dashes
+    int stepX = 0;
+    int stepY = 0;
+    auto period = std::numeric_limits<double>::max();
+
+    for (int i = -MAX_REPEAT_TILES; i <= MAX_REPEAT_TILES; i++) {
+        for (int j = -MAX_REPEAT_TILES; j <= MAX_REPEAT_TILES; j++) {
+            geo::Coordinate translation(i * width, j * height);
+            auto translationLength = translation.magnitude();
+
+            if ((i == 0 && j == 0) || translationLength >= period || translation.dot(direction) <= 0) {
+                continue;
+            }
+
+            auto cross = direction.x() * translation.y() - direction.y() * translation.x();
+            if (std::abs(cross) <= PARALLEL_TOLERANCE * length * translationLength) {
+                stepX = i;
+                stepY = j;
+                period = translationLength;
+            }
+        }
+    }
+
+    if (stepX == 0 && stepY == 0) {
+        return false;
+    }
+
+    // The translation to the next line completes the grid: stepX * nextY - stepY * nextX = 1
+    int a;
+    int b;
+    extendedGcd(stepX, stepY, a, b);
+    auto nextX = -b;
+    auto nextY = a;
+
+    PatternLineFamily family;
+    family.origin = start;
+    family.direction = direction * (1. / length);
+    family.offset = geo::Coordinate(nextX * width, nextY * height);
+
+    if (length < period - LCTOLERANCE) {
+        family.dashes = {length, -(period - length)};
+    }
+
+    _families.push_back(family);
+    return true;
+}
+
+template<typename F>
+void CompiledPattern::forEachLine(const geo::Area& clip, double scale, double angle, F func) const {
+    geo::Coordinate rotation(angle);
+    const geo::Coordinate corners[] = {
+        clip.minP(),
+        clip.maxP(),
+        geo::Coordinate(clip.minP().x(), clip.maxP().y()),
+        geo::Coordinate(clip.maxP().x(), clip.minP().y())
+    };
+
+    for (const auto& family : _families) {
+        auto origin = (family.origin * scale).rotate(rotation);
+        auto direction = family.direction.rotate(rotation);
+        auto offset = (family.offset * scale).rotate(rotation);
+
+        geo::Coordinate normal(-direction.y(), direction.x());
+        auto spacing = offset.dot(normal);
+
+        if (spacing <= LCTOLERANCE) {
+            continue;
+        }
+
+        auto minDistance = std::numeric_limits<double>::max();
+        auto maxDistance = std::numeric_limits<double>::lowest();
+        for (const auto& corner : corners) {
+            auto distance = (corner - origin).dot(normal);
+            minDistance = std::min(minDistance, distance);
+            maxDistance = std::max(maxDistance, distance);
+        }
+
+        auto last = std::floor(maxDistance / spacing);
+        for (auto index = std::ceil(minDistance / spacing); index <= last; index++) {
+            auto base = origin + offset * index;
+
+            // Clip the line to the area
+            auto begin = std::numeric_limits<double>::lowest();
+            auto end = std::numeric_limits<double>::max();
+            bool outside = false;
+
+            for (int axis = 0; axis < 2 && !outside; axis++) {
+                auto position = axis == 0 ? base.x() : base.y();
+                auto step = axis == 0 ? direction.x() : direction.y();
+                auto min = axis == 0 ? clip.minP().x() : clip.minP().y();
+                auto max = axis == 0 ? clip.maxP().x() : clip.maxP().y();
+
+                if (std::abs(step) < PARALLEL_TOLERANCE) {
+                    outside = position < min || position > max;
+                    continue;
+                }
+
+                auto t1 = (min - position) / step;
+                auto t2 = (max - position) / step;
+                begin = std::max(begin, std::min(t1, t2));
+                end = std::min(end, std::max(t1, t2));
+            }
+
+            if (!outside && begin < end) {
+                func(family, base, direction, begin, end);
+            }
+        }
+    }
+}
+
+std::vector<geo::Vector> CompiledPattern::segments(const geo::Area& clip, double scale, double angle) const {
+    std::vector<geo::Vector> segments;
+
+    forEachLine(clip, scale, angle, [&](const PatternLineFamily& family,
+                                        const geo::Coordinate& base,
+                                        const geo::Coordinate& direction,
+                                        double begin,
+                                        double end) {
+        addDashes(family, scale, base, direction, begin, end, segments);
+    });
+
+    return segments;
+}
+
+std::vector<geo::Vector> CompiledPattern::segments(const geo::Region& region,
+                                                   const geo::Area& clip,
+                                                   double scale,
+                                                   double angle) const {
+    std::vector<geo::Vector> segments;
+    std::vector<double> cuts;
+
+    forEachLine(clip, scale, angle, [&](const PatternLineFamily& family,
+                                        const geo::Coordinate& base,
+                                        const geo::Coordinate& direction,
+                                        double begin,
+                                        double end) {
+        cuts.clear();
+        cuts.push_back(begin);
+        for (const auto& point : region.getLineIntersection(geo::Vector(base + direction * begin,
+                                                                         base + direction * end))) {
+            cuts.push_back((point - base).dot(direction));
+        }
+        cuts.push_back(end);
+        std::sort(cuts.begin(), cuts.end());
+
+        for (size_t i = 1; i < cuts.size(); i++) {
+            if (cuts[i] - cuts[i - 1] < LCTOLERANCE) {
+                continue;
+            }
+
+            if (region.isPointInside(base + direction * ((cuts[i - 1] + cuts[i]) / 2))) {
+                addDashes(family, scale, base, direction, cuts[i - 1], cuts[i], segments);
+            }
+        }
+    });
+
+    return segments;
+}
+
+std::vector<entity::CADEntity_CSPtr> CompiledPattern::tileEntities(const geo::Area& clip, double scale, double angle) const {
+    std::vector<entity::CADEntity_CSPtr> entities;
+
+    if (_tileEntities.empty()) {
+        return entities;
+    }
+
+    auto width = _tileSize.x();
+    auto height = _tileSize.y();
+    int firstX = 0;
+    int lastX = 0;
+    int firstY = 0;
+    int lastY = 0;
+
+    if (width > 0 && height > 0 && scale > 0) {
+        // Area in the coordinates of the pattern
+        auto minP = clip.minP().rotate(-angle) * (1. / scale);
+        geo::Area area(minP, minP);
+        area = area.merge(clip.maxP().rotate(-angle) * (1. / scale));
+        area = area.merge(geo::Coordinate(clip.minP().x(), clip.maxP().y()).rotate(-angle) * (1. / scale));
+        area = area.merge(geo::Coordinate(clip.maxP().x(), clip.minP().y()).rotate(-angle) * (1. / scale));
+
+        firstX = static_cast<int>(std::ceil((area.minP().x() - _tileEntitiesBounds.maxP().x()) / width));
+        lastX = static_cast<int>(std::floor((area.maxP().x() - _tileEntitiesBounds.minP().x()) / width));
+        firstY = static_cast<int>(std::ceil((area.minP().y() - _tileEntitiesBounds.maxP().y()) / height));
+        lastY = static_cast<int>(std::floor((area.maxP().y() - _tileEntitiesBounds.minP().y()) / height));
+    }
+
+    std::vector<entity::CADEntity_CSPtr> transformed;
+    transformed.reserve(_tileEntities.size());
+    for (const auto& entity : _tileEntities) {
+        transformed.push_back(entity
+                              ->scale(geo::Coordinate(0, 0), geo::Coordinate(scale, scale))
+                              ->rotate(geo::Coordinate(0, 0), angle));
+    }
+
+    for (int i = firstX; i <= lastX; i++) {
+        for (int j = firstY; j <= lastY; j++) {
+            auto offset = (geo::Coordinate(i * width, j * height) * scale).rotate(angle);
+
+            for (const auto& entity : transformed) {
+                auto moved = entity->move(offset);
+
+                if (moved->boundingBox().overlaps(clip)) {
+                    entities.push_back(moved);
+                }
+            }
+        }
+    }
+
+    return entities;
+}
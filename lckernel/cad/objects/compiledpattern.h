@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+#include "cad/geometry/geoarea.h"
+#include "cad/geometry/geocoordinate.h"
+#include "cad/geometry/geovector.h"
+
+namespace lc {
+namespace geo {
+class Region;
+}
+
+namespace objects {
+/**
+ * @brief Family of parallel dashed lines, as defined in PAT files
+ */
+struct PatternLineFamily {
+    geo::Coordinate origin;     /*!< Start of a dash on the first line */
+    geo::Coordinate direction;  /*!< Unit vector along the lines */
+    geo::Coordinate offset;     /*!< Translation from one line to the next one */
+    std::vector<double> dashes; /*!< Length of the dashes, negative for gaps, empty for continuous lines */
+};
+
+/**
+ * @brief Hatch pattern compiled from the entities of a pattern tile
+ *
+ * A pattern file contains a tile which is repeated in both directions. Each line of the tile is
+ * compiled into a line family, which allows generating the segments inside an area without
+ * iterating over all the tiles.
+ * Entities which can't be expressed as a line family (arcs, lines with a slope which doesn't repeat
+ * on the tile grid) are kept and repeated tile by tile.
+ * A compiled pattern is immutable, it can be shared between hatches and threads.
+ */
+class CompiledPattern {
+public:
+    /**
+     * @brief Compile a pattern
+     * @param entities Entities of the tile
+     * @param tileSize Width and height of the tile, the tile starts at (0, 0)
+     */
+    CompiledPattern(const std::vector<entity::CADEntity_CSPtr>& entities, const geo::Coordinate& tileSize);
+
+    const std::vector<PatternLineFamily>& families() const {
+        return _families;
+    }
+
+    const std::vector<entity::CADEntity_CSPtr>& tileEntities() const {
+        return _tileEntities;
+    }
+
+    /**
+     * @brief Return the segments of the line families inside an area
+     * @param clip Area to fill
+     * @param scale Scale of the pattern
+     * @param angle Rotation of the pattern around (0, 0)
+     */
+    std::vector<geo::Vector> segments(const geo::Area& clip, double scale, double angle) const;
+
+    /**
+     * @brief Return the segments of the line families inside an area and a region
+     * Each line is intersected once with the region, the dashes are cut to the parts inside it.
+     */
+    std::vector<geo::Vector> segments(const geo::Region& region, const geo::Area& clip, double scale, double angle) const;
+
+    /**
+     * @brief Return the tile entities repeated over the tiles overlapping an area
+     */
+    std::vector<entity::CADEntity_CSPtr> tileEntities(const geo::Area& clip, double scale, double angle) const;
+
+private:
+    bool compileLine(const geo::Coordinate& start, const geo::Coordinate& end);
+
+    template<typename F>
+    void forEachLine(const geo::Area& clip, double scale, double angle, F func) const;
+
+    geo::Coordinate _tileSize;
+    std::vector<PatternLineFamily> _families;
+    std::vector<entity::CADEntity_CSPtr> _tileEntities;
+    geo::Area _tileEntitiesBounds;
+};
+
+DECLARE_SHORT_SHARED_PTR(CompiledPattern)
+}
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "cad/objects/compiledpattern.h"
+
 // Defination for hatch pattern
 // May be this must be in diffrent namespace
 namespace lc {
@@ -8,6 +10,7 @@ struct Pattern {
     lc::geo::Area boundingBox;
     std::string name;
     std::vector<lc::entity::CADEntity_CSPtr> entities;
+    CompiledPattern_CSPtr compiled; /*!< Shared by all the hatches using the pattern, can be nullptr */
 };
 }
 }
@@ -24,6 +24,7 @@ namespace operation {
 class DocumentOperation : public Undoable, public std::enable_shared_from_this<operation::DocumentOperation> {
     friend class lc::storage::Document;
     friend class Builder;
+    friend class Transaction;
 
 public:
     DocumentOperation(storage::Document_SPtr document, const std::string& description);
@@ -1,11 +1,14 @@
 #include "entitybuilder.h"
 #include "cad/storage/document.h"
 
+#include <iterator>
+
 using namespace lc;
 using namespace operation;
 
 EntityBuilder::EntityBuilder(const std::shared_ptr<storage::Document>& document) :
-    DocumentOperation(document, "EntityBuilder") {
+    DocumentOperation(document, "EntityBuilder"),
+    _flushedCount(0) {
 }
 
 EntityBuilder* EntityBuilder::appendEntity(entity::CADEntity_CSPtr cadEntity) {
@@ -21,62 +24,76 @@ EntityBuilder* EntityBuilder::appendOperation(Base_SPtr operation) {
 void EntityBuilder::processInternal() {
     processStack();
 
-    auto ec = document()->entityContainer();
-
     // Build a buffer with all entities we need to remove during a undo cycle
-    for (const auto& entity : _workingBuffer) {
-        auto org = ec.entityByID(entity->id());
+    // The entities already flushed were handled by flushEntities()
+    for (auto it = _workingBuffer.begin() + _flushedCount; it != _workingBuffer.end(); ++it) {
+        auto org = document()->entityByID((*it)->id());
 
         if (org != nullptr) {
             _entitiesThatWhereUpdated.push_back(org);
         }
     }
 
-    // Remove entities
-    for (const auto& entity : _entitiesThatNeedsRemoval) {
-        document()->removeEntity(entity);
+    // Remove entities and add/update all entities in the document
+    if (_flushedCount == 0) {
+        document()->applyBatch(_workingBuffer, _entitiesThatNeedsRemoval, {});
     }
-
-    // Add/Update all entities in the document
-    for (const auto& entity : _workingBuffer) {
-        document()->insertEntity(entity);
+    else {
+        std::vector<entity::CADEntity_CSPtr> remaining(_workingBuffer.begin() + _flushedCount, _workingBuffer.end());
+        document()->applyBatch(remaining, _entitiesThatNeedsRemoval, {});
     }
 }
 
-void EntityBuilder::undo() const {
-    for (const auto& entity : _workingBuffer) {
-        document()->removeEntity(entity);
-    }
+size_t EntityBuilder::flushEntities() {
+    std::vector<entity::CADEntity_CSPtr> entities(_workingBuffer.begin() + _flushedCount, _workingBuffer.end());
+    _flushedCount = _workingBuffer.size();
 
-    for (const auto& entity : _entitiesThatWhereUpdated) {
-        document()->insertEntity(entity);
+    for (const auto& entity : entities) {
+        auto org = document()->entityByID(entity->id());
+
+        if (org != nullptr) {
+            _entitiesThatWhereUpdated.push_back(org);
+        }
     }
 
-    for (const auto& entity : _entitiesThatNeedsRemoval) {
-        document()->insertEntity(entity);
+    if (!entities.empty()) {
+        document()->applyBatch(entities, {}, {});
     }
+
+    return entities.size();
+}
+
+void EntityBuilder::undo() const {
+    std::vector<entity::CADEntity_CSPtr> restored(_entitiesThatWhereUpdated);
+    restored.insert(restored.end(), _entitiesThatNeedsRemoval.begin(), _entitiesThatNeedsRemoval.end());
+
+    document()->applyBatch(restored, _workingBuffer, {});
 }
 
 void EntityBuilder::redo() const {
-    for (const auto& entity : _entitiesThatNeedsRemoval) {
-        document()->removeEntity(entity);
-    }
+    document()->applyBatch(_workingBuffer, _entitiesThatNeedsRemoval, {});
+}
 
-    for (const auto& entity : _workingBuffer) {
-        document()->insertEntity(entity);
-    }
+size_t EntityBuilder::memoryUsage() const {
+    auto entities = _workingBuffer.size() + _entitiesThatWhereUpdated.size() + _entitiesThatNeedsRemoval.size();
+    auto capacity = _workingBuffer.capacity() + _entitiesThatWhereUpdated.capacity() + _entitiesThatNeedsRemoval.capacity();
+
+    return sizeof(EntityBuilder) + capacity * sizeof(entity::CADEntity_CSPtr) + entities * ENTITY_MEMORY_ESTIMATE;
 }
 
 void EntityBuilder::processStack() {
     std::vector<entity::CADEntity_CSPtr> entitySet;
 
-    for (auto it = _stack.begin(); it != _stack.end(); ++it) {
-        // Get looping stack, we currently support only one single loop!!
-        std::vector<Base_SPtr> stack(_stack.begin(), it);
-        entitySet = (*it)->process(document(), entitySet, _workingBuffer, _entitiesThatNeedsRemoval, stack);
+    // Looping stack, operations preceding the current one. We currently support only one single loop!!
+    std::vector<Base_SPtr> stack;
+    stack.reserve(_stack.size());
+
+    for (const auto& operation : _stack) {
+        entitySet = operation->process(document(), std::move(entitySet), _workingBuffer, _entitiesThatNeedsRemoval, stack);
+        stack.push_back(operation);
     }
 
     _stack.clear();
 
-    _workingBuffer.insert(_workingBuffer.end(), entitySet.begin(), entitySet.end());
+    _workingBuffer.insert(_workingBuffer.end(), std::make_move_iterator(entitySet.begin()), std::make_move_iterator(entitySet.end()));
 }
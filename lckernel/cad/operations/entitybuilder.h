@@ -13,8 +13,13 @@ DECLARE_SHORT_SHARED_PTR(Document)
 }
 
 namespace operation {
+class EntityDelta;
+class Transaction;
+
 class EntityBuilder: public DocumentOperation {
     friend class lc::operation::Base;
+    friend class lc::operation::EntityDelta;
+    friend class lc::operation::Transaction;
 
 public:
     /**
@@ -40,12 +45,23 @@ public:
     virtual void undo() const;
     virtual void redo() const;
 
+    size_t memoryUsage() const override;
+
     /**
      * @brief Apply the operations
      * Apply operations on the entities without updating the document, and clear the stack.
      */
     void processStack();
 
+    /**
+     * @brief Add the entities appended so far to the document before the builder is executed
+     * Used to show the result of a long operation while it is being built. The entities are added with a single
+     * batch event and without undo cycle. They stay part of the builder: executing it adds the remaining entities,
+     * undoing it removes all of them.
+     * @return Amount of entities added to the document
+     */
+    size_t flushEntities();
+
 protected:
     virtual void processInternal();
 
@@ -55,6 +71,7 @@ private:
 
     std::vector<entity::CADEntity_CSPtr> _entitiesThatWhereUpdated;
     std::vector<entity::CADEntity_CSPtr> _entitiesThatNeedsRemoval;
+    size_t _flushedCount;
 };
 
 DECLARE_SHORT_SHARED_PTR(EntityBuilder)
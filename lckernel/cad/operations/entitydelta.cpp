@@ -0,0 +1,114 @@
+#include "entitydelta.h"
+#include "entitybuilder.h"
+#include "cad/storage/document.h"
+
+using namespace lc;
+using namespace lc::operation;
+
+EntityDelta::EntityDelta(storage::Document_SPtr document, const std::string& text) :
+    Undoable(text),
+    _document(std::move(document)) {
+}
+
+storage::Document_SPtr EntityDelta::document() const {
+    return _document;
+}
+
+void EntityDelta::append(const entity::CADEntity_CSPtr& before, const entity::CADEntity_CSPtr& after) {
+    if (before == nullptr && after == nullptr) {
+        return;
+    }
+
+    auto id = before != nullptr ? before->id() : after->id();
+    auto it = _index.find(id);
+
+    if (it != _index.end()) {
+        _changes[it->second].after = after;
+        return;
+    }
+
+    _index.emplace(id, _changes.size());
+    _changes.push_back({before, after});
+}
+
+bool EntityDelta::append(const Undoable_SPtr& undoable) {
+    auto delta = std::dynamic_pointer_cast<const EntityDelta>(undoable);
+    if (delta != nullptr) {
+        for (const auto& change : delta->_changes) {
+            append(change.before, change.after);
+        }
+
+        return true;
+    }
+
+    auto builder = std::dynamic_pointer_cast<const EntityBuilder>(undoable);
+    if (builder != nullptr) {
+        // Removals are applied first, and restored last during undo
+        for (const auto& entity : builder->_entitiesThatNeedsRemoval) {
+            append(entity, nullptr);
+        }
+
+        std::unordered_map<ID_DATATYPE, entity::CADEntity_CSPtr> updated;
+        for (const auto& entity : builder->_entitiesThatWhereUpdated) {
+            updated[entity->id()] = entity;
+        }
+
+        for (const auto& entity : builder->_workingBuffer) {
+            auto it = updated.find(entity->id());
+            append(it != updated.end() ? it->second : nullptr, entity);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+size_t EntityDelta::size() const {
+    return _changes.size();
+}
+
+void EntityDelta::undo() const {
+    std::vector<entity::CADEntity_CSPtr> restored;
+    std::vector<entity::CADEntity_CSPtr> created;
+
+    for (const auto& change : _changes) {
+        if (change.before != nullptr) {
+            restored.push_back(change.before);
+        }
+        else if (change.after != nullptr) {
+            created.push_back(change.after);
+        }
+    }
+
+    _document->applyBatch(restored, created, {});
+}
+
+void EntityDelta::redo() const {
+    std::vector<entity::CADEntity_CSPtr> changed;
+    std::vector<entity::CADEntity_CSPtr> removed;
+
+    for (const auto& change : _changes) {
+        if (change.after != nullptr) {
+            changed.push_back(change.after);
+        }
+        else if (change.before != nullptr) {
+            removed.push_back(change.before);
+        }
+    }
+
+    _document->applyBatch(changed, removed, {});
+}
+
+size_t EntityDelta::memoryUsage() const {
+    size_t entities = 0;
+
+    for (const auto& change : _changes) {
+        entities += (change.before != nullptr) + (change.after != nullptr);
+    }
+
+    return sizeof(EntityDelta) +
+           _changes.capacity() * sizeof(Change) +
+           _index.size() * (sizeof(std::pair<ID_DATATYPE, size_t>) + 2 * sizeof(void*)) +
+           entities * ENTITY_MEMORY_ESTIMATE;
+}
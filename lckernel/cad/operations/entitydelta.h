@@ -0,0 +1,70 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+#include "undoable.h"
+
+namespace lc {
+namespace storage {
+class Document;
+DECLARE_SHORT_SHARED_PTR(Document)
+}
+
+namespace operation {
+/**
+ * @brief Net change of a set of entities in a document
+ * Stores for each changed entity its version before and after the change, allowing to
+ * compact a sequence of undoable operations into a single one.
+ * Undo and redo are applied as a single batch on the document.
+ *
+ * @param document
+ * @param text
+ */
+class EntityDelta : public Undoable {
+public:
+    EntityDelta(storage::Document_SPtr document, const std::string& text);
+
+    storage::Document_SPtr document() const;
+
+    /**
+     * @brief Record the change of an entity
+     * When the entity was already changed, the first version before and the last version after are kept
+     * @param before Entity before the change, nullptr if it didn't exist
+     * @param after Entity after the change, nullptr if it was removed
+     */
+    void append(const entity::CADEntity_CSPtr& before, const entity::CADEntity_CSPtr& after);
+
+    /**
+     * @brief Record the changes of an operation which was applied after the ones of this delta
+     * @param undoable EntityBuilder or EntityDelta
+     * @return false if the changes of the operation can't be represented as a delta
+     */
+    bool append(const Undoable_SPtr& undoable);
+
+    /**
+     * @brief Return the amount of changed entities
+     */
+    size_t size() const;
+
+    void undo() const override;
+    void redo() const override;
+
+    size_t memoryUsage() const override;
+
+private:
+    struct Change {
+        entity::CADEntity_CSPtr before;
+        entity::CADEntity_CSPtr after;
+    };
+
+    storage::Document_SPtr _document;
+    std::vector<Change> _changes;
+    std::unordered_map<ID_DATATYPE, size_t> _index;
+};
+
+DECLARE_SHORT_SHARED_PTR(EntityDelta)
+}
+}
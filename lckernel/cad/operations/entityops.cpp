@@ -2,9 +2,44 @@
 #include "cad/storage/document.h"
 
 #include "cad/storage/storagemanager.h"
+#include "cad/tools/threadpool.h"
+
+#include <algorithm>
+#include <iterator>
+
 using namespace lc;
 using namespace lc::operation;
 
+namespace {
+/**
+ * Minimal amount of entities a thread gets when a transformation is spread over the thread pool
+ */
+const size_t TRANSFORM_CHUNK_SIZE = 512;
+
+/**
+ * Replace each entity by the result of transform, keeping the order of the entities.
+ * Entities needing special handling (inserts, custom entities) connect to the document when created,
+ * they are transformed on the calling thread. All other entities are spread over the thread pool.
+ * Transformations keep the entity family, so the tag of the result matches the tag of the source.
+ */
+template<typename Transform>
+void transformEntities(std::vector<entity::CADEntity_CSPtr>& entities, const Transform& transform) {
+    for (auto& entity : entities) {
+        if (entity->entityTag() != entity::EntityTag::Generic) {
+            entity = transform(entity);
+        }
+    }
+
+    tools::ThreadPool::instance().parallelFor(entities.size(), TRANSFORM_CHUNK_SIZE, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            if (entities[i]->entityTag() == entity::EntityTag::Generic) {
+                entities[i] = transform(entities[i]);
+            }
+        }
+    });
+}
+}
+
 /********************************************************************************************************/
 /** Base                                                                                              ***/
 /********************************************************************************************************/
@@ -12,11 +47,11 @@ Begin::Begin() :  Base() {
 }
 
 std::vector<entity::CADEntity_CSPtr> Begin::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
+    const std::vector<Base_SPtr>& operationStack) {
     _entities.insert(_entities.end(), entities.begin(), entities.end());
     return entities;
 }
@@ -33,36 +68,19 @@ Loop::Loop(const int numTimes) :  Base(), _numTimes(numTimes) {
 }
 
 std::vector<entity::CADEntity_CSPtr> Loop::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
-    std::vector<entity::CADEntity_CSPtr> final;
-
-    // Find the start
-    std::vector<entity::CADEntity_CSPtr> _start;
-
-    for (const auto& base : operationStack) {
-        /// @todo can we get rid of dynamic_cast??
-        auto begin = dynamic_cast<const lc::operation::Begin*>(base.get());
-
-        if (begin != nullptr) {
-            auto entities = begin->getEntities();
-            _start.insert(_start.end(), entities.begin(), entities.end());
-        }
-    }
-
-    // run the operation queue
-    std::vector<entity::CADEntity_CSPtr> entitySet2(entities);
-
+    const std::vector<Base_SPtr>& operationStack) {
+    // run the operation queue, each operation transforms the set it receives
     for (int n = 0; n < _numTimes - 1; n++) {
         for (const auto& base : operationStack) {
-            entitySet2 = base->process(document, entitySet2, workingBuffer, removals, operationStack);
+            entities = base->process(document, std::move(entities), workingBuffer, removals, operationStack);
         }
     }
 
-    return entitySet2;
+    return entities;
 }
 
 /********************************************************************************************************/
@@ -74,19 +92,16 @@ Move::Move(geo::Coordinate offset) :
 }
 
 std::vector<entity::CADEntity_CSPtr>  Move::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
-
-    for (const auto& entity : entities) {
-        auto e = entity->move(_offset);
-        newQueue.push_back(e);
-    }
+    const std::vector<Base_SPtr>& operationStack) {
+    transformEntities(entities, [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->move(_offset);
+    });
 
-    return newQueue;
+    return entities;
 }
 
 /********************************************************************************************************/
@@ -98,20 +113,18 @@ Copy::Copy(geo::Coordinate offset) :
 }
 
 std::vector<entity::CADEntity_CSPtr> Copy::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
+    const std::vector<Base_SPtr>& operationStack) {
+    workingBuffer.insert(workingBuffer.end(), entities.begin(), entities.end());
 
-    for (const auto& entity : entities) {
-        auto e = entity->copy(_offset);
-        workingBuffer.push_back(entity);
-        newQueue.push_back(e);
-    }
+    transformEntities(entities, [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->copy(_offset);
+    });
 
-    return newQueue;
+    return entities;
 }
 
 /********************************************************************************************************/
@@ -124,19 +137,16 @@ Scale::Scale(geo::Coordinate scale_center, geo::Coordinate scale_factor) :
 }
 
 std::vector<entity::CADEntity_CSPtr> Scale::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
+    const std::vector<Base_SPtr>& operationStack) {
+    transformEntities(entities, [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->scale(_scale_center, _scale_factor);
+    });
 
-    for (const auto& entity : entities) {
-        auto e = entity->scale(_scale_center, _scale_factor);
-        newQueue.push_back(e);
-    }
-
-    return newQueue;
+    return entities;
 }
 
 /********************************************************************************************************/
@@ -149,19 +159,16 @@ Rotate::Rotate(geo::Coordinate rotation_center, const double rotation_angle) :
 }
 
 std::vector<entity::CADEntity_CSPtr> Rotate::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
+    const std::vector<Base_SPtr>& operationStack) {
+    transformEntities(entities, [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->rotate(_rotation_center, _rotation_angle);
+    });
 
-    for (const auto& entity : entities) {
-        auto e = entity->rotate(_rotation_center, _rotation_angle);
-        newQueue.push_back(e);
-    }
-
-    return newQueue;
+    return entities;
 }
 
 /********************************************************************************************************/
@@ -171,13 +178,13 @@ Push::Push() : Base() {
 }
 
 std::vector<entity::CADEntity_CSPtr> Push::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
-    std::vector<entity::CADEntity_CSPtr> newQueue(workingBuffer);
-    newQueue.insert(newQueue.end(), entities.begin(), entities.end());
+    const std::vector<Base_SPtr>& operationStack) {
+    std::vector<entity::CADEntity_CSPtr> newQueue(std::move(workingBuffer));
+    newQueue.insert(newQueue.end(), std::make_move_iterator(entities.begin()), std::make_move_iterator(entities.end()));
     workingBuffer.clear();
     return newQueue;
 }
@@ -191,23 +198,18 @@ SelectByLayer::SelectByLayer(meta::Layer_CSPtr layer) :
 }
 
 std::vector<entity::CADEntity_CSPtr> SelectByLayer::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
+    const std::vector<Base_SPtr>& operationStack) {
+    // Move the selected entities at the end of the buffer in one pass, keeping the order of both parts
+    auto selected = std::stable_partition(workingBuffer.begin(), workingBuffer.end(), [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->layer() != _layer;
+    });
 
-    std::vector<entity::CADEntity_CSPtr> e;
-
-    for(auto it = workingBuffer.begin(); it != workingBuffer.end();) {
-        if((*it)->layer() == _layer) {
-            e.push_back(*it);
-            it = workingBuffer.erase(it);
-        }
-        else {
-            it++;
-        }
-    }
+    std::vector<entity::CADEntity_CSPtr> e(std::make_move_iterator(selected), std::make_move_iterator(workingBuffer.end()));
+    workingBuffer.erase(selected, workingBuffer.end());
 
     return e;
 }
@@ -220,11 +222,11 @@ Remove::Remove() : Base() {
 }
 
 std::vector<entity::CADEntity_CSPtr> Remove::process(
-    const std::shared_ptr<storage::Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entities,
+    const storage::Document_SPtr& document,
+    std::vector<entity::CADEntity_CSPtr> entities,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> operationStack) {
+    const std::vector<Base_SPtr>& operationStack) {
     removals.insert(removals.end(), entities.begin(), entities.end());
     std::vector<entity::CADEntity_CSPtr> e;
     return e;
@@ -23,12 +23,21 @@ class Base {
 public:
     virtual ~Base() = default;
 
+    /**
+     * @brief Apply the operation
+     * @param document Document the builder works on
+     * @param entities Entities returned by the previous operation, moved in so they can be transformed in place
+     * @param workingBuffer Entities which will be added to the document
+     * @param removals Entities which will be removed from the document
+     * @param operationStack Operations preceding this one in the builder
+     * @return Entities passed to the next operation, in the same order as the input entities
+     */
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
-        const std::vector<entity::CADEntity_CSPtr> entities,
+        const storage::Document_SPtr& document,
+        std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack
+        const std::vector<Base_SPtr>& operationStack
     ) = 0;
 };
 
@@ -56,11 +65,11 @@ public:
     virtual ~Loop() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const storage::Document_SPtr document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 
 private:
     int _numTimes;
@@ -92,11 +101,11 @@ public:
     virtual ~Begin() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 
     std::vector<entity::CADEntity_CSPtr> getEntities() const;
 
@@ -130,11 +139,11 @@ public:
     virtual ~Move() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 
 private:
     geo::Coordinate _offset;
@@ -166,11 +175,11 @@ public:
     virtual ~Copy() = default;
 
     std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack) override;
+        const std::vector<Base_SPtr>& operationStack) override;
 
 private:
     geo::Coordinate _offset;
@@ -202,11 +211,11 @@ public:
     virtual ~Rotate() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 
 private:
     geo::Coordinate _rotation_center;
@@ -221,11 +230,11 @@ public:
     virtual ~Scale() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 
 private:
     geo::Coordinate _scale_center;
@@ -260,11 +269,11 @@ public:
     virtual ~Push() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
         std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 };
 DECLARE_SHORT_SHARED_PTR(Push)
 
@@ -292,11 +301,11 @@ public:
     virtual ~SelectByLayer() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
-        std::vector <entity::CADEntity_CSPtr>& workingBuffer,
+        std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 
 private:
     meta::Layer_CSPtr _layer;
@@ -327,11 +336,11 @@ public:
     virtual ~Remove() = default;
 
     virtual std::vector<entity::CADEntity_CSPtr> process(
-        const std::shared_ptr<storage::Document> document,
+        const storage::Document_SPtr& document,
         std::vector<entity::CADEntity_CSPtr> entities,
-        std::vector <entity::CADEntity_CSPtr>& workingBuffer,
+        std::vector<entity::CADEntity_CSPtr>& workingBuffer,
         std::vector<entity::CADEntity_CSPtr>& removals,
-        const std::vector<Base_SPtr> operationStack);
+        const std::vector<Base_SPtr>& operationStack);
 };
 DECLARE_SHORT_SHARED_PTR(Remove)
 }
@@ -33,6 +33,9 @@ RemoveLayer::RemoveLayer(std::shared_ptr<storage::Document> document, meta::Laye
 }
 
 void RemoveLayer::processInternal() {
+    // Entities which are not loaded yet would keep a layer which isn't part of the document
+    document()->loadAll();
+
     auto le = document()->entityContainer().entitiesByLayer(_layer).asVector();
     _entities.insert(_entities.end(), le.begin(), le.end());
 
@@ -70,6 +73,7 @@ ReplaceLayer::ReplaceLayer(std::shared_ptr<storage::Document> document, meta::La
 }
 
 void ReplaceLayer::processInternal() {
+    document()->loadAll();
     redo();
 }
 
@@ -0,0 +1,87 @@
+#include "transaction.h"
+#include "cad/storage/document.h"
+
+#include <iterator>
+
+using namespace lc;
+using namespace operation;
+
+Transaction::Transaction(storage::Document_SPtr document, const std::string& description) :
+    DocumentOperation(std::move(document), description),
+    _operationCount(0) {
+}
+
+void Transaction::append(DocumentOperation_SPtr operation) {
+    if (operation->document() != document()) {
+        throw std::runtime_error("Operation should have the same document");
+    }
+
+    _operationCount++;
+
+    auto builder = std::dynamic_pointer_cast<EntityBuilder>(operation);
+    if (builder != nullptr && builder->_flushedCount == 0) {
+        builder->processStack();
+
+        if (_entities != nullptr && merge(*builder)) {
+            return;
+        }
+
+        _entities = std::make_shared<EntityBuilder>(document());
+        _operations.push_back(_entities);
+        merge(*builder);
+        return;
+    }
+
+    _entities = nullptr;
+    _operations.push_back(std::move(operation));
+}
+
+bool Transaction::merge(EntityBuilder& builder) {
+    // Removals are applied before additions, an entity added earlier in the transaction would be added back
+    if (!builder._entitiesThatNeedsRemoval.empty() && !_entities->_workingBuffer.empty()) {
+        return false;
+    }
+
+    auto& workingBuffer = _entities->_workingBuffer;
+    auto& removals = _entities->_entitiesThatNeedsRemoval;
+
+    workingBuffer.insert(workingBuffer.end(),
+                         std::make_move_iterator(builder._workingBuffer.begin()),
+                         std::make_move_iterator(builder._workingBuffer.end()));
+    removals.insert(removals.end(),
+                    std::make_move_iterator(builder._entitiesThatNeedsRemoval.begin()),
+                    std::make_move_iterator(builder._entitiesThatNeedsRemoval.end()));
+
+    builder._workingBuffer.clear();
+    builder._entitiesThatNeedsRemoval.clear();
+
+    return true;
+}
+
+void Transaction::processInternal() {
+    for (const auto& operation : _operations) {
+        operation->processInternal();
+    }
+}
+
+void Transaction::undo() const {
+    for (auto it = _operations.rbegin(); it != _operations.rend(); it++) {
+        (*it)->undo();
+    }
+}
+
+void Transaction::redo() const {
+    for (const auto& operation : _operations) {
+        operation->redo();
+    }
+}
+
+size_t Transaction::memoryUsage() const {
+    auto bytes = sizeof(Transaction) + _operations.capacity() * sizeof(DocumentOperation_SPtr);
+
+    for (const auto& operation : _operations) {
+        bytes += operation->memoryUsage();
+    }
+
+    return bytes;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include "documentoperation.h"
+#include "entitybuilder.h"
+
+namespace lc {
+namespace operation {
+/**
+ * @brief Group the operations executed during a storage::Document::batch() call
+ * The operations are not applied when they are appended, the transaction applies all of them when it is executed,
+ * with a single commit and a single undo cycle.
+ * Consecutive EntityBuilders are merged into one, so their entities are added and removed with a single batch event.
+ * The stack of an EntityBuilder is processed when it is appended, against the document as it was before the transaction.
+ */
+class Transaction : public DocumentOperation {
+public:
+    Transaction(storage::Document_SPtr document, const std::string& description);
+
+    /**
+     * @brief Add an operation to the transaction
+     * @param operation Operation to add, it should have the same document than the transaction
+     */
+    void append(DocumentOperation_SPtr operation);
+
+    /**
+     * @brief Return the amount of operations appended to the transaction
+     */
+    size_t operationCount() const {
+        return _operationCount;
+    }
+
+    void undo() const override;
+    void redo() const override;
+
+    size_t memoryUsage() const override;
+
+protected:
+    void processInternal() override;
+
+private:
+    /**
+     * @brief Move the result of an EntityBuilder to the builder collecting the entities
+     * @return false if the builder can't be merged without changing the result
+     */
+    bool merge(EntityBuilder& builder);
+
+    std::vector<DocumentOperation_SPtr> _operations;
+    EntityBuilder_SPtr _entities;
+    size_t _operationCount;
+};
+
+DECLARE_SHORT_SHARED_PTR(Transaction)
+}
+}
@@ -61,6 +61,24 @@ public:
         return _text;
     }
 
+    /*!
+     * \brief Approximate amount of memory kept alive by this operation
+     *
+     * Used by the undo manager to keep its history within a memory budget.
+     * Operations holding entities should add them using ENTITY_MEMORY_ESTIMATE.
+     *
+     * @return size in bytes
+     */
+    virtual size_t memoryUsage() const {
+        return sizeof(Undoable) + _text.capacity();
+    }
+
+protected:
+    /*!
+     * \brief Rough size of an entity kept alive by an operation
+     */
+    static const size_t ENTITY_MEMORY_ESTIMATE = 256;
+
 private:
     std::string _text;
 };
@@ -1,4 +1,5 @@
 #include "arc.h"
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -110,10 +111,10 @@ std::vector<CADEntity_CSPtr> Arc::splitEntity(const geo::Coordinate& coord) cons
     // check if angle is between start and end
     if (abs(coord.distanceTo(this->center())-this->radius()) < LCTOLERANCE)
         if (isAngleBetween(angle)) {
-            auto newArc = std::make_shared<Arc>(this->center(), this->radius(), this->startAngle(), angle,
+            auto newArc = tools::makePooled<Arc>(this->center(), this->radius(), this->startAngle(), angle,
                                                 this->CCW(), layer(), metaInfo(), block());
             out.push_back(newArc);
-            newArc = std::make_shared<Arc>(this->center(), this->radius(), angle, this->endAngle(),
+            newArc = tools::makePooled<Arc>(this->center(), this->radius(), angle, this->endAngle(),
                                            this->CCW(), layer(), metaInfo(), block());
             out.push_back(newArc);
         }
@@ -129,20 +130,20 @@ lc::geo::Coordinate Arc::representingPoint() const {
 
 
 CADEntity_CSPtr Arc::move(const geo::Coordinate &offset) const {
-    auto newArc = std::make_shared<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
+    auto newArc = tools::makePooled<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
                                         this->CCW(), layer(), metaInfo(), block());
     newArc->setID(this->id());
     return newArc;
 }
 
 CADEntity_CSPtr Arc::copy(const geo::Coordinate &offset) const {
-    auto newArc = std::make_shared<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
+    auto newArc = tools::makePooled<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
                                         this->CCW(), layer(), metaInfo(), block());
     return newArc;
 }
 
 CADEntity_CSPtr Arc::rotate(const geo::Coordinate &rotation_center, const double rotation_angle) const {
-    auto newArc = std::make_shared<Arc>(this->center().rotate(rotation_center, rotation_angle),
+    auto newArc = tools::makePooled<Arc>(this->center().rotate(rotation_center, rotation_angle),
                                         this->radius(), this->startAngle() + rotation_angle,
                                         this->endAngle() + rotation_angle, this->CCW(), layer(), metaInfo(), block());
     newArc->setID(this->id());
@@ -150,7 +151,7 @@ CADEntity_CSPtr Arc::rotate(const geo::Coordinate &rotation_center, const double
 }
 
 CADEntity_CSPtr Arc::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
-    auto newArc = std::make_shared<Arc>(this->center().scale(scale_center, scale_factor),
+    auto newArc = tools::makePooled<Arc>(this->center().scale(scale_center, scale_factor),
                                         this->radius() * fabs(scale_factor.x()),
                                         this->startAngle(), this->endAngle(), this->CCW(), layer(), metaInfo(), block());
     newArc->setID(this->id());
@@ -161,7 +162,7 @@ CADEntity_CSPtr Arc::scale(const geo::Coordinate &scale_center, const geo::Coord
 CADEntity_CSPtr Arc::mirror(const geo::Coordinate &axis1, const geo::Coordinate &axis2) const {
     double a= (axis2- axis1).angle()*2;
 
-    auto newArc = std::make_shared<Arc>(this->center().mirror(axis1,axis2),
+    auto newArc = tools::makePooled<Arc>(this->center().mirror(axis1,axis2),
                                         this->radius(),
                                         lc::maths::Math::correctAngle(a - this->startAngle()),
                                         lc::maths::Math::correctAngle(a - this->endAngle()),
@@ -176,7 +177,7 @@ const geo::Area Arc::boundingBox() const {
 }
 
 CADEntity_CSPtr Arc::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newArc = std::make_shared<Arc>(this->center(), this->radius(), this->startAngle(), this->endAngle(),
+    auto newArc = tools::makePooled<Arc>(this->center(), this->radius(), this->startAngle(), this->endAngle(),
                                         this->CCW(), layer, metaInfo, block);
     newArc->setID(this->id());
     return newArc;
@@ -195,7 +196,7 @@ std::map<unsigned int, lc::geo::Coordinate> Arc::dragPoints() const {
 
 CADEntity_CSPtr Arc::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {//bulge expenced down
     try {
-        auto newEntity = std::make_shared<Arc>(geo::Arc::createArcBulge(dragPoints.at(0), dragPoints.at(1), bulge()), layer(), metaInfo());
+        auto newEntity = tools::makePooled<Arc>(geo::Arc::createArcBulge(dragPoints.at(0), dragPoints.at(1), bulge()), layer(), metaInfo());
         newEntity->setID(id());
         return newEntity;
     }
@@ -245,7 +246,7 @@ CADEntity_CSPtr Arc::setProperties(const PropertiesMap& propertiesMap) const {
         }
     }
 
-    auto arcEntity = std::make_shared<Arc>(centerp, radiusp, startAnglep, endAnglep, isCCWp, layer(), metaInfo(), block());
+    auto arcEntity = tools::makePooled<Arc>(centerp, radiusp, startAnglep, endAnglep, isCCWp, layer(), metaInfo(), block());
     arcEntity->setID(this->id());
     return arcEntity;
 }
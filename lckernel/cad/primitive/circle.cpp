@@ -3,6 +3,7 @@
 #include <algorithm>
 #include "cad/interface/metatype.h"
 #include "arc.h"
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -72,7 +73,7 @@ std::vector<CADEntity_CSPtr> Circle::splitEntity(const geo::Coordinate& coord) c
     std::vector<CADEntity_CSPtr> out;
     auto angle = (coord-center()).angle();
     if (abs(coord.distanceTo(this->center())-this->radius()) < LCTOLERANCE) {
-        auto newArc = std::make_shared<Arc>(this->center(), this->radius(), angle, angle-1.5*LCTOLERANCE,
+        auto newArc = tools::makePooled<Arc>(this->center(), this->radius(), angle, angle-1.5*LCTOLERANCE,
                                             true, layer(), metaInfo(), block());
         out.push_back(newArc);
     }
@@ -84,18 +85,18 @@ lc::geo::Coordinate Circle::representingPoint() const {
 }
 
 CADEntity_CSPtr Circle::move(const geo::Coordinate &offset) const {
-    auto newCircle = std::make_shared<Circle>(this->center() + offset, this->radius(), layer(), metaInfo(), block());
+    auto newCircle = tools::makePooled<Circle>(this->center() + offset, this->radius(), layer(), metaInfo(), block());
     newCircle->setID(this->id());
     return newCircle;
 }
 
 CADEntity_CSPtr Circle::copy(const geo::Coordinate &offset) const {
-    auto newCircle = std::make_shared<Circle>(this->center() + offset, this->radius(), layer(), metaInfo(), block());
+    auto newCircle = tools::makePooled<Circle>(this->center() + offset, this->radius(), layer(), metaInfo(), block());
     return newCircle;
 }
 
 CADEntity_CSPtr Circle::rotate(const geo::Coordinate &rotation_center, const double rotation_angle) const {
-    auto newCircle = std::make_shared<Circle>(this->center().rotate(rotation_center, rotation_angle), this->radius(),
+    auto newCircle = tools::makePooled<Circle>(this->center().rotate(rotation_center, rotation_angle), this->radius(),
                      layer(), metaInfo(), block());
     newCircle->setID(this->id());
     return newCircle;
@@ -104,14 +105,14 @@ CADEntity_CSPtr Circle::rotate(const geo::Coordinate &rotation_center, const dou
 CADEntity_CSPtr Circle::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
     /// @todo return ellipse if scalefactor.x != scalefactor.y
 
-    auto newCircle = std::make_shared<Circle>(this->center().scale(scale_center, scale_factor),
+    auto newCircle = tools::makePooled<Circle>(this->center().scale(scale_center, scale_factor),
                      this->radius() * fabs(scale_factor.x()), layer(), metaInfo(), block());
     newCircle->setID(this->id());
     return newCircle;
 }
 
 CADEntity_CSPtr Circle::mirror(const geo::Coordinate &axis1, const geo::Coordinate &axis2) const {
-    auto newCircle = std::make_shared<Circle>(this->center().mirror(axis1, axis2),
+    auto newCircle = tools::makePooled<Circle>(this->center().mirror(axis1, axis2),
                      this->radius(), layer(), metaInfo(), block());
     newCircle->setID(this->id());
     return newCircle;
@@ -123,7 +124,7 @@ const geo::Area Circle::boundingBox() const {
 }
 
 CADEntity_CSPtr Circle::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Circle>(this->center(), this->radius(), layer, metaInfo, block);
+    auto newEntity = tools::makePooled<Circle>(this->center(), this->radius(), layer, metaInfo, block);
     newEntity->setID(this->id());
     return newEntity;
 }
@@ -152,7 +153,7 @@ CADEntity_CSPtr Circle::setProperties(const PropertiesMap& propertiesMap) const
         }
     }
 
-    auto newCircle = std::make_shared<Circle>(centerp, radiusp, layer(), metaInfo(), block());
+    auto newCircle = tools::makePooled<Circle>(centerp, radiusp, layer(), metaInfo(), block());
     newCircle->setID(this->id());
     return newCircle;
 }
@@ -10,3 +10,7 @@ lc::entity::CustomEntity::CustomEntity(const lc::entity::Insert_CSPtr& insert, b
 lc::entity::CADEntity_CSPtr lc::entity::CustomEntity::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     return shared_from_this();
 }
+
+lc::entity::EntityTag lc::entity::CustomEntity::entityTag() const {
+    return EntityTag::CustomEntity;
+}
@@ -20,6 +20,8 @@ public:
     std::map<unsigned int, geo::Coordinate> dragPoints() const override = 0;
     CADEntity_CSPtr setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const override;
 
+    EntityTag entityTag() const override;
+
     CADEntity_CSPtr move(const geo::Coordinate& offset) const override = 0;
     CADEntity_CSPtr copy(const geo::Coordinate& offset) const override = 0;
     CADEntity_CSPtr rotate(const geo::Coordinate& rotation_center, double rotation_angle) const override = 0;
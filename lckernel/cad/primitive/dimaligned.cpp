@@ -1,6 +1,7 @@
 #include <map>
 #include "cad/primitive/dimaligned.h"
 #include "dimaligned.h"
+#include "cad/tools/poolallocator.h"
 
 
 using namespace lc;
@@ -47,7 +48,7 @@ DimAligned::DimAligned(const lc::builder::DimAlignedBuilder& builder) :
 }
 
 CADEntity_CSPtr DimAligned::move(const geo::Coordinate& offset) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint() + offset,
+    auto newDimAligned = tools::makePooled<DimAligned>(this->definitionPoint() + offset,
                          this->middleOfText() + offset,
                          this->attachmentPoint(),
                          this->textAngle(),
@@ -63,7 +64,7 @@ CADEntity_CSPtr DimAligned::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimAligned::copy(const geo::Coordinate& offset) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint() + offset,
+    auto newDimAligned = tools::makePooled<DimAligned>(this->definitionPoint() + offset,
                          this->middleOfText() + offset,
                          this->attachmentPoint(),
                          this->textAngle(),
@@ -78,7 +79,7 @@ CADEntity_CSPtr DimAligned::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimAligned::rotate(const geo::Coordinate& rotation_center, double rotation_angle) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+    auto newDimAligned = tools::makePooled<DimAligned>(this->definitionPoint().rotate(rotation_center, rotation_angle),
                          this->middleOfText().rotate(rotation_center, rotation_angle),
                          this->attachmentPoint(),
                          this->textAngle(),
@@ -94,7 +95,7 @@ CADEntity_CSPtr DimAligned::rotate(const geo::Coordinate& rotation_center, doubl
 }
 
 CADEntity_CSPtr DimAligned::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint().scale(scale_center, scale_factor),
+    auto newDimAligned = tools::makePooled<DimAligned>(this->definitionPoint().scale(scale_center, scale_factor),
                          this->middleOfText().scale(scale_center, scale_factor),
                          this->attachmentPoint(),
                          this->textAngle(),
@@ -112,7 +113,7 @@ CADEntity_CSPtr DimAligned::scale(const geo::Coordinate& scale_center, const geo
 CADEntity_CSPtr DimAligned::mirror(const geo::Coordinate& axis1,
                                    const geo::Coordinate& axis2) const {
 
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint().mirror(axis1, axis2),
+    auto newDimAligned = tools::makePooled<DimAligned>(this->definitionPoint().mirror(axis1, axis2),
                          this->middleOfText().mirror(axis1, axis2),
                          this->attachmentPoint(),
                          this->textAngle(),
@@ -147,7 +148,7 @@ const geo::Area DimAligned::boundingBox() const {
 }
 
 CADEntity_CSPtr DimAligned::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newDimAligned = std::make_shared<DimAligned>(
+    auto newDimAligned = tools::makePooled<DimAligned>(
                              this->definitionPoint(),
                              this->middleOfText(),
                              this->attachmentPoint(),
@@ -187,7 +188,7 @@ std::map<unsigned int, geo::Coordinate> DimAligned::dragPoints() const {
 
 CADEntity_CSPtr DimAligned::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimAligned>(dragPoints.at(0),
+        auto newEntity = tools::makePooled<DimAligned>(dragPoints.at(0),
                          dragPoints.at(1),
                          attachmentPoint(),
                          textAngle(),
@@ -235,7 +236,7 @@ CADEntity_CSPtr DimAligned::setProperties(const PropertiesMap& propertiesMap) co
         }
     }
 
-    auto newDimAligned = std::make_shared<DimAligned>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
+    auto newDimAligned = tools::makePooled<DimAligned>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
                          lineSpacingStyle(), explicitValuep, definitionPoint2p, definitionPoint3p, layer(), metaInfo(), block());
     newDimAligned->setID(this->id());
     return newDimAligned;
@@ -1,5 +1,6 @@
 #include "cad/primitive/dimangular.h"
 #include "dimangular.h"
+#include "cad/tools/poolallocator.h"
 
 
 using namespace lc;
@@ -56,7 +57,7 @@ DimAngular::DimAngular(const lc::builder::DimAngularBuilder& builder) :
 
 
 CADEntity_CSPtr DimAngular::move(const geo::Coordinate& offset) const {
-    auto newDimAngular = std::make_shared<DimAngular>(
+    auto newDimAngular = tools::makePooled<DimAngular>(
                              definitionPoint() + offset,
                              middleOfText() + offset,
                              attachmentPoint(),
@@ -76,7 +77,7 @@ CADEntity_CSPtr DimAngular::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimAngular::copy(const geo::Coordinate& offset) const {
-    auto newDimAngular = std::make_shared<DimAngular>(
+    auto newDimAngular = tools::makePooled<DimAngular>(
                              definitionPoint() + offset,
                              middleOfText() + offset,
                              attachmentPoint(),
@@ -95,7 +96,7 @@ CADEntity_CSPtr DimAngular::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimAngular::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimAngular = std::make_shared<DimAngular>(
+    auto newDimAngular = tools::makePooled<DimAngular>(
                              definitionPoint().rotate(rotation_center, rotation_angle),
                              middleOfText().rotate(rotation_center, rotation_angle),
                              attachmentPoint(),
@@ -115,7 +116,7 @@ CADEntity_CSPtr DimAngular::rotate(const geo::Coordinate& rotation_center, const
 }
 
 CADEntity_CSPtr DimAngular::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimAngular = std::make_shared<DimAngular>(
+    auto newDimAngular = tools::makePooled<DimAngular>(
                              definitionPoint().scale(scale_center, scale_factor),
                              middleOfText().scale(scale_center, scale_factor),
                              attachmentPoint(),
@@ -135,7 +136,7 @@ CADEntity_CSPtr DimAngular::scale(const geo::Coordinate& scale_center, const geo
 }
 
 CADEntity_CSPtr DimAngular::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
-    auto newDimAngular = std::make_shared<DimAngular>(
+    auto newDimAngular = tools::makePooled<DimAngular>(
                              definitionPoint().mirror(axis1,axis2),
                              middleOfText().mirror(axis1,axis2),
                              attachmentPoint(),
@@ -162,7 +163,7 @@ const geo::Area DimAngular::boundingBox() const {
 }
 
 CADEntity_CSPtr DimAngular::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newDimAngular = std::make_shared<DimAngular>(
+    auto newDimAngular = tools::makePooled<DimAngular>(
                              definitionPoint(),
                              middleOfText(),
                              attachmentPoint(),
@@ -214,7 +215,7 @@ std::map<unsigned int, geo::Coordinate> DimAngular::dragPoints() const {
 
 CADEntity_CSPtr DimAngular::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimAngular>(
+        auto newEntity = tools::makePooled<DimAngular>(
                              dragPoints.at(0),
                              dragPoints.at(1),
                              attachmentPoint(),
@@ -279,7 +280,7 @@ CADEntity_CSPtr DimAngular::setProperties(const PropertiesMap& propertiesMap) co
         }
     }
 
-    auto newDimAngular = std::make_shared<DimAngular>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
+    auto newDimAngular = tools::makePooled<DimAngular>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
                          lineSpacingStyle(), explicitValuep, defLine11p, defLine12p,defLine21p, defLine22p, layer(), metaInfo(), block());
     newDimAngular->setID(this->id());
     return newDimAngular;
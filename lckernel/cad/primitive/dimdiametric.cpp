@@ -1,5 +1,6 @@
 #include "cad/primitive/dimdiametric.h"
 #include "dimdiametric.h"
+#include "cad/tools/poolallocator.h"
 
 
 using namespace lc;
@@ -45,7 +46,7 @@ DimDiametric::DimDiametric(const lc::builder::DimDiametricBuilder& builder) :
 }
 
 CADEntity_CSPtr DimDiametric::move(const geo::Coordinate& offset) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint() + offset,
+    auto newDimDiametric = tools::makePooled<DimDiametric>(this->definitionPoint() + offset,
                            this->middleOfText() + offset,
                            this->attachmentPoint(),
                            this->textAngle(),
@@ -60,7 +61,7 @@ CADEntity_CSPtr DimDiametric::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimDiametric::copy(const geo::Coordinate& offset) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint() + offset,
+    auto newDimDiametric = tools::makePooled<DimDiametric>(this->definitionPoint() + offset,
                            this->middleOfText() + offset,
                            this->attachmentPoint(),
                            this->textAngle(),
@@ -74,7 +75,7 @@ CADEntity_CSPtr DimDiametric::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimDiametric::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(
+    auto newDimDiametric = tools::makePooled<DimDiametric>(
                                this->definitionPoint().rotate(rotation_center, rotation_angle),
                                this->middleOfText().rotate(rotation_center, rotation_angle),
                                this->attachmentPoint(),
@@ -90,7 +91,7 @@ CADEntity_CSPtr DimDiametric::rotate(const geo::Coordinate& rotation_center, con
 }
 
 CADEntity_CSPtr DimDiametric::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint().scale(scale_center, scale_factor),
+    auto newDimDiametric = tools::makePooled<DimDiametric>(this->definitionPoint().scale(scale_center, scale_factor),
                            this->middleOfText().scale(scale_center, scale_factor),
                            this->attachmentPoint(),
                            this->textAngle(),
@@ -105,7 +106,7 @@ CADEntity_CSPtr DimDiametric::scale(const geo::Coordinate& scale_center, const g
 }
 
 CADEntity_CSPtr DimDiametric::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint().mirror(axis1, axis2),
+    auto newDimDiametric = tools::makePooled<DimDiametric>(this->definitionPoint().mirror(axis1, axis2),
                            this->middleOfText().mirror(axis1, axis2),
                            this->attachmentPoint(),
                            this->textAngle(),
@@ -124,7 +125,7 @@ const geo::Area DimDiametric::boundingBox() const {
 }
 
 CADEntity_CSPtr DimDiametric::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(
+    auto newDimDiametric = tools::makePooled<DimDiametric>(
                                this->definitionPoint(),
                                this->middleOfText(),
                                this->attachmentPoint(),
@@ -163,7 +164,7 @@ std::map<unsigned int, geo::Coordinate> DimDiametric::dragPoints() const {
 
 CADEntity_CSPtr DimDiametric::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimDiametric>(dragPoints.at(0),
+        auto newEntity = tools::makePooled<DimDiametric>(dragPoints.at(0),
                          dragPoints.at(1),
                          attachmentPoint(),
                          textAngle(),
@@ -211,7 +212,7 @@ CADEntity_CSPtr DimDiametric::setProperties(const PropertiesMap& propertiesMap)
         }
     }
 
-    auto newDimDia = std::make_shared<DimDiametric>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
+    auto newDimDia = tools::makePooled<DimDiametric>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
                      lineSpacingStyle(), explicitValuep, definitionPoint2p, leaderp, layer(), metaInfo(), block());
     newDimDia->setID(this->id());
     return newDimDia;
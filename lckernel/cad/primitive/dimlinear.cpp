@@ -1,5 +1,6 @@
 #include "cad/primitive/dimlinear.h"
 #include "dimlinear.h"
+#include "cad/tools/poolallocator.h"
 
 
 using namespace lc;
@@ -53,7 +54,7 @@ DimLinear::DimLinear(const lc::builder::DimLinearBuilder& builder) :
 }
 
 CADEntity_CSPtr DimLinear::move(const geo::Coordinate& offset) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint() + offset,
+    auto newDimLinear = tools::makePooled<DimLinear>(this->definitionPoint() + offset,
                         this->middleOfText() + offset,
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -71,7 +72,7 @@ CADEntity_CSPtr DimLinear::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimLinear::copy(const geo::Coordinate& offset) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint() + offset,
+    auto newDimLinear = tools::makePooled<DimLinear>(this->definitionPoint() + offset,
                         this->middleOfText() + offset,
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -88,7 +89,7 @@ CADEntity_CSPtr DimLinear::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimLinear::rotate(const geo::Coordinate& rotation_center, double rotation_angle) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+    auto newDimLinear = tools::makePooled<DimLinear>(this->definitionPoint().rotate(rotation_center, rotation_angle),
                         this->middleOfText().rotate(rotation_center, rotation_angle),
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -106,7 +107,7 @@ CADEntity_CSPtr DimLinear::rotate(const geo::Coordinate& rotation_center, double
 }
 
 CADEntity_CSPtr DimLinear::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint().scale(scale_center, scale_factor),
+    auto newDimLinear = tools::makePooled<DimLinear>(this->definitionPoint().scale(scale_center, scale_factor),
                         this->middleOfText().scale(scale_center, scale_factor),
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -130,7 +131,7 @@ const geo::Area DimLinear::boundingBox() const {
 }
 
 CADEntity_CSPtr DimLinear::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newDimLinear = std::make_shared<DimLinear>(
+    auto newDimLinear = tools::makePooled<DimLinear>(
                             this->definitionPoint(),
                             this->middleOfText(),
                             this->attachmentPoint(),
@@ -178,7 +179,7 @@ std::map<unsigned int, geo::Coordinate> DimLinear::dragPoints() const {
 
 CADEntity_CSPtr DimLinear::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimLinear>(dragPoints.at(0),
+        auto newEntity = tools::makePooled<DimLinear>(dragPoints.at(0),
                          dragPoints.at(1),
                          attachmentPoint(),
                          textAngle(),
@@ -236,7 +237,7 @@ CADEntity_CSPtr DimLinear::setProperties(const PropertiesMap& propertiesMap) con
         }
     }
 
-    auto newDimLin = std::make_shared<DimLinear>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
+    auto newDimLin = tools::makePooled<DimLinear>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
                      lineSpacingStyle(), explicitValuep, definitionPoint2p, definitionPoint3p, anglep, obliquep, layer(), metaInfo(), block());
     newDimLin->setID(this->id());
     return newDimLin;
@@ -1,5 +1,6 @@
 #include "cad/primitive/dimradial.h"
 #include "dimradial.h"
+#include "cad/tools/poolallocator.h"
 
 
 using namespace lc;
@@ -45,7 +46,7 @@ DimRadial::DimRadial(const lc::builder::DimRadialBuilder& builder) :
 }
 
 CADEntity_CSPtr DimRadial::move(const geo::Coordinate& offset) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint() + offset,
+    auto newDimRadial = tools::makePooled<DimRadial>(this->definitionPoint() + offset,
                         this->middleOfText() + offset,
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -62,7 +63,7 @@ CADEntity_CSPtr DimRadial::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimRadial::copy(const geo::Coordinate& offset) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint() + offset,
+    auto newDimRadial = tools::makePooled<DimRadial>(this->definitionPoint() + offset,
                         this->middleOfText() + offset,
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -77,7 +78,7 @@ CADEntity_CSPtr DimRadial::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr DimRadial::rotate(const geo::Coordinate& rotation_center, double rotation_angle) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+    auto newDimRadial = tools::makePooled<DimRadial>(this->definitionPoint().rotate(rotation_center, rotation_angle),
                         this->middleOfText().rotate(rotation_center, rotation_angle),
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -93,7 +94,7 @@ CADEntity_CSPtr DimRadial::rotate(const geo::Coordinate& rotation_center, double
 }
 
 CADEntity_CSPtr DimRadial::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint().scale(scale_center, scale_factor),
+    auto newDimRadial = tools::makePooled<DimRadial>(this->definitionPoint().scale(scale_center, scale_factor),
                         this->middleOfText().scale(scale_center, scale_factor),
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -109,7 +110,7 @@ CADEntity_CSPtr DimRadial::scale(const geo::Coordinate& scale_center, const geo:
 }
 
 CADEntity_CSPtr DimRadial::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint().mirror(axis1,axis2),
+    auto newDimRadial = tools::makePooled<DimRadial>(this->definitionPoint().mirror(axis1,axis2),
                         this->middleOfText().mirror(axis1,axis2),
                         this->attachmentPoint(),
                         this->textAngle(),
@@ -129,7 +130,7 @@ const geo::Area DimRadial::boundingBox() const {
 }
 
 CADEntity_CSPtr DimRadial::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newDimRadial = std::make_shared<DimRadial>(
+    auto newDimRadial = tools::makePooled<DimRadial>(
                             this->definitionPoint(),
                             this->middleOfText(),
                             this->attachmentPoint(),
@@ -167,7 +168,7 @@ std::map<unsigned int, geo::Coordinate> DimRadial::dragPoints() const {
 
 CADEntity_CSPtr DimRadial::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimRadial>(dragPoints.at(0),
+        auto newEntity = tools::makePooled<DimRadial>(dragPoints.at(0),
                          dragPoints.at(1),
                          attachmentPoint(),
                          textAngle(),
@@ -215,7 +216,7 @@ CADEntity_CSPtr DimRadial::setProperties(const PropertiesMap& propertiesMap) con
         }
     }
 
-    auto newDimRad = std::make_shared<DimRadial>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
+    auto newDimRad = tools::makePooled<DimRadial>(definitionPointp, middleOfTextp, attachmentPoint(), textAnglep, lineSpacingFactorp,
                      lineSpacingStyle(), explicitValuep, definitionPoint2p, leaderp, layer(), metaInfo(), block());
     newDimRad->setID(this->id());
     return newDimRad;
@@ -3,6 +3,7 @@
 #include <cad/interface/snapable.h>
 #include "ellipse.h"
 #include <cad/builders/ellipse.h>
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -42,7 +43,7 @@ Ellipse::Ellipse(const lc::builder::EllipseBuilder& builder) :
 }
 
 CADEntity_CSPtr Ellipse::move(const geo::Coordinate &offset) const {
-    auto newellipse = std::make_shared<Ellipse>(this->center() + offset,
+    auto newellipse = tools::makePooled<Ellipse>(this->center() + offset,
                       this->majorP(),
                       this->minorRadius(),
                       this->startAngle(), this->endAngle(),
@@ -55,7 +56,7 @@ CADEntity_CSPtr Ellipse::move(const geo::Coordinate &offset) const {
 }
 
 CADEntity_CSPtr Ellipse::copy(const geo::Coordinate &offset) const {
-    auto newEllipse = std::make_shared<Ellipse>(this->center() + offset,
+    auto newEllipse = tools::makePooled<Ellipse>(this->center() + offset,
                       this->majorP(),
                       this->minorRadius(),
                       this->startAngle(), this->endAngle(),
@@ -68,7 +69,7 @@ CADEntity_CSPtr Ellipse::copy(const geo::Coordinate &offset) const {
 
 CADEntity_CSPtr Ellipse::rotate(const geo::Coordinate &rotation_center, double rotation_angle) const {
     auto rotated = this->georotate(rotation_center, rotation_angle);
-    auto newEllipse = std::make_shared<Ellipse>(rotated.center(),
+    auto newEllipse = tools::makePooled<Ellipse>(rotated.center(),
                       rotated.majorP(),
                       rotated.minorRadius(),
                       rotated.startAngle(),
@@ -84,7 +85,7 @@ CADEntity_CSPtr Ellipse::rotate(const geo::Coordinate &rotation_center, double r
 
 CADEntity_CSPtr Ellipse::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
     auto scaled = this->geoscale(scale_center, scale_factor);
-    auto newEllipse = std::make_shared<Ellipse>(scaled.center(),
+    auto newEllipse = tools::makePooled<Ellipse>(scaled.center(),
                       scaled.majorP(),
                       scaled.minorRadius(),
                       scaled.startAngle(),
@@ -110,7 +111,7 @@ CADEntity_CSPtr Ellipse::mirror(const geo::Coordinate &axis1, const geo::Coordin
         endP = endPoint().mirror(axis1, axis2);
     }
 
-    auto newEllipse = std::make_shared<Ellipse>(cen, majP,
+    auto newEllipse = tools::makePooled<Ellipse>(cen, majP,
                       minorRadius(),
                       getEllipseAngle(startP),
                       getEllipseAngle(endP),
@@ -157,7 +158,7 @@ const geo::Area Ellipse::boundingBox() const {
 }
 
 CADEntity_CSPtr Ellipse::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Ellipse>(
+    auto newEntity = tools::makePooled<Ellipse>(
                          this->center(),
                          this->majorP(),
                          this->minorRadius(),
@@ -323,7 +324,7 @@ std::vector<CADEntity_CSPtr> Ellipse::splitEntity(const geo::Coordinate& coord)
     if(nearestPoint.distanceTo(coord)<LCTOLERANCE) {
         if(this->isArc()) {
             if (this->isAngleBetween(angle)) {
-                auto newellipse = std::make_shared<Ellipse>(this->center(),
+                auto newellipse = tools::makePooled<Ellipse>(this->center(),
                                   this->majorP(),
                                   this->minorRadius(),
                                   this->startAngle(), angle,
@@ -332,7 +333,7 @@ std::vector<CADEntity_CSPtr> Ellipse::splitEntity(const geo::Coordinate& coord)
                                   metaInfo(),
                                   block());
                 out.push_back(newellipse);
-                newellipse = std::make_shared<Ellipse>(this->center(),
+                newellipse = tools::makePooled<Ellipse>(this->center(),
                                                        this->majorP(),
                                                        this->minorRadius(),
                                                        angle, this->endAngle(),
@@ -343,7 +344,7 @@ std::vector<CADEntity_CSPtr> Ellipse::splitEntity(const geo::Coordinate& coord)
                 out.push_back(newellipse);
             }
         } else {
-            auto newellipse = std::make_shared<Ellipse>(this->center(),
+            auto newellipse = tools::makePooled<Ellipse>(this->center(),
                               this->majorP(),
                               this->minorRadius(),
                               angle, angle-1.5*LCARCTOLERANCE,//Break to arc
@@ -411,7 +412,7 @@ CADEntity_CSPtr Ellipse::setProperties(const PropertiesMap& propertiesMap) const
         }
     }
 
-    auto ellipseEntity = std::make_shared<Ellipse>(centerp, majorPointp, minorRadiusp, startAnglep, endAnglep, reversedp, layer(), metaInfo(), block());
+    auto ellipseEntity = tools::makePooled<Ellipse>(centerp, majorPointp, minorRadiusp, startAnglep, endAnglep, reversedp, layer(), metaInfo(), block());
     ellipseEntity->setID(this->id());
     return ellipseEntity;
 }
@@ -2,6 +2,7 @@
 #include <cmath>
 #include <algorithm>
 #include "cad/interface/metatype.h"
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -18,7 +19,7 @@ Hatch::Hatch(const Hatch_CSPtr& other, bool sameID) : CADEntity(other, sameID) {
 }
 
 CADEntity_CSPtr Hatch::move(const geo::Coordinate &offset) const {
-    auto newHatch =  std::make_shared<Hatch>(layer(), metaInfo(), block());
+    auto newHatch =  tools::makePooled<Hatch>(layer(), metaInfo(), block());
     newHatch->setRegion(_region.move(offset));
     newHatch->setPattern(_pattern);
     newHatch->setPatternName(_name);
@@ -30,7 +31,7 @@ CADEntity_CSPtr Hatch::move(const geo::Coordinate &offset) const {
 }
 
 CADEntity_CSPtr Hatch::copy(const geo::Coordinate &offset) const {
-    auto newHatch =  std::make_shared<Hatch>(layer(), metaInfo(), block());
+    auto newHatch =  tools::makePooled<Hatch>(layer(), metaInfo(), block());
     newHatch->setRegion(_region.copy(offset));
     newHatch->setPattern(_pattern);
     newHatch->setPatternName(_name);
@@ -41,7 +42,7 @@ CADEntity_CSPtr Hatch::copy(const geo::Coordinate &offset) const {
 }
 
 CADEntity_CSPtr Hatch::rotate(const geo::Coordinate &rotation_center, const double rotation_angle) const {
-    auto newHatch =  std::make_shared<Hatch>(layer(), metaInfo(), block());
+    auto newHatch =  tools::makePooled<Hatch>(layer(), metaInfo(), block());
     newHatch->setRegion(_region.rotate(rotation_center, rotation_angle));
     newHatch->setPattern(_pattern);
     newHatch->setPatternName(_name);
@@ -53,7 +54,7 @@ CADEntity_CSPtr Hatch::rotate(const geo::Coordinate &rotation_center, const doub
 }
 
 CADEntity_CSPtr Hatch::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
-    auto newHatch =  std::make_shared<Hatch>(layer(), metaInfo(), block());
+    auto newHatch =  tools::makePooled<Hatch>(layer(), metaInfo(), block());
     newHatch->setRegion(_region.scale(scale_center, scale_factor));
     newHatch->setPattern(_pattern);
     newHatch->setPatternName(_name);
@@ -65,7 +66,7 @@ CADEntity_CSPtr Hatch::scale(const geo::Coordinate &scale_center, const geo::Coo
 }
 
 CADEntity_CSPtr Hatch::mirror(const geo::Coordinate &axis1, const geo::Coordinate &axis2) const {
-    auto newHatch =  std::make_shared<Hatch>(layer(), metaInfo(), block());
+    auto newHatch =  tools::makePooled<Hatch>(layer(), metaInfo(), block());
     newHatch->setRegion(_region.mirror(axis1, axis2));
     newHatch->setPattern(_pattern);
     newHatch->setPatternName(_name);
@@ -81,7 +82,7 @@ const geo::Area Hatch::boundingBox() const {
 }
 
 CADEntity_CSPtr Hatch::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newHatch =  std::make_shared<Hatch>(layer, metaInfo, block);
+    auto newHatch =  tools::makePooled<Hatch>(layer, metaInfo, block);
     newHatch->setRegion(_region.move(lc::geo::Coordinate(0,0)));
     newHatch->setPattern(_pattern);
     newHatch->setPatternName(_name);
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cad/math/helpermethods.h>
 #include "cad/geometry/geoarea.h"
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -96,7 +97,7 @@ geo::Coordinate Image::nearestPointOnEntity(const geo::Coordinate& coord) const
 }
 
 CADEntity_CSPtr Image::move(const geo::Coordinate& offset) const {
-    auto newImage = std::make_shared<Image>(_name,
+    auto newImage = tools::makePooled<Image>(_name,
                                             _base + offset,
                                             _uv,
                                             _vv,
@@ -113,7 +114,7 @@ CADEntity_CSPtr Image::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr Image::copy(const geo::Coordinate& offset) const {
-    auto newImage = std::make_shared<Image>(_name,
+    auto newImage = tools::makePooled<Image>(_name,
                                             _base + offset,
                                             _uv,
                                             _vv,
@@ -129,14 +130,14 @@ CADEntity_CSPtr Image::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr Image::rotate(const geo::Coordinate& rotation_center, double rotation_angle) const {
-    // auto newImage = std::make_shared<Image>(_bottomLeft.rotate(rotation_center, rotation_angle),
+    // auto newImage = tools::makePooled<Image>(_bottomLeft.rotate(rotation_center, rotation_angle),
     //                                           _topRight.rotate(rotation_center, rotation_angle), layer());
     // newImage->setID(this->id());
     return nullptr;
 }
 
 CADEntity_CSPtr Image::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-//   auto newImage = std::make_shared<Image>(_bottomLeft.scale(scale_center, scale_factor),
+//   auto newImage = tools::makePooled<Image>(_bottomLeft.scale(scale_center, scale_factor),
     //                                           _topRight.scale(scale_center, scale_factor), layer());
     //newImage->setID(this->id());
     return nullptr;
@@ -168,7 +169,7 @@ const geo::Area Image::boundingBox() const {
 }
 
 CADEntity_CSPtr Image::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newImage = std::make_shared<Image>(
+    auto newImage = tools::makePooled<Image>(
                         _name,
                         _base,
                         _uv,
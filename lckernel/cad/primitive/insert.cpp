@@ -1,4 +1,7 @@
 #include "insert.h"
+#include <algorithm>
+#include <cad/meta/customentitystorage.h>
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -13,6 +16,7 @@ Insert::Insert(const Insert_CSPtr& other, bool sameID) :
 
     _document->addEntityEvent().connect<Insert, &Insert::on_addEntityEvent>(this);
     _document->removeEntityEvent().connect<Insert, &Insert::on_removeEntityEvent>(this);
+    _document->batchEntityEvent().connect<Insert, &Insert::on_batchEntityEvent>(this);
 }
 
 Insert::Insert(const builder::InsertBuilder& builder) :
@@ -25,11 +29,13 @@ Insert::Insert(const builder::InsertBuilder& builder) :
 
     _document->addEntityEvent().connect<Insert, &Insert::on_addEntityEvent>(this);
     _document->removeEntityEvent().connect<Insert, &Insert::on_removeEntityEvent>(this);
+    _document->batchEntityEvent().connect<Insert, &Insert::on_batchEntityEvent>(this);
 }
 
 Insert::~Insert() {
     document()->addEntityEvent().disconnect<Insert, &Insert::on_addEntityEvent>(this);
     document()->removeEntityEvent().disconnect<Insert, &Insert::on_removeEntityEvent>(this);
+    document()->batchEntityEvent().disconnect<Insert, &Insert::on_batchEntityEvent>(this);
 }
 
 const meta::Block_CSPtr& Insert::displayBlock() const {
@@ -41,14 +47,14 @@ const geo::Coordinate& Insert::position() const {
 }
 
 CADEntity_CSPtr Insert::move(const geo::Coordinate& offset) const {
-    auto newEntity = std::make_shared<Insert>(shared_from_this(), true);
+    auto newEntity = tools::makePooled<Insert>(shared_from_this(), true);
     newEntity->_position = _position + offset;
 
     return newEntity;
 }
 
 CADEntity_CSPtr Insert::copy(const geo::Coordinate& offset) const {
-    auto newEntity = std::make_shared<Insert>(shared_from_this());
+    auto newEntity = tools::makePooled<Insert>(shared_from_this());
     newEntity->_position = _position + offset;
 
     return newEntity;
@@ -73,6 +79,14 @@ const geo::Area Insert::boundingBox() const {
     return _boundingBox;
 }
 
+EntityTag Insert::entityTag() const {
+    if (std::dynamic_pointer_cast<const meta::CustomEntityStorage>(_displayBlock) != nullptr) {
+        return EntityTag::CustomEntityInsert;
+    }
+
+    return EntityTag::Insert;
+}
+
 CADEntity_CSPtr Insert::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
     auto builder = builder::InsertBuilder();
 
@@ -101,7 +115,7 @@ std::map<unsigned int, geo::Coordinate> entity::Insert::dragPoints() const {
 
 entity::CADEntity_CSPtr entity::Insert::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<Insert>(shared_from_this(), true);
+        auto newEntity = tools::makePooled<Insert>(shared_from_this(), true);
         newEntity->_position = dragPoints.at(0);
 
         return newEntity;
@@ -168,3 +182,14 @@ void Insert::on_removeEntityEvent(const lc::event::RemoveEntityEvent& event) {
         calculateBoundingBox();
     }
 }
+
+void Insert::on_batchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    auto inDisplayBlock = [this](const CADEntity_CSPtr& entity) {
+        return entity->block() == _displayBlock;
+    };
+
+    if (std::any_of(event.added().begin(), event.added().end(), inDisplayBlock) ||
+        std::any_of(event.removed().begin(), event.removed().end(), inDisplayBlock)) {
+        calculateBoundingBox();
+    }
+}
@@ -34,6 +34,8 @@ public:
 
     const geo::Area boundingBox() const override;
 
+    EntityTag entityTag() const override;
+
     void dispatch(EntityDispatch& dispatch) const override;
 
     std::map<unsigned int, geo::Coordinate> dragPoints() const override;
@@ -55,6 +57,7 @@ private:
 
     void on_addEntityEvent(const lc::event::AddEntityEvent&);
     void on_removeEntityEvent(const lc::event::RemoveEntityEvent&);
+    void on_batchEntityEvent(const lc::event::BatchEntityEvent&);
 
     storage::Document_SPtr _document;
     geo::Coordinate _position;
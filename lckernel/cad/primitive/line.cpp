@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include "cad/geometry/geoarea.h"
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -73,14 +74,14 @@ std::vector<CADEntity_CSPtr> Line::splitEntity(const geo::Coordinate& coord) con
     std::vector<CADEntity_CSPtr> out;
     auto nearestPoint = this->nearestPointOnEntity(coord);
     if(nearestPoint.distanceTo(coord)<LCTOLERANCE) {
-        auto newLine = std::make_shared<Line>(this->start(),
+        auto newLine = tools::makePooled<Line>(this->start(),
                                               nearestPoint,
                                               layer(),
                                               metaInfo(),
                                               block()
                                              );
         out.push_back(newLine);
-        newLine = std::make_shared<Line>(nearestPoint,
+        newLine = tools::makePooled<Line>(nearestPoint,
                                          this->end(),
                                          layer(),
                                          metaInfo(),
@@ -96,7 +97,7 @@ lc::geo::Coordinate Line::representingPoint() const {
 }
 
 CADEntity_CSPtr Line::move(const geo::Coordinate& offset) const {
-    auto newLine = std::make_shared<Line>(this->start() + offset,
+    auto newLine = tools::makePooled<Line>(this->start() + offset,
                                           this->end() + offset,
                                           layer(),
                                           metaInfo(),
@@ -107,7 +108,7 @@ CADEntity_CSPtr Line::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr Line::copy(const geo::Coordinate& offset) const {
-    auto newLine = std::make_shared<Line>(this->start() + offset,
+    auto newLine = tools::makePooled<Line>(this->start() + offset,
                                           this->end() + offset,
                                           layer(),
                                           metaInfo(),
@@ -116,7 +117,7 @@ CADEntity_CSPtr Line::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr Line::rotate(const geo::Coordinate& rotation_center, double rotation_angle) const {
-    auto newLine = std::make_shared<Line>(this->start().rotate(rotation_center, rotation_angle),
+    auto newLine = tools::makePooled<Line>(this->start().rotate(rotation_center, rotation_angle),
                                           this->end().rotate(rotation_center, rotation_angle),
                                           layer(),
                                           metaInfo(),
@@ -126,7 +127,7 @@ CADEntity_CSPtr Line::rotate(const geo::Coordinate& rotation_center, double rota
 }
 
 CADEntity_CSPtr Line::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newLine = std::make_shared<Line>(this->start().scale(scale_center, scale_factor),
+    auto newLine = tools::makePooled<Line>(this->start().scale(scale_center, scale_factor),
                                           this->end().scale(scale_center, scale_factor),
                                           layer(),
                                           metaInfo(),
@@ -137,7 +138,7 @@ CADEntity_CSPtr Line::scale(const geo::Coordinate& scale_center, const geo::Coor
 
 CADEntity_CSPtr Line::mirror(const geo::Coordinate& axis1,
                              const geo::Coordinate& axis2) const {
-    auto newLine = std::make_shared<Line>(this->start().mirror(axis1, axis2),
+    auto newLine = tools::makePooled<Line>(this->start().mirror(axis1, axis2),
                                           this->end().mirror(axis1, axis2),
                                           layer(),
                                           metaInfo(),
@@ -151,7 +152,7 @@ const geo::Area Line::boundingBox() const {
 }
 
 CADEntity_CSPtr Line::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Line>(
+    auto newEntity = tools::makePooled<Line>(
                          this->start(),
                          this->end(),
                          layer,
@@ -174,7 +175,7 @@ std::map<unsigned int, lc::geo::Coordinate> Line::dragPoints() const {
 
 CADEntity_CSPtr Line::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<Line>(dragPoints.at(0),
+        auto newEntity = tools::makePooled<Line>(dragPoints.at(0),
                                                 dragPoints.at(1),
                                                 layer(),
                                                 metaInfo(),
@@ -212,7 +213,7 @@ CADEntity_CSPtr Line::setProperties(const PropertiesMap& propertiesMap) const {
         }
     }
 
-    auto lineEntity = std::make_shared<Line>(startCoordp, endCoordp, layer(), metaInfo(), block());
+    auto lineEntity = tools::makePooled<Line>(startCoordp, endCoordp, layer(), metaInfo(), block());
     lineEntity->setID(this->id());
     return lineEntity;
 }
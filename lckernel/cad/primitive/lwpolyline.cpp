@@ -8,6 +8,7 @@
 #include <cad/primitive/arc.h>
 #include <cad/primitive/line.h>
 #include "lwpolyline.h"
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -72,7 +73,7 @@ CADEntity_CSPtr LWPolyline::move(const geo::Coordinate& offset) const {
     for (auto& vertex : _vertex) {
         newVertex.emplace_back(vertex.location() + offset, vertex.bulge(), vertex.startWidth(), vertex.endWidth());
     }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex,
+    auto newEntity = tools::makePooled<LWPolyline>(newVertex,
                      width(),
                      elevation(),
                      tickness(),
@@ -89,7 +90,7 @@ CADEntity_CSPtr LWPolyline::copy(const geo::Coordinate& offset) const {
     for (auto& vertex : _vertex) {
         newVertex.emplace_back(vertex.location() + offset, vertex.bulge(), vertex.startWidth(), vertex.endWidth());
     }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex,
+    auto newEntity = tools::makePooled<LWPolyline>(newVertex,
                      width(),
                      elevation(),
                      tickness(),
@@ -109,7 +110,7 @@ CADEntity_CSPtr LWPolyline::rotate(const geo::Coordinate& rotation_center, doubl
                                vertex.startWidth(),
                                vertex.endWidth());
     }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex,
+    auto newEntity = tools::makePooled<LWPolyline>(newVertex,
                      width(),
                      elevation(),
                      tickness(),
@@ -132,7 +133,7 @@ CADEntity_CSPtr LWPolyline::scale(const geo::Coordinate& scale_center, const geo
                                vertex.endWidth()
                               );
     }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex,
+    auto newEntity = tools::makePooled<LWPolyline>(newVertex,
                      width(),
                      elevation(),
                      tickness(),
@@ -162,7 +163,7 @@ const geo::Area LWPolyline::boundingBox() const {
 }
 
 CADEntity_CSPtr LWPolyline::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newEntity = std::make_shared<LWPolyline>(
+    auto newEntity = tools::makePooled<LWPolyline>(
                          _vertex,
                          _width,
                          _elevation,
@@ -184,7 +185,7 @@ void LWPolyline::generateEntities() {
     itr++;
     while (itr != vertex().end()) {
         if (lastPoint->bulge() != 0.) {
-            _entities.push_back(std::make_shared<const Arc>(
+            _entities.push_back(tools::makePooled<Arc>(
                                     geo::Arc::createArcBulge(lastPoint->location(), itr->location(), lastPoint->bulge()),
                                     layer(),
                                     metaInfo(),
@@ -192,7 +193,7 @@ void LWPolyline::generateEntities() {
                                 ));
         }
         else {
-            _entities.push_back(std::make_shared<const Line>(lastPoint->location(), itr->location(), layer(), metaInfo(), block()));
+            _entities.push_back(tools::makePooled<Line>(lastPoint->location(), itr->location(), layer(), metaInfo(), block()));
         }
         lastPoint = itr;
         itr++;
@@ -201,7 +202,7 @@ void LWPolyline::generateEntities() {
     if (_closed) {
         auto firstP = _vertex.begin();
         if (lastPoint->bulge() != 0.) {
-            _entities.push_back(std::make_shared<const Arc>(
+            _entities.push_back(tools::makePooled<Arc>(
                                     geo::Arc::createArcBulge(lastPoint->location(), firstP->location(), lastPoint->bulge()),
                                     layer(),
                                     metaInfo(),
@@ -209,7 +210,7 @@ void LWPolyline::generateEntities() {
                                 ));
         }
         else {
-            _entities.push_back(std::make_shared<const Line>(lastPoint->location(), firstP->location(), layer(), metaInfo(), block()));
+            _entities.push_back(tools::makePooled<Line>(lastPoint->location(), firstP->location(), layer(), metaInfo(), block()));
         }
     }
 }
@@ -352,7 +353,7 @@ CADEntity_CSPtr LWPolyline::setDragPoints(std::map<unsigned int, lc::geo::Coordi
             i++;
         }
 
-        auto newEntity = std::make_shared<LWPolyline>(newVertex,
+        auto newEntity = tools::makePooled<LWPolyline>(newVertex,
                          width(),
                          elevation(),
                          tickness(),
@@ -444,7 +445,7 @@ std::vector<CADEntity_CSPtr> LWPolyline::splitEntity(const geo::Coordinate& coor
         }
     }
     //Create new entity from vertices
-    auto newEntity = std::make_shared<LWPolyline>(newVertex,
+    auto newEntity = tools::makePooled<LWPolyline>(newVertex,
                      width(),
                      elevation(),
                      tickness(),
@@ -454,7 +455,7 @@ std::vector<CADEntity_CSPtr> LWPolyline::splitEntity(const geo::Coordinate& coor
                      , metaInfo(), block()
                                                  );
     out.push_back(newEntity);
-    newEntity = std::make_shared<LWPolyline>(newVertex2,
+    newEntity = tools::makePooled<LWPolyline>(newVertex2,
                 width(),
                 elevation(),
                 tickness(),
@@ -515,7 +516,7 @@ CADEntity_CSPtr LWPolyline::setProperties(const PropertiesMap& propertiesMap) co
         }
     }
 
-    auto newLWPolyline = std::make_shared<LWPolyline>(vertex(), widthp, elevationp, ticknessp, closedp, extrusionDirectionp, layer(), metaInfo(), block());
+    auto newLWPolyline = tools::makePooled<LWPolyline>(vertex(), widthp, elevationp, ticknessp, closedp, extrusionDirectionp, layer(), metaInfo(), block());
     newLWPolyline->setID(this->id());
     return newLWPolyline;
 }
@@ -1,5 +1,6 @@
 #include <memory>
 #include <cad/primitive/point.h>
+#include "cad/tools/poolallocator.h"
 
 using namespace lc;
 using namespace entity;
@@ -25,33 +26,33 @@ Point::Point(const builder::PointBuilder& builder) :
 }
 
 CADEntity_CSPtr Point::move(const geo::Coordinate& offset) const {
-    auto newCoordinate = std::make_shared<Point>(this->x() + offset.x(), this->y() + offset.y(), layer(), metaInfo(), block());
+    auto newCoordinate = tools::makePooled<Point>(this->x() + offset.x(), this->y() + offset.y(), layer(), metaInfo(), block());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::copy(const geo::Coordinate& offset) const {
-    auto newCoordinate = std::make_shared<Point>(this->x() + offset.x(), this->y() + offset.y(), layer(), metaInfo(), block());
+    auto newCoordinate = tools::makePooled<Point>(this->x() + offset.x(), this->y() + offset.y(), layer(), metaInfo(), block());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
     auto rotcord = geo::Coordinate(this->x(), this->y()).rotate(rotation_center, rotation_angle);
-    auto newCoordinate = std::make_shared<Point>(rotcord.x(), rotcord.y(), layer(), metaInfo(), block());
+    auto newCoordinate = tools::makePooled<Point>(rotcord.x(), rotcord.y(), layer(), metaInfo(), block());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
     auto rotcord = geo::Coordinate(this->x(), this->y()).scale(scale_center, scale_factor);
-    auto newCoordinate = std::make_shared<Point>(rotcord.x(), rotcord.y(), layer(), metaInfo(), block());
+    auto newCoordinate = tools::makePooled<Point>(rotcord.x(), rotcord.y(), layer(), metaInfo(), block());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
     auto rotcord = geo::Coordinate(this->x(), this->y()).rotate(axis1, axis2);
-    auto newCoordinate = std::make_shared<Point>(rotcord.x(), rotcord.y(), layer(), metaInfo(), block());
+    auto newCoordinate = tools::makePooled<Point>(rotcord.x(), rotcord.y(), layer(), metaInfo(), block());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
@@ -61,7 +62,7 @@ const geo::Area Point::boundingBox() const {
 }
 
 CADEntity_CSPtr Point::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Point>(this->x(), this->y(),
+    auto newEntity = tools::makePooled<Point>(this->x(), this->y(),
                      layer,
                      metaInfo,
                      block
@@ -102,7 +103,7 @@ std::map<unsigned int, lc::geo::Coordinate> Point::dragPoints() const {
 
 CADEntity_CSPtr Point::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<Point>(dragPoints.at(0),
+        auto newEntity = tools::makePooled<Point>(dragPoints.at(0),
                          layer(),
                          metaInfo(),
                          block()
@@ -131,7 +132,7 @@ CADEntity_CSPtr Point::setProperties(const PropertiesMap& propertiesMap) const {
         }
     }
 
-    auto pointEntity = std::make_shared<Point>(coordp, layer(), metaInfo(), block());
+    auto pointEntity = tools::makePooled<Point>(coordp, layer(), metaInfo(), block());
     pointEntity->setID(this->id());
     return pointEntity;
 }
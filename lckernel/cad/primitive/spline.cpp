@@ -2,6 +2,7 @@
 #include <algorithm>
 #include "cad/geometry/geoarea.h"
 #include "spline.h"
+#include "cad/tools/poolallocator.h"
 
 
 using namespace lc;
@@ -96,7 +97,7 @@ CADEntity_CSPtr Spline::move(const geo::Coordinate& offset) const {
         control_pts.push_back(point + offset);
     }
 
-    auto newSpline = std::make_shared<Spline>(control_pts,
+    auto newSpline = tools::makePooled<Spline>(control_pts,
                      knotPoints(),
                      fitPoints(),
                      degree(),
@@ -126,7 +127,7 @@ CADEntity_CSPtr Spline::copy(const geo::Coordinate& offset) const {
         control_pts.push_back(point + offset);
     }
 
-    auto newSpline = std::make_shared<Spline>(control_pts,
+    auto newSpline = tools::makePooled<Spline>(control_pts,
                      knotPoints(),
                      fitPoints(),
                      degree(),
@@ -157,7 +158,7 @@ CADEntity_CSPtr Spline::rotate(const geo::Coordinate& rotation_center, double ro
 
     auto normal = geo::Coordinate(nX(), nY(), nZ()).rotate(rotation_angle);
 
-    auto newSpline = std::make_shared<Spline>(control_pts,
+    auto newSpline = tools::makePooled<Spline>(control_pts,
                      knotPoints(),
                      fitPoints(),
                      degree(),
@@ -187,7 +188,7 @@ CADEntity_CSPtr Spline::scale(const geo::Coordinate& scale_center, const geo::Co
         control_pts.push_back(point.scale(scale_center, scale_factor));
     }
 
-    auto newSpline = std::make_shared<Spline>(control_pts,
+    auto newSpline = tools::makePooled<Spline>(control_pts,
                      knotPoints(),
                      fitPoints(),
                      degree(),
@@ -217,7 +218,7 @@ CADEntity_CSPtr Spline::mirror(const geo::Coordinate& axis1, const geo::Coordina
         control_pts.push_back(point.mirror(axis1, axis2));
     }
 
-    auto newSpline = std::make_shared<Spline>(control_pts,
+    auto newSpline = tools::makePooled<Spline>(control_pts,
                      knotPoints(),
                      fitPoints(),
                      degree(),
@@ -245,7 +246,7 @@ const geo::Area Spline::boundingBox() const {
 }
 
 CADEntity_CSPtr Spline::modify(meta::Layer_CSPtr layer, meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newSpline = std::make_shared<Spline>(
+    auto newSpline = tools::makePooled<Spline>(
                          controlPoints(),
                          knotPoints(),
                          fitPoints(),
@@ -310,7 +311,7 @@ CADEntity_CSPtr Spline::setDragPoints(std::map<unsigned int, lc::geo::Coordinate
             i++;
         }
 
-        auto newEntity = std::make_shared<Spline>(controlPoints,
+        auto newEntity = tools::makePooled<Spline>(controlPoints,
                          knotPoints(),
                          fitPoints,
                          degree(),
@@ -385,7 +386,7 @@ CADEntity_CSPtr Spline::setProperties(const PropertiesMap& propertiesMap) const
         }
     }
 
-    auto newSpline = std::make_shared<Spline>(controlPointsp, knotPoints(), fitPoints(), degreep, closedp, fitTolerancep, startTangentp.x(),
+    auto newSpline = tools::makePooled<Spline>(controlPointsp, knotPoints(), fitPoints(), degreep, closedp, fitTolerancep, startTangentp.x(),
                      startTangentp.y(), startTangentp.z(), endTangentp.x(),endTangentp.y(), endTangentp.z(), normalVectorp.x(), normalVectorp.y(), normalVectorp.z(), flags(), layer(), metaInfo(), block());
     newSpline->setID(this->id());
     return newSpline;
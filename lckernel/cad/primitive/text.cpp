@@ -1,4 +1,5 @@
 #include "text.h"
+#include "cad/tools/poolallocator.h"
 
 
 using namespace lc;
@@ -71,7 +72,7 @@ Text::Text(const Text_CSPtr& other, bool sameID) :
 }
 
 CADEntity_CSPtr Text::move(const geo::Coordinate& offset) const {
-    auto newText = std::make_shared<Text>(this->_insertion_point + offset,
+    auto newText = tools::makePooled<Text>(this->_insertion_point + offset,
                                           this->_text_value,
                                           this->_height,
                                           this->_angle,
@@ -91,7 +92,7 @@ CADEntity_CSPtr Text::move(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr Text::copy(const geo::Coordinate& offset) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = tools::makePooled<Text>(
                        this->_insertion_point + offset,
                        this->_text_value,
                        this->_height,
@@ -111,7 +112,7 @@ CADEntity_CSPtr Text::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr Text::rotate(const geo::Coordinate& rotation_center, double rotation_angle) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = tools::makePooled<Text>(
                        this->_insertion_point.rotate(rotation_center, rotation_angle),
                        this->_text_value,
                        this->_height,
@@ -130,7 +131,7 @@ CADEntity_CSPtr Text::rotate(const geo::Coordinate& rotation_center, double rota
 }
 
 CADEntity_CSPtr Text::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = tools::makePooled<Text>(
                        this->_insertion_point.scale(scale_center, scale_factor),
                        this->_text_value,
                        this->_height * std::sqrt(scale_factor.x() * scale_factor.y()),  // Does this make sense?
@@ -159,7 +160,7 @@ const geo::Area Text::boundingBox() const {
 }
 
 CADEntity_CSPtr Text::modify(meta::Layer_CSPtr layer, const meta::MetaInfo_CSPtr metaInfo, meta::Block_CSPtr block) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = tools::makePooled<Text>(
                        this->_insertion_point,
                        this->_text_value,
                        this->_height,
@@ -191,7 +192,7 @@ std::map<unsigned int, lc::geo::Coordinate> Text::dragPoints() const {
 
 CADEntity_CSPtr Text::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<Text>(dragPoints.at(0),
+        auto newEntity = tools::makePooled<Text>(dragPoints.at(0),
                                                 text_value(),
                                                 height(),
                                                 angle(),
@@ -273,7 +274,7 @@ CADEntity_CSPtr Text::setProperties(const PropertiesMap& propertiesMap) const {
         }
     }
 
-    auto textEntity = std::make_shared<Text>(insertionPointp, textValuep, heightp, anglep, style(), textgeneration(), halign(), valign(), underlinedp, strikethroughp, boldp, italicp, layer(), metaInfo(), block());
+    auto textEntity = tools::makePooled<Text>(insertionPointp, textValuep, heightp, anglep, style(), textgeneration(), halign(), valign(), underlinedp, strikethroughp, boldp, italicp, layer(), metaInfo(), block());
     textEntity->setID(this->id());
     return textEntity;
 }
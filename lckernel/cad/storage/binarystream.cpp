@@ -0,0 +1,165 @@
+#include "binarystream.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace lc::storage;
+
+void BinaryWriter::writeUInt8(uint8_t value) {
+    _buffer.push_back(static_cast<char>(value));
+}
+
+void BinaryWriter::writeUInt32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        writeUInt8(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void BinaryWriter::writeUInt64(uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        writeUInt8(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void BinaryWriter::writeVarUInt(uint64_t value) {
+    while (value >= 0x80) {
+        writeUInt8(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    writeUInt8(static_cast<uint8_t>(value));
+}
+
+void BinaryWriter::writeBool(bool value) {
+    writeUInt8(value ? 1 : 0);
+}
+
+void BinaryWriter::writeDouble(double value) {
+    static_assert(sizeof(double) == sizeof(uint64_t), "double must be 64 bits");
+
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUInt64(bits);
+}
+
+void BinaryWriter::writeString(const std::string& value) {
+    writeVarUInt(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void BinaryWriter::writeCoordinate(const geo::Coordinate& coordinate) {
+    writeDouble(coordinate.x());
+    writeDouble(coordinate.y());
+    writeDouble(coordinate.z());
+}
+
+void BinaryWriter::writeBytes(const char* data, size_t size) {
+    _buffer.append(data, size);
+}
+
+const std::string& BinaryWriter::buffer() const {
+    return _buffer;
+}
+
+std::string& BinaryWriter::buffer() {
+    return _buffer;
+}
+
+void BinaryWriter::clear() {
+    _buffer.clear();
+}
+
+BinaryReader::BinaryReader(const char* data, size_t size) :
+    _data(data),
+    _size(size),
+    _position(0) {
+}
+
+uint8_t BinaryReader::readUInt8() {
+    require(1);
+    return static_cast<uint8_t>(_data[_position++]);
+}
+
+uint32_t BinaryReader::readUInt32() {
+    uint32_t value = 0;
+
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(readUInt8()) << (i * 8);
+    }
+
+    return value;
+}
+
+uint64_t BinaryReader::readUInt64() {
+    uint64_t value = 0;
+
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(readUInt8()) << (i * 8);
+    }
+
+    return value;
+}
+
+uint64_t BinaryReader::readVarUInt() {
+    uint64_t value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        auto byte = readUInt8();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+
+    throw std::runtime_error("Invalid variable length integer");
+}
+
+bool BinaryReader::readBool() {
+    return readUInt8() != 0;
+}
+
+double BinaryReader::readDouble() {
+    auto bits = readUInt64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string BinaryReader::readString() {
+    auto size = readVarUInt();
+    auto data = readBytes(size);
+    return std::string(data, size);
+}
+
+lc::geo::Coordinate BinaryReader::readCoordinate() {
+    auto x = readDouble();
+    auto y = readDouble();
+    auto z = readDouble();
+    return geo::Coordinate(x, y, z);
+}
+
+const char* BinaryReader::readBytes(size_t size) {
+    require(size);
+    auto data = _data + _position;
+    _position += size;
+    return data;
+}
+
+size_t BinaryReader::position() const {
+    return _position;
+}
+
+size_t BinaryReader::remaining() const {
+    return _size - _position;
+}
+
+bool BinaryReader::atEnd() const {
+    return _position == _size;
+}
+
+void BinaryReader::require(size_t size) const {
+    if (size > _size - _position) {
+        throw std::runtime_error("Unexpected end of binary data");
+    }
+}
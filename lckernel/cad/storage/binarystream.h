@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cad/geometry/geocoordinate.h"
+
+namespace lc {
+namespace storage {
+/**
+ * @brief Append values to a byte buffer in a portable binary representation
+ * Integers are written as little endian or as variable length integers, doubles as little endian IEEE 754.
+ */
+class BinaryWriter {
+public:
+    BinaryWriter() = default;
+
+    void writeUInt8(uint8_t value);
+
+    void writeUInt32(uint32_t value);
+
+    void writeUInt64(uint64_t value);
+
+    /**
+     * @brief Write an unsigned integer using 7 bits per byte, small values take a single byte
+     */
+    void writeVarUInt(uint64_t value);
+
+    void writeBool(bool value);
+
+    void writeDouble(double value);
+
+    void writeString(const std::string& value);
+
+    void writeCoordinate(const geo::Coordinate& coordinate);
+
+    void writeBytes(const char* data, size_t size);
+
+    const std::string& buffer() const;
+
+    std::string& buffer();
+
+    void clear();
+
+private:
+    std::string _buffer;
+};
+
+/**
+ * @brief Read values written by a BinaryWriter
+ * Reading past the end of the data throws a std::runtime_error.
+ */
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size);
+
+    uint8_t readUInt8();
+
+    uint32_t readUInt32();
+
+    uint64_t readUInt64();
+
+    uint64_t readVarUInt();
+
+    bool readBool();
+
+    double readDouble();
+
+    std::string readString();
+
+    geo::Coordinate readCoordinate();
+
+    /**
+     * @brief Return a pointer to the next size bytes and skip them
+     */
+    const char* readBytes(size_t size);
+
+    size_t position() const;
+
+    size_t remaining() const;
+
+    bool atEnd() const;
+
+private:
+    void require(size_t size) const;
+
+    const char* _data;
+    size_t _size;
+    size_t _position;
+};
+}
+}
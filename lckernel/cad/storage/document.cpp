@@ -7,6 +7,7 @@
 #include "cad/events/addentityevent.h"
 #include "cad/events/removeentityevent.h"
 #include "cad/events/replaceentityevent.h"
+#include "cad/events/batchentityevent.h"
 
 using namespace lc::storage;
 
@@ -16,6 +17,7 @@ Document::Document():
     _addEntityEvent(),
     _replaceEntityEvent(),
     _removeEntityEvent(),
+    _batchEntityEvent(),
     _addLayerEvent(),
     _addViewportEvent(),
     _replaceLayerEvent(),
@@ -23,6 +25,9 @@ Document::Document():
     _addLinePatternEvent(),
     _replaceLinePatternEvent(),
     _removeLinePatternEvent(),
+    _addBlockEvent(),
+    _replaceBlockEvent(),
+    _removeBlockEvent(),
     _newWaitingCustomEntityEvent() {
     storage::DocumentList::getInstance().addDocument(this);
 }
@@ -60,6 +65,10 @@ Nano::Signal<void(const lc::event::RemoveEntityEvent&)>& Document::removeEntityE
     return this->_removeEntityEvent;
 }
 
+Nano::Signal<void(const lc::event::BatchEntityEvent&)>& Document::batchEntityEvent() {
+    return this->_batchEntityEvent;
+}
+
 Nano::Signal<void(const lc::event::RemoveLayerEvent&)>& Document::removeLayerEvent() {
     return this->_removeLayerEvent;
 }
@@ -88,6 +97,106 @@ Nano::Signal<void(const lc::event::ReplaceLinePatternEvent&)>& Document::replace
     return this->_replaceLinePatternEvent;
 }
 
+Nano::Signal<void(const lc::event::RemoveBlockEvent&)>& Document::removeBlockEvent() {
+    return this->_removeBlockEvent;
+}
+
+Nano::Signal<void(const lc::event::AddBlockEvent&)>& Document::addBlockEvent() {
+    return this->_addBlockEvent;
+}
+
+Nano::Signal<void(const lc::event::ReplaceBlockEvent&)>& Document::replaceBlockEvent() {
+    return this->_replaceBlockEvent;
+}
+
 Nano::Signal<void(const lc::event::NewWaitingCustomEntityEvent&)>& Document::newWaitingCustomEntityEvent() {
     return _newWaitingCustomEntityEvent;
 }
+
+IntersectionIndex& Document::intersectionIndex() {
+    if (!_intersectionIndex) {
+        _intersectionIndex.reset(new IntersectionIndex(this));
+    }
+
+    return *_intersectionIndex;
+}
+
+void Document::setEntityLoader(EntityLoader_SPtr loader) {
+    _entityLoader = std::move(loader);
+}
+
+EntityLoader_SPtr Document::entityLoader() const {
+    return _entityLoader;
+}
+
+void Document::loadArea(const geo::Area& area) {
+    if (_entityLoader == nullptr) {
+        return;
+    }
+
+    // The loader is detached while the entities are added, queries made by the listeners don't load again
+    auto loader = std::move(_entityLoader);
+    auto entities = loader->load(area);
+
+    if (!loader->loaded()) {
+        _entityLoader = loader;
+    }
+
+    if (!entities.empty()) {
+        applyBatch(entities, {}, {});
+    }
+}
+
+void Document::loadAll() {
+    if (_entityLoader == nullptr) {
+        return;
+    }
+
+    auto loader = std::move(_entityLoader);
+    auto entities = loader->loadAll();
+
+    if (!entities.empty()) {
+        applyBatch(entities, {}, {});
+    }
+}
+
+size_t Document::eachInArea(const geo::Area& area, const std::function<void(const entity::CADEntity_CSPtr&)>& func) {
+    loadArea(area);
+    return entityContainer().eachInArea(area, func);
+}
+
+size_t Document::eachEntity(const std::function<void(const entity::CADEntity_CSPtr&)>& func) {
+    loadAll();
+    return entityContainer().eachEntity(func);
+}
+
+size_t Document::countInArea(const geo::Area& area) {
+    loadArea(area);
+    return entityContainer().eachInArea(area, [](const entity::CADEntity_CSPtr&) {});
+}
+
+std::vector<ID_DATATYPE> Document::entityIDsInArea(const geo::Area& area) {
+    std::vector<ID_DATATYPE> ids;
+    loadArea(area);
+
+    entityContainer().eachInArea(area, [&](const entity::CADEntity_CSPtr& entity) {
+        ids.push_back(entity->id());
+    });
+
+    return ids;
+}
+
+std::vector<double> Document::boundingBoxesInArea(const geo::Area& area) {
+    std::vector<double> boundingBoxes;
+    loadArea(area);
+
+    entityContainer().eachInArea(area, [&](const entity::CADEntity_CSPtr& entity) {
+        auto boundingBox = entity->boundingBox();
+        boundingBoxes.push_back(boundingBox.minP().x());
+        boundingBoxes.push_back(boundingBox.minP().y());
+        boundingBoxes.push_back(boundingBox.maxP().x());
+        boundingBoxes.push_back(boundingBox.maxP().y());
+    });
+
+    return boundingBoxes;
+}
@@ -4,6 +4,8 @@
 
 #include "cad/const.h"
 #include "cad/storage/entitycontainer.h"
+#include "cad/storage/entityloader.h"
+#include "cad/storage/intersectionindex.h"
 #include "storagemanager.h"
 
 #include <nano-signal-slot/nano_signal_slot.hpp>
@@ -14,6 +16,8 @@
 #include <cad/events/removelayerevent.h>
 #include <cad/events/replacelayerevent.h>
 #include <cad/events/newwaitingcustomentityevent.h>
+#include <functional>
+#include <memory>
 #include <unordered_set>
 #include "cad/meta/dxflinepattern.h"
 
@@ -23,11 +27,16 @@
 #include "cad/events/addentityevent.h"
 #include "cad/events/removeentityevent.h"
 #include "cad/events/replaceentityevent.h"
+#include "cad/events/batchentityevent.h"
 
 #include "cad/events/addlinepatternevent.h"
 #include "cad/events/removelinepatternevent.h"
 #include "cad/events/replacelinepatternevent.h"
 
+#include "cad/events/addblockevent.h"
+#include "cad/events/removeblockevent.h"
+#include "cad/events/replaceblockevent.h"
+
 namespace lc {
 
 namespace entity {
@@ -37,6 +46,8 @@ class CADEntity;
 namespace operation {
 class DocumentOperation;
 DECLARE_SHORT_SHARED_PTR(DocumentOperation)
+class Transaction;
+DECLARE_SHORT_SHARED_PTR(Transaction)
 }
 
 namespace storage {
@@ -71,6 +82,12 @@ public:
      */
     virtual Nano::Signal<void(const lc::event::RemoveEntityEvent&)>& removeEntityEvent();
 
+    /*!
+     * \brief Event emitted once for a batch of added/removed entities
+     * \sa applyBatch
+     */
+    virtual Nano::Signal<void(const lc::event::BatchEntityEvent&)>& batchEntityEvent();
+
     /*!
      * \brief Event to remove an layer
      */
@@ -103,6 +120,21 @@ public:
      */
     virtual Nano::Signal<void(const lc::event::ReplaceLinePatternEvent&)>& replaceLinePatternEvent();
 
+    /*!
+     * \brief Event to remove a block
+     */
+    virtual Nano::Signal<void(const lc::event::RemoveBlockEvent&)>& removeBlockEvent();
+
+    /*!
+     * \brief Event to add a block
+     */
+    virtual Nano::Signal<void(const lc::event::AddBlockEvent&)>& addBlockEvent();
+
+    /*!
+     * \brief Event to replace a block
+     */
+    virtual Nano::Signal<void(const lc::event::ReplaceBlockEvent&)>& replaceBlockEvent();
+
     /**
      * @brief Event called when an unmanaged entity is added to the document
      */
@@ -161,6 +193,39 @@ public:
      */
     virtual void removeEntity(const entity::CADEntity_CSPtr& entity) = 0;
 
+    /*!
+     * \brief add, remove and replace a set of entities at once
+     * Unlike insertEntity() and removeEntity(), no event is emitted per entity,
+     * a single BatchEntityEvent is emitted for the whole set.
+     * Removals are applied first, then replacements, then additions.
+     * \param adds Entities to add, an entity with an existing ID replaces the old one
+     * \param removes Entities to remove
+     * \param replaces New versions of entities already present in the document
+     */
+    virtual void applyBatch(const std::vector<entity::CADEntity_CSPtr>& adds,
+                            const std::vector<entity::CADEntity_CSPtr>& removes,
+                            const std::vector<entity::CADEntity_CSPtr>& replaces) = 0;
+
+    /*!
+     * \brief execute a function with all its operations grouped in a single transaction
+     * Operations executed by the function are applied together when it returns,
+     * with one commit and one undo cycle. Nested calls are part of the outer transaction.
+     * When the function throws, its operations are discarded.
+     * \param func Function executing the operations
+     * \sa operation::Transaction
+     */
+    virtual void batch(const std::function<void()>& func) = 0;
+
+    /*!
+     * \brief execute a function with its operations appended to a given transaction
+     * Unlike batch(), the operations are not applied when the function returns. The transaction can be filled
+     * by several calls, the caller executes it once complete or drops it to discard the operations.
+     * Nested batch() calls are part of the transaction.
+     * \param transaction Transaction collecting the operations
+     * \param func Function executing the operations
+     */
+    virtual void batchInto(const operation::Transaction_SPtr& transaction, const std::function<void()>& func) = 0;
+
     /**
     *  \brief add a new layer to the document
     *  \param layer layer to be added.
@@ -243,6 +308,65 @@ public:
      */
     virtual entity::CADEntity_CSPtr entityByID(ID_DATATYPE id) const = 0;
 
+    /**
+     * @brief Set the source of the entities which are not part of the document yet
+     * The entities are added by loadArea() and loadAll(), the loader is released once everything is loaded.
+     * @param loader Entity loader, nullptr when the document is complete
+     */
+    void setEntityLoader(EntityLoader_SPtr loader);
+
+    /**
+     * @brief Return the entity loader, nullptr when all the entities are part of the document
+     */
+    EntityLoader_SPtr entityLoader() const;
+
+    /**
+     * @brief Add the entities of the loader overlapping an area
+     * Called before drawing or querying an area. The entities are added with applyBatch(), outside of the undo stack.
+     */
+    void loadArea(const geo::Area& area);
+
+    /**
+     * @brief Add all the entities of the loader
+     * Called before operations working on the whole document, like saving it.
+     */
+    void loadAll();
+
+    /**
+     * @brief Return the cache of the intersections between the entities of this document
+     * The index is created on first use and kept up to date with the entity events.
+     */
+    IntersectionIndex& intersectionIndex();
+
+    /**
+     * @brief Call a function for each entity which bounding box overlaps an area
+     * Entities are passed directly from the document storage, no container is built.
+     * @return amount of entities passed to the function
+     */
+    size_t eachInArea(const geo::Area& area, const std::function<void(const entity::CADEntity_CSPtr&)>& func);
+
+    /**
+     * @brief Call a function for each entity of the document
+     * @return amount of entities passed to the function
+     */
+    size_t eachEntity(const std::function<void(const entity::CADEntity_CSPtr&)>& func);
+
+    /**
+     * @brief Return the amount of entities which bounding box overlaps an area
+     */
+    size_t countInArea(const geo::Area& area);
+
+    /**
+     * @brief Return the IDs of the entities which bounding box overlaps an area
+     */
+    std::vector<ID_DATATYPE> entityIDsInArea(const geo::Area& area);
+
+    /**
+     * @brief Return the bounding boxes of the entities overlapping an area, as a flat array
+     * Each entity adds minX, minY, maxX, maxY, in the same order as eachInArea() and entityIDsInArea().
+     */
+    std::vector<double> boundingBoxesInArea(const geo::Area& area);
+
 public:
     friend class lc::operation::DocumentOperation;
 
@@ -253,6 +377,7 @@ private:
     Nano::Signal<void(const lc::event::AddEntityEvent&)> _addEntityEvent;
     Nano::Signal<void(const lc::event::ReplaceEntityEvent&)> _replaceEntityEvent;
     Nano::Signal<void(const lc::event::RemoveEntityEvent&)> _removeEntityEvent;
+    Nano::Signal<void(const lc::event::BatchEntityEvent&)> _batchEntityEvent;
 
     Nano::Signal<void(const lc::event::AddLayerEvent&)> _addLayerEvent;
     Nano::Signal<void(const lc::event::AddViewportEvent&)> _addViewportEvent;
@@ -263,7 +388,16 @@ private:
     Nano::Signal<void(const lc::event::ReplaceLinePatternEvent&)> _replaceLinePatternEvent;
     Nano::Signal<void(const lc::event::RemoveLinePatternEvent&)> _removeLinePatternEvent;
 
+    Nano::Signal<void(const lc::event::AddBlockEvent&)> _addBlockEvent;
+    Nano::Signal<void(const lc::event::ReplaceBlockEvent&)> _replaceBlockEvent;
+    Nano::Signal<void(const lc::event::RemoveBlockEvent&)> _removeBlockEvent;
+
     Nano::Signal<void(const lc::event::NewWaitingCustomEntityEvent&)> _newWaitingCustomEntityEvent;
+
+    EntityLoader_SPtr _entityLoader;
+
+    // Declared after the signals, the index disconnects itself before they are destroyed
+    std::unique_ptr<IntersectionIndex> _intersectionIndex;
 };
 
 DECLARE_SHORT_SHARED_PTR(Document);
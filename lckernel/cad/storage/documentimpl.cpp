@@ -11,7 +11,8 @@ using namespace lc::storage;
 
 DocumentImpl::DocumentImpl(StorageManager_SPtr storageManager) :
     Document(),
-    _storageManager(std::move(storageManager)) {
+    _storageManager(std::move(storageManager)),
+    _batchDepth(0) {
     _storageManager->addDocumentMetaType(std::make_shared<meta::Layer>("0", meta::MetaLineWidthByValue(1.0), Color(255, 255, 255)));
     //Add papers too
     _storageManager->addDocumentMetaType(std::make_shared<lc::meta::Block>("*Paper_Space", geo::Coordinate()));
@@ -19,6 +20,15 @@ DocumentImpl::DocumentImpl(StorageManager_SPtr storageManager) :
 }
 
 void DocumentImpl::execute(const operation::DocumentOperation_SPtr& operation) {
+    if (_batchDepth > 0) {
+        if (_transaction == nullptr) {
+            _transaction = std::make_shared<operation::Transaction>(operation->document(), "Batch");
+        }
+
+        _transaction->append(operation);
+        return;
+    }
+
     {
         std::lock_guard<std::mutex> lck(_documentMutex);
         begin(operation);
@@ -34,6 +44,49 @@ void DocumentImpl::execute(const operation::DocumentOperation_SPtr& operation) {
     }
 }
 
+void DocumentImpl::batch(const std::function<void()>& func) {
+    _batchDepth++;
+
+    try {
+        func();
+    }
+    catch (...) {
+        if (--_batchDepth == 0) {
+            _transaction = nullptr;
+        }
+        throw;
+    }
+
+    if (--_batchDepth > 0) {
+        return;
+    }
+
+    auto transaction = std::move(_transaction);
+    _transaction = nullptr;
+
+    if (transaction != nullptr) {
+        execute(transaction);
+    }
+}
+
+void DocumentImpl::batchInto(const operation::Transaction_SPtr& transaction, const std::function<void()>& func) {
+    auto outer = std::move(_transaction);
+    _transaction = transaction;
+    _batchDepth++;
+
+    try {
+        func();
+    }
+    catch (...) {
+        _batchDepth--;
+        _transaction = std::move(outer);
+        throw;
+    }
+
+    _batchDepth--;
+    _transaction = std::move(outer);
+}
+
 void DocumentImpl::begin(const operation::DocumentOperation_SPtr& operation) {
     this->operationStart(operation);
     event::BeginProcessEvent event;
@@ -55,25 +108,11 @@ void DocumentImpl::insertEntity(const entity::CADEntity_CSPtr& cadEntity) {
     event::AddEntityEvent event(cadEntity);
     addEntityEvent()(event);
 
-    auto insert = std::dynamic_pointer_cast<const entity::Insert>(cadEntity);
-    if (insert != nullptr && std::dynamic_pointer_cast<const entity::CustomEntity>(cadEntity) == nullptr) {
-        auto ces = std::dynamic_pointer_cast<const meta::CustomEntityStorage>(insert->displayBlock());
-
-        if (ces != nullptr) {
-            _waitingCustomEntities[ces->pluginName()].insert(insert);
-            _newWaitingCustomEntities.insert(insert);
-        }
-    }
+    addWaitingCustomEntity(cadEntity);
 }
 
 void DocumentImpl::removeEntity(const entity::CADEntity_CSPtr& entity) {
-    auto insert = std::dynamic_pointer_cast<const entity::Insert>(entity);
-    if (insert != nullptr && std::dynamic_pointer_cast<const entity::CustomEntity>(entity) == nullptr) {
-        auto ces = std::dynamic_pointer_cast<const meta::CustomEntityStorage>(insert->displayBlock());
-        if (ces != nullptr) {
-            _waitingCustomEntities[ces->pluginName()].erase(insert);
-        }
-    }
+    removeWaitingCustomEntity(entity);
 
     if (_storageManager->entityByID(entity->id()) != nullptr) {
         _storageManager->removeEntity(entity);
@@ -82,6 +121,86 @@ void DocumentImpl::removeEntity(const entity::CADEntity_CSPtr& entity) {
     }
 }
 
+void DocumentImpl::applyBatch(const std::vector<entity::CADEntity_CSPtr>& adds,
+                              const std::vector<entity::CADEntity_CSPtr>& removes,
+                              const std::vector<entity::CADEntity_CSPtr>& replaces) {
+    std::vector<entity::CADEntity_CSPtr> added;
+    std::vector<entity::CADEntity_CSPtr> removed;
+    added.reserve(adds.size() + replaces.size());
+    removed.reserve(removes.size() + replaces.size());
+
+    auto removeStored = [&](const entity::CADEntity_CSPtr& entity) {
+        auto stored = _storageManager->entityByID(entity->id());
+        if (stored != nullptr) {
+            removeWaitingCustomEntity(stored);
+            _storageManager->removeEntity(stored);
+            removed.push_back(stored);
+        }
+    };
+
+    for (const auto& entity : removes) {
+        removeStored(entity);
+    }
+
+    // When the same ID is given more than once, the last version wins
+    std::unordered_map<ID_DATATYPE, size_t> addedIndex;
+    addedIndex.reserve(adds.size() + replaces.size());
+
+    auto addEntity = [&](const entity::CADEntity_CSPtr& entity) {
+        auto it = addedIndex.find(entity->id());
+        if (it != addedIndex.end()) {
+            added[it->second] = entity;
+            return;
+        }
+
+        removeStored(entity);
+        addedIndex.emplace(entity->id(), added.size());
+        added.push_back(entity);
+    };
+
+    for (const auto& entity : replaces) {
+        addEntity(entity);
+    }
+
+    for (const auto& entity : adds) {
+        addEntity(entity);
+    }
+
+    _storageManager->insertEntities(added);
+
+    for (const auto& entity : added) {
+        addWaitingCustomEntity(entity);
+    }
+
+    if (!added.empty() || !removed.empty()) {
+        event::BatchEntityEvent event(std::move(added), std::move(removed));
+        batchEntityEvent()(event);
+    }
+}
+
+void DocumentImpl::addWaitingCustomEntity(const entity::CADEntity_CSPtr& entity) {
+    if (entity->entityTag() != entity::EntityTag::CustomEntityInsert) {
+        return;
+    }
+
+    auto insert = std::static_pointer_cast<const entity::Insert>(entity);
+    auto ces = std::static_pointer_cast<const meta::CustomEntityStorage>(insert->displayBlock());
+
+    _waitingCustomEntities[ces->pluginName()].insert(insert);
+    _newWaitingCustomEntities.insert(insert);
+}
+
+void DocumentImpl::removeWaitingCustomEntity(const entity::CADEntity_CSPtr& entity) {
+    if (entity->entityTag() != entity::EntityTag::CustomEntityInsert) {
+        return;
+    }
+
+    auto insert = std::static_pointer_cast<const entity::Insert>(entity);
+    auto ces = std::static_pointer_cast<const meta::CustomEntityStorage>(insert->displayBlock());
+
+    _waitingCustomEntities[ces->pluginName()].erase(insert);
+}
+
 
 
 void DocumentImpl::addDocumentMetaType(const lc::meta::DocumentMetaType_CSPtr& dmt) {
@@ -105,6 +224,12 @@ void DocumentImpl::addDocumentMetaType(const lc::meta::DocumentMetaType_CSPtr& d
         event::AddLinePatternEvent event(linePattern);
         addLinePatternEvent()(event);
     }
+
+    auto block = std::dynamic_pointer_cast<const meta::Block>(dmt);
+    if (block != nullptr) {
+        event::AddBlockEvent event(block);
+        addBlockEvent()(event);
+    }
 }
 void DocumentImpl::removeDocumentMetaType(const meta::DocumentMetaType_CSPtr& dmt) {
     _storageManager->removeDocumentMetaType(dmt);
@@ -119,6 +244,12 @@ void DocumentImpl::removeDocumentMetaType(const meta::DocumentMetaType_CSPtr& dm
         event::RemoveLinePatternEvent event(linePattern);
         removeLinePatternEvent()(event);
     }
+
+    auto block = std::dynamic_pointer_cast<const meta::Block>(dmt);
+    if (block != nullptr) {
+        event::RemoveBlockEvent event(block);
+        removeBlockEvent()(event);
+    }
 }
 void DocumentImpl::replaceDocumentMetaType(const meta::DocumentMetaType_CSPtr& oldDmt, meta::DocumentMetaType_CSPtr newDmt) {
     _storageManager->replaceDocumentMetaType(oldDmt, newDmt);
@@ -141,6 +272,15 @@ void DocumentImpl::replaceDocumentMetaType(const meta::DocumentMetaType_CSPtr& o
             replaceLinePatternEvent()(event);
         }
     }
+
+    auto oldBlock = std::dynamic_pointer_cast<const meta::Block>(oldDmt);
+    if (oldBlock != nullptr) {
+        auto newBlock = std::dynamic_pointer_cast<const meta::Block>(newDmt);
+        if (newBlock != nullptr) {
+            event::ReplaceBlockEvent event(oldBlock, newBlock);
+            replaceBlockEvent()(event);
+        }
+    }
 }
 
 std::map<std::string, lc::meta::DocumentMetaType_CSPtr, lc::tools::StringHelper::cmpCaseInsensetive> DocumentImpl::allMetaTypes() {
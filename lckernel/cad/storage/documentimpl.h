@@ -10,6 +10,7 @@
 #include "document.h"
 #include "storagemanager.h"
 #include "cad/operations/documentoperation.h"
+#include "cad/operations/transaction.h"
 
 namespace lc {
 namespace storage {
@@ -24,6 +25,14 @@ public:
 
     void removeEntity(const entity::CADEntity_CSPtr& entity) override;
 
+    void applyBatch(const std::vector<entity::CADEntity_CSPtr>& adds,
+                    const std::vector<entity::CADEntity_CSPtr>& removes,
+                    const std::vector<entity::CADEntity_CSPtr>& replaces) override;
+
+    void batch(const std::function<void()>& func) override;
+
+    void batchInto(const operation::Transaction_SPtr& transaction, const std::function<void()>& func) override;
+
     void addDocumentMetaType(const meta::DocumentMetaType_CSPtr& dmt) override;
 
     void removeDocumentMetaType(const meta::DocumentMetaType_CSPtr& dmt) override;
@@ -65,12 +74,26 @@ public:
     std::vector<lc::meta::Block_CSPtr> blocks() const override;
 
 private:
+    /**
+     * @brief Register a custom entity insert waiting for its plugin
+     */
+    void addWaitingCustomEntity(const entity::CADEntity_CSPtr& entity);
+
+    /**
+     * @brief Unregister a custom entity insert waiting for its plugin
+     */
+    void removeWaitingCustomEntity(const entity::CADEntity_CSPtr& entity);
+
     std::mutex _documentMutex;
     // AI am considering remove the shared_ptr from this one so we can never get a shared object from it
     StorageManager_SPtr _storageManager;
 
     std::map<std::string, std::unordered_set<entity::Insert_CSPtr>> _waitingCustomEntities;
     std::unordered_set<entity::Insert_CSPtr> _newWaitingCustomEntities;
+
+    // Operations executed during batch() are collected here
+    unsigned int _batchDepth;
+    operation::Transaction_SPtr _transaction;
 };
 }
 }
@@ -0,0 +1,969 @@
+#include "entitycodec.h"
+#include "document.h"
+
+#include <mutex>
+#include <stdexcept>
+
+#include "cad/builders/insert.h"
+#include "cad/meta/customentitystorage.h"
+#include "cad/meta/metacolor.h"
+#include "cad/meta/metalinewidth.h"
+#include "cad/meta/metapool.h"
+#include "cad/primitive/arc.h"
+#include "cad/primitive/circle.h"
+#include "cad/primitive/dimaligned.h"
+#include "cad/primitive/dimangular.h"
+#include "cad/primitive/dimdiametric.h"
+#include "cad/primitive/dimlinear.h"
+#include "cad/primitive/dimradial.h"
+#include "cad/primitive/ellipse.h"
+#include "cad/primitive/hatch.h"
+#include "cad/primitive/image.h"
+#include "cad/primitive/insert.h"
+#include "cad/primitive/line.h"
+#include "cad/primitive/lwpolyline.h"
+#include "cad/primitive/point.h"
+#include "cad/primitive/spline.h"
+#include "cad/primitive/text.h"
+
+using namespace lc;
+using namespace lc::storage;
+using namespace lc::storage::entitycodec;
+
+namespace {
+enum MetaKind : uint8_t {
+    COLOR_BY_VALUE = 1,
+    COLOR_BY_BLOCK,
+    LINEWIDTH_BY_VALUE,
+    LINEWIDTH_BY_BLOCK,
+    LINEPATTERN_BY_VALUE,
+    LINEPATTERN_BY_BLOCK
+};
+
+enum BlockKind : uint8_t {
+    BLOCK = 0,
+    CUSTOM_ENTITY_STORAGE
+};
+
+enum MetaTypeKind : uint8_t {
+    LAYER = 1,
+    LINEPATTERN,
+    BLOCK_DEFINITION
+};
+
+const uint64_t REFERENCE_NULL = 0;
+const uint64_t REFERENCE_DEFINITION = 1;
+const uint64_t REFERENCE_OFFSET = 2;
+
+/**
+ * Make sure newly created entities don't get the ID of a decoded entity
+ */
+void reserveID(ID_DATATYPE id) {
+    auto current = entity::ID::__idCounter.load();
+
+    while (current < id && !entity::ID::__idCounter.compare_exchange_weak(current, id)) {
+    }
+}
+
+struct DecodedHeader {
+    ID_DATATYPE id;
+    meta::Layer_CSPtr layer;
+    meta::MetaInfo_CSPtr metaInfo;
+    meta::Block_CSPtr block;
+};
+
+template<typename T>
+entity::CADEntity_CSPtr withID(std::shared_ptr<T> entity, ID_DATATYPE id) {
+    entity->setID(id);
+    return entity;
+}
+}
+
+/********************************************************************************************************/
+/** EntityEncoder                                                                                     ***/
+/********************************************************************************************************/
+EntityEncoder::EntityEncoder(BinaryWriter& writer) :
+    _writer(writer),
+    _written(false) {
+}
+
+bool EntityEncoder::write(const entity::CADEntity_CSPtr& entity) {
+    _written = false;
+
+    // Insert doesn't support dispatch, custom entities are stored as the insert waiting for their plugin
+    if (entity->entityTag() != entity::EntityTag::Generic) {
+        auto insert = std::dynamic_pointer_cast<const entity::Insert>(entity);
+        if (insert == nullptr) {
+            return false;
+        }
+
+        writeHeader(INSERT, entity);
+        writeBlock(insert->displayBlock());
+        _writer.writeCoordinate(insert->position());
+        return true;
+    }
+
+    entity->dispatch(*this);
+    return _written;
+}
+
+bool EntityEncoder::writeMetaType(const meta::DocumentMetaType_CSPtr& metaType) {
+    if (auto layer = std::dynamic_pointer_cast<const meta::Layer>(metaType)) {
+        _writer.writeUInt8(LAYER);
+        writeLayer(layer);
+    }
+    else if (auto linePattern = std::dynamic_pointer_cast<const meta::DxfLinePatternByValue>(metaType)) {
+        _writer.writeUInt8(LINEPATTERN);
+        writeLinePattern(linePattern);
+    }
+    else if (auto block = std::dynamic_pointer_cast<const meta::Block>(metaType)) {
+        _writer.writeUInt8(BLOCK_DEFINITION);
+        writeBlock(block);
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+void EntityEncoder::reset() {
+    _referenced.clear();
+    _layers.clear();
+    _linePatterns.clear();
+    _blocks.clear();
+    _metaInfos.clear();
+}
+
+void EntityEncoder::writeHeader(EntityType type, const entity::CADEntity_CSPtr& entity) {
+    _writer.writeUInt8(type);
+    _writer.writeVarUInt(entity->id());
+    writeLayer(entity->layer());
+    writeMetaInfo(entity->metaInfo());
+    writeBlock(entity->block());
+    _written = true;
+}
+
+void EntityEncoder::writeDimension(const entity::Dimension& dimension) {
+    _writer.writeCoordinate(dimension.definitionPoint());
+    _writer.writeCoordinate(dimension.middleOfText());
+    _writer.writeUInt8(dimension.attachmentPoint());
+    _writer.writeDouble(dimension.textAngle());
+    _writer.writeDouble(dimension.lineSpacingFactor());
+    _writer.writeUInt8(dimension.lineSpacingStyle());
+    _writer.writeString(dimension.explicitValue());
+}
+
+void EntityEncoder::writeEntities(const std::vector<entity::CADEntity_CSPtr>& entities) {
+    // Write to a separate buffer, since unsupported entities are skipped the count is only known afterwards
+    BinaryWriter content;
+    EntityEncoder encoder(content);
+    std::swap(encoder._referenced, _referenced);
+    std::swap(encoder._layers, _layers);
+    std::swap(encoder._linePatterns, _linePatterns);
+    std::swap(encoder._blocks, _blocks);
+    std::swap(encoder._metaInfos, _metaInfos);
+
+    uint64_t count = 0;
+    for (const auto& entity : entities) {
+        if (encoder.write(entity)) {
+            count++;
+        }
+    }
+
+    std::swap(encoder._referenced, _referenced);
+    std::swap(encoder._layers, _layers);
+    std::swap(encoder._linePatterns, _linePatterns);
+    std::swap(encoder._blocks, _blocks);
+    std::swap(encoder._metaInfos, _metaInfos);
+
+    _writer.writeVarUInt(count);
+    _writer.writeBytes(content.buffer().data(), content.buffer().size());
+}
+
+bool EntityEncoder::writeReference(const std::shared_ptr<const void>& object, std::unordered_map<const void*, uint64_t>& table) {
+    if (object == nullptr) {
+        _writer.writeVarUInt(REFERENCE_NULL);
+        return false;
+    }
+
+    auto it = table.find(object.get());
+    if (it != table.end()) {
+        _writer.writeVarUInt(it->second + REFERENCE_OFFSET);
+        return false;
+    }
+
+    table.emplace(object.get(), table.size());
+    _referenced.push_back(object);
+    _writer.writeVarUInt(REFERENCE_DEFINITION);
+    return true;
+}
+
+void EntityEncoder::writeLayer(const meta::Layer_CSPtr& layer) {
+    if (!writeReference(layer, _layers)) {
+        return;
+    }
+
+    auto color = layer->color();
+    _writer.writeString(layer->name());
+    _writer.writeDouble(layer->lineWidth().width());
+    _writer.writeDouble(color.red());
+    _writer.writeDouble(color.green());
+    _writer.writeDouble(color.blue());
+    _writer.writeDouble(color.alpha());
+    writeLinePattern(layer->linePattern());
+    _writer.writeBool(layer->isFrozen());
+}
+
+void EntityEncoder::writeLinePattern(const meta::DxfLinePatternByValue_CSPtr& linePattern) {
+    if (!writeReference(linePattern, _linePatterns)) {
+        return;
+    }
+
+    _writer.writeString(linePattern->name());
+    _writer.writeString(linePattern->description());
+    _writer.writeVarUInt(linePattern->path().size());
+    for (auto value : linePattern->path()) {
+        _writer.writeDouble(value);
+    }
+    _writer.writeDouble(linePattern->length());
+}
+
+void EntityEncoder::writeBlock(const meta::Block_CSPtr& block) {
+    if (!writeReference(block, _blocks)) {
+        return;
+    }
+
+    auto customEntityStorage = std::dynamic_pointer_cast<const meta::CustomEntityStorage>(block);
+    if (customEntityStorage != nullptr) {
+        _writer.writeUInt8(CUSTOM_ENTITY_STORAGE);
+        _writer.writeString(customEntityStorage->pluginName());
+        _writer.writeString(customEntityStorage->entityName());
+        _writer.writeCoordinate(customEntityStorage->base());
+        _writer.writeVarUInt(customEntityStorage->params().size());
+        for (const auto& param : customEntityStorage->params()) {
+            _writer.writeString(param.first);
+            _writer.writeString(param.second);
+        }
+        return;
+    }
+
+    _writer.writeUInt8(BLOCK);
+    _writer.writeString(block->name());
+    _writer.writeCoordinate(block->base());
+}
+
+void EntityEncoder::writeMetaInfo(const meta::MetaInfo_CSPtr& metaInfo) {
+    if (!writeReference(metaInfo, _metaInfos)) {
+        return;
+    }
+
+    // Write to a separate buffer, unknown meta types are skipped
+    BinaryWriter content;
+    std::vector<meta::DxfLinePatternByValue_CSPtr> linePatterns;
+    uint64_t count = 0;
+
+    for (const auto& item : *metaInfo) {
+        const auto& metaType = item.second;
+
+        if (auto color = std::dynamic_pointer_cast<const meta::MetaColorByValue>(metaType)) {
+            content.writeUInt8(COLOR_BY_VALUE);
+            content.writeDouble(color->red());
+            content.writeDouble(color->green());
+            content.writeDouble(color->blue());
+            content.writeDouble(color->alpha());
+        }
+        else if (std::dynamic_pointer_cast<const meta::MetaColorByBlock>(metaType)) {
+            content.writeUInt8(COLOR_BY_BLOCK);
+        }
+        else if (auto width = std::dynamic_pointer_cast<const meta::MetaLineWidthByValue>(metaType)) {
+            content.writeUInt8(LINEWIDTH_BY_VALUE);
+            content.writeDouble(width->width());
+        }
+        else if (std::dynamic_pointer_cast<const meta::MetaLineWidthByBlock>(metaType)) {
+            content.writeUInt8(LINEWIDTH_BY_BLOCK);
+        }
+        else if (auto linePattern = std::dynamic_pointer_cast<const meta::DxfLinePatternByValue>(metaType)) {
+            content.writeUInt8(LINEPATTERN_BY_VALUE);
+            linePatterns.push_back(linePattern);
+        }
+        else if (std::dynamic_pointer_cast<const meta::DxfLinePatternByBlock>(metaType)) {
+            content.writeUInt8(LINEPATTERN_BY_BLOCK);
+        }
+        else {
+            continue;
+        }
+
+        count++;
+    }
+
+    // Line patterns references are written after the list, since they can contain definitions
+    _writer.writeVarUInt(count);
+    _writer.writeBytes(content.buffer().data(), content.buffer().size());
+    for (const auto& linePattern : linePatterns) {
+        writeLinePattern(linePattern);
+    }
+}
+
+void EntityEncoder::visit(entity::Line_CSPtr line) {
+    writeHeader(LINE, line);
+    _writer.writeCoordinate(line->start());
+    _writer.writeCoordinate(line->end());
+}
+
+void EntityEncoder::visit(entity::Point_CSPtr point) {
+    writeHeader(POINT, point);
+    _writer.writeCoordinate(*point);
+}
+
+void EntityEncoder::visit(entity::Circle_CSPtr circle) {
+    writeHeader(CIRCLE, circle);
+    _writer.writeCoordinate(circle->center());
+    _writer.writeDouble(circle->radius());
+}
+
+void EntityEncoder::visit(entity::Arc_CSPtr arc) {
+    writeHeader(ARC, arc);
+    _writer.writeCoordinate(arc->center());
+    _writer.writeDouble(arc->radius());
+    _writer.writeDouble(arc->startAngle());
+    _writer.writeDouble(arc->endAngle());
+    _writer.writeBool(arc->CCW());
+}
+
+void EntityEncoder::visit(entity::Ellipse_CSPtr ellipse) {
+    writeHeader(ELLIPSE, ellipse);
+    _writer.writeCoordinate(ellipse->center());
+    _writer.writeCoordinate(ellipse->majorP());
+    _writer.writeDouble(ellipse->minorRadius());
+    _writer.writeDouble(ellipse->startAngle());
+    _writer.writeDouble(ellipse->endAngle());
+    _writer.writeBool(ellipse->isReversed());
+}
+
+void EntityEncoder::visit(entity::Text_CSPtr text) {
+    writeHeader(TEXT, text);
+    _writer.writeCoordinate(text->insertion_point());
+    _writer.writeString(text->text_value());
+    _writer.writeDouble(text->height());
+    _writer.writeDouble(text->angle());
+    _writer.writeString(text->style());
+    _writer.writeUInt8(text->textgeneration());
+    _writer.writeUInt8(text->halign());
+    _writer.writeUInt8(text->valign());
+    _writer.writeBool(text->underlined());
+    _writer.writeBool(text->strikethrough());
+    _writer.writeBool(text->bold());
+    _writer.writeBool(text->italic());
+}
+
+void EntityEncoder::visit(entity::Spline_CSPtr spline) {
+    writeHeader(SPLINE, spline);
+
+    _writer.writeVarUInt(spline->controlPoints().size());
+    for (const auto& point : spline->controlPoints()) {
+        _writer.writeCoordinate(point);
+    }
+
+    _writer.writeVarUInt(spline->knotPoints().size());
+    for (auto knot : spline->knotPoints()) {
+        _writer.writeDouble(knot);
+    }
+
+    _writer.writeVarUInt(spline->fitPoints().size());
+    for (const auto& point : spline->fitPoints()) {
+        _writer.writeCoordinate(point);
+    }
+
+    _writer.writeVarUInt(spline->degree());
+    _writer.writeBool(spline->closed());
+    _writer.writeDouble(spline->fitTolerance());
+    _writer.writeCoordinate(geo::Coordinate(spline->startTanX(), spline->startTanY(), spline->startTanZ()));
+    _writer.writeCoordinate(geo::Coordinate(spline->endTanX(), spline->endTanY(), spline->endTanZ()));
+    _writer.writeCoordinate(geo::Coordinate(spline->nX(), spline->nY(), spline->nZ()));
+    _writer.writeVarUInt(spline->flags());
+}
+
+void EntityEncoder::visit(entity::DimAligned_CSPtr dimension) {
+    writeHeader(DIMALIGNED, dimension);
+    writeDimension(*dimension);
+    _writer.writeCoordinate(dimension->definitionPoint2());
+    _writer.writeCoordinate(dimension->definitionPoint3());
+}
+
+void EntityEncoder::visit(entity::DimAngular_CSPtr dimension) {
+    writeHeader(DIMANGULAR, dimension);
+    writeDimension(*dimension);
+    _writer.writeCoordinate(dimension->defLine11());
+    _writer.writeCoordinate(dimension->defLine12());
+    _writer.writeCoordinate(dimension->defLine21());
+    _writer.writeCoordinate(dimension->defLine22());
+}
+
+void EntityEncoder::visit(entity::DimDiametric_CSPtr dimension) {
+    writeHeader(DIMDIAMETRIC, dimension);
+    writeDimension(*dimension);
+    _writer.writeCoordinate(dimension->definitionPoint2());
+    _writer.writeDouble(dimension->leader());
+}
+
+void EntityEncoder::visit(entity::DimLinear_CSPtr dimension) {
+    writeHeader(DIMLINEAR, dimension);
+    writeDimension(*dimension);
+    _writer.writeCoordinate(dimension->definitionPoint2());
+    _writer.writeCoordinate(dimension->definitionPoint3());
+    _writer.writeDouble(dimension->angle());
+    _writer.writeDouble(dimension->oblique());
+}
+
+void EntityEncoder::visit(entity::DimRadial_CSPtr dimension) {
+    writeHeader(DIMRADIAL, dimension);
+    writeDimension(*dimension);
+    _writer.writeCoordinate(dimension->definitionPoint2());
+    _writer.writeDouble(dimension->leader());
+}
+
+void EntityEncoder::visit(entity::LWPolyline_CSPtr polyline) {
+    writeHeader(LWPOLYLINE, polyline);
+
+    _writer.writeVarUInt(polyline->vertex().size());
+    for (const auto& vertex : polyline->vertex()) {
+        _writer.writeCoordinate(vertex.location());
+        _writer.writeDouble(vertex.bulge());
+        _writer.writeDouble(vertex.startWidth());
+        _writer.writeDouble(vertex.endWidth());
+    }
+
+    _writer.writeDouble(polyline->width());
+    _writer.writeDouble(polyline->elevation());
+    _writer.writeDouble(polyline->tickness());
+    _writer.writeBool(polyline->closed());
+    _writer.writeCoordinate(polyline->extrusionDirection());
+}
+
+void EntityEncoder::visit(entity::Image_CSPtr image) {
+    writeHeader(IMAGE, image);
+    _writer.writeString(image->name());
+    _writer.writeCoordinate(image->base());
+    _writer.writeCoordinate(image->uv());
+    _writer.writeCoordinate(image->vv());
+    _writer.writeDouble(image->width());
+    _writer.writeDouble(image->height());
+    _writer.writeDouble(image->brightness());
+    _writer.writeDouble(image->contrast());
+    _writer.writeDouble(image->fade());
+}
+
+void EntityEncoder::visit(entity::Hatch_CSPtr hatch) {
+    writeHeader(HATCH, hatch);
+    _writer.writeString(hatch->getPatternName());
+    _writer.writeBool(hatch->isSolid());
+    _writer.writeDouble(hatch->getAngle());
+    _writer.writeDouble(hatch->getScale());
+
+    const auto& loops = hatch->getRegion().loopList();
+    _writer.writeVarUInt(loops.size());
+    for (const auto& loop : loops) {
+        writeEntities(loop.entities());
+    }
+
+    const auto& pattern = hatch->getPattern();
+    _writer.writeString(pattern.name);
+    _writer.writeCoordinate(pattern.boundingBox.minP());
+    _writer.writeCoordinate(pattern.boundingBox.maxP());
+    writeEntities(pattern.entities);
+}
+
+/********************************************************************************************************/
+/** EntityDecoder                                                                                     ***/
+/********************************************************************************************************/
+EntityDecoder::EntityDecoder(Document_SPtr document) :
+    _document(std::move(document)) {
+}
+
+std::vector<meta::DocumentMetaType_CSPtr> EntityDecoder::takeNewMetaTypes() {
+    std::vector<meta::DocumentMetaType_CSPtr> newMetaTypes;
+    std::swap(newMetaTypes, _newMetaTypes);
+    return newMetaTypes;
+}
+
+meta::DocumentMetaType_CSPtr EntityDecoder::readMetaType(BinaryReader& reader, bool fromDocument) {
+    switch (reader.readUInt8()) {
+        case LAYER:
+            return readLayer(reader, fromDocument);
+
+        case LINEPATTERN:
+            return readLinePattern(reader, fromDocument);
+
+        case BLOCK_DEFINITION:
+            return readBlock(reader, fromDocument);
+
+        default:
+            throw std::runtime_error("Unknown meta type");
+    }
+}
+
+void EntityDecoder::addMetaType(const meta::DocumentMetaType_CSPtr& metaType) {
+    _known[metaType->id()] = metaType;
+}
+
+template<typename T>
+std::shared_ptr<const T> EntityDecoder::resolve(std::shared_ptr<const T> decoded) {
+    auto it = _known.find(decoded->id());
+    if (it != _known.end()) {
+        auto known = std::dynamic_pointer_cast<const T>(it->second);
+        if (known != nullptr) {
+            return known;
+        }
+    }
+
+    _known[decoded->id()] = decoded;
+    _newMetaTypes.push_back(decoded);
+    return decoded;
+}
+
+void EntityDecoder::reset() {
+    _layers.clear();
+    _linePatterns.clear();
+    _blocks.clear();
+    _metaInfos.clear();
+}
+
+meta::Layer_CSPtr EntityDecoder::readLayer(BinaryReader& reader, bool fromDocument) {
+    auto reference = reader.readVarUInt();
+
+    if (reference == REFERENCE_NULL) {
+        return nullptr;
+    }
+
+    if (reference != REFERENCE_DEFINITION) {
+        return _layers.at(reference - REFERENCE_OFFSET);
+    }
+
+    auto name = reader.readString();
+    auto width = reader.readDouble();
+    auto red = reader.readDouble();
+    auto green = reader.readDouble();
+    auto blue = reader.readDouble();
+    auto alpha = reader.readDouble();
+    auto linePattern = readLinePattern(reader);
+    auto frozen = reader.readBool();
+
+    meta::Layer_CSPtr layer;
+    if (fromDocument) {
+        layer = _document->layerByName(name);
+    }
+
+    if (layer == nullptr) {
+        layer = std::make_shared<const meta::Layer>(name, meta::MetaLineWidthByValue(width), Color(red, green, blue, alpha), linePattern, frozen);
+
+        if (fromDocument) {
+            layer = resolve(layer);
+        }
+    }
+
+    _layers.push_back(layer);
+    return layer;
+}
+
+meta::DxfLinePatternByValue_CSPtr EntityDecoder::readLinePattern(BinaryReader& reader, bool fromDocument) {
+    auto reference = reader.readVarUInt();
+
+    if (reference == REFERENCE_NULL) {
+        return nullptr;
+    }
+
+    if (reference != REFERENCE_DEFINITION) {
+        return _linePatterns.at(reference - REFERENCE_OFFSET);
+    }
+
+    auto name = reader.readString();
+    auto description = reader.readString();
+    std::vector<double> path(reader.readVarUInt());
+    for (auto& value : path) {
+        value = reader.readDouble();
+    }
+    auto length = reader.readDouble();
+
+    meta::DxfLinePatternByValue_CSPtr linePattern;
+    if (fromDocument) {
+        linePattern = _document->linePatternByName(name);
+    }
+
+    if (linePattern == nullptr) {
+        linePattern = std::make_shared<const meta::DxfLinePatternByValue>(name, description, path, length);
+
+        if (fromDocument) {
+            linePattern = resolve(linePattern);
+        }
+    }
+
+    _linePatterns.push_back(linePattern);
+    return linePattern;
+}
+
+meta::Block_CSPtr EntityDecoder::readBlock(BinaryReader& reader, bool fromDocument) {
+    auto reference = reader.readVarUInt();
+
+    if (reference == REFERENCE_NULL) {
+        return nullptr;
+    }
+
+    if (reference != REFERENCE_DEFINITION) {
+        return _blocks.at(reference - REFERENCE_OFFSET);
+    }
+
+    meta::Block_CSPtr block;
+
+    switch (reader.readUInt8()) {
+        case BLOCK: {
+            auto name = reader.readString();
+            auto base = reader.readCoordinate();
+            block = std::make_shared<const meta::Block>(name, base);
+            break;
+        }
+
+        case CUSTOM_ENTITY_STORAGE: {
+            auto pluginName = reader.readString();
+            auto entityName = reader.readString();
+            auto base = reader.readCoordinate();
+            std::map<std::string, std::string> params;
+            for (auto count = reader.readVarUInt(); count > 0; count--) {
+                auto key = reader.readString();
+                params[key] = reader.readString();
+            }
+            block = std::make_shared<const meta::CustomEntityStorage>(pluginName, entityName, base, params);
+            break;
+        }
+
+        default:
+            throw std::runtime_error("Unknown block type");
+    }
+
+    if (fromDocument) {
+        auto existing = _document->blockByName(block->name());
+        if (existing != nullptr) {
+            block = existing;
+        }
+        else {
+            block = resolve(block);
+        }
+    }
+
+    _blocks.push_back(block);
+    return block;
+}
+
+meta::MetaInfo_CSPtr EntityDecoder::readMetaInfo(BinaryReader& reader) {
+    auto reference = reader.readVarUInt();
+
+    if (reference == REFERENCE_NULL) {
+        return nullptr;
+    }
+
+    if (reference != REFERENCE_DEFINITION) {
+        return _metaInfos.at(reference - REFERENCE_OFFSET);
+    }
+
+    auto metaInfo = meta::MetaInfo::create();
+    auto count = reader.readVarUInt();
+    size_t linePatterns = 0;
+
+    for (uint64_t i = 0; i < count; i++) {
+        switch (reader.readUInt8()) {
+            case COLOR_BY_VALUE: {
+                auto red = reader.readDouble();
+                auto green = reader.readDouble();
+                auto blue = reader.readDouble();
+                auto alpha = reader.readDouble();
+                metaInfo->add(std::make_shared<const meta::MetaColorByValue>(red, green, blue, alpha));
+                break;
+            }
+
+            case COLOR_BY_BLOCK:
+                metaInfo->add(std::make_shared<const meta::MetaColorByBlock>());
+                break;
+
+            case LINEWIDTH_BY_VALUE:
+                metaInfo->add(std::make_shared<const meta::MetaLineWidthByValue>(reader.readDouble()));
+                break;
+
+            case LINEWIDTH_BY_BLOCK:
+                metaInfo->add(std::make_shared<const meta::MetaLineWidthByBlock>());
+                break;
+
+            case LINEPATTERN_BY_VALUE:
+                linePatterns++;
+                break;
+
+            case LINEPATTERN_BY_BLOCK:
+                metaInfo->add(std::make_shared<const meta::DxfLinePatternByBlock>());
+                break;
+
+            default:
+                throw std::runtime_error("Unknown meta type");
+        }
+    }
+
+    for (size_t i = 0; i < linePatterns; i++) {
+        auto linePattern = readLinePattern(reader);
+        if (linePattern != nullptr) {
+            metaInfo->add(linePattern);
+        }
+    }
+
+    auto interned = meta::MetaPool::instance().intern(metaInfo);
+    _metaInfos.push_back(interned);
+    return interned;
+}
+
+std::vector<entity::CADEntity_CSPtr> EntityDecoder::readEntities(BinaryReader& reader) {
+    std::vector<entity::CADEntity_CSPtr> entities(reader.readVarUInt());
+
+    for (auto& entity : entities) {
+        entity = read(reader);
+    }
+
+    return entities;
+}
+
+entity::CADEntity_CSPtr EntityDecoder::read(BinaryReader& reader) {
+    auto type = reader.readUInt8();
+
+    DecodedHeader header;
+    header.id = reader.readVarUInt();
+    header.layer = readLayer(reader);
+    header.metaInfo = readMetaInfo(reader);
+    header.block = readBlock(reader);
+
+    reserveID(header.id);
+
+    switch (type) {
+        case LINE: {
+            auto start = reader.readCoordinate();
+            auto end = reader.readCoordinate();
+            return withID(std::make_shared<entity::Line>(start, end, header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case POINT: {
+            auto position = reader.readCoordinate();
+            return withID(std::make_shared<entity::Point>(position, header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case CIRCLE: {
+            auto center = reader.readCoordinate();
+            auto radius = reader.readDouble();
+            return withID(std::make_shared<entity::Circle>(center, radius, header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case ARC: {
+            auto center = reader.readCoordinate();
+            auto radius = reader.readDouble();
+            auto startAngle = reader.readDouble();
+            auto endAngle = reader.readDouble();
+            auto ccw = reader.readBool();
+            return withID(std::make_shared<entity::Arc>(center, radius, startAngle, endAngle, ccw,
+                          header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case ELLIPSE: {
+            auto center = reader.readCoordinate();
+            auto majorP = reader.readCoordinate();
+            auto minorRadius = reader.readDouble();
+            auto startAngle = reader.readDouble();
+            auto endAngle = reader.readDouble();
+            auto reversed = reader.readBool();
+            return withID(std::make_shared<entity::Ellipse>(center, majorP, minorRadius, startAngle, endAngle, reversed,
+                          header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case TEXT: {
+            auto insertionPoint = reader.readCoordinate();
+            auto value = reader.readString();
+            auto height = reader.readDouble();
+            auto angle = reader.readDouble();
+            auto style = reader.readString();
+            auto textGeneration = static_cast<TextConst::DrawingDirection>(reader.readUInt8());
+            auto halign = static_cast<TextConst::HAlign>(reader.readUInt8());
+            auto valign = static_cast<TextConst::VAlign>(reader.readUInt8());
+            auto underlined = reader.readBool();
+            auto strikethrough = reader.readBool();
+            auto bold = reader.readBool();
+            auto italic = reader.readBool();
+            return withID(std::make_shared<entity::Text>(insertionPoint, value, height, angle, style,
+                          textGeneration, halign, valign, underlined, strikethrough, bold, italic,
+                          header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case SPLINE: {
+            std::vector<geo::Coordinate> controlPoints(reader.readVarUInt());
+            for (auto& point : controlPoints) {
+                point = reader.readCoordinate();
+            }
+
+            std::vector<double> knotPoints(reader.readVarUInt());
+            for (auto& knot : knotPoints) {
+                knot = reader.readDouble();
+            }
+
+            std::vector<geo::Coordinate> fitPoints(reader.readVarUInt());
+            for (auto& point : fitPoints) {
+                point = reader.readCoordinate();
+            }
+
+            auto degree = static_cast<int>(reader.readVarUInt());
+            auto closed = reader.readBool();
+            auto fitTolerance = reader.readDouble();
+            auto startTangent = reader.readCoordinate();
+            auto endTangent = reader.readCoordinate();
+            auto normal = reader.readCoordinate();
+            auto flags = static_cast<geo::Spline::splineflag>(reader.readVarUInt());
+
+            return withID(std::make_shared<entity::Spline>(controlPoints, knotPoints, fitPoints, degree, closed, fitTolerance,
+                          startTangent.x(), startTangent.y(), startTangent.z(),
+                          endTangent.x(), endTangent.y(), endTangent.z(),
+                          normal.x(), normal.y(), normal.z(), flags,
+                          header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case LWPOLYLINE: {
+            std::vector<entity::LWVertex2D> vertex;
+            auto count = reader.readVarUInt();
+            vertex.reserve(count);
+            for (uint64_t i = 0; i < count; i++) {
+                auto location = reader.readCoordinate();
+                auto bulge = reader.readDouble();
+                auto startWidth = reader.readDouble();
+                auto endWidth = reader.readDouble();
+                vertex.emplace_back(location, bulge, startWidth, endWidth);
+            }
+
+            auto width = reader.readDouble();
+            auto elevation = reader.readDouble();
+            auto thickness = reader.readDouble();
+            auto closed = reader.readBool();
+            auto extrusionDirection = reader.readCoordinate();
+
+            return withID(std::make_shared<entity::LWPolyline>(vertex, width, elevation, thickness, closed, extrusionDirection,
+                          header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case IMAGE: {
+            auto name = reader.readString();
+            auto base = reader.readCoordinate();
+            auto uv = reader.readCoordinate();
+            auto vv = reader.readCoordinate();
+            auto width = reader.readDouble();
+            auto height = reader.readDouble();
+            auto brightness = reader.readDouble();
+            auto contrast = reader.readDouble();
+            auto fade = reader.readDouble();
+            return withID(std::make_shared<entity::Image>(name, base, uv, vv, width, height, brightness, contrast, fade,
+                          header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        case HATCH: {
+            auto hatch = std::make_shared<entity::Hatch>(header.layer, header.metaInfo, header.block);
+            hatch->setPatternName(reader.readString());
+            hatch->setSolid(reader.readBool());
+            hatch->setAngle(reader.readDouble());
+            hatch->setScale(reader.readDouble());
+
+            geo::Region region;
+            for (auto loops = reader.readVarUInt(); loops > 0; loops--) {
+                auto entities = readEntities(reader);
+                if (!entities.empty()) {
+                    region.addLoop(geo::Loop(entities));
+                }
+            }
+            hatch->setRegion(region);
+
+            objects::Pattern pattern;
+            pattern.name = reader.readString();
+            auto minP = reader.readCoordinate();
+            auto maxP = reader.readCoordinate();
+            pattern.boundingBox = geo::Area(minP, maxP);
+            pattern.entities = readEntities(reader);
+            hatch->setPattern(pattern);
+
+            return withID(hatch, header.id);
+        }
+
+        case INSERT: {
+            auto displayBlock = readBlock(reader);
+            auto position = reader.readCoordinate();
+
+            // Inserts connect to the events of the document, which isn't safe when decoders run in parallel
+            static std::mutex insertMutex;
+            std::lock_guard<std::mutex> lock(insertMutex);
+
+            builder::InsertBuilder builder;
+            builder.setLayer(header.layer);
+            builder.setMetaInfo(header.metaInfo);
+            builder.setBlock(header.block);
+            builder.setID(header.id);
+            builder.setDisplayBlock(displayBlock);
+            builder.setCoordinate(position);
+            builder.setDocument(_document);
+            return builder.build();
+        }
+
+        case DIMALIGNED:
+        case DIMANGULAR:
+        case DIMDIAMETRIC:
+        case DIMLINEAR:
+        case DIMRADIAL: {
+            auto definitionPoint = reader.readCoordinate();
+            auto middleOfText = reader.readCoordinate();
+            auto attachmentPoint = static_cast<TextConst::AttachmentPoint>(reader.readUInt8());
+            auto textAngle = reader.readDouble();
+            auto lineSpacingFactor = reader.readDouble();
+            auto lineSpacingStyle = static_cast<TextConst::LineSpacingStyle>(reader.readUInt8());
+            auto explicitValue = reader.readString();
+
+            if (type == DIMALIGNED) {
+                auto definitionPoint2 = reader.readCoordinate();
+                auto definitionPoint3 = reader.readCoordinate();
+                return withID(std::make_shared<entity::DimAligned>(definitionPoint, middleOfText, attachmentPoint, textAngle,
+                              lineSpacingFactor, lineSpacingStyle, explicitValue, definitionPoint2, definitionPoint3,
+                              header.layer, header.metaInfo, header.block), header.id);
+            }
+
+            if (type == DIMANGULAR) {
+                auto defLine11 = reader.readCoordinate();
+                auto defLine12 = reader.readCoordinate();
+                auto defLine21 = reader.readCoordinate();
+                auto defLine22 = reader.readCoordinate();
+                return withID(std::make_shared<entity::DimAngular>(definitionPoint, middleOfText, attachmentPoint, textAngle,
+                              lineSpacingFactor, lineSpacingStyle, explicitValue, defLine11, defLine12, defLine21, defLine22,
+                              header.layer, header.metaInfo, header.block), header.id);
+            }
+
+            if (type == DIMLINEAR) {
+                auto definitionPoint2 = reader.readCoordinate();
+                auto definitionPoint3 = reader.readCoordinate();
+                auto angle = reader.readDouble();
+                auto oblique = reader.readDouble();
+                return withID(std::make_shared<entity::DimLinear>(definitionPoint, middleOfText, attachmentPoint, textAngle,
+                              lineSpacingFactor, lineSpacingStyle, explicitValue, definitionPoint2, definitionPoint3,
+                              angle, oblique, header.layer, header.metaInfo, header.block), header.id);
+            }
+
+            auto definitionPoint2 = reader.readCoordinate();
+            auto leader = reader.readDouble();
+
+            if (type == DIMDIAMETRIC) {
+                return withID(std::make_shared<entity::DimDiametric>(definitionPoint, middleOfText, attachmentPoint, textAngle,
+                              lineSpacingFactor, lineSpacingStyle, explicitValue, definitionPoint2, leader,
+                              header.layer, header.metaInfo, header.block), header.id);
+            }
+
+            return withID(std::make_shared<entity::DimRadial>(definitionPoint, middleOfText, attachmentPoint, textAngle,
+                          lineSpacingFactor, lineSpacingStyle, explicitValue, definitionPoint2, leader,
+                          header.layer, header.metaInfo, header.block), header.id);
+        }
+
+        default:
+            throw std::runtime_error("Unknown entity type");
+    }
+}
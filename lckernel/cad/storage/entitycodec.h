@@ -0,0 +1,180 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+#include "cad/interface/entitydispatch.h"
+#include "cad/meta/block.h"
+#include "cad/meta/dxflinepattern.h"
+#include "cad/meta/layer.h"
+#include "binarystream.h"
+
+namespace lc {
+namespace entity {
+class Dimension;
+}
+
+namespace storage {
+class Document;
+DECLARE_SHORT_SHARED_PTR(Document)
+
+/**
+ * @brief Binary representation of entities
+ *
+ * An entity is written as its type, ID, references to its layer, meta info and block, followed by its geometry.
+ * A reference is 0 for nullptr, 1 when the definition of a new object follows, or the index of an object
+ * already written + 2. Layers, line patterns, blocks and meta info shared by many entities are written only once.
+ *
+ * Encoder and decoder keep a table of the written objects, entities must be read back in the order they
+ * were written, with a decoder starting at the same point as the encoder.
+ */
+namespace entitycodec {
+enum EntityType : uint8_t {
+    LINE = 1,
+    POINT,
+    CIRCLE,
+    ARC,
+    ELLIPSE,
+    SPLINE,
+    LWPOLYLINE,
+    TEXT,
+    IMAGE,
+    HATCH,
+    INSERT,
+    DIMALIGNED,
+    DIMANGULAR,
+    DIMDIAMETRIC,
+    DIMLINEAR,
+    DIMRADIAL
+};
+}
+
+/**
+ * @brief Write entities to a BinaryWriter
+ * Custom entities are written as the insert of their custom entity block.
+ */
+class EntityEncoder : public EntityDispatch {
+public:
+    explicit EntityEncoder(BinaryWriter& writer);
+
+    /**
+     * @brief Write an entity
+     * @return false if the entity type isn't supported, nothing is written in that case
+     */
+    bool write(const entity::CADEntity_CSPtr& entity);
+
+    /**
+     * @brief Write a layer, line pattern or block, which can be read back with EntityDecoder::readMetaType()
+     * @return false if the meta type isn't supported, nothing is written in that case
+     */
+    bool writeMetaType(const meta::DocumentMetaType_CSPtr& metaType);
+
+    /**
+     * @brief Forget the objects already written
+     * Needed when the following entities are read by a new decoder.
+     */
+    void reset();
+
+    void visit(entity::Line_CSPtr) override;
+    void visit(entity::Point_CSPtr) override;
+    void visit(entity::Circle_CSPtr) override;
+    void visit(entity::Arc_CSPtr) override;
+    void visit(entity::Ellipse_CSPtr) override;
+    void visit(entity::Text_CSPtr) override;
+    void visit(entity::Spline_CSPtr) override;
+    void visit(entity::DimAligned_CSPtr) override;
+    void visit(entity::DimAngular_CSPtr) override;
+    void visit(entity::DimDiametric_CSPtr) override;
+    void visit(entity::DimLinear_CSPtr) override;
+    void visit(entity::DimRadial_CSPtr) override;
+    void visit(entity::LWPolyline_CSPtr) override;
+    void visit(entity::Image_CSPtr) override;
+    void visit(entity::Hatch_CSPtr) override;
+
+private:
+    void writeHeader(entitycodec::EntityType type, const entity::CADEntity_CSPtr& entity);
+    void writeDimension(const entity::Dimension& dimension);
+    void writeEntities(const std::vector<entity::CADEntity_CSPtr>& entities);
+
+    void writeLayer(const meta::Layer_CSPtr& layer);
+    void writeLinePattern(const meta::DxfLinePatternByValue_CSPtr& linePattern);
+    void writeBlock(const meta::Block_CSPtr& block);
+    void writeMetaInfo(const meta::MetaInfo_CSPtr& metaInfo);
+
+    /**
+     * @brief Write the reference to an object
+     * @return true if the definition of the object must follow
+     */
+    bool writeReference(const std::shared_ptr<const void>& object, std::unordered_map<const void*, uint64_t>& table);
+
+    BinaryWriter& _writer;
+    std::vector<std::shared_ptr<const void>> _referenced; /*!< Keeps referenced objects alive, so their address can't be reused */
+    std::unordered_map<const void*, uint64_t> _layers;
+    std::unordered_map<const void*, uint64_t> _linePatterns;
+    std::unordered_map<const void*, uint64_t> _blocks;
+    std::unordered_map<const void*, uint64_t> _metaInfos;
+    bool _written;
+};
+
+/**
+ * @brief Read entities written by an EntityEncoder
+ *
+ * Layers, line patterns and blocks are taken from the document when it contains one with the same name,
+ * otherwise the decoded object is used and listed in takeNewMetaTypes(), so it can be added to the document
+ * before the entities.
+ * Invalid data throws a std::runtime_error.
+ */
+class EntityDecoder {
+public:
+    explicit EntityDecoder(Document_SPtr document);
+
+    entity::CADEntity_CSPtr read(BinaryReader& reader);
+
+    /**
+     * @brief Read a meta type written by EntityEncoder::writeMetaType()
+     * @param fromDocument Return the meta type of the document with the same name if there is one.
+     * Otherwise the decoded object is returned, even if it isn't part of the document, and is used by the following
+     * entities referencing it. The meta types the definitions of which follow are still taken from the document.
+     */
+    meta::DocumentMetaType_CSPtr readMetaType(BinaryReader& reader, bool fromDocument = true);
+
+    /**
+     * @brief Use a meta type which isn't part of the document yet for the decoded objects with the same ID
+     * Allows decoders running in parallel to share the objects before they are added to the document.
+     */
+    void addMetaType(const meta::DocumentMetaType_CSPtr& metaType);
+
+    /**
+     * @brief Return the document meta types which were decoded but are not part of the document, and clear the list
+     */
+    std::vector<meta::DocumentMetaType_CSPtr> takeNewMetaTypes();
+
+    void reset();
+
+private:
+    std::vector<entity::CADEntity_CSPtr> readEntities(BinaryReader& reader);
+
+    meta::Layer_CSPtr readLayer(BinaryReader& reader, bool fromDocument = true);
+    meta::DxfLinePatternByValue_CSPtr readLinePattern(BinaryReader& reader, bool fromDocument = true);
+    meta::Block_CSPtr readBlock(BinaryReader& reader, bool fromDocument = true);
+    meta::MetaInfo_CSPtr readMetaInfo(BinaryReader& reader);
+
+    /**
+     * @brief Return the known meta type with the same ID as a decoded one which isn't part of the document
+     */
+    template<typename T>
+    std::shared_ptr<const T> resolve(std::shared_ptr<const T> decoded);
+
+    Document_SPtr _document;
+    std::unordered_map<std::string, meta::DocumentMetaType_CSPtr> _known;
+    std::vector<meta::Layer_CSPtr> _layers;
+    std::vector<meta::DxfLinePatternByValue_CSPtr> _linePatterns;
+    std::vector<meta::Block_CSPtr> _blocks;
+    std::vector<meta::MetaInfo_CSPtr> _metaInfos;
+    std::vector<meta::DocumentMetaType_CSPtr> _newMetaTypes;
+};
+}
+}
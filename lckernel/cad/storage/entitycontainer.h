@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <limits>
 #include <string>
@@ -80,6 +81,15 @@ public:
         _tree->insert(entity);
     }
 
+    /*!
+     * \brief add a set of entities to the EntityContainer
+     * Any entity that already exists will get replaced
+     * \param entities entities to be added
+     */
+    void insert(const std::vector<CT>& entities) {
+        _tree->insert(entities);
+    }
+
 
     /*!
      * \brief Add all entities to this container
@@ -304,6 +314,55 @@ public:
         return container;
     }
 
+    /**
+     * @brief Call a function for each entity which bounding box overlaps an area
+     * Same entities as entitiesOverlappingArea, without building a vector.
+     * @return amount of entities passed to the function
+     */
+    template<typename T>
+    size_t eachInArea(const geo::Area& area, T func) const {
+        size_t count = 0;
+        auto visit = [&](const CT& entity) {
+            if (entity->boundingBox().overlaps(area)) {
+                func(entity);
+                count++;
+            }
+        };
+
+        _tree->eachInArea(area, visit);
+        return count;
+    }
+
+    /**
+     * @brief Call a function for each entity of the container
+     * @return amount of entities passed to the function
+     */
+    template<typename T>
+    size_t eachEntity(T func) const {
+        size_t count = 0;
+        auto visit = [&](const CT& entity) {
+            func(entity);
+            count++;
+        };
+
+        _tree->eachEntity(visit);
+        return count;
+    }
+
+    /**
+     * @brief Return the entities which bounding box overlaps an area
+     * Same as entitiesWithinAndCrossingAreaFast, without building a new container.
+     */
+    std::vector<CT> entitiesOverlappingArea(const geo::Area& area) const {
+        std::vector<CT> entities = _tree->retrieve(area);
+
+        entities.erase(std::remove_if(entities.begin(), entities.end(), [&](const CT& entity) {
+            return !entity->boundingBox().overlaps(area);
+        }), entities.end());
+
+        return entities;
+    }
+
     /*!
      * \brief getEntityPathsNearCoordinate
      * \param point point where to look for entities
@@ -314,8 +373,8 @@ public:
             double distance,
             lc::SimpleSnapConstrain _snapConstrain) const {
 
-        const auto area = lc::geo::Area(lc::geo::Coordinate(point.x(), point.y()) + distance / 2.,
-                                        lc::geo::Coordinate(point.x(), point.y()) + distance / 2.);
+        const auto area = lc::geo::Area(lc::geo::Coordinate(point.x(), point.y()) - distance,
+                                        lc::geo::Coordinate(point.x(), point.y()) + distance);
         std::vector<CT> ent = _tree->retrieve(area);
 
         // Now calculate for each entity if we are near the entities path
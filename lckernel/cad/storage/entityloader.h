@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+#include "cad/geometry/geoarea.h"
+
+namespace lc {
+namespace storage {
+/**
+ * @brief Source of entities of a document which are materialised on demand
+ *
+ * Used by file formats which can decode part of a drawing, the document asks for the entities of an area
+ * before it is drawn or queried. Each entity is returned only once.
+ */
+class EntityLoader {
+public:
+    virtual ~EntityLoader() = default;
+
+    /**
+     * @brief Return the entities overlapping an area which were not loaded yet
+     * Entities close to the area can be returned too.
+     */
+    virtual std::vector<entity::CADEntity_CSPtr> load(const geo::Area& area) = 0;
+
+    /**
+     * @brief Return all the entities which were not loaded yet
+     */
+    virtual std::vector<entity::CADEntity_CSPtr> loadAll() = 0;
+
+    /**
+     * @brief Check if all the entities were loaded
+     */
+    virtual bool loaded() const = 0;
+
+    /**
+     * @brief Return the area covered by all the entities, loaded or not
+     */
+    virtual geo::Area bounds() const = 0;
+};
+
+DECLARE_SHORT_SHARED_PTR(EntityLoader)
+}
+}
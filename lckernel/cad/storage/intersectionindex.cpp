@@ -0,0 +1,176 @@
+#include "intersectionindex.h"
+
+#include "cad/storage/document.h"
+#include "cad/math/intersect.h"
+#include "cad/base/visitor.h"
+
+using namespace lc;
+using namespace storage;
+
+namespace {
+std::vector<geo::Coordinate> computeIntersections(const entity::CADEntity_CSPtr& entity1,
+                                                  const entity::CADEntity_CSPtr& entity2) {
+    if (!entity1->boundingBox().overlaps(entity2->boundingBox())) {
+        return std::vector<geo::Coordinate>();
+    }
+
+    maths::Intersect intersect(maths::Intersect::OnEntity, LCTOLERANCE);
+    visitorDispatcher<bool, GeoEntityVisitor>(intersect, *entity1.get(), *entity2.get());
+    return intersect.result();
+}
+}
+
+IntersectionIndex::IntersectionIndex(Document* document) :
+    _document(document) {
+
+    _document->addEntityEvent().connect<IntersectionIndex, &IntersectionIndex::on_addEntityEvent>(this);
+    _document->removeEntityEvent().connect<IntersectionIndex, &IntersectionIndex::on_removeEntityEvent>(this);
+    _document->replaceEntityEvent().connect<IntersectionIndex, &IntersectionIndex::on_replaceEntityEvent>(this);
+    _document->batchEntityEvent().connect<IntersectionIndex, &IntersectionIndex::on_batchEntityEvent>(this);
+}
+
+IntersectionIndex::~IntersectionIndex() {
+    _document->addEntityEvent().disconnect<IntersectionIndex, &IntersectionIndex::on_addEntityEvent>(this);
+    _document->removeEntityEvent().disconnect<IntersectionIndex, &IntersectionIndex::on_removeEntityEvent>(this);
+    _document->replaceEntityEvent().disconnect<IntersectionIndex, &IntersectionIndex::on_replaceEntityEvent>(this);
+    _document->batchEntityEvent().disconnect<IntersectionIndex, &IntersectionIndex::on_batchEntityEvent>(this);
+}
+
+std::vector<geo::Coordinate> IntersectionIndex::intersections(const entity::CADEntity_CSPtr& entity1,
+                                                              const entity::CADEntity_CSPtr& entity2) {
+    if (entity1->id() == entity2->id()) {
+        return std::vector<geo::Coordinate>();
+    }
+
+    if (!inDocument(entity1) || !inDocument(entity2)) {
+        return computeIntersections(entity1, entity2);
+    }
+
+    return cachedIntersections(entity1, entity2);
+}
+
+std::vector<geo::Coordinate> IntersectionIndex::intersectionsWithDocument(const entity::CADEntity_CSPtr& entity) {
+    std::vector<entity::CADEntity_CSPtr> candidates;
+    auto area = entity->boundingBox();
+
+    if (entity->block() != nullptr) {
+        candidates = _document->entitiesByBlock(entity->block()).entitiesOverlappingArea(area);
+    }
+    else {
+        candidates = _document->entityContainer().entitiesOverlappingArea(area);
+    }
+
+    bool cache = inDocument(entity);
+    std::vector<geo::Coordinate> points;
+
+    for (const auto& candidate : candidates) {
+        if (candidate->id() == entity->id()) {
+            continue;
+        }
+
+        if (cache) {
+            const auto& pairPoints = cachedIntersections(entity, candidate);
+            points.insert(points.end(), pairPoints.begin(), pairPoints.end());
+        }
+        else {
+            auto pairPoints = computeIntersections(entity, candidate);
+            points.insert(points.end(), pairPoints.begin(), pairPoints.end());
+        }
+    }
+
+    return points;
+}
+
+std::vector<geo::Coordinate> IntersectionIndex::intersectMany(const std::vector<entity::CADEntity_CSPtr>& entities) {
+    std::vector<geo::Coordinate> points;
+
+    for (size_t outer = 0; outer < entities.size(); outer++) {
+        for (size_t inner = outer + 1; inner < entities.size(); inner++) {
+            auto pairPoints = intersections(entities[outer], entities[inner]);
+            points.insert(points.end(), pairPoints.begin(), pairPoints.end());
+        }
+    }
+
+    return points;
+}
+
+size_t IntersectionIndex::size() const {
+    return _pairs.size();
+}
+
+void IntersectionIndex::clear() {
+    _pairs.clear();
+    _partners.clear();
+}
+
+const std::vector<geo::Coordinate>& IntersectionIndex::cachedIntersections(const entity::CADEntity_CSPtr& entity1,
+                                                                           const entity::CADEntity_CSPtr& entity2) {
+    bool swap = entity2->id() < entity1->id();
+    const auto& first = swap ? entity2 : entity1;
+    const auto& second = swap ? entity1 : entity2;
+
+    auto& cachedPair = _pairs[PairKey(first->id(), second->id())];
+
+    if (cachedPair.entity1 != first || cachedPair.entity2 != second) {
+        cachedPair.entity1 = first;
+        cachedPair.entity2 = second;
+        cachedPair.points = computeIntersections(first, second);
+
+        _partners[first->id()].insert(second->id());
+        _partners[second->id()].insert(first->id());
+    }
+
+    return cachedPair.points;
+}
+
+bool IntersectionIndex::inDocument(const entity::CADEntity_CSPtr& entity) const {
+    return _document->entityByID(entity->id()) == entity;
+}
+
+void IntersectionIndex::invalidate(ID_DATATYPE id) {
+    auto partners = _partners.find(id);
+    if (partners == _partners.end()) {
+        return;
+    }
+
+    for (auto partner : partners->second) {
+        _pairs.erase(id < partner ? PairKey(id, partner) : PairKey(partner, id));
+
+        auto partnerPartners = _partners.find(partner);
+        if (partnerPartners != _partners.end()) {
+            partnerPartners->second.erase(id);
+
+            if (partnerPartners->second.empty()) {
+                _partners.erase(partnerPartners);
+            }
+        }
+    }
+
+    _partners.erase(id);
+}
+
+void IntersectionIndex::on_addEntityEvent(const lc::event::AddEntityEvent& event) {
+    invalidate(event.entity()->id());
+}
+
+void IntersectionIndex::on_removeEntityEvent(const lc::event::RemoveEntityEvent& event) {
+    invalidate(event.entity()->id());
+}
+
+void IntersectionIndex::on_replaceEntityEvent(const lc::event::ReplaceEntityEvent& event) {
+    invalidate(event.entity()->id());
+}
+
+void IntersectionIndex::on_batchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    if (_partners.empty()) {
+        return;
+    }
+
+    for (const auto& entity : event.removed()) {
+        invalidate(entity->id());
+    }
+
+    for (const auto& entity : event.added()) {
+        invalidate(entity->id());
+    }
+}
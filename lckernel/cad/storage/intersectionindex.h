@@ -0,0 +1,105 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+#include "cad/geometry/geocoordinate.h"
+#include "cad/events/addentityevent.h"
+#include "cad/events/removeentityevent.h"
+#include "cad/events/replaceentityevent.h"
+#include "cad/events/batchentityevent.h"
+
+namespace lc {
+namespace storage {
+class Document;
+
+/**
+ * @brief Cache of the intersections between the entities of a document
+ *
+ * The intersection points are computed once per pair of entities (Intersect::OnEntity, LCTOLERANCE)
+ * and kept until one of both entities is removed or replaced in the document.
+ * Candidate pairs are found with the bounding boxes of the entities stored in the document quad tree,
+ * only the overlapping pairs are intersected.
+ *
+ * This allows intersection snapping, trimming and scripts to query the same intersections many times
+ * without recomputing them.
+ * The index isn't thread safe, it must be used from the thread modifying the document.
+ */
+class IntersectionIndex {
+public:
+    explicit IntersectionIndex(Document* document);
+
+    ~IntersectionIndex();
+
+    IntersectionIndex(const IntersectionIndex&) = delete;
+    IntersectionIndex& operator=(const IntersectionIndex&) = delete;
+
+    /**
+     * @brief Return the intersections of two entities
+     * The result is only cached when both entities are part of the document.
+     */
+    std::vector<geo::Coordinate> intersections(const entity::CADEntity_CSPtr& entity1,
+                                               const entity::CADEntity_CSPtr& entity2);
+
+    /**
+     * @brief Return the intersections of an entity with all the other entities in the same block of the document
+     */
+    std::vector<geo::Coordinate> intersectionsWithDocument(const entity::CADEntity_CSPtr& entity);
+
+    /**
+     * @brief Return the intersections between all the given entities
+     * Same result as IntersectMany, using the cache.
+     */
+    std::vector<geo::Coordinate> intersectMany(const std::vector<entity::CADEntity_CSPtr>& entities);
+
+    /**
+     * @brief Return the amount of cached pairs, including the pairs which don't intersect
+     */
+    size_t size() const;
+
+    /**
+     * @brief Forget all the intersections
+     */
+    void clear();
+
+private:
+    struct CachedPair {
+        entity::CADEntity_CSPtr entity1;
+        entity::CADEntity_CSPtr entity2;
+        std::vector<geo::Coordinate> points;
+    };
+
+    typedef std::pair<ID_DATATYPE, ID_DATATYPE> PairKey;
+
+    void on_addEntityEvent(const lc::event::AddEntityEvent&);
+    void on_removeEntityEvent(const lc::event::RemoveEntityEvent&);
+    void on_replaceEntityEvent(const lc::event::ReplaceEntityEvent&);
+    void on_batchEntityEvent(const lc::event::BatchEntityEvent&);
+
+    const std::vector<geo::Coordinate>& cachedIntersections(const entity::CADEntity_CSPtr& entity1,
+                                                            const entity::CADEntity_CSPtr& entity2);
+
+    /**
+     * @brief Return true if the entity is the current version of an entity of the document
+     */
+    bool inDocument(const entity::CADEntity_CSPtr& entity) const;
+
+    /**
+     * @brief Forget all intersections of an entity
+     */
+    void invalidate(ID_DATATYPE id);
+
+    Document* _document;
+
+    std::map<PairKey, CachedPair> _pairs;
+
+    // IDs of the entities each entity has a cached pair with
+    std::unordered_map<ID_DATATYPE, std::unordered_set<ID_DATATYPE>> _partners;
+};
+}
+}
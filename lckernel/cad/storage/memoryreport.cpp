@@ -0,0 +1,213 @@
+#include "memoryreport.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include "cad/geometry/geobeziercubic.h"
+#include "cad/primitive/arc.h"
+#include "cad/primitive/circle.h"
+#include "cad/primitive/dimaligned.h"
+#include "cad/primitive/dimangular.h"
+#include "cad/primitive/dimdiametric.h"
+#include "cad/primitive/dimlinear.h"
+#include "cad/primitive/dimradial.h"
+#include "cad/primitive/ellipse.h"
+#include "cad/primitive/hatch.h"
+#include "cad/primitive/image.h"
+#include "cad/primitive/insert.h"
+#include "cad/primitive/line.h"
+#include "cad/primitive/lwpolyline.h"
+#include "cad/primitive/point.h"
+#include "cad/primitive/spline.h"
+#include "cad/primitive/text.h"
+
+using namespace lc;
+using namespace storage;
+
+namespace {
+template<typename T>
+size_t vectorBytes(const std::vector<T>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+
+/**
+ * @brief Return the heap memory of a string, 0 when it fits in the string object
+ */
+size_t stringBytes(const std::string& string) {
+    static const auto localCapacity = std::string().capacity();
+    return string.capacity() > localCapacity ? string.capacity() + 1 : 0;
+}
+}
+
+MemoryReport::MemoryReport() :
+    _type(nullptr),
+    _bytes(0) {
+}
+
+MemoryReport::MemoryReport(const EntityContainer<entity::CADEntity_CSPtr>& container) :
+    MemoryReport() {
+
+    container.each<const entity::CADEntity>([this](entity::CADEntity_CSPtr entity) {
+        add(entity);
+    });
+}
+
+void MemoryReport::add(const entity::CADEntity_CSPtr& entity) {
+    auto bytes = measure(entity);
+
+    auto& usage = _entities[_type];
+    usage.count++;
+    usage.bytes += bytes;
+
+    _attributes.insert(entity->attributes().get());
+}
+
+size_t MemoryReport::entityCount() const {
+    size_t count = 0;
+    for (const auto& usage : _entities) {
+        count += usage.second.count;
+    }
+    return count;
+}
+
+size_t MemoryReport::totalBytes() const {
+    auto bytes = _attributes.size() * sizeof(entity::EntityAttributes);
+    for (const auto& usage : _entities) {
+        bytes += usage.second.bytes;
+    }
+    return bytes;
+}
+
+std::string MemoryReport::toString() const {
+    std::ostringstream stream;
+
+    stream << std::left << std::setw(16) << "Type"
+           << std::right << std::setw(12) << "Count"
+           << std::setw(16) << "Bytes"
+           << std::setw(12) << "Bytes/entity" << "\n";
+
+    for (const auto& usage : _entities) {
+        stream << std::left << std::setw(16) << usage.first
+               << std::right << std::setw(12) << usage.second.count
+               << std::setw(16) << usage.second.bytes
+               << std::setw(12) << usage.second.bytes / usage.second.count << "\n";
+    }
+
+    stream << std::left << std::setw(16) << "Attributes"
+           << std::right << std::setw(12) << _attributes.size()
+           << std::setw(16) << _attributes.size() * sizeof(entity::EntityAttributes) << "\n";
+
+    stream << std::left << std::setw(16) << "Total"
+           << std::right << std::setw(12) << entityCount()
+           << std::setw(16) << totalBytes() << "\n";
+
+    return stream.str();
+}
+
+size_t MemoryReport::measure(const entity::CADEntity_CSPtr& entity) {
+    _type = "Other";
+    _bytes = sizeof(entity::CADEntity);
+
+    // Insert doesn't support dispatch
+    if (entity->entityTag() != entity::EntityTag::Generic) {
+        if (std::dynamic_pointer_cast<const entity::Insert>(entity) != nullptr) {
+            measured("Insert", sizeof(entity::Insert));
+        }
+    }
+    else {
+        entity->dispatch(*this);
+    }
+
+    return _bytes;
+}
+
+void MemoryReport::measured(const char* type, size_t bytes) {
+    _type = type;
+    _bytes = bytes;
+}
+
+void MemoryReport::visit(entity::Line_CSPtr line) {
+    measured("Line", sizeof(entity::Line));
+}
+
+void MemoryReport::visit(entity::Point_CSPtr point) {
+    measured("Point", sizeof(entity::Point));
+}
+
+void MemoryReport::visit(entity::Circle_CSPtr circle) {
+    measured("Circle", sizeof(entity::Circle));
+}
+
+void MemoryReport::visit(entity::Arc_CSPtr arc) {
+    measured("Arc", sizeof(entity::Arc));
+}
+
+void MemoryReport::visit(entity::Ellipse_CSPtr ellipse) {
+    measured("Ellipse", sizeof(entity::Ellipse));
+}
+
+void MemoryReport::visit(entity::Text_CSPtr text) {
+    measured("Text", sizeof(entity::Text) + stringBytes(text->text_value()) + stringBytes(text->style()));
+}
+
+void MemoryReport::visit(entity::Spline_CSPtr spline) {
+    auto bytes = sizeof(entity::Spline) +
+                 vectorBytes(spline->controlPoints()) +
+                 vectorBytes(spline->knotPoints()) +
+                 vectorBytes(spline->fitPoints()) +
+                 vectorBytes(spline->beziers()) +
+                 spline->beziers().size() * sizeof(geo::CubicBezier);
+
+    measured("Spline", bytes);
+}
+
+void MemoryReport::visit(entity::DimAligned_CSPtr dimAligned) {
+    measured("DimAligned", sizeof(entity::DimAligned) + stringBytes(dimAligned->explicitValue()));
+}
+
+void MemoryReport::visit(entity::DimAngular_CSPtr dimAngular) {
+    measured("DimAngular", sizeof(entity::DimAngular) + stringBytes(dimAngular->explicitValue()));
+}
+
+void MemoryReport::visit(entity::DimDiametric_CSPtr dimDiametric) {
+    measured("DimDiametric", sizeof(entity::DimDiametric) + stringBytes(dimDiametric->explicitValue()));
+}
+
+void MemoryReport::visit(entity::DimLinear_CSPtr dimLinear) {
+    measured("DimLinear", sizeof(entity::DimLinear) + stringBytes(dimLinear->explicitValue()));
+}
+
+void MemoryReport::visit(entity::DimRadial_CSPtr dimRadial) {
+    measured("DimRadial", sizeof(entity::DimRadial) + stringBytes(dimRadial->explicitValue()));
+}
+
+void MemoryReport::visit(entity::LWPolyline_CSPtr lwPolyline) {
+    auto bytes = sizeof(entity::LWPolyline) + vectorBytes(lwPolyline->vertex());
+
+    // Segments are cached as entities
+    auto segments = lwPolyline->asEntities();
+    bytes += segments.size() * sizeof(entity::CADEntity_CSPtr);
+    for (const auto& segment : segments) {
+        bytes += measure(segment);
+    }
+
+    measured("LWPolyline", bytes);
+}
+
+void MemoryReport::visit(entity::Image_CSPtr image) {
+    measured("Image", sizeof(entity::Image) + stringBytes(image->name()));
+}
+
+void MemoryReport::visit(entity::Hatch_CSPtr hatch) {
+    const auto& loops = hatch->getRegion().loopList();
+    auto bytes = sizeof(entity::Hatch) + stringBytes(hatch->getPatternName()) + vectorBytes(loops);
+
+    for (const auto& loop : loops) {
+        bytes += vectorBytes(loop.entities());
+        for (const auto& boundary : loop.entities()) {
+            bytes += measure(boundary);
+        }
+    }
+
+    measured("Hatch", bytes);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_set>
+
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+#include "cad/interface/entitydispatch.h"
+#include "entitycontainer.h"
+
+namespace lc {
+namespace storage {
+/**
+ * @brief Memory used by the entities of one type
+ */
+struct EntityMemoryUsage {
+    size_t count; /*!< Amount of entities */
+    size_t bytes; /*!< Size of the objects and of the data they own */
+};
+
+/**
+ * @brief Estimate of the memory used by entities, grouped by type
+ *
+ * The size of an entity is the size of its object plus the heap memory of its vertices, control points,
+ * strings and cached sub entities. Layers, meta info and blocks are shared, only the attributes
+ * combining them are counted, once.
+ * Containers are counted by capacity, the allocator overhead isn't included.
+ */
+class MemoryReport : public EntityDispatch {
+public:
+    MemoryReport();
+
+    explicit MemoryReport(const EntityContainer<entity::CADEntity_CSPtr>& container);
+
+    /**
+     * @brief Add an entity to the report
+     */
+    void add(const entity::CADEntity_CSPtr& entity);
+
+    /**
+     * @brief Return the usage per entity type, sorted by type name
+     */
+    const std::map<std::string, EntityMemoryUsage>& entities() const {
+        return _entities;
+    }
+
+    /**
+     * @brief Return the amount of different attributes used by the entities
+     */
+    size_t attributesCount() const {
+        return _attributes.size();
+    }
+
+    size_t entityCount() const;
+
+    /**
+     * @brief Return the memory used by the entities and their attributes
+     */
+    size_t totalBytes() const;
+
+    /**
+     * @brief Return the report as a table, one line per entity type
+     */
+    std::string toString() const;
+
+    void visit(entity::Line_CSPtr line) override;
+    void visit(entity::Point_CSPtr point) override;
+    void visit(entity::Circle_CSPtr circle) override;
+    void visit(entity::Arc_CSPtr arc) override;
+    void visit(entity::Ellipse_CSPtr ellipse) override;
+    void visit(entity::Text_CSPtr text) override;
+    void visit(entity::Spline_CSPtr spline) override;
+    void visit(entity::DimAligned_CSPtr dimAligned) override;
+    void visit(entity::DimAngular_CSPtr dimAngular) override;
+    void visit(entity::DimDiametric_CSPtr dimDiametric) override;
+    void visit(entity::DimLinear_CSPtr dimLinear) override;
+    void visit(entity::DimRadial_CSPtr dimRadial) override;
+    void visit(entity::LWPolyline_CSPtr lwPolyline) override;
+    void visit(entity::Image_CSPtr image) override;
+    void visit(entity::Hatch_CSPtr hatch) override;
+
+private:
+    /**
+     * @brief Return the size of an entity, without adding it to the report
+     */
+    size_t measure(const entity::CADEntity_CSPtr& entity);
+
+    void measured(const char* type, size_t bytes);
+
+    std::map<std::string, EntityMemoryUsage> _entities;
+    std::unordered_set<const entity::EntityAttributes*> _attributes;
+
+    // Result of the last dispatch
+    const char* _type;
+    size_t _bytes;
+};
+}
+}
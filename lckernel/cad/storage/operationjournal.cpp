@@ -0,0 +1,644 @@
+#include "operationjournal.h"
+#include "document.h"
+#include "cad/meta/block.h"
+#include "cad/meta/dxflinepattern.h"
+#include "cad/meta/layer.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <boost/crc.hpp>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace lc;
+using namespace lc::storage;
+
+namespace {
+const char JOURNAL_MAGIC[4] = {'L', 'C', 'J', 'L'};
+const uint32_t JOURNAL_VERSION = 2;
+const size_t FILE_HEADER_SIZE = sizeof(JOURNAL_MAGIC) + sizeof(uint32_t);
+const size_t RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+uint32_t checksum(const char* data, size_t size) {
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+void writeFile(std::FILE* file, const std::string& data) {
+    if (std::fwrite(data.data(), 1, data.size(), file) != data.size()) {
+        throw std::runtime_error("Unable to write operation journal");
+    }
+}
+
+/**
+ * @brief Replace the count placeholder written at the given position
+ */
+void writeCount(BinaryWriter& writer, size_t position, uint64_t count) {
+    BinaryWriter countWriter;
+    countWriter.writeUInt64(count);
+    writer.buffer().replace(position, countWriter.buffer().size(), countWriter.buffer());
+}
+
+void syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        throw std::runtime_error("Unable to write operation journal");
+    }
+
+#ifdef _WIN32
+    if (_commit(_fileno(file)) != 0) {
+#else
+    if (fsync(fileno(file)) != 0) {
+#endif
+        throw std::runtime_error("Unable to sync operation journal");
+    }
+}
+
+std::vector<entity::CADEntity_CSPtr> allEntities(const Document_SPtr& document) {
+    auto entities = document->entityContainer().asVector();
+
+    for (const auto& block : document->blocks()) {
+        auto blockEntities = document->entitiesByBlock(block).asVector();
+        entities.insert(entities.end(), blockEntities.begin(), blockEntities.end());
+    }
+
+    return entities;
+}
+
+/**
+ * @brief Return the layers, line patterns and blocks of a document
+ * Line patterns come first, so the layers using them are decoded with the version of the journal.
+ */
+std::vector<meta::DocumentMetaType_CSPtr> allMetaTypes(const Document_SPtr& document) {
+    std::vector<meta::DocumentMetaType_CSPtr> linePatterns;
+    std::vector<meta::DocumentMetaType_CSPtr> others;
+
+    for (const auto& metaType : document->allMetaTypes()) {
+        if (std::dynamic_pointer_cast<const meta::DxfLinePatternByValue>(metaType.second) != nullptr) {
+            linePatterns.push_back(metaType.second);
+        }
+        else if (std::dynamic_pointer_cast<const meta::Layer>(metaType.second) != nullptr ||
+                 std::dynamic_pointer_cast<const meta::Block>(metaType.second) != nullptr) {
+            others.push_back(metaType.second);
+        }
+    }
+
+    linePatterns.insert(linePatterns.end(), others.begin(), others.end());
+    return linePatterns;
+}
+
+/**
+ * @brief Return the meta type of the document with the same ID, or nullptr
+ */
+meta::DocumentMetaType_CSPtr documentMetaType(const Document_SPtr& document, const meta::DocumentMetaType_CSPtr& metaType) {
+    auto metaTypes = document->allMetaTypes();
+    auto it = metaTypes.find(metaType->id());
+
+    return it == metaTypes.end() ? nullptr : it->second;
+}
+}
+
+OperationJournal::OperationJournal(Document_SPtr document, std::string path, size_t checkpointInterval) :
+    _document(std::move(document)),
+    _path(std::move(path)),
+    _checkpointInterval(checkpointInterval),
+    _inTransaction(false),
+    _current{TRANSACTION, 0, {}, {}},
+    _sequence(0),
+    _sinceCheckpoint(0),
+    _writing(false),
+    _stop(false),
+    _file(nullptr),
+    _encoder(_buffer) {
+
+    // The initial checkpoint is written synchronously, so errors are reported to the caller
+    writeCheckpoint(snapshot());
+    connectDocument(true);
+
+    _writer = std::thread(&OperationJournal::writerLoop, this);
+}
+
+OperationJournal::~OperationJournal() {
+    connectDocument(false);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    _writer.join();
+
+    if (_file != nullptr) {
+        std::fclose(_file);
+    }
+}
+
+void OperationJournal::connectDocument(bool connect) {
+    if (connect) {
+        _document->beginProcessEvent().connect<OperationJournal, &OperationJournal::on_beginProcessEvent>(this);
+        _document->commitProcessEvent().connect<OperationJournal, &OperationJournal::on_commitProcessEvent>(this);
+        _document->addEntityEvent().connect<OperationJournal, &OperationJournal::on_addEntityEvent>(this);
+        _document->removeEntityEvent().connect<OperationJournal, &OperationJournal::on_removeEntityEvent>(this);
+        _document->replaceEntityEvent().connect<OperationJournal, &OperationJournal::on_replaceEntityEvent>(this);
+        _document->batchEntityEvent().connect<OperationJournal, &OperationJournal::on_batchEntityEvent>(this);
+        _document->addLayerEvent().connect<OperationJournal, &OperationJournal::on_addLayerEvent>(this);
+        _document->removeLayerEvent().connect<OperationJournal, &OperationJournal::on_removeLayerEvent>(this);
+        _document->replaceLayerEvent().connect<OperationJournal, &OperationJournal::on_replaceLayerEvent>(this);
+        _document->addLinePatternEvent().connect<OperationJournal, &OperationJournal::on_addLinePatternEvent>(this);
+        _document->removeLinePatternEvent().connect<OperationJournal, &OperationJournal::on_removeLinePatternEvent>(this);
+        _document->replaceLinePatternEvent().connect<OperationJournal, &OperationJournal::on_replaceLinePatternEvent>(this);
+        _document->addBlockEvent().connect<OperationJournal, &OperationJournal::on_addBlockEvent>(this);
+        _document->removeBlockEvent().connect<OperationJournal, &OperationJournal::on_removeBlockEvent>(this);
+        _document->replaceBlockEvent().connect<OperationJournal, &OperationJournal::on_replaceBlockEvent>(this);
+    }
+    else {
+        _document->beginProcessEvent().disconnect<OperationJournal, &OperationJournal::on_beginProcessEvent>(this);
+        _document->commitProcessEvent().disconnect<OperationJournal, &OperationJournal::on_commitProcessEvent>(this);
+        _document->addEntityEvent().disconnect<OperationJournal, &OperationJournal::on_addEntityEvent>(this);
+        _document->removeEntityEvent().disconnect<OperationJournal, &OperationJournal::on_removeEntityEvent>(this);
+        _document->replaceEntityEvent().disconnect<OperationJournal, &OperationJournal::on_replaceEntityEvent>(this);
+        _document->batchEntityEvent().disconnect<OperationJournal, &OperationJournal::on_batchEntityEvent>(this);
+        _document->addLayerEvent().disconnect<OperationJournal, &OperationJournal::on_addLayerEvent>(this);
+        _document->removeLayerEvent().disconnect<OperationJournal, &OperationJournal::on_removeLayerEvent>(this);
+        _document->replaceLayerEvent().disconnect<OperationJournal, &OperationJournal::on_replaceLayerEvent>(this);
+        _document->addLinePatternEvent().disconnect<OperationJournal, &OperationJournal::on_addLinePatternEvent>(this);
+        _document->removeLinePatternEvent().disconnect<OperationJournal, &OperationJournal::on_removeLinePatternEvent>(this);
+        _document->replaceLinePatternEvent().disconnect<OperationJournal, &OperationJournal::on_replaceLinePatternEvent>(this);
+        _document->addBlockEvent().disconnect<OperationJournal, &OperationJournal::on_addBlockEvent>(this);
+        _document->removeBlockEvent().disconnect<OperationJournal, &OperationJournal::on_removeBlockEvent>(this);
+        _document->replaceBlockEvent().disconnect<OperationJournal, &OperationJournal::on_replaceBlockEvent>(this);
+    }
+}
+
+const std::string& OperationJournal::path() const {
+    return _path;
+}
+
+void OperationJournal::flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() {
+        return _queue.empty() && !_writing;
+    });
+
+    if (!_error.empty()) {
+        throw std::runtime_error(_error);
+    }
+}
+
+void OperationJournal::checkpoint() {
+    _sinceCheckpoint = 0;
+    submit(snapshot());
+}
+
+void OperationJournal::on_beginProcessEvent(const event::BeginProcessEvent& event) {
+    _inTransaction = true;
+}
+
+void OperationJournal::on_commitProcessEvent(const event::CommitProcessEvent& event) {
+    _inTransaction = false;
+    submitCurrent();
+}
+
+void OperationJournal::on_addEntityEvent(const event::AddEntityEvent& event) {
+    change(event.entity()->id(), event.entity());
+}
+
+void OperationJournal::on_removeEntityEvent(const event::RemoveEntityEvent& event) {
+    change(event.entity()->id(), nullptr);
+}
+
+void OperationJournal::on_replaceEntityEvent(const event::ReplaceEntityEvent& event) {
+    change(event.entity()->id(), event.entity());
+}
+
+void OperationJournal::on_batchEntityEvent(const event::BatchEntityEvent& event) {
+    // Outside of an operation the batch is a record on its own, so a replace is never split in two records
+    bool standalone = !_inTransaction;
+    _inTransaction = true;
+
+    // Replaced entities are listed in both, the new version must win
+    for (const auto& entity : event.removed()) {
+        change(entity->id(), nullptr);
+    }
+
+    for (const auto& entity : event.added()) {
+        change(entity->id(), entity);
+    }
+
+    if (standalone) {
+        _inTransaction = false;
+        submitCurrent();
+    }
+}
+
+void OperationJournal::on_addLayerEvent(const event::AddLayerEvent& event) {
+    changeMetaType(event.layer(), false);
+}
+
+void OperationJournal::on_removeLayerEvent(const event::RemoveLayerEvent& event) {
+    changeMetaType(event.layer(), true);
+}
+
+void OperationJournal::on_replaceLayerEvent(const event::ReplaceLayerEvent& event) {
+    replaceMetaType(event.oldLayer(), event.newLayer());
+}
+
+void OperationJournal::on_addLinePatternEvent(const event::AddLinePatternEvent& event) {
+    changeMetaType(event.linePattern(), false);
+}
+
+void OperationJournal::on_removeLinePatternEvent(const event::RemoveLinePatternEvent& event) {
+    changeMetaType(event.linePattern(), true);
+}
+
+void OperationJournal::on_replaceLinePatternEvent(const event::ReplaceLinePatternEvent& event) {
+    replaceMetaType(event.oldLinePattern(), event.newLinePattern());
+}
+
+void OperationJournal::on_addBlockEvent(const event::AddBlockEvent& event) {
+    changeMetaType(event.block(), false);
+}
+
+void OperationJournal::on_removeBlockEvent(const event::RemoveBlockEvent& event) {
+    changeMetaType(event.block(), true);
+}
+
+void OperationJournal::on_replaceBlockEvent(const event::ReplaceBlockEvent& event) {
+    replaceMetaType(event.oldBlock(), event.newBlock());
+}
+
+void OperationJournal::change(ID_DATATYPE id, const entity::CADEntity_CSPtr& entity) {
+    if (!_inTransaction) {
+        Record record{TRANSACTION, 0, {}, {}};
+        record.changes.emplace_back(id, entity);
+        submit(std::move(record));
+        return;
+    }
+
+    auto it = _currentIndex.find(id);
+    if (it != _currentIndex.end()) {
+        _current.changes[it->second].second = entity;
+        return;
+    }
+
+    _currentIndex.emplace(id, _current.changes.size());
+    _current.changes.emplace_back(id, entity);
+}
+
+void OperationJournal::changeMetaType(const meta::DocumentMetaType_CSPtr& metaType, bool removed) {
+    if (!_inTransaction) {
+        Record record{TRANSACTION, 0, {}, {}};
+        record.metaTypeChanges.push_back({metaType, removed});
+        submit(std::move(record));
+        return;
+    }
+
+    // Meta types are identified by their kind and name, a remove followed by an add is a replace
+    auto it = _currentMetaTypeIndex.find(metaType->id());
+    if (it != _currentMetaTypeIndex.end()) {
+        _current.metaTypeChanges[it->second] = {metaType, removed};
+        return;
+    }
+
+    _currentMetaTypeIndex.emplace(metaType->id(), _current.metaTypeChanges.size());
+    _current.metaTypeChanges.push_back({metaType, removed});
+}
+
+void OperationJournal::replaceMetaType(const meta::DocumentMetaType_CSPtr& oldMetaType,
+                                       const meta::DocumentMetaType_CSPtr& newMetaType) {
+    bool standalone = !_inTransaction;
+    _inTransaction = true;
+
+    if (oldMetaType->id() != newMetaType->id()) {
+        changeMetaType(oldMetaType, true);
+    }
+    changeMetaType(newMetaType, false);
+
+    if (standalone) {
+        _inTransaction = false;
+        submitCurrent();
+    }
+}
+
+void OperationJournal::submitCurrent() {
+    if (_current.changes.empty() && _current.metaTypeChanges.empty()) {
+        return;
+    }
+
+    Record record{TRANSACTION, 0, {}, {}};
+    std::swap(record.metaTypeChanges, _current.metaTypeChanges);
+    std::swap(record.changes, _current.changes);
+    _currentMetaTypeIndex.clear();
+    _currentIndex.clear();
+    submit(std::move(record));
+
+    if (_checkpointInterval != 0 && ++_sinceCheckpoint >= _checkpointInterval) {
+        checkpoint();
+    }
+}
+
+void OperationJournal::submit(Record record) {
+    record.sequence = ++_sequence;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(record));
+    }
+    _condition.notify_all();
+}
+
+OperationJournal::Record OperationJournal::snapshot() {
+    Record record{CHECKPOINT, 0, {}, {}};
+
+    for (const auto& metaType : allMetaTypes(_document)) {
+        record.metaTypeChanges.push_back({metaType, false});
+    }
+
+    for (const auto& entity : allEntities(_document)) {
+        record.changes.emplace_back(entity->id(), entity);
+    }
+
+    return record;
+}
+
+void OperationJournal::writerLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true) {
+        _condition.wait(lock, [this]() {
+            return _stop || !_queue.empty();
+        });
+
+        if (_queue.empty()) {
+            return;
+        }
+
+        std::deque<Record> records;
+        std::swap(records, _queue);
+        _writing = true;
+        bool failed = !_error.empty();
+        lock.unlock();
+
+        // Once a write failed the file can't be trusted anymore, following records are dropped
+        std::string error;
+        if (!failed) {
+            try {
+                bool pending = false;
+
+                for (const auto& record : records) {
+                    if (record.type == CHECKPOINT) {
+                        writeCheckpoint(record);
+                        pending = false;
+                    }
+                    else {
+                        writeRecord(record, _file);
+                        pending = true;
+                    }
+                }
+
+                if (pending) {
+                    syncFile(_file);
+                }
+            }
+            catch (const std::exception& e) {
+                error = e.what();
+            }
+        }
+
+        lock.lock();
+        _writing = false;
+        if (_error.empty()) {
+            _error = error;
+        }
+        _condition.notify_all();
+    }
+}
+
+void OperationJournal::writeRecord(const Record& record, std::FILE* file) {
+    _buffer.clear();
+    _buffer.writeUInt8(record.type);
+    _buffer.writeVarUInt(record.sequence);
+
+    // Meta types are written first, so the entities of the record use their new version
+    auto countPosition = _buffer.buffer().size();
+    _buffer.writeUInt64(0);
+
+    uint64_t count = 0;
+    for (const auto& change : record.metaTypeChanges) {
+        auto position = _buffer.buffer().size();
+        _buffer.writeBool(change.removed);
+
+        if (!_encoder.writeMetaType(change.metaType)) {
+            _buffer.buffer().resize(position);
+            continue;
+        }
+
+        count++;
+    }
+
+    writeCount(_buffer, countPosition, count);
+
+    // Count placeholder, unsupported entities are skipped
+    countPosition = _buffer.buffer().size();
+    _buffer.writeUInt64(0);
+
+    count = 0;
+    for (const auto& change : record.changes) {
+        auto position = _buffer.buffer().size();
+        _buffer.writeVarUInt(change.first);
+        _buffer.writeBool(change.second != nullptr);
+
+        if (change.second != nullptr && !_encoder.write(change.second)) {
+            _buffer.buffer().resize(position);
+            continue;
+        }
+
+        count++;
+    }
+
+    writeCount(_buffer, countPosition, count);
+
+    const auto& payload = _buffer.buffer();
+    BinaryWriter header;
+    header.writeUInt32(static_cast<uint32_t>(payload.size()));
+    header.writeUInt32(checksum(payload.data(), payload.size()));
+
+    writeFile(file, header.buffer());
+    writeFile(file, payload);
+}
+
+void OperationJournal::writeCheckpoint(const Record& record) {
+    auto tmpPath = _path + ".tmp";
+
+    if (_file != nullptr) {
+        std::fclose(_file);
+        _file = nullptr;
+    }
+
+    auto file = std::fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Unable to open operation journal " + tmpPath);
+    }
+
+    // The checkpoint starts a new file, which must be readable without the previous records
+    _encoder.reset();
+
+    try {
+        BinaryWriter header;
+        header.writeBytes(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header.writeUInt32(JOURNAL_VERSION);
+        writeFile(file, header.buffer());
+        writeRecord(record, file);
+        syncFile(file);
+    }
+    catch (...) {
+        std::fclose(file);
+        throw;
+    }
+
+    std::fclose(file);
+
+#ifdef _WIN32
+    std::remove(_path.c_str());
+#endif
+    if (std::rename(tmpPath.c_str(), _path.c_str()) != 0) {
+        throw std::runtime_error("Unable to replace operation journal " + _path);
+    }
+
+    _file = std::fopen(_path.c_str(), "ab");
+    if (_file == nullptr) {
+        throw std::runtime_error("Unable to open operation journal " + _path);
+    }
+}
+
+size_t OperationJournal::replay(const Document_SPtr& document, const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Unable to open operation journal " + path);
+    }
+
+    std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    if (data.size() < FILE_HEADER_SIZE || std::memcmp(data.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        throw std::runtime_error(path + " is not an operation journal");
+    }
+
+    BinaryReader fileReader(data.data(), data.size());
+    fileReader.readBytes(sizeof(JOURNAL_MAGIC));
+    if (fileReader.readUInt32() != JOURNAL_VERSION) {
+        throw std::runtime_error("Unsupported operation journal version");
+    }
+
+    EntityDecoder decoder(document);
+    size_t applied = 0;
+
+    while (fileReader.remaining() >= RECORD_HEADER_SIZE) {
+        auto size = fileReader.readUInt32();
+        auto crc = fileReader.readUInt32();
+
+        if (size > fileReader.remaining()) {
+            break;
+        }
+
+        auto payload = fileReader.readBytes(size);
+        if (checksum(payload, size) != crc) {
+            break;
+        }
+
+        // Decode the whole record before changing the document, so a record is applied completely or not at all
+        RecordType type;
+        std::vector<meta::DocumentMetaType_CSPtr> metaTypePuts;
+        std::vector<meta::DocumentMetaType_CSPtr> metaTypeRemoves;
+        std::vector<entity::CADEntity_CSPtr> puts;
+        std::vector<ID_DATATYPE> removed;
+
+        try {
+            BinaryReader reader(payload, size);
+            type = static_cast<RecordType>(reader.readUInt8());
+            reader.readVarUInt();
+
+            if (type == CHECKPOINT) {
+                decoder.reset();
+            }
+            else if (type != TRANSACTION) {
+                break;
+            }
+
+            for (auto count = reader.readUInt64(); count > 0; count--) {
+                auto removed = reader.readBool();
+                auto metaType = decoder.readMetaType(reader, false);
+
+                if (removed) {
+                    metaTypeRemoves.push_back(metaType);
+                }
+                else {
+                    metaTypePuts.push_back(metaType);
+                }
+            }
+
+            for (auto count = reader.readUInt64(); count > 0; count--) {
+                auto id = reader.readVarUInt();
+
+                if (reader.readBool()) {
+                    puts.push_back(decoder.read(reader));
+                }
+                else {
+                    removed.push_back(id);
+                }
+            }
+        }
+        catch (const std::runtime_error&) {
+            break;
+        }
+
+        for (const auto& metaType : decoder.takeNewMetaTypes()) {
+            document->addDocumentMetaType(metaType);
+        }
+
+        for (const auto& metaType : metaTypePuts) {
+            auto existing = documentMetaType(document, metaType);
+
+            if (existing == nullptr) {
+                document->addDocumentMetaType(metaType);
+            }
+            else if (existing != metaType) {
+                document->replaceDocumentMetaType(existing, metaType);
+            }
+        }
+
+        std::vector<entity::CADEntity_CSPtr> removes;
+        if (type == CHECKPOINT) {
+            removes = allEntities(document);
+        }
+        else {
+            for (auto id : removed) {
+                auto entity = document->entityByID(id);
+                if (entity != nullptr) {
+                    removes.push_back(entity);
+                }
+            }
+        }
+
+        document->applyBatch(puts, removes, {});
+
+        // Removed after the entities, which may still use them until then
+        for (const auto& metaType : metaTypeRemoves) {
+            auto existing = documentMetaType(document, metaType);
+
+            if (existing != nullptr) {
+                document->removeDocumentMetaType(existing);
+            }
+        }
+
+        applied++;
+    }
+
+    return applied;
+}
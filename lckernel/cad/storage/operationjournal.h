@@ -0,0 +1,187 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cad/const.h"
+#include "cad/base/cadentity.h"
+#include "cad/events/addblockevent.h"
+#include "cad/events/addentityevent.h"
+#include "cad/events/addlayerevent.h"
+#include "cad/events/addlinepatternevent.h"
+#include "cad/events/batchentityevent.h"
+#include "cad/events/beginprocessevent.h"
+#include "cad/events/commitprocessevent.h"
+#include "cad/events/removeblockevent.h"
+#include "cad/events/removeentityevent.h"
+#include "cad/events/removelayerevent.h"
+#include "cad/events/removelinepatternevent.h"
+#include "cad/events/replaceblockevent.h"
+#include "cad/events/replaceentityevent.h"
+#include "cad/events/replacelayerevent.h"
+#include "cad/events/replacelinepatternevent.h"
+#include "entitycodec.h"
+
+namespace lc {
+namespace storage {
+/**
+ * @brief Append-only log of the changes made to a document
+ *
+ * The journal starts with a checkpoint containing all layers, line patterns, blocks and entities of the document,
+ * followed by a record per transaction with the entities and the meta types added, replaced or removed between
+ * a BeginProcessEvent and its CommitProcessEvent. Changes made outside of an operation (undo, redo) are recorded
+ * as soon as they happen, with a record per BatchEntityEvent.
+ *
+ * Records are encoded and written by a background thread. All records queued while the previous write was
+ * in progress are written at once and synced to disk with a single fsync, so the cost of the sync is shared
+ * by the transactions of a burst of edits.
+ *
+ * Every checkpointInterval transactions, a new checkpoint is written to a temporary file which replaces the
+ * journal, which keeps the journal and the replay time bounded.
+ *
+ * Each record is stored with its length and a CRC32. replay() stops at the first incomplete or corrupted
+ * record, so a crash while writing loses at most the transactions which were not synced yet.
+ */
+class OperationJournal {
+public:
+    static const size_t DEFAULT_CHECKPOINT_INTERVAL = 1000;
+
+    /**
+     * @brief Start journaling a document
+     * The file is created or truncated, a checkpoint of the current document is written to it.
+     * Throws a std::runtime_error if the file can't be opened.
+     * @param document Document to journal
+     * @param path Path of the journal
+     * @param checkpointInterval Amount of transactions between two checkpoints, 0 to disable automatic checkpoints
+     */
+    OperationJournal(Document_SPtr document, std::string path, size_t checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL);
+
+    /**
+     * @brief Stop journaling, the queued records are written first
+     */
+    ~OperationJournal();
+
+    OperationJournal(const OperationJournal&) = delete;
+    OperationJournal& operator=(const OperationJournal&) = delete;
+
+    const std::string& path() const;
+
+    /**
+     * @brief Wait until all transactions committed so far are written and synced
+     * Throws a std::runtime_error if a write failed.
+     */
+    void flush();
+
+    /**
+     * @brief Replace the journal by a checkpoint of the current document
+     */
+    void checkpoint();
+
+    /**
+     * @brief Apply the content of a journal to a document
+     * Layers, line patterns and blocks of the journal replace the ones of the document with the same name.
+     * Records after an incomplete or corrupted one are ignored.
+     * Throws a std::runtime_error if the file can't be read or isn't a journal.
+     * @param document Document to restore, usually empty
+     * @param path Path of the journal
+     * @return Amount of records applied
+     */
+    static size_t replay(const Document_SPtr& document, const std::string& path);
+
+private:
+    enum RecordType : uint8_t {
+        TRANSACTION = 1,
+        CHECKPOINT
+    };
+
+    /**
+     * @brief Layer, line pattern or block added, replaced or removed
+     */
+    struct MetaTypeChange {
+        meta::DocumentMetaType_CSPtr metaType;
+        bool removed;
+    };
+
+    /**
+     * @brief Entities and meta types changed by a transaction, or all of them for a checkpoint
+     * A nullptr entity means the entity with the given ID was removed.
+     */
+    struct Record {
+        RecordType type;
+        uint64_t sequence;
+        std::vector<MetaTypeChange> metaTypeChanges;
+        std::vector<std::pair<ID_DATATYPE, entity::CADEntity_CSPtr>> changes;
+    };
+
+    void on_beginProcessEvent(const event::BeginProcessEvent& event);
+    void on_commitProcessEvent(const event::CommitProcessEvent& event);
+    void on_addEntityEvent(const event::AddEntityEvent& event);
+    void on_removeEntityEvent(const event::RemoveEntityEvent& event);
+    void on_replaceEntityEvent(const event::ReplaceEntityEvent& event);
+    void on_batchEntityEvent(const event::BatchEntityEvent& event);
+    void on_addLayerEvent(const event::AddLayerEvent& event);
+    void on_removeLayerEvent(const event::RemoveLayerEvent& event);
+    void on_replaceLayerEvent(const event::ReplaceLayerEvent& event);
+    void on_addLinePatternEvent(const event::AddLinePatternEvent& event);
+    void on_removeLinePatternEvent(const event::RemoveLinePatternEvent& event);
+    void on_replaceLinePatternEvent(const event::ReplaceLinePatternEvent& event);
+    void on_addBlockEvent(const event::AddBlockEvent& event);
+    void on_removeBlockEvent(const event::RemoveBlockEvent& event);
+    void on_replaceBlockEvent(const event::ReplaceBlockEvent& event);
+
+    void change(ID_DATATYPE id, const entity::CADEntity_CSPtr& entity);
+    void changeMetaType(const meta::DocumentMetaType_CSPtr& metaType, bool removed);
+    void replaceMetaType(const meta::DocumentMetaType_CSPtr& oldMetaType, const meta::DocumentMetaType_CSPtr& newMetaType);
+
+    /**
+     * @brief Connect or disconnect the document events
+     */
+    void connectDocument(bool connect);
+
+    /**
+     * @brief Queue the changes collected since the last record as a transaction record
+     */
+    void submitCurrent();
+    void submit(Record record);
+    Record snapshot();
+
+    void writerLoop();
+    void writeRecord(const Record& record, std::FILE* file);
+    void writeCheckpoint(const Record& record);
+
+    Document_SPtr _document;
+    std::string _path;
+    size_t _checkpointInterval;
+
+    // Accessed by the thread emitting the document events
+    bool _inTransaction;
+    Record _current;
+    std::unordered_map<ID_DATATYPE, size_t> _currentIndex;
+    std::unordered_map<std::string, size_t> _currentMetaTypeIndex;
+    uint64_t _sequence;
+    size_t _sinceCheckpoint;
+
+    // Shared with the writer thread
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<Record> _queue;
+    bool _writing;
+    bool _stop;
+    std::string _error;
+
+    // Accessed by the writer thread
+    std::FILE* _file;
+    BinaryWriter _buffer;
+    EntityEncoder _encoder; /*!< Writes to _buffer, its table of written objects is shared by the records of the file */
+    std::thread _writer;
+};
+
+DECLARE_SHORT_SHARED_PTR(OperationJournal)
+}
+}
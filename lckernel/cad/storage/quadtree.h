@@ -289,6 +289,42 @@ public:
         });
     }
 
+    /**
+     * @brief Call a function for each entity within this node and it's sub nodes
+     * Unlike each(), entities are passed as stored, without cast.
+     */
+    template<typename T>
+    void eachEntity(T& func) const {
+        if (_nodes[0] != nullptr) {
+            for (auto node : _nodes) {
+                node->eachEntity(func);
+            }
+        }
+
+        for (const auto& object : _objects) {
+            func(object);
+        }
+    }
+
+    /**
+     * @brief Call a function for each entity stored in the nodes including an area
+     * Same entities as retrieve(area), without copying them into a vector.
+     */
+    template<typename T>
+    void eachInArea(const geo::Area& area, T& func) const {
+        if (_nodes[0] != nullptr) {
+            for (auto node : _nodes) {
+                if (node->includes(area)) {
+                    node->eachInArea(area, func);
+                }
+            }
+        }
+
+        for (const auto& object : _objects) {
+            func(object);
+        }
+    }
+
     /**
      * @brief optimise
      * Optmise this tree. Current implementation will remove empty nodes up till the root node
@@ -553,6 +589,20 @@ public:
         QuadTreeSub<E>::insert(entity);
     }
 
+    /**
+     * @brief insert
+     * Insert a set of entities into the quad tree, the ID cache is grown only once
+     * @param entities
+     */
+    void insert(const std::vector<E>& entities) {
+        _cadentities.reserve(_cadentities.size() + entities.size());
+
+        for (const auto& entity : entities) {
+            _cadentities.insert(std::make_pair(entity->id(), entity));
+            QuadTreeSub<E>::insert(entity);
+        }
+    }
+
     /**
      * @brief test
      * validy of the tree by comparing all nodes with the std::map
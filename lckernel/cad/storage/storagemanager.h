@@ -21,6 +21,16 @@ public:
      */
     virtual void insertEntity(entity::CADEntity_CSPtr) = 0;
 
+    /**
+     * @brief insert a set of entities at once
+     * \param std::vector<entity::CADEntity_CSPtr>
+     */
+    virtual void insertEntities(const std::vector<entity::CADEntity_CSPtr>& entities) {
+        for (const auto& entity : entities) {
+            insertEntity(entity);
+        }
+    }
+
     /**
      * @brief insertEntityContainer
      * \param EntityContainer<entity::CADEntity_CSPtr>
@@ -27,6 +27,28 @@ void StorageManagerImpl::insertEntity(entity::CADEntity_CSPtr entity) {
     }
 }
 
+void StorageManagerImpl::insertEntities(const std::vector<entity::CADEntity_CSPtr>& entities) {
+    // Group the entities per block so each container is updated in one go
+    std::vector<entity::CADEntity_CSPtr> modelEntities;
+    std::map<std::string, std::vector<entity::CADEntity_CSPtr>> blockEntities;
+    modelEntities.reserve(entities.size());
+
+    for (const auto& entity : entities) {
+        if (entity->block() != nullptr) {
+            blockEntities[entity->block()->name()].push_back(entity);
+        }
+        else {
+            modelEntities.push_back(entity);
+        }
+    }
+
+    _entities.insert(modelEntities);
+
+    for (const auto& block : blockEntities) {
+        _blocksEntities[block.first].insert(block.second);
+    }
+}
+
 void StorageManagerImpl::removeEntity(entity::CADEntity_CSPtr entity) {
     if (entity->block() != nullptr)
     {
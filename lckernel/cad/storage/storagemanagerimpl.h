@@ -37,6 +37,7 @@ public:
     virtual ~StorageManagerImpl() = default;
 
     void insertEntity(entity::CADEntity_CSPtr) override;
+    void insertEntities(const std::vector<entity::CADEntity_CSPtr>& entities) override;
     void removeEntity(entity::CADEntity_CSPtr) override;
     void insertEntityContainer(const EntityContainer <entity::CADEntity_CSPtr>&) override;
     entity::CADEntity_CSPtr entityByID(ID_DATATYPE id) const override;
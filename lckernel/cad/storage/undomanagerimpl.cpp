@@ -1,72 +1,147 @@
 #include "undomanagerimpl.h"
 
 #include "cad/operations/documentoperation.h"
+#include "cad/operations/entitydelta.h"
 #include "cad/operations/undoable.h"
 #include <nano-signal-slot/nano_signal_slot.hpp>
 
 using namespace lc;
 using namespace lc::storage;
 
-UndoManagerImpl::UndoManagerImpl(unsigned int maximumUndoLevels) :
-    _maximumUndoLevels(maximumUndoLevels) {
+namespace {
+/**
+ * Entries using less memory than this are considered small edits and can be compacted
+ */
+const size_t COMPACTION_THRESHOLD = 64 * 1024;
+
+Document_SPtr undoableDocument(const operation::Undoable_SPtr& undoable) {
+    auto operation = std::dynamic_pointer_cast<operation::DocumentOperation>(undoable);
+    if (operation != nullptr) {
+        return operation->document();
+    }
+
+    auto delta = std::dynamic_pointer_cast<operation::EntityDelta>(undoable);
+    if (delta != nullptr) {
+        return delta->document();
+    }
+
+    return nullptr;
+}
+}
+
+UndoManagerImpl::UndoManagerImpl(unsigned int maximumUndoLevels, size_t memoryBudget) :
+    _position(0),
+    _memoryUsage(0),
+    _maximumUndoLevels(maximumUndoLevels),
+    _memoryBudget(memoryBudget) {
 }
 
 void UndoManagerImpl::on_CommitProcessEvent(const event::CommitProcessEvent& event) {
     operation::Undoable_SPtr undoable = std::dynamic_pointer_cast<operation::Undoable>(event.operation());
 
     if (undoable != nullptr) {
-        // // LOG4CXX_DEBUG(logger, "Process: " + undoable->text());
-
-        // Check if Redo is possible, if so we might need to purge objects from memory
-        // as long as we can redo, purge these objects
-        while (canRedo()) {
-            operation::Undoable_SPtr undoable = _reDoables.top();
-            _reDoables.pop();
-            // Need to get a list of absolute entities, they are all entities that are created in the _reDoables list
-            // document()->absolueteEntity(entity);
+        // A new operation makes the redo entries unreachable, release them
+        for (auto it = _history.begin() + _position; it != _history.end(); ++it) {
+            _memoryUsage -= it->memoryUsage;
         }
+        _history.erase(_history.begin() + _position, _history.end());
 
-        // Add undoable to stack
-        _unDoables.push_back(undoable);
+        // Add undoable to the history
+        auto memoryUsage = undoable->memoryUsage();
+        _history.push_back({undoable, memoryUsage});
+        _memoryUsage += memoryUsage;
+        _position++;
 
-        // Remove old undoables
-        if (_unDoables.size() > this->_maximumUndoLevels) {
-            // Need to get a list of absolute entities, they are all entities that are deleted in the _unDoables list
-            // document()->absolueteEntity(entity);
-            _unDoables.erase(_unDoables.begin(), _unDoables.begin() + 1);
+        trim();
+    }
+}
+
+void UndoManagerImpl::trim() {
+    while (_position > _maximumUndoLevels) {
+        if (!compactOldest()) {
+            evictOldest();
         }
     }
+
+    // Always keep the last operation, even when it doesn't fit in the budget
+    while (_memoryUsage > _memoryBudget && _position > 1) {
+        evictOldest();
+    }
 }
 
+bool UndoManagerImpl::compactOldest() {
+    if (_position < 2) {
+        return false;
+    }
+
+    const auto& first = _history[0];
+    const auto& second = _history[1];
+
+    if (first.memoryUsage > COMPACTION_THRESHOLD || second.memoryUsage > COMPACTION_THRESHOLD) {
+        return false;
+    }
+
+    auto document = undoableDocument(first.undoable);
+    if (document == nullptr || document != undoableDocument(second.undoable)) {
+        return false;
+    }
+
+    auto delta = std::make_shared<operation::EntityDelta>(document, first.undoable->text());
+    if (!delta->append(first.undoable) || !delta->append(second.undoable)) {
+        return false;
+    }
+
+    auto memoryUsage = delta->memoryUsage();
+    _memoryUsage = _memoryUsage - first.memoryUsage - second.memoryUsage + memoryUsage;
+
+    _history.pop_front();
+    _history.front() = {delta, memoryUsage};
+    _position--;
+
+    return true;
+}
+
+void UndoManagerImpl::evictOldest() {
+    auto entry = std::move(_history.front());
+    _history.pop_front();
+    _memoryUsage -= entry.memoryUsage;
+    _position--;
+
+    if (_spillHandler) {
+        _spillHandler(entry.undoable);
+    }
+}
 
 void UndoManagerImpl::redo() {
     if (canRedo()) {
-        operation::Undoable_SPtr undoable = _reDoables.top();
-        _reDoables.pop();
-        undoable->redo();
-        _unDoables.push_back(undoable);
+        _history[_position].undoable->redo();
+        _position++;
     }
 }
 void UndoManagerImpl::undo() {
     if (canUndo()) {
-        operation::Undoable_SPtr undoable = _unDoables.back();
-        _unDoables.pop_back();
-        undoable->undo();
-        _reDoables.push(undoable);
+        _position--;
+        _history[_position].undoable->undo();
     }
 }
 
 bool UndoManagerImpl::canRedo() const {
-    return !_reDoables.empty();
+    return _position < _history.size();
 }
 bool UndoManagerImpl::canUndo() const {
-    return !_unDoables.empty();
+    return _position > 0;
 }
 
 void UndoManagerImpl::removeUndoables() {
-    _unDoables.clear();
+    _history.clear();
+    _position = 0;
+    _memoryUsage = 0;
+}
 
-    while (!_reDoables.empty()) {
-        _reDoables.pop();
-    }
+size_t UndoManagerImpl::memoryUsage() const {
+    return _memoryUsage;
+}
+
+void UndoManagerImpl::setSpillHandler(SpillHandler spillHandler) {
+    _spillHandler = std::move(spillHandler);
 }
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <stack>
-#include <vector>
+#include <deque>
+#include <functional>
 
 #include "cad/const.h"
 
@@ -13,13 +13,24 @@
 namespace lc {
 namespace storage {
 /**
- * UndoManagerImpl manages a stack of operations and allows for
+ * UndoManagerImpl manages a history of operations and allows for
  * undo or re-do operations that where done on a canvas
+ *
+ * The history is bounded by a number of levels and by the memory kept alive by the operations.
+ * When the level limit is reached, the two oldest entity operations are compacted into a single delta
+ * as long as they are small, the oldest entry is evicted otherwise.
+ * When the memory budget is exceeded, the oldest entries are evicted.
  * @param maximumUndoLevels
+ * @param memoryBudget in bytes
  */
 class UndoManagerImpl : public UndoManager {
 public:
-    UndoManagerImpl(unsigned int maximumUndoLevels);
+    /**
+     * @brief Function receiving the operations evicted from the history, allowing to spill them to disk
+     */
+    typedef std::function<void(const operation::Undoable_SPtr&)> SpillHandler;
+
+    UndoManagerImpl(unsigned int maximumUndoLevels, size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
 
     virtual ~UndoManagerImpl() = default;
 
@@ -66,10 +77,46 @@ public:
      */
     virtual void removeUndoables();
 
+    /*!
+     * \brief Approximate memory kept alive by the history
+     * \return size in bytes
+     */
+    size_t memoryUsage() const;
+
+    /*!
+     * \brief Set the function receiving the operations evicted from the undo history
+     * Without handler, evicted operations are released.
+     * \param spillHandler
+     */
+    void setSpillHandler(SpillHandler spillHandler);
+
+    static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
 private:
-    std::vector<operation::Undoable_SPtr> _unDoables; /*!< Undo list */
-    std::stack<operation::Undoable_SPtr> _reDoables; /*!< Redo stack */
+    struct Entry {
+        operation::Undoable_SPtr undoable;
+        size_t memoryUsage;
+    };
+
+    /*!
+     * \brief Compact or evict the oldest entries until the history is within its limits
+     */
+    void trim();
+
+    /*!
+     * \brief Try to replace the two oldest entries by a single delta
+     * \return true if the entries were compacted
+     */
+    bool compactOldest();
+
+    void evictOldest();
+
+    std::deque<Entry> _history; /*!< Undo entries followed by redo entries */
+    size_t _position; /*!< Amount of entries which can be undone */
+    size_t _memoryUsage; /*!< Sum of the memory usage of all entries */
     const unsigned int _maximumUndoLevels; /*!< Maximum undo level */
+    const size_t _memoryBudget; /*!< Maximum memory usage */
+    SpillHandler _spillHandler;
 
 public:
     void on_CommitProcessEvent(const lc::event::CommitProcessEvent& event);
@@ -0,0 +1,84 @@
+#include "kdtree.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace lc::tools;
+
+KdTree::KdTree(const std::vector<geo::Coordinate>& points) {
+    _nodes.reserve(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        _nodes.push_back({points[i].x(), points[i].y(), i});
+    }
+
+    build(0, _nodes.size(), true);
+}
+
+void KdTree::build(size_t begin, size_t end, bool splitX) {
+    // The tree is stored implicitly, the median of each range is the node splitting it
+    while (end - begin > 1) {
+        auto middle = begin + (end - begin) / 2;
+
+        std::nth_element(_nodes.begin() + begin, _nodes.begin() + middle, _nodes.begin() + end,
+                         [splitX](const Node& a, const Node& b) {
+            return splitX ? a.x < b.x : a.y < b.y;
+        });
+
+        build(begin, middle, !splitX);
+        begin = middle + 1;
+        splitX = !splitX;
+    }
+}
+
+bool KdTree::nearest(const geo::Coordinate& point, double maxDistance, size_t& index) const {
+    auto bestDistance2 = maxDistance * maxDistance;
+    auto bestIndex = std::numeric_limits<size_t>::max();
+
+    search(0, _nodes.size(), true, point.x(), point.y(), bestDistance2, bestIndex);
+
+    if (bestIndex == std::numeric_limits<size_t>::max()) {
+        return false;
+    }
+
+    index = bestIndex;
+    return true;
+}
+
+void KdTree::search(size_t begin,
+                    size_t end,
+                    bool splitX,
+                    double x,
+                    double y,
+                    double& bestDistance2,
+                    size_t& bestIndex) const {
+    if (begin >= end) {
+        return;
+    }
+
+    auto middle = begin + (end - begin) / 2;
+    const auto& node = _nodes[middle];
+
+    auto dx = node.x - x;
+    auto dy = node.y - y;
+    auto distance2 = dx * dx + dy * dy;
+    if (distance2 <= bestDistance2) {
+        bestDistance2 = distance2;
+        bestIndex = node.index;
+    }
+
+    auto split = splitX ? x - node.x : y - node.y;
+
+    // Search the side of the point first, the other side only if it can contain a nearer point
+    if (split < 0) {
+        search(begin, middle, !splitX, x, y, bestDistance2, bestIndex);
+        if (split * split <= bestDistance2) {
+            search(middle + 1, end, !splitX, x, y, bestDistance2, bestIndex);
+        }
+    }
+    else {
+        search(middle + 1, end, !splitX, x, y, bestDistance2, bestIndex);
+        if (split * split <= bestDistance2) {
+            search(begin, middle, !splitX, x, y, bestDistance2, bestIndex);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include "cad/geometry/geocoordinate.h"
+
+namespace lc {
+namespace tools {
+/**
+ * @brief Static 2D k-d tree of coordinates
+ * The tree is built once from a list of coordinates and answers nearest point queries in logarithmic time.
+ * The z coordinate is ignored.
+ */
+class KdTree {
+public:
+    KdTree() = default;
+
+    /**
+     * @brief Build the tree
+     * @param points Coordinates, their position in this vector is the index returned by nearest()
+     */
+    explicit KdTree(const std::vector<geo::Coordinate>& points);
+
+    size_t size() const {
+        return _nodes.size();
+    }
+
+    bool empty() const {
+        return _nodes.empty();
+    }
+
+    /**
+     * @brief Find the nearest coordinate
+     * @param point Coordinate to search from
+     * @param maxDistance Coordinates further than this distance are ignored
+     * @param index Index of the nearest coordinate, set if one was found
+     * @return false if no coordinate is within maxDistance
+     */
+    bool nearest(const geo::Coordinate& point, double maxDistance, size_t& index) const;
+
+private:
+    struct Node {
+        double x;
+        double y;
+        size_t index;
+    };
+
+    void build(size_t begin, size_t end, bool splitX);
+
+    void search(size_t begin, size_t end, bool splitX, double x, double y, double& bestDistance2, size_t& bestIndex) const;
+
+    std::vector<Node> _nodes;
+};
+}
+}
@@ -0,0 +1,393 @@
+#include "poolallocator.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace lc;
+using namespace tools;
+
+const size_t Pool::MAX_BLOCK_SIZE;
+
+namespace {
+const size_t GRANULARITY = 16;
+const size_t SIZE_CLASSES = Pool::MAX_BLOCK_SIZE / GRANULARITY;
+const size_t SLAB_SIZE = 64 * 1024;
+
+// Amount of blocks moved at once between a thread cache and the shared pool
+const size_t BATCH_SIZE = 64;
+
+// Amount of slabs without used blocks kept per size class, so a slab isn't released and created again
+// each time the amount of blocks used crosses a slab boundary
+const size_t MAX_EMPTY_SLABS = 1;
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+/**
+ * @brief Header at the start of each slab
+ * Slabs are aligned on their size, the slab of a block is found by masking its address.
+ */
+struct Slab {
+    FreeBlock* freeBlocks;
+    size_t freeCount;
+    Slab* previous; /*!< Links of the list of slabs with free blocks */
+    Slab* next;
+};
+
+const size_t SLAB_HEADER_SIZE = (sizeof(Slab) + GRANULARITY - 1) / GRANULARITY * GRANULARITY;
+
+/**
+ * @brief Blocks of one size class shared by all threads
+ */
+struct SizeClass {
+    std::mutex mutex;
+    Slab* available = nullptr;
+    size_t slabCount = 0;
+    size_t emptySlabs = 0;
+
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> deallocations{0};
+};
+
+/**
+ * @brief Return the shared size classes
+ * They are never destroyed, entities can be released during the destruction of static objects.
+ */
+std::array<SizeClass, SIZE_CLASSES>& sizeClasses() {
+    static auto classes = new std::array<SizeClass, SIZE_CLASSES>();
+    return *classes;
+}
+
+size_t sizeClassIndex(size_t size) {
+    return size == 0 ? 0 : (size - 1) / GRANULARITY;
+}
+
+size_t blocksPerSlab(size_t index) {
+    return (SLAB_SIZE - SLAB_HEADER_SIZE) / ((index + 1) * GRANULARITY);
+}
+
+Slab* slabOf(void* block) {
+    return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(block) & ~static_cast<uintptr_t>(SLAB_SIZE - 1));
+}
+
+/**
+ * @brief Map a slab aligned on its size
+ * Slabs are mapped directly, so released slabs are given back to the system instead of staying in the heap.
+ */
+void* allocateSlab() {
+#ifdef _WIN32
+    // Allocations are aligned on 64kB
+    auto memory = VirtualAlloc(nullptr, SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+#else
+    // Map twice the size and unmap the parts before and after the aligned slab
+    auto memory = mmap(nullptr, 2 * SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    auto start = reinterpret_cast<uintptr_t>(memory);
+    auto aligned = (start + SLAB_SIZE - 1) & ~static_cast<uintptr_t>(SLAB_SIZE - 1);
+
+    if (aligned > start) {
+        munmap(memory, aligned - start);
+    }
+    if (aligned + SLAB_SIZE < start + 2 * SLAB_SIZE) {
+        munmap(reinterpret_cast<void*>(aligned + SLAB_SIZE), start + 2 * SLAB_SIZE - aligned - SLAB_SIZE);
+    }
+
+    return reinterpret_cast<void*>(aligned);
+#endif
+}
+
+void releaseSlab(Slab* slab) {
+#ifdef _WIN32
+    VirtualFree(slab, 0, MEM_RELEASE);
+#else
+    munmap(slab, SLAB_SIZE);
+#endif
+}
+
+void linkSlab(SizeClass& sizeClass, Slab* slab) {
+    slab->previous = nullptr;
+    slab->next = sizeClass.available;
+
+    if (sizeClass.available != nullptr) {
+        sizeClass.available->previous = slab;
+    }
+    sizeClass.available = slab;
+}
+
+void unlinkSlab(SizeClass& sizeClass, Slab* slab) {
+    if (slab->previous != nullptr) {
+        slab->previous->next = slab->next;
+    }
+    else {
+        sizeClass.available = slab->next;
+    }
+
+    if (slab->next != nullptr) {
+        slab->next->previous = slab->previous;
+    }
+}
+
+/**
+ * @brief Create a slab with all its blocks free, the size class must be locked
+ */
+void createSlab(size_t index) {
+    auto& sizeClass = sizeClasses()[index];
+    auto blockSize = (index + 1) * GRANULARITY;
+    auto slab = static_cast<Slab*>(allocateSlab());
+    auto memory = reinterpret_cast<char*>(slab);
+
+    slab->freeBlocks = nullptr;
+    slab->freeCount = blocksPerSlab(index);
+
+    for (auto block = memory + SLAB_HEADER_SIZE; block + blockSize <= memory + SLAB_SIZE; block += blockSize) {
+        auto freeBlock = reinterpret_cast<FreeBlock*>(block);
+        freeBlock->next = slab->freeBlocks;
+        slab->freeBlocks = freeBlock;
+    }
+
+    linkSlab(sizeClass, slab);
+    sizeClass.slabCount++;
+    sizeClass.emptySlabs++;
+}
+
+/**
+ * @brief Take up to BATCH_SIZE blocks from the shared pool, a new slab is created when it is empty
+ * @return List of blocks
+ */
+FreeBlock* takeBlocks(size_t index, size_t& count) {
+    auto& sizeClass = sizeClasses()[index];
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+
+    FreeBlock* blocks = nullptr;
+    count = 0;
+
+    while (count < BATCH_SIZE) {
+        if (sizeClass.available == nullptr) {
+            if (count > 0) {
+                break;
+            }
+
+            createSlab(index);
+        }
+
+        auto slab = sizeClass.available;
+        if (slab->freeCount == blocksPerSlab(index)) {
+            sizeClass.emptySlabs--;
+        }
+
+        while (count < BATCH_SIZE && slab->freeBlocks != nullptr) {
+            auto block = slab->freeBlocks;
+            slab->freeBlocks = block->next;
+            slab->freeCount--;
+
+            block->next = blocks;
+            blocks = block;
+            count++;
+        }
+
+        if (slab->freeBlocks == nullptr) {
+            unlinkSlab(sizeClass, slab);
+        }
+    }
+
+    return blocks;
+}
+
+/**
+ * @brief Give a list of blocks back to the shared pool
+ * Slabs which have no used block anymore are released, except MAX_EMPTY_SLABS of them.
+ */
+void giveBlocks(size_t index, FreeBlock* blocks) {
+    auto& sizeClass = sizeClasses()[index];
+    auto capacity = blocksPerSlab(index);
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+
+    while (blocks != nullptr) {
+        auto block = blocks;
+        blocks = block->next;
+
+        auto slab = slabOf(block);
+        if (slab->freeBlocks == nullptr) {
+            linkSlab(sizeClass, slab);
+        }
+
+        block->next = slab->freeBlocks;
+        slab->freeBlocks = block;
+        slab->freeCount++;
+
+        if (slab->freeCount == capacity) {
+            if (sizeClass.emptySlabs < MAX_EMPTY_SLABS) {
+                sizeClass.emptySlabs++;
+            }
+            else {
+                unlinkSlab(sizeClass, slab);
+                releaseSlab(slab);
+                sizeClass.slabCount--;
+            }
+        }
+    }
+}
+
+thread_local bool threadCacheDestroyed = false;
+
+/**
+ * @brief Free blocks and counters of a thread
+ */
+class ThreadCache {
+public:
+    ThreadCache() :
+        _freeBlocks(),
+        _counts(),
+        _allocations(),
+        _deallocations() {
+    }
+
+    ~ThreadCache() {
+        for (size_t index = 0; index < SIZE_CLASSES; index++) {
+            if (_freeBlocks[index] != nullptr) {
+                giveBlocks(index, _freeBlocks[index]);
+            }
+
+            publish(index);
+        }
+
+        threadCacheDestroyed = true;
+    }
+
+    void* allocate(size_t index) {
+        if (_freeBlocks[index] == nullptr) {
+            _freeBlocks[index] = takeBlocks(index, _counts[index]);
+            publish(index);
+        }
+
+        auto block = _freeBlocks[index];
+        _freeBlocks[index] = block->next;
+        _counts[index]--;
+        _allocations[index]++;
+        return block;
+    }
+
+    void deallocate(size_t index, void* block) {
+        auto freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = _freeBlocks[index];
+        _freeBlocks[index] = freeBlock;
+        _counts[index]++;
+        _deallocations[index]++;
+
+        // Keep one batch, give the rest back so blocks released by an other thread can be reused
+        if (_counts[index] >= 2 * BATCH_SIZE) {
+            auto last = _freeBlocks[index];
+            for (size_t i = 1; i < BATCH_SIZE; i++) {
+                last = last->next;
+            }
+
+            auto rest = last->next;
+            last->next = nullptr;
+            giveBlocks(index, rest);
+            _counts[index] = BATCH_SIZE;
+            publish(index);
+        }
+    }
+
+    void addStatistics(PoolStatistics& statistics) const {
+        for (size_t index = 0; index < SIZE_CLASSES; index++) {
+            statistics.allocations += _allocations[index];
+            statistics.deallocations += _deallocations[index];
+        }
+    }
+
+private:
+    void publish(size_t index) {
+        auto& sizeClass = sizeClasses()[index];
+        sizeClass.allocations += _allocations[index];
+        sizeClass.deallocations += _deallocations[index];
+        _allocations[index] = 0;
+        _deallocations[index] = 0;
+    }
+
+    std::array<FreeBlock*, SIZE_CLASSES> _freeBlocks;
+    std::array<size_t, SIZE_CLASSES> _counts;
+    std::array<size_t, SIZE_CLASSES> _allocations;
+    std::array<size_t, SIZE_CLASSES> _deallocations;
+};
+
+/**
+ * @brief Return the cache of the calling thread, nullptr when the thread is exiting
+ */
+ThreadCache* threadCache() {
+    if (threadCacheDestroyed) {
+        return nullptr;
+    }
+
+    thread_local ThreadCache cache;
+    return &cache;
+}
+}
+
+void* Pool::allocate(size_t size) {
+    auto index = sizeClassIndex(size);
+    auto cache = threadCache();
+
+    if (cache != nullptr) {
+        return cache->allocate(index);
+    }
+
+    // The thread is exiting, take a single block
+    size_t count;
+    auto blocks = takeBlocks(index, count);
+    auto rest = blocks->next;
+    blocks->next = nullptr;
+    giveBlocks(index, rest);
+
+    sizeClasses()[index].allocations++;
+    return blocks;
+}
+
+void Pool::deallocate(void* block, size_t size) {
+    auto index = sizeClassIndex(size);
+    auto cache = threadCache();
+
+    if (cache != nullptr) {
+        cache->deallocate(index, block);
+        return;
+    }
+
+    auto freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = nullptr;
+    giveBlocks(index, freeBlock);
+    sizeClasses()[index].deallocations++;
+}
+
+PoolStatistics Pool::statistics() {
+    PoolStatistics statistics = {0, 0, 0};
+
+    for (auto& sizeClass : sizeClasses()) {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        statistics.allocations += sizeClass.allocations;
+        statistics.deallocations += sizeClass.deallocations;
+        statistics.reservedBytes += sizeClass.slabCount * SLAB_SIZE;
+    }
+
+    if (auto cache = threadCache()) {
+        cache->addStatistics(statistics);
+    }
+
+    return statistics;
+}
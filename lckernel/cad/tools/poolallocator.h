@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lc {
+namespace tools {
+/**
+ * @brief Allocation counters of the pool
+ * Each thread publishes its counters when it exchanges blocks with the shared pool, the counters of the
+ * other threads can be late by a few hundred allocations.
+ */
+struct PoolStatistics {
+    size_t allocations;   /*!< Amount of blocks allocated since the start */
+    size_t deallocations; /*!< Amount of blocks released since the start */
+    size_t reservedBytes; /*!< Memory reserved by the pool, including the free blocks */
+};
+
+/**
+ * @brief Pool of small fixed size blocks, used to allocate entities and their shared_ptr control blocks
+ *
+ * Blocks are grouped by size classes of 16 bytes, and carved out of 64kB slabs.
+ * Each thread keeps a cache of free blocks per size class, the shared pool is only locked to refill or
+ * empty a cache. A block can be released by any thread.
+ * Once all the blocks of a slab are back in the shared pool, the slab is given back to the system.
+ * One free slab per size class is kept.
+ * Larger blocks are allocated with operator new.
+ */
+class Pool {
+public:
+    // Larger blocks are not pooled
+    static const size_t MAX_BLOCK_SIZE = 1024;
+
+    static void* allocate(size_t size);
+    static void deallocate(void* block, size_t size);
+
+    static PoolStatistics statistics();
+};
+
+/**
+ * @brief Standard allocator using Pool
+ */
+template<typename T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+
+    PoolAllocator() = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) {
+    }
+
+    T* allocate(size_t n) {
+        if (!isPooled(n)) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        return static_cast<T*>(Pool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t n) {
+        if (!isPooled(n)) {
+            ::operator delete(block);
+            return;
+        }
+
+        Pool::deallocate(block, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const {
+        return false;
+    }
+
+private:
+    static bool isPooled(size_t n) {
+        return n * sizeof(T) <= Pool::MAX_BLOCK_SIZE && alignof(T) <= alignof(std::max_align_t);
+    }
+};
+
+/**
+ * @brief Destroy an object allocated with PoolAllocator
+ */
+template<typename T>
+struct PoolDeleter {
+    void operator()(T* object) const {
+        object->~T();
+        PoolAllocator<T>().deallocate(object, 1);
+    }
+};
+
+/**
+ * @brief Same as std::make_shared, the object and the control block are allocated from the pool
+ */
+template<typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&& ... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Create an object in pooled memory, for types which constructor can't be called by makePooled()
+ * @param construct Function constructing the object in the given memory with placement new
+ */
+template<typename T, typename F>
+std::shared_ptr<T> constructPooled(F construct) {
+    PoolAllocator<T> allocator;
+    auto memory = allocator.allocate(1);
+
+    T* object;
+    try {
+        object = construct(static_cast<void*>(memory));
+    }
+    catch (...) {
+        allocator.deallocate(memory, 1);
+        throw;
+    }
+
+    return std::shared_ptr<T>(object, PoolDeleter<T>(), allocator);
+}
+}
+}
@@ -0,0 +1,145 @@
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+using namespace lc::tools;
+
+namespace {
+/**
+ * Shared state of a parallelFor() call
+ * Chunks are taken in order by the calling thread and the workers until all of them are processed.
+ */
+struct ParallelJob {
+    ParallelJob(size_t count, size_t numChunks, const std::function<void(size_t, size_t)>& func) :
+        count(count),
+        numChunks(numChunks),
+        func(func),
+        next(0),
+        done(0) {
+    }
+
+    void run() {
+        size_t chunk;
+
+        while ((chunk = next++) < numChunks) {
+            try {
+                func(chunk * count / numChunks, (chunk + 1) * count / numChunks);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+
+            if (++done == numChunks) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    const size_t count;
+    const size_t numChunks;
+    const std::function<void(size_t, size_t)>& func;
+
+    std::atomic<size_t> next;
+    std::atomic<size_t> done;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr exception;
+};
+}
+
+ThreadPool::ThreadPool(unsigned int numWorkers) :
+    _stop(false) {
+    for (unsigned int i = 0; i < numWorkers; i++) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+unsigned int ThreadPool::concurrency() const {
+    return _workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t minChunkSize, const std::function<void(size_t, size_t)>& func) {
+    if (count == 0) {
+        return;
+    }
+
+    auto numChunks = std::min<size_t>(count / std::max<size_t>(minChunkSize, 1), concurrency());
+
+    if (numChunks <= 1) {
+        func(0, count);
+        return;
+    }
+
+    // The job is shared with the workers, a worker picking it up after completion only finds no chunk left
+    auto job = std::make_shared<ParallelJob>(count, numChunks, func);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 1; i < numChunks; i++) {
+            _tasks.emplace_back([job]() {
+                job->run();
+            });
+        }
+    }
+    _condition.notify_all();
+
+    job->run();
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->finished.wait(lock, [&job]() {
+            return job->done == job->numChunks;
+        });
+    }
+
+    if (job->exception) {
+        std::rethrow_exception(job->exception);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() {
+                return _stop || !_tasks.empty();
+            });
+
+            if (_stop && _tasks.empty()) {
+                return;
+            }
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lc {
+namespace tools {
+/**
+ * @brief Pool of worker threads shared by the kernel
+ * Used to spread independent work, like transforming a large set of entities, over the available cores.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Create a pool
+     * @param numWorkers Number of worker threads, the thread calling parallelFor() always takes part in the work
+     */
+    explicit ThreadPool(unsigned int numWorkers);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Return the pool shared by the kernel
+     * The pool has one thread less than the amount of cores, the last one being the calling thread.
+     */
+    static ThreadPool& instance();
+
+    /**
+     * @brief Return the amount of threads working on a parallelFor(), including the calling thread
+     */
+    unsigned int concurrency() const;
+
+    /**
+     * @brief Call func on contiguous sub-ranges of [0, count)
+     * Each index is part of exactly one sub-range. The function returns once all sub-ranges are processed,
+     * the first exception thrown by func is re-thrown in the calling thread.
+     * Ranges which can't be split in parts of at least minChunkSize elements are processed on the calling thread.
+     * Can be called from a worker thread.
+     * @param count Size of the range
+     * @param minChunkSize Minimal amount of elements per sub-range
+     * @param func Function called with the begin and end index of a sub-range
+     */
+    void parallelFor(size_t count, size_t minChunkSize, const std::function<void(size_t, size_t)>& func);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop;
+};
+}
+}
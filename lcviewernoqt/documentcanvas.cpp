@@ -55,6 +55,7 @@ DocumentCanvas::DocumentCanvas(const std::shared_ptr<lc::storage::Document>& doc
 {
     document->addEntityEvent().connect<DocumentCanvas, &DocumentCanvas::on_addEntityEvent>(this);
     document->removeEntityEvent().connect<DocumentCanvas, &DocumentCanvas::on_removeEntityEvent>(this);
+    document->batchEntityEvent().connect<DocumentCanvas, &DocumentCanvas::on_batchEntityEvent>(this);
     document->commitProcessEvent().connect<DocumentCanvas, &DocumentCanvas::on_commitProcessEvent>(this);
 
     // Render code for selected area
@@ -95,6 +96,7 @@ DocumentCanvas::DocumentCanvas(const std::shared_ptr<lc::storage::Document>& doc
 DocumentCanvas::~DocumentCanvas() {
     _document->addEntityEvent().disconnect<DocumentCanvas, &DocumentCanvas::on_addEntityEvent>(this);
     _document->removeEntityEvent().disconnect<DocumentCanvas, &DocumentCanvas::on_removeEntityEvent>(this);
+    _document->batchEntityEvent().disconnect<DocumentCanvas, &DocumentCanvas::on_batchEntityEvent>(this);
     _document->commitProcessEvent().disconnect<DocumentCanvas, &DocumentCanvas::on_commitProcessEvent>(this);
 
     if (_selectedArea != nullptr) {
@@ -164,7 +166,15 @@ void DocumentCanvas::zoom(LcPainter& painter, double factor, bool relativezoom,
 }
 
 void DocumentCanvas::autoScale(LcPainter& painter) {
-    auto extends = entityContainer().boundingBox();
+    auto container = entityContainer();
+    auto extends = container.boundingBox();
+
+    // Entities of the model space which are not loaded yet are part of the drawing
+    auto loader = _viewport == nullptr ? _document->entityLoader() : nullptr;
+    if (loader != nullptr) {
+        extends = container.asVector().empty() ? loader->bounds() : extends.merge(loader->bounds());
+    }
+
     extends = extends.increaseBy(std::min(extends.width(), extends.height()) * 0.1);
 
     setDisplayArea(painter, extends);
@@ -211,6 +221,7 @@ void DocumentCanvas::render(LcPainter& painter, PainterType type) {
         painter.source_rgb(1., 1., 1.);
         painter.lineWidthCompensation(0.5);
         painter.enable_antialias();
+        loadArea(visibleUserArea);
         auto visibleEntities = entityContainer().entitiesWithinAndCrossingAreaFast(visibleUserArea);
         std::vector<lc::viewer::LCVDrawItem_SPtr> visibleDrawables;
         visibleEntities.each< const lc::entity::CADEntity >([&](lc::entity::CADEntity_CSPtr entity) {
@@ -255,7 +266,8 @@ void DocumentCanvas::render(LcPainter& painter, PainterType type) {
 }
 
 double DocumentCanvas::drawWidth(const lc::entity::CADEntity_CSPtr& entity, const lc::entity::Insert_CSPtr& insert) {
-    auto entityLineWidth = entity->metaInfo<lc::meta::MetaLineWidth>(lc::meta::MetaLineWidthByValue::LCMETANAME());
+    auto metaInfo = entity->metaInfo();
+    auto entityLineWidth = metaInfo != nullptr ? metaInfo->lineWidth() : nullptr;
     auto entityLineWidthByValue = std::dynamic_pointer_cast<const lc::meta::MetaLineWidthByValue>(entityLineWidth);
 
     if (entityLineWidthByValue != nullptr) {
@@ -263,7 +275,10 @@ double DocumentCanvas::drawWidth(const lc::entity::CADEntity_CSPtr& entity, cons
     }
     else if(insert != nullptr &&
             std::dynamic_pointer_cast<const lc::meta::MetaLineWidthByBlock>(entityLineWidth) != nullptr) {
-        auto insertLW = insert->metaInfo<lc::meta::MetaLineWidthByValue>(lc::meta::MetaLineWidth::LCMETANAME());
+        auto insertMetaInfo = insert->metaInfo();
+        auto insertLW = std::dynamic_pointer_cast<const lc::meta::MetaLineWidthByValue>(
+                            insertMetaInfo != nullptr ? insertMetaInfo->lineWidth() : nullptr
+                        );
 
         if(insertLW != nullptr) {
             return insertLW->width();
@@ -283,7 +298,8 @@ std::vector<double> DocumentCanvas::drawLinePattern(
     double width) {
     auto layer = entity->layer();
 
-    lc::meta::DxfLinePattern_CSPtr entityLinePattern = entity->metaInfo<lc::meta::DxfLinePattern>(lc::meta::DxfLinePattern::LCMETANAME());
+    auto metaInfo = entity->metaInfo();
+    lc::meta::DxfLinePattern_CSPtr entityLinePattern = metaInfo != nullptr ? metaInfo->linePattern() : nullptr;
     auto linePatternByValue = std::dynamic_pointer_cast<const lc::meta::DxfLinePatternByValue>(entityLinePattern);
     auto linePatternByBlock = std::dynamic_pointer_cast<const lc::meta::DxfLinePatternByBlock>(entityLinePattern);
 
@@ -291,7 +307,10 @@ std::vector<double> DocumentCanvas::drawLinePattern(
         return linePatternByValue->lcPattern(width);
     }
     else if(linePatternByBlock != nullptr && insert != nullptr) {
-        auto insertLP = insert->metaInfo<lc::meta::DxfLinePatternByValue>(lc::meta::DxfLinePattern::LCMETANAME());
+        auto insertMetaInfo = insert->metaInfo();
+        auto insertLP = std::dynamic_pointer_cast<const lc::meta::DxfLinePatternByValue>(
+                            insertMetaInfo != nullptr ? insertMetaInfo->linePattern() : nullptr
+                        );
 
         if(insertLP != nullptr) {
             return insertLP->lcPattern(width);
@@ -311,7 +330,8 @@ lc::Color DocumentCanvas::drawColor(const lc::entity::CADEntity_CSPtr& entity, c
                                     bool selected) {
     LcDrawOptions lcDrawOptions;
 
-    lc::meta::MetaColor_CSPtr entityColor = entity->metaInfo<lc::meta::MetaColor>(lc::meta::MetaColor::LCMETANAME());
+    auto metaInfo = entity->metaInfo();
+    lc::meta::MetaColor_CSPtr entityColor = metaInfo != nullptr ? metaInfo->color() : nullptr;
     lc::meta::MetaColorByValue_CSPtr colorByValue = std::dynamic_pointer_cast<const lc::meta::MetaColorByValue>(entityColor);
 
     if (selected) {
@@ -322,7 +342,10 @@ lc::Color DocumentCanvas::drawColor(const lc::entity::CADEntity_CSPtr& entity, c
     }
     else if(insert != nullptr &&
             std::dynamic_pointer_cast<const lc::meta::MetaColorByBlock>(entityColor) != nullptr) {
-        auto insertColor = insert->metaInfo<lc::meta::MetaColorByValue>(lc::meta::MetaColor::LCMETANAME());
+        auto insertMetaInfo = insert->metaInfo();
+        auto insertColor = std::dynamic_pointer_cast<const lc::meta::MetaColorByValue>(
+                               insertMetaInfo != nullptr ? insertMetaInfo->color() : nullptr
+                           );
 
         if(insertColor != nullptr) {
             return insertColor->color();
@@ -501,6 +524,22 @@ void DocumentCanvas::on_removeEntityEvent(const lc::event::RemoveEntityEvent& ev
         (*_painterPtr).deleteEntityCached( (event.entity())->id() );  // Delete the cacahed pack
 }
 
+// This assumes that the added entities are already in _document->entityContainer()
+void DocumentCanvas::on_batchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    bool cached = _painterPtr != NULL && (*_painterPtr).isCachingEnabled();
+
+    for (const auto& entity : event.removed()) {
+        _entityDrawItem.erase(entity->id());
+        if (cached) {
+            (*_painterPtr).deleteEntityCached(entity->id());
+        }
+    }
+
+    for (const auto& entity : event.added()) {
+        _entityDrawItem.insert(std::make_pair(entity->id(), asDrawable(entity)));
+    }
+}
+
 std::shared_ptr<lc::storage::Document> DocumentCanvas::document() const {
     return _document;
 }
@@ -509,6 +548,25 @@ lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr> DocumentCanvas::entity
     return _document->entitiesByBlock(_viewport);
 }
 
+std::vector<lc::EntityDistance> DocumentCanvas::entityPathsNearCoordinate(const lc::geo::Coordinate& point,
+                                                                          double distance,
+                                                                          const lc::SimpleSnapConstrain& snapConstrain) const {
+    loadArea(lc::geo::Area(point - lc::geo::Coordinate(distance, distance), distance * 2, distance * 2));
+
+    if (_viewport == nullptr) {
+        return _document->entityContainer().getEntityPathsNearCoordinate(point, distance, snapConstrain);
+    }
+
+    return entityContainer().getEntityPathsNearCoordinate(point, distance, snapConstrain);
+}
+
+void DocumentCanvas::loadArea(const lc::geo::Area& area) const {
+    // The entities of the paper space are loaded with the blocks
+    if (_viewport == nullptr) {
+        _document->loadArea(area);
+    }
+}
+
 lc::geo::Area DocumentCanvas::bounds() const {
     return entityContainer().bounds();
 }
@@ -534,6 +592,8 @@ void DocumentCanvas::makeSelection(double x, double y, double w, double h, bool
         di->selected(true);
     }
 
+    loadArea(*_selectedArea);
+
     lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr> entitiesInSelection;
     if (occupies) {
         entitiesInSelection = entityContainer().entitiesFullWithinArea(*_selectedArea);
@@ -825,6 +885,7 @@ void DocumentCanvas::selectPoint(double x, double y) {
 
     _updatedSelection.clear();
     lc::geo::Area selectionArea(lc::geo::Coordinate(x - w, y - w), w * 2, w * 2);
+    loadArea(selectionArea);
     auto entities = entityContainer().entitiesWithinAndCrossingAreaFast(selectionArea);
     entities.each< const lc::entity::CADEntity >([=](lc::entity::CADEntity_CSPtr entity) {
         //Check if it is on entity
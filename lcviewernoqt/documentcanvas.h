@@ -205,6 +205,14 @@ public:
      */
     lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr> entityContainer() const;
 
+    /**
+     * @brief Return the entities of the viewport with a path near a coordinate
+     * Unlike entityContainer().getEntityPathsNearCoordinate(), the entities of the model space aren't copied.
+     */
+    std::vector<lc::EntityDistance> entityPathsNearCoordinate(const lc::geo::Coordinate& point,
+                                                              double distance,
+                                                              const lc::SimpleSnapConstrain& snapConstrain) const;
+
     /**
      * Return CADEntity as LCVDrawItem
      */
@@ -243,8 +251,16 @@ private:
 
     void on_removeEntityEvent(const lc::event::RemoveEntityEvent&);
 
+    void on_batchEntityEvent(const lc::event::BatchEntityEvent&);
+
     void on_commitProcessEvent(const lc::event::CommitProcessEvent&);
 
+    /**
+     * @brief Add the entities of the model space overlapping an area which are not loaded yet
+     * Called before drawing or querying an area of the document.
+     */
+    void loadArea(const lc::geo::Area& area) const;
+
     double drawWidth(const lc::entity::CADEntity_CSPtr& entity, const lc::entity::Insert_CSPtr& insert);
 
     std::vector<double> drawLinePattern(
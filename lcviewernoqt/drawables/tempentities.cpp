@@ -5,21 +5,119 @@ using namespace lc::viewer;
 using namespace lc::viewer::drawable;
 
 TempEntities::TempEntities(DocumentCanvas_SPtr docCanvas) :
-    _docCanvas(std::move(docCanvas)) {
+    _docCanvas(std::move(docCanvas)),
+    _offset(0., 0.),
+    _updateRequested(false) {
 }
 
 void TempEntities::addEntity(lc::entity::CADEntity_CSPtr entity) {
-    _entities.insert(std::move(entity));
-    requestUpdateEvent()();
+    insert(std::move(entity));
+    requestUpdate();
+}
+
+void TempEntities::addEntities(const std::vector<lc::entity::CADEntity_CSPtr>& entities) {
+    _entities.reserve(_entities.size() + entities.size());
+
+    for (const auto& entity : entities) {
+        insert(entity);
+    }
+
+    requestUpdate();
 }
 
 void TempEntities::removeEntity(lc::entity::CADEntity_CSPtr entity) {
-    _entities.remove(std::move(entity));
+    erase(entity);
+    requestUpdate();
+}
+
+void TempEntities::removeEntities(const std::vector<lc::entity::CADEntity_CSPtr>& entities) {
+    for (const auto& entity : entities) {
+        erase(entity);
+    }
+
+    requestUpdate();
+}
+
+void TempEntities::clear() {
+    _entities.clear();
+    _indexes.clear();
+    _offset = lc::geo::Coordinate(0., 0.);
+    requestUpdate();
+}
+
+void TempEntities::setOffset(const lc::geo::Coordinate& offset) {
+    _offset = offset;
+    requestUpdate();
+}
+
+void TempEntities::insert(lc::entity::CADEntity_CSPtr entity) {
+    auto it = _indexes.find(entity->id());
+
+    if (it == _indexes.end()) {
+        _indexes.emplace(entity->id(), _entities.size());
+        _entities.push_back({entity, DocumentCanvas::asDrawable(entity), entity->boundingBox()});
+        return;
+    }
+
+    auto& tempEntity = _entities[it->second];
+    if (tempEntity.entity != entity) {
+        tempEntity.drawable = DocumentCanvas::asDrawable(entity);
+        tempEntity.boundingBox = entity->boundingBox();
+        tempEntity.entity = std::move(entity);
+    }
+}
+
+void TempEntities::erase(const lc::entity::CADEntity_CSPtr& entity) {
+    auto it = _indexes.find(entity->id());
+    if (it == _indexes.end()) {
+        return;
+    }
+
+    // The order of the entities doesn't matter, the last one takes the place of the removed one
+    auto index = it->second;
+    _indexes.erase(it);
+
+    if (index != _entities.size() - 1) {
+        _entities[index] = std::move(_entities.back());
+        _indexes[_entities[index].entity->id()] = index;
+    }
+
+    _entities.pop_back();
+}
+
+void TempEntities::requestUpdate() {
+    if (_updateRequested) {
+        return;
+    }
+
+    _updateRequested = true;
     requestUpdateEvent()();
 }
 
 void TempEntities::onDraw(lc::viewer::event::DrawEvent const &event) {
-    _entities.each<const lc::entity::CADEntity>([&](lc::entity::CADEntity_CSPtr entity) {
-        _docCanvas->drawEntity(event.painter(), _docCanvas->asDrawable(entity));
-    });
+    _updateRequested = false;
+
+    if (_entities.empty()) {
+        return;
+    }
+
+    auto& painter = event.painter();
+    auto visibleArea = event.updateRect();
+    bool moved = _offset.x() != 0. || _offset.y() != 0.;
+
+    if (moved) {
+        painter.save();
+        painter.translate(_offset.x(), _offset.y());
+        visibleArea = lc::geo::Area(visibleArea.minP() - _offset, visibleArea.maxP() - _offset);
+    }
+
+    for (const auto& tempEntity : _entities) {
+        if (tempEntity.drawable != nullptr && visibleArea.overlaps(tempEntity.boundingBox)) {
+            _docCanvas->drawEntity(painter, tempEntity.drawable);
+        }
+    }
+
+    if (moved) {
+        painter.restore();
+    }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include <cad/base/cadentity.h>
-#include <cad/storage/entitycontainer.h>
+#include <cad/geometry/geoarea.h>
+#include <cad/geometry/geocoordinate.h>
 #include "../drawitems/lcvdrawitem.h"
 #include "../events/drawevent.h"
 #include "../documentcanvas.h"
@@ -12,6 +16,10 @@ namespace drawable {
 /**
  * \brief Storage for entities which needs to be displayed without being in the document.
  * This is useful when modifying an entity to display a preview.
+ *
+ * The drawable of an entity is created once when it is added and kept until the entity is removed or replaced.
+ * Moving the whole preview only changes an offset applied when drawing, the drawables are not rebuilt.
+ * Changes request a single update until the next draw, so adding thousands of entities repaints the view once.
  */
 class TempEntities {
 public:
@@ -23,16 +31,51 @@ public:
 
     /**
      * \brief Add a new entity to the container
+     * An entity with the same ID is replaced.
      * \param entity Entity to add
      */
     void addEntity(lc::entity::CADEntity_CSPtr entity);
 
+    /**
+     * \brief Add entities to the container
+     * \param entities Entities to add
+     */
+    void addEntities(const std::vector<lc::entity::CADEntity_CSPtr>& entities);
+
     /**
      * \brief Remove entity from the container
      * \param entity Entity to remove
      */
     void removeEntity(lc::entity::CADEntity_CSPtr entity);
 
+    /**
+     * \brief Remove entities from the container
+     * \param entities Entities to remove
+     */
+    void removeEntities(const std::vector<lc::entity::CADEntity_CSPtr>& entities);
+
+    /**
+     * \brief Remove all the entities and reset the offset
+     */
+    void clear();
+
+    /**
+     * \brief Return the amount of entities in the container
+     */
+    size_t size() const {
+        return _entities.size();
+    }
+
+    /**
+     * \brief Set the offset applied to all the entities when drawing
+     * \param offset Offset from the position of the entities
+     */
+    void setOffset(const lc::geo::Coordinate& offset);
+
+    const lc::geo::Coordinate& offset() const {
+        return _offset;
+    }
+
     /**
      * \brief Draw all the entities
      */
@@ -42,12 +85,32 @@ public:
     };
 
 private:
+    struct TempEntity {
+        lc::entity::CADEntity_CSPtr entity;
+        LCVDrawItem_SPtr drawable;
+        lc::geo::Area boundingBox;
+    };
+
+    void insert(lc::entity::CADEntity_CSPtr entity);
+    void erase(const lc::entity::CADEntity_CSPtr& entity);
+
+    /**
+     * \brief Request an update, unless one is already waiting for the next draw
+     */
+    void requestUpdate();
+
     DocumentCanvas_SPtr _docCanvas;
-    lc::storage::EntityContainer<lc::entity::CADEntity_CSPtr> _entities;
+
+    std::vector<TempEntity> _entities;
+    std::unordered_map<ID_DATATYPE, size_t> _indexes;
+
+    lc::geo::Coordinate _offset;
+    bool _updateRequested;
+
     Nano::Signal<void()> _requestUpdateEvent;
 };
 
 using TempEntities_SPtr = std::shared_ptr<TempEntities>;
 }
 }
-}
\ No newline at end of file
+}
@@ -12,7 +12,14 @@
 using namespace lc::viewer;
 LCVHatch::LCVHatch(const lc::entity::Hatch_CSPtr& hatch) :
     LCVDrawItem(hatch, true),
-    _hatch(hatch) {
+    _hatch(hatch),
+    _compiledPattern(hatch->getPattern().compiled) {
+
+    if (_compiledPattern == nullptr && !hatch->isSolid()) {
+        const auto& pattern = hatch->getPattern();
+        _compiledPattern = std::make_shared<const lc::objects::CompiledPattern>(pattern.entities,
+                                                                                pattern.boundingBox.maxP());
+    }
 }
 
 void LCVHatch::drawSolid(LcPainter& painter, const LcDrawOptions &options, const lc::geo::Area& rect) const {
@@ -76,42 +83,6 @@ void LCVHatch::drawSolid(LcPainter& painter, const LcDrawOptions &options, const
     }
 }
 
-std::vector<lc::entity::CADEntity_CSPtr> getPatterrnEntitiesFromHatch(const lc::entity::Hatch_CSPtr& hatch) {
-    std::vector<lc::entity::CADEntity_CSPtr> entities;
-    auto& reg = hatch->getRegion();
-    auto bbox = reg.boundingBox();
-    auto scale = hatch->getScale();
-    auto angle = hatch->getAngle();
-    float hsize = hatch->getPattern().boundingBox.maxP().x();
-    float vsize = hatch->getPattern().boundingBox.maxP().y();
-
-    int xmin,xmax,ymin,ymax;
-    xmin = floor(bbox.minP().x()/hsize/scale);
-    ymin = floor(bbox.minP().y()/hsize/scale);
-    xmax = floor(bbox.maxP().x()/vsize/scale);
-    ymax = floor(bbox.maxP().y()/vsize/scale);
-
-    //Create new entities for the bounding box
-    if(angle!=0) {
-        xmin-=1;
-        ymin-=1;
-        xmax+=1;
-        ymax+=1;
-    }
-    for(int i=xmin; i<=xmax; i++)
-        for(int j=ymin; j<=ymax; j++) {
-            for(const auto& entity : hatch->getPattern().entities) {
-                entities.push_back(
-                    entity
-                    ->scale(lc::geo::Coordinate(0,0), lc::geo::Coordinate(scale,scale))
-                    ->rotate(lc::geo::Coordinate(0,0), angle)
-                    ->move(lc::geo::Coordinate(i*scale*hsize,j*scale*vsize)
-                          ));
-            }
-        }
-    return entities;
-};
-
 void trimEntities(const std::vector<lc::geo::Coordinate>& cutPoints, std::vector<lc::entity::CADEntity_CSPtr>& spiltedEntities) {
     for(auto& cutPoint : cutPoints) {
         std::vector<lc::entity::CADEntity_CSPtr> tempEntities;
@@ -129,19 +100,33 @@ void trimEntities(const std::vector<lc::geo::Coordinate>& cutPoints, std::vector
     }
 }
 
-// This fails when intersection fails
 void LCVHatch::drawPattern(LcPainter& painter, const LcDrawOptions &options, const lc::geo::Area& rect) const {
     auto& reg = _hatch->getRegion();
     auto bbox = reg.boundingBox();
-    std::vector<lc::entity::CADEntity_CSPtr> entities = getPatterrnEntitiesFromHatch(_hatch);
+    if (!bbox.overlaps(rect)) {
+        return;
+    }
+
+    // Only the visible part of the hatch is generated
+    auto clip = bbox.intersection(rect);
+    auto scale = _hatch->getScale();
+    auto angle = _hatch->getAngle();
+
+    for (const auto& segment : _compiledPattern->segments(reg, clip, scale, angle)) {
+        painter.move_to(segment.start().x(), segment.start().y());
+        painter.line_to(segment.end().x(), segment.end().y());
+    }
+    if (autostroke()) {
+        painter.stroke();
+    }
+
+    // Arcs and lines which don't repeat on the tile grid
+    // This fails when intersection fails
     std::vector<lc::entity::CADEntity_CSPtr> finalEntities;
-    for(const auto& entity : entities) {
-        if (!entity->boundingBox().overlaps(bbox))//optimization
-            continue;// It decreased the rendering time from ~5sec to <1s
+    for(const auto& entity : _compiledPattern->tileEntities(clip, scale, angle)) {
         if (auto splitable = std::dynamic_pointer_cast<const lc::entity::Splitable>(entity)) {
             lc::maths::Intersect intersect(lc::maths::Intersect::OnEntity, LCTOLERANCE);
             for(auto &x: reg.loopList()) {
-                //if(!entity->boundingBox().overlaps(x.boundingBox())) continue;//not needed i think
                 for(auto &y: x.entities()) {
                     if(entity->boundingBox().overlaps(y->boundingBox()))
                         visitorDispatcher<bool, lc::GeoEntityVisitor>(intersect, *y.get(), *entity.get());
@@ -28,6 +28,7 @@ public:
 
 private:
     lc::entity::Hatch_CSPtr _hatch;
+    lc::objects::CompiledPattern_CSPtr _compiledPattern;
 };
 }
 }
@@ -14,11 +14,13 @@ LCVInsert::LCVInsert(lc::entity::Insert_CSPtr& insert) :
 
     _insert->document()->addEntityEvent().connect<LCVInsert, &LCVInsert::on_addEntityEvent>(this);
     _insert->document()->removeEntityEvent().connect<LCVInsert, &LCVInsert::on_removeEntityEvent>(this);
+    _insert->document()->batchEntityEvent().connect<LCVInsert, &LCVInsert::on_batchEntityEvent>(this);
 }
 
 LCVInsert::~LCVInsert() {
     _insert->document()->addEntityEvent().disconnect<LCVInsert, &LCVInsert::on_addEntityEvent>(this);
     _insert->document()->removeEntityEvent().disconnect<LCVInsert, &LCVInsert::on_removeEntityEvent>(this);
+    _insert->document()->batchEntityEvent().disconnect<LCVInsert, &LCVInsert::on_batchEntityEvent>(this);
 }
 
 void LCVInsert::append(const lc::entity::CADEntity_CSPtr& entity) {
@@ -65,6 +67,22 @@ void LCVInsert::on_removeEntityEvent(const lc::event::RemoveEntityEvent& event)
     _entities.erase(entity->id());
 }
 
+void LCVInsert::on_batchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    for(const auto& entity : event.removed()) {
+        if(entity->block() && entity->id() != _insert->id()) {
+            _entities.erase(entity->id());
+        }
+    }
+
+    for(const auto& entity : event.added()) {
+        _entities.erase(entity->id());
+
+        if(entity->block() == _insert->displayBlock()) {
+            append(entity);
+        }
+    }
+}
+
 void LCVInsert::selected(bool selected) {
     LCVDrawItem::selected(selected);
 
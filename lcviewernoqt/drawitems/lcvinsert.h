@@ -30,6 +30,8 @@ private:
 
     void on_removeEntityEvent(const lc::event::RemoveEntityEvent&);
 
+    void on_batchEntityEvent(const lc::event::BatchEntityEvent&);
+
 private:
     lc::entity::Insert_CSPtr _insert;
     lc::geo::Coordinate _offset;
@@ -1,6 +1,8 @@
 #include <cad/interface/unmanageddraggable.h>
 #include "dragmanager.h"
 
+#include <algorithm>
+
 using namespace lc;
 using namespace lc::viewer;
 using namespace lc::viewer::manager;
@@ -10,7 +12,8 @@ DragManager::DragManager(DocumentCanvas_SPtr docCanvas, std::shared_ptr<drawable
     _docCanvas(std::move(docCanvas)),
     _cursor(std::move(cursor)),
     _tempEntities(std::move(tempEntities)),
-    _entityDragged(false)
+    _entityDragged(false),
+    _translating(false)
 {}
 
 std::vector<lc::geo::Coordinate> DragManager::selectedEntitiesDragPoints() {
@@ -30,6 +33,13 @@ std::vector<lc::geo::Coordinate> DragManager::selectedEntitiesDragPoints() {
             dragPoints.push_back(dragPoint.second);
         }
     }
+
+    // Translated entities are only moved on release
+    if(_entityDragged && _translating) {
+        for(auto& dragPoint : dragPoints) {
+            dragPoint = dragPoint + _tempEntities->offset();
+        }
+    }
     return dragPoints;
 }
 
@@ -38,8 +48,28 @@ void DragManager::onSelectionChanged() {
         _dragPointsEvent(lc::viewer::event::DragPointsEvent(selectedEntitiesDragPoints(), _size));
 }
 
+bool DragManager::isTranslated(const lc::entity::CADEntity_CSPtr& entity) const {
+    auto draggable = std::dynamic_pointer_cast<const lc::entity::Draggable>(entity);
+    if(!draggable || std::dynamic_pointer_cast<const lc::entity::UnmanagedDraggable>(entity)) {
+        return false;
+    }
+
+    for(const auto& point : draggable->dragPoints()) {
+        if(point.second.distanceTo(_selectedPoint) >= LCTOLERANCE) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void DragManager::moveEntities() {
+    if(_translating) {
+        _tempEntities->setOffset(_cursor->position() - _dragOrigin);
+        return;
+    }
+
     std::vector<lc::entity::CADEntity_CSPtr> replacementEntities;
+    std::vector<lc::entity::CADEntity_CSPtr> replacedEntities;
     for(const auto& entity : _replacementEntities) {
         auto draggable = std::dynamic_pointer_cast<const lc::entity::Draggable>(entity);
         auto unmanaged = std::dynamic_pointer_cast<const lc::entity::UnmanagedDraggable>(entity);
@@ -56,9 +86,14 @@ void DragManager::moveEntities() {
 
         auto newEntity = draggable->setDragPoints(entityDragPoints);
         replacementEntities.push_back(newEntity);
-        _tempEntities->removeEntity(entity);
-        _tempEntities->addEntity(newEntity);
+
+        // Entities keeping their ID are replaced when the new one is added
+        if(newEntity->id() != entity->id()) {
+            replacedEntities.push_back(entity);
+        }
     }
+    _tempEntities->removeEntities(replacedEntities);
+    _tempEntities->addEntities(replacementEntities);
     _replacementEntities=replacementEntities;
 }
 
@@ -88,6 +123,7 @@ void DragManager::onMousePress() {
     _builder->append(_entityBuilder);
 
     _entityDragged=false;
+    _translating=false;
     std::vector<lc::viewer::LCVDrawItem_SPtr> selectedDrawables = _docCanvas->selectedDrawables();
     if(selectedDrawables.empty()) {
         return;
@@ -119,11 +155,38 @@ void DragManager::onMousePress() {
         _entityBuilder->appendOperation(std::make_shared<lc::operation::Remove>());
         _entityBuilder->processStack();
         _builder->execute();
+
+        // Entities only translated by the drag keep their drawables, the preview is moved with an offset
+        _translating = std::all_of(_replacementEntities.begin(), _replacementEntities.end(),
+                                   [this](const lc::entity::CADEntity_CSPtr& entity) {
+            return isTranslated(entity);
+        });
+
+        if(_translating) {
+            _dragOrigin = _selectedPoint;
+            _tempEntities->setOffset(lc::geo::Coordinate(0., 0.));
+            _tempEntities->addEntities(_replacementEntities);
+        }
     }
 }
 
 void DragManager::onMouseRelease() {
-    if(_entityDragged) {
+    if(_entityDragged && _translating) {
+        auto offset = _tempEntities->offset();
+        _tempEntities->removeEntities(_replacementEntities);
+        _tempEntities->setOffset(lc::geo::Coordinate(0., 0.));
+
+        for(const auto& entity : _replacementEntities) {
+            _entityBuilder->appendEntity(entity->move(offset));
+        }
+        _builder->execute();
+        _replacementEntities.clear();
+        _docCanvas->updateSelection();
+
+        _entityDragged = false;
+        _translating = false;
+    }
+    else if(_entityDragged) {
         //_builder->undo(); //Re-insert original entities which are already deleted
         // i think _builder.undo() is not working here, we need 2 undos here
         for(const auto& entity : _replacementEntities) {
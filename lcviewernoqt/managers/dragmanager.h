@@ -72,6 +72,12 @@ private:
 
     void moveEntities();
 
+    /**
+     * \brief Return true if all the drag points of the entity are under the selected point.
+     * Dragging such an entity only translates it.
+     */
+    bool isTranslated(const lc::entity::CADEntity_CSPtr& entity) const;
+
     DocumentCanvas_SPtr _docCanvas;
     std::shared_ptr<drawable::Cursor> _cursor;
     drawable::TempEntities_SPtr _tempEntities;
@@ -84,6 +90,10 @@ private:
     lc::geo::Coordinate _selectedPoint;
     std::vector<lc::entity::CADEntity_CSPtr> _replacementEntities;
 
+    // When all the dragged entities are translated, they are previewed with an offset and moved on release
+    bool _translating;
+    lc::geo::Coordinate _dragOrigin;
+
     Nano::Signal<void(const lc::viewer::event::DragPointsEvent&)> _dragPointsEvent;
 };
 
@@ -4,20 +4,120 @@
 #include <cad/base/visitor.h>
 #include <cad/base/cadentity.h>
 #include <cad/math/intersect.h>
+#include <algorithm>
+#include <limits>
 
 using namespace lc;
 using namespace lc::viewer;
 using namespace lc::viewer::manager;
 
+namespace {
+// Amount of hovered entities which stay available for snapping
+const size_t MAX_REMEMBERED_ENTITIES = 10;
+
+lc::entity::CADEntity_CSPtr documentEntity(const lc::entity::CADEntity_CSPtr& entity) {
+    auto drawable = std::dynamic_pointer_cast<const LCVDrawItem>(entity);
+    if(drawable) {
+        return drawable->entity();
+    }
+
+    return entity;
+}
+
+lc::entity::Snapable_CSPtr asSnapable(const lc::entity::CADEntity_CSPtr& entity) {
+    return std::dynamic_pointer_cast<const lc::entity::Snapable>(documentEntity(entity));
+}
+}
+
 SnapManagerImpl::SnapManagerImpl(DocumentCanvas_SPtr view, lc::entity::Snapable_CSPtr grid, double distanceToSnap) :
     _grid(std::move(grid)),
     _gridSnappable(false),
     _snapIntersections(false),
     _distanceToSnap(distanceToSnap),
     _view(std::move(view)),
-    _snapConstrain(SimpleSnapConstrain(lc::SimpleSnapConstrain::NONE, 0, 0.))
+    _snapConstrain(SimpleSnapConstrain(lc::SimpleSnapConstrain::NONE, 0, 0.)),
+    _snapPointsOutdated(false)
 {
+    _view->document()->commitProcessEvent().connect<SnapManagerImpl, &SnapManagerImpl::on_commitProcessEvent>(this);
+    _view->document()->batchEntityEvent().connect<SnapManagerImpl, &SnapManagerImpl::on_batchEntityEvent>(this);
+}
+
+SnapManagerImpl::~SnapManagerImpl() {
+    _view->document()->commitProcessEvent().disconnect<SnapManagerImpl, &SnapManagerImpl::on_commitProcessEvent>(this);
+    _view->document()->batchEntityEvent().disconnect<SnapManagerImpl, &SnapManagerImpl::on_batchEntityEvent>(this);
+}
+
+void SnapManagerImpl::on_commitProcessEvent(const lc::event::CommitProcessEvent& event) {
+    // Remembered entities might have been modified or removed
+    _rememberedEntities.clear();
+    clearSnapPoints();
+}
+
+void SnapManagerImpl::on_batchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    // Batches are also applied outside of a commit, for example while a file is opened
+    _rememberedEntities.clear();
+    clearSnapPoints();
+}
+
+void SnapManagerImpl::rememberEntity(const lc::entity::CADEntity_CSPtr& entity) {
+    auto it = std::find(_rememberedEntities.begin(), _rememberedEntities.end(), entity);
+    if (it != _rememberedEntities.end()) {
+        return;
+    }
+
+    if (_rememberedEntities.size() >= MAX_REMEMBERED_ENTITIES) {
+        _rememberedEntities.pop_front();
+    }
+    _rememberedEntities.push_back(entity);
+    _snapPointsOutdated = true;
+}
+
+void SnapManagerImpl::clearSnapPoints() {
+    _logicalPoints.clear();
+    _intersectionPoints.clear();
+    _logicalTree = lc::tools::KdTree();
+    _intersectionTree = lc::tools::KdTree();
+    _snapPointsOutdated = !_rememberedEntities.empty();
+}
+
+void SnapManagerImpl::updateSnapPoints() {
+    clearSnapPoints();
+
+    if (_snapConstrain.hasConstrain(lc::SimpleSnapConstrain::LOGICAL)) {
+        lc::SimpleSnapConstrain logical(lc::SimpleSnapConstrain::LOGICAL, 0, 0.);
+
+        for (const auto& entity : _rememberedEntities) {
+            auto snapable = asSnapable(entity);
+            if (snapable == nullptr) {
+                continue;
+            }
 
+            for (const auto& point : snapable->snapPoints(entity->boundingBox().minP(),
+                                                          logical,
+                                                          std::numeric_limits<double>::max(),
+                                                          std::numeric_limits<int>::max())) {
+                _logicalPoints.push_back(point.coordinate());
+            }
+        }
+    }
+
+    if (_snapIntersections) {
+        // Intersections are cached by the document, they are only computed once for each pair of entities
+        auto& intersectionIndex = _view->document()->intersectionIndex();
+
+        for (size_t a = 0; a < _rememberedEntities.size(); a++) {
+            for (size_t b = a + 1; b < _rememberedEntities.size(); b++) {
+                for (const auto& point : intersectionIndex.intersections(documentEntity(_rememberedEntities[a]),
+                                                                         documentEntity(_rememberedEntities[b]))) {
+                    _intersectionPoints.push_back(point);
+                }
+            }
+        }
+    }
+
+    _logicalTree = lc::tools::KdTree(_logicalPoints);
+    _intersectionTree = lc::tools::KdTree(_intersectionPoints);
+    _snapPointsOutdated = false;
 }
 
 /**
@@ -48,70 +148,65 @@ void SnapManagerImpl::setDeviceLocation(int x, int y) {
     // We should call this function only if the mouse haven't moved for XX milli seconds
 
     // Find all entities that are close to the current mouse pointer
-    // TODO: We properly need to remember entities which we had snap point in the past, some sort og queue
-    // this way we can get more efficiently snap to entities outside the cursor's 'range' so the
-    // person can 'pick' a entity onceand then it would stay in the list of entities to
-    // consider for snapping. THis will mostly lickly be lines only
-    std::vector<lc::EntityDistance> entities = _view->entityContainer().getEntityPathsNearCoordinate(location,
+    // They are remembered, so the person can 'pick' a entity once and then it would stay in the list of entities
+    // to consider for snapping
+    std::vector<lc::EntityDistance> entities = _view->entityPathsNearCoordinate(location,
             realDistanceForPixels, _snapConstrain);
     std::sort(entities.begin(), entities.end(), lc::EntityDistanceSorter(location));
 
-    // Emit Snappoint event if a entity intersects with a other entity
-    if (entities.size() > 1 && _snapIntersections) {
-
-        for (size_t a = 0; a < entities.size(); a++) {
-            for (size_t b = a + 1; b < entities.size(); b++) {
-                lc::entity::CADEntity_CSPtr i1 = entities.at(a).entity();
-                lc::entity::CADEntity_CSPtr i2 = entities.at(b).entity();
+    for (const auto& entity : entities) {
+        rememberEntity(entity.entity());
+    }
 
-                lc::maths::Intersect intersect(lc::maths::Intersect::OnEntity, LCTOLERANCE);
-                visitorDispatcher<bool, lc::GeoEntityVisitor>(intersect, *i1.get(), *i2.get());
+    if (_snapPointsOutdated) {
+        updateSnapPoints();
+    }
 
-                if (!intersect.result().empty()) {
-                    std::vector<lc::geo::Coordinate> coords = intersect.result();
-                    std::sort(coords.begin(), coords.end(), lc::geo::CoordinateDistanceSort(location));
+    size_t index;
 
-                    lc::geo::Coordinate sp = coords.at(0);
-                    if ((location - sp).magnitude() < realDistanceForPixels) {
-                        auto event = event::SnapPointEvent(sp);
-                        _snapPointEvent(event);
-                        return;
-                    }
-                }
-            }
-        }
+    // Emit Snappoint event if a entity intersects with a other entity
+    if (_snapIntersections && _intersectionTree.nearest(location, realDistanceForPixels, index)) {
+        auto event = event::SnapPointEvent(_intersectionPoints[index]);
+        _snapPointEvent(event);
+        return;
     }
 
-    // Emit snappoint based on closest entity
-    if (!entities.empty()) {
+    // Nearest end point, middle point or center of the remembered entities
+    bool hasSnapPoint = _logicalTree.nearest(location, realDistanceForPixels, index);
+    lc::geo::Coordinate snapPoint = hasSnapPoint ? _logicalPoints[index] : location;
+
+    // Snap points depending on the cursor location, of the closest entity
+    auto constrain = _snapConstrain.disableConstrain(lc::SimpleSnapConstrain::LOGICAL);
+    if (constrain.constrain() != lc::SimpleSnapConstrain::NONE) {
         // GO over all entities, first closest to the cursor gradually moving away
         for (auto &entity : entities) {
-            lc::entity::Snapable_CSPtr captr;
-
-            auto drawable = std::dynamic_pointer_cast<const LCVDrawItem>(entity.entity());
-            if(drawable) {
-                captr = std::dynamic_pointer_cast<const lc::entity::Snapable>(drawable->entity());
-            }
-            else {
-                captr = std::dynamic_pointer_cast<const lc::entity::Snapable>(entity.entity());
-            }
+            lc::entity::Snapable_CSPtr captr = asSnapable(entity.entity());
 
             if (captr) {
                 // Locale snap points
-                std::vector<lc::EntityCoordinate> sp = captr->snapPoints(location, _snapConstrain,
-                                                       realDistanceForPixels, 10);
-                // When a snappoint was found, emit it
+                std::vector<lc::EntityCoordinate> sp = captr->snapPoints(location, constrain,
+                                                       realDistanceForPixels, 1);
                 if (!sp.empty()) {
-                    event::SnapPointEvent snapEvent(sp.at(0).coordinate());
-                    _lastSnapEvent = snapEvent;
-                    auto event = event::SnapPointEvent(sp.at(0).coordinate());
-                    _snapPointEvent(event);
-                    return;
+                    auto coordinate = sp.at(0).coordinate();
+                    if (!hasSnapPoint || coordinate.distanceTo(location) < snapPoint.distanceTo(location)) {
+                        snapPoint = coordinate;
+                        hasSnapPoint = true;
+                    }
+                    break;
                 }
             }
         }
     }
 
+    // When a snappoint was found, emit it
+    if (hasSnapPoint) {
+        event::SnapPointEvent snapEvent(snapPoint);
+        _lastSnapEvent = snapEvent;
+        auto event = event::SnapPointEvent(snapPoint);
+        _snapPointEvent(event);
+        return;
+    }
+
     // If no entity was found to snap against, then snap to grid
     if (_gridSnappable) {
         std::vector<lc::EntityCoordinate> points = _grid->snapPoints(location, _snapConstrain, realDistanceForPixels,
@@ -145,6 +240,7 @@ bool SnapManagerImpl::isGridSnappable() const {
 
 void SnapManagerImpl::setIntersectionsSnappable(bool enabled) {
     _snapIntersections = enabled;
+    clearSnapPoints();
 }
 
 bool SnapManagerImpl::isIntersectionsSnappable() const {
@@ -157,6 +253,7 @@ void SnapManagerImpl::setMiddleSnappable(bool enabled) {
     } else {
         _snapConstrain = _snapConstrain.disableConstrain(lc::SimpleSnapConstrain::LOGICAL);
     }
+    clearSnapPoints();
 }
 
 void SnapManagerImpl::setEntitySnappable(bool enabled) {
@@ -177,4 +274,5 @@ lc::SimpleSnapConstrain SnapManagerImpl::snapConstrain() const {
 
 void SnapManagerImpl::snapConstrain(const lc::SimpleSnapConstrain &snapConstrain) {
     _snapConstrain = snapConstrain;
+    clearSnapPoints();
 }
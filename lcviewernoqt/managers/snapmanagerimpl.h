@@ -1,12 +1,21 @@
 #pragma once
 
+#include <deque>
+
 #include "snapmanager.h"
 #include "../documentcanvas.h"
 #include "../events/LocationEvent.h"
 #include <cad/interface/snapconstrain.h>
+#include <cad/events/commitprocessevent.h>
+#include <cad/tools/kdtree.h>
 
 /*!
  * \brief Implements the SnapManager interface
+ *
+ * The entities hovered recently are remembered, their logical snap points (end points, middle points, centers)
+ * and their intersections are cached in k-d trees. This allows snapping to a point of an entity after the cursor left it,
+ * without recomputing the intersections on each mouse move.
+ * The cache is cleared when the document changes.
  */
 
 namespace lc {
@@ -31,7 +40,7 @@ public:
      */
     SnapManagerImpl(DocumentCanvas_SPtr view, lc::entity::Snapable_CSPtr grid, double distanceToSnap);
 
-    virtual ~SnapManagerImpl() = default;
+    virtual ~SnapManagerImpl();
 
     virtual void setGridSnappable(bool enabled);
 
@@ -55,6 +64,21 @@ public:
     virtual Nano::Signal<void(const event::SnapPointEvent&)>& snapPointEvents();
 
 private:
+    void on_commitProcessEvent(const lc::event::CommitProcessEvent&);
+
+    void on_batchEntityEvent(const lc::event::BatchEntityEvent&);
+
+    /**
+     * @brief Add an entity to the remembered entities, the oldest one is forgotten when the list is full
+     */
+    void rememberEntity(const lc::entity::CADEntity_CSPtr& entity);
+
+    /**
+     * @brief Rebuild the snap points of the remembered entities
+     */
+    void updateSnapPoints();
+
+    void clearSnapPoints();
 
     // Grid is snapable
     lc::entity::Snapable_CSPtr _grid;
@@ -82,6 +106,18 @@ private:
     DocumentCanvas_SPtr _view;
 
     lc::SimpleSnapConstrain _snapConstrain;
+
+    // Entities hovered recently, the most recent one last
+    std::deque<lc::entity::CADEntity_CSPtr> _rememberedEntities;
+
+    // Logical snap points and intersections of the remembered entities
+    std::vector<lc::geo::Coordinate> _logicalPoints;
+    std::vector<lc::geo::Coordinate> _intersectionPoints;
+    lc::tools::KdTree _logicalTree;
+    lc::tools::KdTree _intersectionTree;
+
+    // TRUE when the snap points need to be rebuilt
+    bool _snapPointsOutdated;
 };
 
 
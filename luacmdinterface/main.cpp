@@ -14,6 +14,8 @@
 #include <boost/filesystem.hpp>
 #include <managers/pluginmanager.h>
 #include <managers/luacustomentitymanager.h>
+#include <managers/luajobscheduler.h>
+#include <utils/luaprofiler.h>
 
 
 namespace po = boost::program_options;
@@ -92,6 +94,7 @@ int main(int argc, char** argv) {
     std::string fIn;
     std::string fOut = DEFAULT_OUT_FILENAME;
     std::string fType;
+    std::string fProfile;
     readBuffer = new std::string;
 
     // Read CMD options
@@ -102,7 +105,8 @@ int main(int argc, char** argv) {
     ("height,h", po::value<int>(&height), "(optional) Set output image height, example -h 200")
     ("ifile,i", po::value<std::string>(&fIn), "(required) Set LUA input file name, example: -i file:myFile.lua")
     ("ofile,o", po::value<std::string>(&fOut), "(optional) Set output filename, example -o out.png")
-    ("otype,t", po::value<std::string>(&fType), "(optional) output file type, example -t svg");
+    ("otype,t", po::value<std::string>(&fType), "(optional) output file type, example -t svg")
+    ("profile,p", po::value<std::string>(&fProfile), "(optional) Profile the script, write the folded stacks to a file and the report to stderr, example -p out.folded");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -175,13 +179,36 @@ int main(int argc, char** argv) {
     lcLua.importLCKernel();
     lcLua.setDocument(_document);
 
+    // Same scheduler than the GUI, run until all jobs are done
+    lc::lua::LuaJobScheduler scheduler(luaState.state());
+    lc::lua::LuaCustomEntityManager::getInstance().setScheduler(&scheduler);
+
+    lc::lua::LuaProfiler profiler;
+    lcLua.setProfiler(&profiler);
+    scheduler.setProfiler(&profiler);
+
     std::string luaCode = loadFile(fIn);
 
     if (!luaCode.empty()) {
-        std::string out = lcLua.runString(luaCode.c_str());
+        if (!fProfile.empty()) {
+            profiler.watch(_document);
+            profiler.start(luaState.state());
+        }
+
+        auto job = scheduler.runString(luaCode.c_str(), _document);
+        scheduler.runAll();
+
+        if (!fProfile.empty()) {
+            profiler.stop();
+
+            std::ofstream profileFile(fProfile);
+            profileFile << profiler.folded();
+            std::cerr << profiler.report();
+        }
 
-        if (!out.empty()) {
-            std::cerr << out << std::endl;
+        if (scheduler.status(job) == lc::lua::LuaJobScheduler::JobStatus::Failed) {
+            std::cerr << scheduler.error(job) << std::endl;
+            lc::lua::LuaCustomEntityManager::getInstance().setScheduler(nullptr);
             return 2;
         }
     }
@@ -200,6 +227,7 @@ int main(int argc, char** argv) {
     }
     ofile->close();
 
+    lc::lua::LuaCustomEntityManager::getInstance().setScheduler(nullptr);
     lc::lua::LuaCustomEntityManager::getInstance().removePlugins();
 
     delete lcPainter;
@@ -1,16 +1,67 @@
 #include "file.h"
 #include "libdxfrw/dxfimpl.h"
+#include "native/nativefile.h"
+#include <cad/operations/blockops.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/layerops.h>
+#include <cad/operations/linepatternops.h>
+#include <cad/logger/logger.h>
 #ifdef LIBOPENCAD_ENABLED
 #include "libopencad_interface/libopencad.h"
 #endif
 
 using namespace lc::persistence;
 
+namespace {
+File::Type dxfFileType(DRW::Version dxfVersion) {
+    File::Type type = File::LIBDXFRW_DXF_R12;
+
+    /// @todo create better mapping
+    switch(dxfVersion) {
+    case DRW::UNKNOWNV: /// @todo handle this
+        type = File::LIBDXFRW_DXF_R12; /// @todo not supported ?
+        break;
+    case DRW::AC1006:
+        type = File::LIBDXFRW_DXF_R12;
+        break;
+    case DRW::AC1009:
+        type = File::LIBDXFRW_DXB_R12; //This one is correct
+        break;
+    case DRW::AC1012:
+        type = File::LIBDXFRW_DXF_R12;
+        break;
+    case DRW::AC1014:
+        type = File::LIBDXFRW_DXB_R14;
+        break;
+    case DRW::AC1015:
+        type = File::LIBDXFRW_DXF_R2000;
+        break;
+    case DRW::AC1018:
+        type = File::LIBDXFRW_DXF_R2004;
+        break;
+    case DRW::AC1021:
+        type = File::LIBDXFRW_DXF_R2007;
+        break;
+    case DRW::AC1024:
+        type = File::LIBDXFRW_DXF_R2010;
+        break;
+    case DRW::AC1027:
+        type = File::LIBDXFRW_DXF_R2013;
+        break;
+    }
+
+    return type;
+}
+}
+
 std::string File::getExtensionForFileType(Type type) {
     std::string x;
     if(type >= LIBDXFRW_DXF_R12 && type <= LIBDXFRW_DXB_R2013) {
         x = "dxf";
     }
+    if(type == LIBRECAD_NATIVE) {
+        x = "lcad";
+    }
     return x;
 }
 
@@ -18,52 +69,50 @@ std::map<std::string, std::string> File::getSupportedFileExtensions() {
     std::map<std::string, std::string> types;
     types.insert(std::pair<std::string, std::string>("dxf","DXF files"));
     types.insert(std::pair<std::string, std::string>("dwg","DWG files"));
+    types.insert(std::pair<std::string, std::string>("lcad","LibreCAD files"));
     return types;
 }
 
 File::Type File::open(lc::storage::Document_SPtr document, const std::string& path, File::Library library) {
     auto builder = std::make_shared<operation::Builder>(document, "Open file");
     File::Type version;
+    std::shared_ptr<NativeFile> nativeFile;
 
     switch(library) {
     case LIBDXFRW: {
         DXFimpl F(document, builder);
         dxfRW R(path.c_str());
         R.read(&F, true);
+        F.finishImport();
+        F.logImportSummary();
+
+        version = dxfFileType(R.getVersion());
+        break;
+    }
 
-        /// @todo create better mapping
-        switch(R.getVersion()) {
-        case DRW::UNKNOWNV: /// @todo handle this
-            version = Type::LIBDXFRW_DXF_R12; /// @todo not supported ?
-            break;
-        case DRW::AC1006:
-            version = Type::LIBDXFRW_DXF_R12;
-            break;
-        case DRW::AC1009:
-            version = Type::LIBDXFRW_DXB_R12; //This one is correct
-            break;
-        case DRW::AC1012:
-            version = Type::LIBDXFRW_DXF_R12;
-            break;
-        case DRW::AC1014:
-            version = Type::LIBDXFRW_DXB_R14;
-            break;
-        case DRW::AC1015:
-            version = Type::LIBDXFRW_DXF_R2000;
-            break;
-        case DRW::AC1018:
-            version = Type::LIBDXFRW_DXF_R2004;
-            break;
-        case DRW::AC1021:
-            version = Type::LIBDXFRW_DXF_R2007;
-            break;
-        case DRW::AC1024:
-            version = Type::LIBDXFRW_DXF_R2010;
-            break;
-        case DRW::AC1027:
-            version = Type::LIBDXFRW_DXF_R2013;
-            break;
+    case NATIVE: {
+        nativeFile = std::make_shared<NativeFile>(document, path);
+
+        for(const auto& metaType : nativeFile->metaTypes()) {
+            if(auto linePattern = std::dynamic_pointer_cast<const meta::DxfLinePatternByValue>(metaType)) {
+                builder->append(std::make_shared<operation::AddLinePattern>(document, linePattern));
+            }
+            else if(auto layer = std::dynamic_pointer_cast<const meta::Layer>(metaType)) {
+                builder->append(std::make_shared<operation::AddLayer>(document, layer));
+            }
+            else if(auto block = std::dynamic_pointer_cast<const meta::Block>(metaType)) {
+                builder->append(std::make_shared<operation::AddBlock>(document, block));
+            }
+        }
+
+        // The other entities are decoded when the viewport or a query reaches their area
+        auto entityBuilder = std::make_shared<operation::EntityBuilder>(document);
+        for(const auto& entity : nativeFile->loadBlocks()) {
+            entityBuilder->appendEntity(entity);
         }
+        builder->append(entityBuilder);
+
+        version = Type::LIBRECAD_NATIVE;
         break;
     }
 
@@ -78,19 +127,31 @@ File::Type File::open(lc::storage::Document_SPtr document, const std::string& pa
     }
 
     builder->execute();
+
+    if(nativeFile != nullptr && !nativeFile->loaded()) {
+        document->setEntityLoader(nativeFile);
+    }
+
     return version;
 }
 
 void File::save(lc::storage::Document_SPtr document, const std::string& path, File::Type type) {
+    // Entities of a native file which were never displayed are still part of the drawing
+    document->loadAll();
+
     if(type >= LIBDXFRW_DXF_R12 && type <= LIBDXFRW_DXB_R2013) {
-        DXFimpl* F = new DXFimpl(std::move(document));
-        F->writeDXF(path, type);
+        DXFimpl F(std::move(document));
+        F.writeDXF(path, type);
+    }
+    else if(type == LIBRECAD_NATIVE) {
+        NativeFile::save(document, path);
     }
 }
 
 std::map<File::Type, std::string> File::getAvailableFileTypes() {
     std::map<File::Type, std::string> types;
 
+    types.insert(std::pair<File::Type, std::string>(LIBRECAD_NATIVE, "LibreCAD"));
     types.insert(std::pair<File::Type, std::string>(LIBDXFRW_DXF_R2013, "DXF 2013 (libdxfrw)"));
     types.insert(std::pair<File::Type, std::string>(LIBDXFRW_DXF_R2010, "DXF 2010 (libdxfrw)"));
     types.insert(std::pair<File::Type, std::string>(LIBDXFRW_DXF_R2007, "DXF 2007 (libdxfrw)"));
@@ -117,6 +178,9 @@ std::map<File::Library, std::string> File::getAvailableLibrariesForFormat(std::s
     if(format == "dxf") {
         libraries.insert(std::pair<File::Library, std::string>(LIBDXFRW, "libdxfrw"));
     }
+    if(format == "lcad") {
+        libraries.insert(std::pair<File::Library, std::string>(NATIVE, "LibreCAD"));
+    }
     if(format == "dwg") {
 #ifdef LIBOPENCAD_ENABLED
         libraries.insert(std::pair<File::Library, std::string>(LIBOPENCAD, "libopencad"));
@@ -125,3 +189,100 @@ std::map<File::Library, std::string> File::getAvailableLibrariesForFormat(std::s
 
     return libraries;
 }
+
+ProgressiveOpen::ProgressiveOpen(lc::storage::Document_SPtr document,
+                                 const std::string& path,
+                                 File::Library library,
+                                 size_t chunkSize,
+                                 unsigned int chunkInterval) :
+    _document(std::move(document)),
+    _path(path),
+    _library(library),
+    _chunkSize(chunkSize),
+    _chunkInterval(chunkInterval),
+    _builder(std::make_shared<operation::Builder>(_document, "Open file")),
+    _type(File::LIBDXFRW_DXF_R12),
+    _pendingCount(0),
+    _addedCount(0),
+    _lastChunk(std::chrono::steady_clock::now()),
+    _finished(false) {
+
+    if(_library == File::LIBDXFRW) {
+        _dxf.reset(new DXFimpl(_document, _builder));
+        _reader = std::thread(&ProgressiveOpen::read, this);
+    }
+}
+
+ProgressiveOpen::~ProgressiveOpen() {
+    if(_reader.joinable()) {
+        _reader.join();
+    }
+}
+
+void ProgressiveOpen::read() {
+    try {
+        dxfRW R(_path.c_str());
+        R.read(_dxf.get(), true);
+        _type = dxfFileType(R.getVersion());
+    }
+    catch(...) {
+        _readError = std::current_exception();
+    }
+
+    _dxf->closeImport();
+}
+
+bool ProgressiveOpen::update() {
+    if(_finished) {
+        return true;
+    }
+
+    if(_dxf == nullptr) {
+        _finished = true;
+        _type = File::open(_document, _path, _library);
+        return true;
+    }
+
+    size_t taken = 0;
+    bool done;
+    try {
+        done = _dxf->takeEntities(false, &taken);
+    }
+    catch(...) {
+        // Conversion errors are only reported once the reader stopped, it doesn't use the document anymore
+        _reader.join();
+        _readError = std::current_exception();
+        done = true;
+    }
+    _pendingCount += taken;
+
+    if(done) {
+        if(_reader.joinable()) {
+            _reader.join();
+        }
+        _finished = true;
+
+        if(_readError) {
+            _dxf->_entityBuilder->undo();
+            std::rethrow_exception(_readError);
+        }
+
+        _dxf->logImportSummary();
+        _builder->execute();
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if(_pendingCount > 0 && (_addedCount == 0 || _pendingCount >= _chunkSize || now - _lastChunk >= _chunkInterval)) {
+        _addedCount += _dxf->_entityBuilder->flushEntities();
+        _pendingCount = 0;
+        _lastChunk = now;
+        LOG_DEBUG << "Progressive open: " << _addedCount << " entities added";
+    }
+
+    return false;
+}
+
+File::Type ProgressiveOpen::type() const {
+    return _type;
+}
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <thread>
+
 #include <cad/storage/document.h>
+#include <cad/operations/builder.h>
 
 namespace lc {
 namespace persistence {
@@ -23,12 +29,14 @@ public:
         LIBDXFRW_DXB_R2007,
         LIBDXFRW_DXB_R2010,
         LIBDXFRW_DXB_R2013,
-        LIBOPENCAD_DWG
+        LIBOPENCAD_DWG,
+        LIBRECAD_NATIVE
     };
 
     enum Library {
         LIBDXFRW,
         LIBOPENCAD,
+        NATIVE
     };
 
     static Type open(lc::storage::Document_SPtr document, const std::string& path, Library library);
@@ -43,5 +51,82 @@ public:
 
     static std::map<std::string, std::string> getSupportedFileExtensions();
 };
+
+class DXFimpl;
+
+/**
+ * @brief Open a file while showing its content
+ *
+ * The file is read on a background thread. update() adds the entities read so far to the document in chunks,
+ * each chunk raising a single BatchEntityEvent so the views can draw the drawing while it loads.
+ * update() must be called regularly from the thread owning the document, for example by a timer of the UI.
+ *
+ * The whole open is a single undo cycle, executed by the update() adding the last entities.
+ * Layers, line patterns and blocks are only added by that last update(). The file is read against the ones of the
+ * document when the open started, the document must not be modified and its undo stack must not be used until then.
+ *
+ * Only the files read with libdxfrw are streamed, the other libraries are read at once by the first update().
+ */
+class ProgressiveOpen {
+public:
+    static const size_t DEFAULT_CHUNK_SIZE = 50000;
+    static const unsigned int DEFAULT_CHUNK_INTERVAL = 100;
+
+    /**
+     * @brief Start reading a file
+     * @param document Empty document to fill
+     * @param path Path of the file
+     * @param library Library used to read the file
+     * @param chunkSize Amount of entities after which a chunk is added to the document
+     * @param chunkInterval Time in milliseconds after which a chunk is added to the document
+     */
+    ProgressiveOpen(storage::Document_SPtr document,
+                    const std::string& path,
+                    File::Library library,
+                    size_t chunkSize = DEFAULT_CHUNK_SIZE,
+                    unsigned int chunkInterval = DEFAULT_CHUNK_INTERVAL);
+
+    /**
+     * @brief Wait until the background thread stops reading the file
+     */
+    ~ProgressiveOpen();
+
+    ProgressiveOpen(const ProgressiveOpen&) = delete;
+    ProgressiveOpen& operator=(const ProgressiveOpen&) = delete;
+
+    /**
+     * @brief Add the entities read since the last chunk to the document
+     * A chunk is added when enough entities were read or the chunk interval is elapsed. The first entities are
+     * added as soon as they are read.
+     * If the file can't be read, the added entities are removed and the error is re-thrown.
+     * @return true once the file is completely opened
+     */
+    bool update();
+
+    /**
+     * @brief Return the type of the opened file, valid once update() returned true
+     */
+    File::Type type() const;
+
+private:
+    void read();
+
+    storage::Document_SPtr _document;
+    std::string _path;
+    File::Library _library;
+    size_t _chunkSize;
+    std::chrono::milliseconds _chunkInterval;
+
+    operation::Builder_SPtr _builder;
+    std::unique_ptr<DXFimpl> _dxf;
+    std::thread _reader;
+    std::exception_ptr _readError;
+
+    File::Type _type;
+    size_t _pendingCount;
+    size_t _addedCount;
+    std::chrono::steady_clock::time_point _lastChunk;
+    bool _finished;
+};
 }
 }
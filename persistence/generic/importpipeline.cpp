@@ -0,0 +1,157 @@
+#include "importpipeline.h"
+
+#include <cad/tools/threadpool.h>
+
+using namespace lc::persistence;
+
+namespace {
+// Entities are cheap to build, smaller chunks would spend more time in the pool than in the conversion
+const size_t MIN_CHUNK_SIZE = 128;
+}
+
+ImportPipeline::ImportPipeline(size_t batchSize, size_t maxPendingBatches) :
+    _batchSize(batchSize == 0 ? 1 : batchSize),
+    _maxPendingBatches(maxPendingBatches == 0 ? 1 : maxPendingBatches),
+    _closed(false),
+    _done(false),
+    _thread(&ImportPipeline::convertLoop, this) {
+    _batch.reserve(_batchSize);
+}
+
+ImportPipeline::~ImportPipeline() {
+    if (_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+        }
+        _batchAvailable.notify_one();
+        _thread.join();
+    }
+}
+
+void ImportPipeline::push(Conversion conversion) {
+    _batch.push_back({std::move(conversion), false});
+
+    if (_batch.size() >= _batchSize) {
+        submit();
+    }
+}
+
+void ImportPipeline::pushDeferred(Conversion conversion) {
+    _batch.push_back({std::move(conversion), true});
+
+    if (_batch.size() >= _batchSize) {
+        submit();
+    }
+}
+
+void ImportPipeline::close() {
+    if (!_batch.empty()) {
+        submit();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+    }
+    _batchAvailable.notify_one();
+}
+
+bool ImportPipeline::take(std::vector<entity::CADEntity_CSPtr>& entities, bool wait) {
+    std::vector<Result> converted;
+    bool done;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (wait) {
+            _conversionDone.wait(lock, [this]() {
+                return _done;
+            });
+        }
+
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+
+        converted.swap(_converted);
+        done = _done;
+    }
+
+    entities.reserve(entities.size() + converted.size());
+    for (auto& result : converted) {
+        auto entity = result.deferred ? result.deferred() : std::move(result.entity);
+
+        if (entity != nullptr) {
+            entities.push_back(std::move(entity));
+        }
+    }
+
+    return done;
+}
+
+void ImportPipeline::submit() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _spaceAvailable.wait(lock, [this]() {
+            return _pending.size() < _maxPendingBatches;
+        });
+        _pending.push_back(std::move(_batch));
+    }
+    _batchAvailable.notify_one();
+
+    _batch = std::vector<Item>();
+    _batch.reserve(_batchSize);
+}
+
+void ImportPipeline::convertLoop() {
+    while (true) {
+        std::vector<Item> batch;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _batchAvailable.wait(lock, [this]() {
+                return !_pending.empty() || _closed;
+            });
+
+            if (_pending.empty()) {
+                _done = true;
+                break;
+            }
+
+            batch = std::move(_pending.front());
+            _pending.pop_front();
+        }
+        _spaceAvailable.notify_one();
+
+        // Keep draining after an error so the parser is never blocked
+        if (_error) {
+            continue;
+        }
+
+        std::vector<entity::CADEntity_CSPtr> entities(batch.size());
+        try {
+            tools::ThreadPool::instance().parallelFor(batch.size(), MIN_CHUNK_SIZE, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    if (!batch[i].deferred) {
+                        entities[i] = batch[i].conversion();
+                    }
+                }
+            });
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _error = std::current_exception();
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (batch[i].deferred) {
+                _converted.push_back({nullptr, std::move(batch[i].conversion)});
+            }
+            else if (entities[i] != nullptr) {
+                _converted.push_back({std::move(entities[i]), nullptr});
+            }
+        }
+    }
+
+    _conversionDone.notify_all();
+}
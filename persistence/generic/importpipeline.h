@@ -0,0 +1,103 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cad/base/cadentity.h>
+
+namespace lc {
+namespace persistence {
+/**
+ * @brief Convert the entities of a file on several threads while the file is being parsed
+ *
+ * The parser pushes one conversion per entity. Conversions are grouped in batches, a background thread converts
+ * each batch with the kernel thread pool while the parser continues with the next one.
+ * The converted entities are taken in the order their conversions were pushed, by the thread owning the document.
+ *
+ * A conversion pushed with push() can run on any thread: it must only use the values it captured.
+ * Everything depending on the state of the parser (layer, block, meta info) has to be resolved before pushing it.
+ * Entities connecting to the document, like inserts, are pushed with pushDeferred() and created by take().
+ */
+class ImportPipeline {
+public:
+    using Conversion = std::function<entity::CADEntity_CSPtr()>;
+
+    static const size_t DEFAULT_BATCH_SIZE = 1024;
+    static const size_t DEFAULT_MAX_PENDING_BATCHES = 4;
+
+    /**
+     * @brief Start the pipeline
+     * @param batchSize Amount of conversions per batch
+     * @param maxPendingBatches Amount of batches waiting to be converted before push() blocks
+     */
+    explicit ImportPipeline(size_t batchSize = DEFAULT_BATCH_SIZE,
+                            size_t maxPendingBatches = DEFAULT_MAX_PENDING_BATCHES);
+
+    ~ImportPipeline();
+
+    ImportPipeline(const ImportPipeline&) = delete;
+    ImportPipeline& operator=(const ImportPipeline&) = delete;
+
+    /**
+     * @brief Add the conversion of an entity, run on a worker thread
+     * A conversion returning nullptr doesn't add any entity.
+     * Blocks while the maximum amount of batches is waiting to be converted.
+     */
+    void push(Conversion conversion);
+
+    /**
+     * @brief Add the conversion of an entity, run by the thread calling take()
+     */
+    void pushDeferred(Conversion conversion);
+
+    /**
+     * @brief Signal that all the conversions were pushed
+     */
+    void close();
+
+    /**
+     * @brief Move the converted entities to a vector
+     * The first exception thrown by a conversion is re-thrown here.
+     * @param entities Vector the entities are appended to, in the order their conversions were pushed
+     * @param wait Wait until all the conversions are done, close() must be called by the parser
+     * @return true once all the entities were taken
+     */
+    bool take(std::vector<entity::CADEntity_CSPtr>& entities, bool wait);
+
+private:
+    struct Item {
+        Conversion conversion;
+        bool deferred;
+    };
+
+    struct Result {
+        entity::CADEntity_CSPtr entity;
+        Conversion deferred;
+    };
+
+    void submit();
+
+    void convertLoop();
+
+    size_t _batchSize;
+    size_t _maxPendingBatches;
+
+    std::vector<Item> _batch;
+    std::deque<std::vector<Item>> _pending;
+    std::vector<Result> _converted;
+    std::mutex _mutex;
+    std::condition_variable _batchAvailable;
+    std::condition_variable _spaceAvailable;
+    std::condition_variable _conversionDone;
+    bool _closed;
+    bool _done;
+    std::exception_ptr _error;
+    std::thread _thread;
+};
+}
+}
@@ -1,4 +1,5 @@
 #include "dxfimpl.h"
+#include <sstream>
 #include "../generic/helpers.h"
 
 #include "../patternLoader/patternProvider.h"
@@ -17,6 +18,7 @@
 #include <cad/primitive/spline.h>
 #include <cad/primitive/lwpolyline.h>
 #include <cad/operations/entitybuilder.h>
+#include <cad/meta/metapool.h>
 #include <cad/meta/layer.h>
 #include <cad/operations/layerops.h>
 #include <cad/operations/linepatternops.h>
@@ -33,6 +35,7 @@
 #include <cad/meta/customentitystorage.h>
 #include <cad/logger/logger.h>
 #include <cad/tools/maphelper.h>
+#include <cad/tools/threadpool.h>
 
 using namespace lc::persistence;
 
@@ -68,8 +71,22 @@ DXFimpl::DXFimpl(std::shared_ptr<lc::storage::Document> document, lc::operation:
     _builder(std::move(builder)),
     _entityBuilder(std::make_shared<lc::operation::EntityBuilder>(document)),
     _currentBlock(nullptr),
-    dxfW(nullptr) {
+    dxfW(nullptr),
+    _pipeline(new ImportPipeline()) {
     _builder->append(_entityBuilder);
+
+    // The file is parsed on another thread when it's opened progressively, the document is only read here
+    for (const auto& layer : _document->allLayers()) {
+        _layers[layer.first] = layer.second;
+    }
+
+    for (const auto& block : _document->blocks()) {
+        _blocks[block->name()] = block;
+    }
+
+    for (const auto& linePattern : _document->linePatterns()) {
+        _linePatterns[linePattern->name()] = linePattern;
+    }
 }
 
 inline int DXFimpl::widthToInt(double wid) const {
@@ -83,19 +100,19 @@ inline int DXFimpl::widthToInt(double wid) const {
 }
 
 void DXFimpl::setBlock(const int handle) {
-    LOG_WARNING << "setBlock " << handle;
+    LOG_TRACE << "setBlock " << handle;
 }
 
 void DXFimpl::addViewport(const DRW_Viewport& data) {
-    LOG_WARNING << "addViewport ";
+    _unsupportedCount["Viewport"]++;
 }
 
 void DXFimpl::addVport(const DRW_Vport& data) {
-    LOG_WARNING << "addVport ";
+    _unsupportedCount["VPort"]++;
 }
 
 void DXFimpl::addBlock(const DRW_Block& data) {
-    LOG_WARNING << "addBlock " << data.name;
+    LOG_DEBUG << "addBlock " << data.name;
 
     _currentBlock = nullptr;
 
@@ -150,81 +167,152 @@ void DXFimpl::addBlock(const DRW_Block& data) {
         _currentBlock = std::make_shared<lc::meta::Block>(data.name, base);
     }
     _builder->append(std::make_shared<lc::operation::AddBlock>(_document, _currentBlock));
+    _blocks[data.name] = _currentBlock;
 
     // May need to check if the block already exists: not sure
     _handleBlock.insert(std::pair<int, lc::meta::Block_CSPtr>(data.parentHandle, _currentBlock));
 }
 
 void DXFimpl::endBlock() {
-    LOG_WARNING << "endBlock";
     _currentBlock = nullptr;
 }
 
+void DXFimpl::pushEntity(lc::entity::CADEntity_CSPtr entity) {
+    _pipeline->push([entity]() {
+        return entity;
+    });
+}
+
+void DXFimpl::finishImport() {
+    closeImport();
+    takeEntities(true);
+}
+
+void DXFimpl::closeImport() {
+    _pipeline->close();
+}
+
+bool DXFimpl::takeEntities(bool wait, size_t* count) {
+    std::vector<lc::entity::CADEntity_CSPtr> entities;
+    auto done = _pipeline->take(entities, wait);
+
+    if (count != nullptr) {
+        *count = entities.size();
+    }
+
+    for (auto& entity : entities) {
+        _entityBuilder->appendEntity(std::move(entity));
+    }
+
+    return done;
+}
+
+void DXFimpl::logImportSummary() const {
+    unsigned int total = 0;
+    std::ostringstream imported;
+    for (const auto& count : _importedCount) {
+        total += count.second;
+        imported << " " << count.first << ":" << count.second;
+    }
+    LOG_INFO << "DXF import: " << total << " entities" << imported.str();
+
+    for (const auto& count : _unsupportedCount) {
+        LOG_WARNING << "DXF import: skipped " << count.second << " unsupported " << count.first;
+    }
+}
+
 void DXFimpl::addLine(const DRW_Line& data) {
-    LOG_WARNING << "addLine";
-    lc::builder::LineBuilder builder;
+    _importedCount["Line"]++;
+    auto mf = getMetaInfo(data);
+    auto block = getBlock(data);
+    auto layer = getLayer(data);
+    auto start = coord(data.basePoint);
+    auto end = coord(data.secPoint);
 
-    builder.setMetaInfo(getMetaInfo(data));
-    builder.setBlock(getBlock(data));
-    builder.setLayer(getLayer(data));
-    builder.setStart(coord(data.basePoint));
-    builder.setEnd(coord(data.secPoint));
+    _pipeline->push([=]() {
+        lc::builder::LineBuilder builder;
 
-    LOG_WARNING << "Block:" << builder.block();
-    _entityBuilder->appendEntity(builder.build());
+        builder.setMetaInfo(mf);
+        builder.setBlock(block);
+        builder.setLayer(layer);
+        builder.setStart(start);
+        builder.setEnd(end);
+
+        return builder.build();
+    });
 }
 
 void DXFimpl::addCircle(const DRW_Circle& data) {
-    LOG_WARNING << "addCircle";
-    lc::builder::CircleBuilder builder;
+    _importedCount["Circle"]++;
+    auto mf = getMetaInfo(data);
+    auto layer = getLayer(data);
+    auto block = getBlock(data);
+    auto center = coord(data.basePoint);
+    auto radius = data.radious;
+
+    _pipeline->push([=]() {
+        lc::builder::CircleBuilder builder;
 
-    builder.setMetaInfo(getMetaInfo(data));
-    builder.setLayer(getLayer(data));
-    builder.setCenter(coord(data.basePoint));
-    builder.setRadius(data.radious);
-    builder.setBlock(getBlock(data));
+        builder.setMetaInfo(mf);
+        builder.setLayer(layer);
+        builder.setCenter(center);
+        builder.setRadius(radius);
+        builder.setBlock(block);
 
-    _entityBuilder->appendEntity(builder.build());
+        return builder.build();
+    });
 }
 
 void DXFimpl::addArc(const DRW_Arc& data) {
-    LOG_WARNING << "addArc";
-    lc::builder::ArcBuilder builder;
-
-    builder.setMetaInfo(getMetaInfo(data));
-    builder.setLayer(getLayer(data));
-    builder.setBlock(getBlock(data));
-    builder.setCenter(coord(data.basePoint));
-    builder.setRadius(data.radious);
-    builder.setStartAngle(data.staangle);
-    builder.setEndAngle(data.endangle);
-    builder.setIsCCW((bool) data.isccw);
-
-    _entityBuilder->appendEntity(builder.build());
+    _importedCount["Arc"]++;
+    auto mf = getMetaInfo(data);
+    auto layer = getLayer(data);
+    auto block = getBlock(data);
+    auto center = coord(data.basePoint);
+    auto radius = data.radious;
+    auto startAngle = data.staangle;
+    auto endAngle = data.endangle;
+    auto isCCW = (bool) data.isccw;
+
+    _pipeline->push([=]() {
+        lc::builder::ArcBuilder builder;
+
+        builder.setMetaInfo(mf);
+        builder.setLayer(layer);
+        builder.setBlock(block);
+        builder.setCenter(center);
+        builder.setRadius(radius);
+        builder.setStartAngle(startAngle);
+        builder.setEndAngle(endAngle);
+        builder.setIsCCW(isCCW);
+
+        return builder.build();
+    });
 }
 
 void DXFimpl::addEllipse(const DRW_Ellipse& data) {
-    LOG_WARNING << "addEllipse";
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(data);
+    _importedCount["Ellipse"]++;
+    auto mf = getMetaInfo(data);
     auto layer = getLayer(data);
-
-    auto secPoint = coord(data.secPoint);
-    auto lcEllipse = std::make_shared<lc::entity::Ellipse>(coord(data.basePoint),
-                     secPoint,
-                     secPoint.magnitude() * data.ratio,
-                     data.staparam,
-                     data.endparam,
-                     data.isccw,
-                     layer,
-                     mf,
-                     getBlock(data)
-                                                          );
-
-    _entityBuilder->appendEntity(lcEllipse);
+    auto block = getBlock(data);
+
+    _pipeline->push([=]() {
+        auto secPoint = coord(data.secPoint);
+        return std::make_shared<lc::entity::Ellipse>(coord(data.basePoint),
+                secPoint,
+                secPoint.magnitude() * data.ratio,
+                data.staparam,
+                data.endparam,
+                data.isccw,
+                layer,
+                mf,
+                block
+                                                    );
+    });
 }
 
 void DXFimpl::addLayer(const DRW_Layer& data) {
-    LOG_WARNING << "addLayer " << data.name;
+    LOG_DEBUG << "addLayer " << data.name;
     auto col = icol.intToColor(data.color);
 
     if (col == nullptr) {
@@ -237,25 +325,28 @@ void DXFimpl::addLayer(const DRW_Layer& data) {
         lw = getLcLineWidth<lc::meta::MetaLineWidthByValue>(DRW_LW_Conv::lineWidth::width00);
     }
 
-    auto lp = _document->linePatternByName(data.lineType);
+    auto lp = linePatternByName(data.lineType);
     auto isFrozen = (bool) ((unsigned int) data.flags & 1u);
 
     auto layer = std::make_shared<lc::meta::Layer>(data.name, lw->width(), col->color(), lp, isFrozen);
     // If a layer starts with a * it's a special layer we don't process yet
     if(data.name == "0") {
-        auto al = std::make_shared<lc::operation::ReplaceLayer>(_document, _document->layerByName("0"), layer);
+        auto al = std::make_shared<lc::operation::ReplaceLayer>(_document, _layers["0"], layer);
         _builder->append(al);
+        _layers[data.name] = layer;
     }
     else if (data.name.length() > 0 && (data.name.compare(0,1,"*") != 0)) {
         auto al = std::make_shared<lc::operation::AddLayer>(_document, layer);
         _builder->append(al);
+        _layers[data.name] = layer;
     }
 }
 
 void DXFimpl::addSpline(const DRW_Spline* data) {
-    LOG_WARNING << "addSpline";
+    _importedCount["Spline"]++;
     auto layer = getLayer(*data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(*data);
+    auto mf = getMetaInfo(*data);
+    auto block = getBlock(*data);
 
     // http://discourse.mcneel.com/t/creating-on-nurbscurve-from-control-points-and-knot-vector/12928/3
     auto knotList = data->knotslist;
@@ -263,185 +354,214 @@ void DXFimpl::addSpline(const DRW_Spline* data) {
         knotList.erase(knotList.begin());
         knotList.pop_back();
     }
-    auto lcSpline = std::make_shared<lc::entity::Spline>(coords(data->controllist),
-                    knotList,
-                    coords(data->fitlist),
-                    data->degree,
-                    false,
-                    data->tolfit,
-                    data->tgStart.x, data->tgStart.y, data->tgStart.z,
-                    data->tgEnd.x, data->tgEnd.y, data->tgEnd.z,
-                    data->normalVec.x, data->normalVec.y, data->normalVec.z,
-                    static_cast<lc::geo::Spline::splineflag>(data->flags),
-                    layer,
-                    mf,
-                    getBlock(*data)
-                                                        );
-
-    _entityBuilder->appendEntity(lcSpline);
+    auto controlPoints = coords(data->controllist);
+    auto fitPoints = coords(data->fitlist);
+    auto degree = data->degree;
+    auto tolerance = data->tolfit;
+    auto tgStart = coord(data->tgStart);
+    auto tgEnd = coord(data->tgEnd);
+    auto normal = coord(data->normalVec);
+    auto flags = static_cast<lc::geo::Spline::splineflag>(data->flags);
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::Spline>(controlPoints,
+                knotList,
+                fitPoints,
+                degree,
+                false,
+                tolerance,
+                tgStart.x(), tgStart.y(), tgStart.z(),
+                tgEnd.x(), tgEnd.y(), tgEnd.z(),
+                normal.x(), normal.y(), normal.z(),
+                flags,
+                layer,
+                mf,
+                block
+                                                   );
+    });
 }
 
 void DXFimpl::addText(const DRW_Text& data) {
-    LOG_WARNING << "addText";
+    _importedCount["Text"]++;
     auto layer = getLayer(data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(data);
-    auto lcText = std::make_shared<lc::entity::Text>(coord(data.basePoint),
-                  data.text, data.height,
-                  data.angle * M_PI / 180, data.style,
-                  lc::TextConst::DrawingDirection(data.textgen),
-                  lc::TextConst::HAlign(data.alignH),
-                  lc::TextConst::VAlign(data.alignV),
-                  false,
-                  false,
-                  false,
-                  false,
-                  layer,
-                  mf,
-                  getBlock(data)
-                                                    );
-
-    _entityBuilder->appendEntity(lcText);
+    auto mf = getMetaInfo(data);
+    auto block = getBlock(data);
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::Text>(coord(data.basePoint),
+                data.text, data.height,
+                data.angle * M_PI / 180, data.style,
+                lc::TextConst::DrawingDirection(data.textgen),
+                lc::TextConst::HAlign(data.alignH),
+                lc::TextConst::VAlign(data.alignV),
+                false,
+                false,
+                false,
+                false,
+                layer,
+                mf,
+                block
+                                                 );
+    });
 }
 
 void DXFimpl::addPoint(const DRW_Point& data) {
-    LOG_WARNING << "addPoint";
+    _importedCount["Point"]++;
     auto layer = getLayer(data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(data);
-    auto lcPoint = std::make_shared<lc::entity::Point>(coord(data.basePoint),
-                   layer,
-                   mf,
-                   getBlock(data)
-                                                      );
-
-    _entityBuilder->appendEntity(lcPoint);
+    auto mf = getMetaInfo(data);
+    auto block = getBlock(data);
+    auto position = coord(data.basePoint);
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::Point>(position,
+                layer,
+                mf,
+                block
+                                                  );
+    });
 }
 
 void DXFimpl::addDimAlign(const DRW_DimAligned* data) {
-    LOG_WARNING << "addDimAlign";
+    _importedCount["DimAligned"]++;
     auto layer = getLayer(*data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimAligned = std::make_shared<lc::entity::DimAligned>(
-                            coord(data->getDefPoint()),
-                            coord(data->getTextPoint()),
-                            static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
-                            data->getDir(),
-                            data->getTextLineFactor(),
-                            static_cast<lc::TextConst::LineSpacingStyle>(data->getTextLineStyle()),
-                            data->getText(),
-                            coord(data->getDef1Point()),
-                            coord(data->getDef2Point()),
-                            layer,
-                            mf,
-                            getBlock(*data)
-                        );
-
-    _entityBuilder->appendEntity(lcDimAligned);
+    auto mf = getMetaInfo(*data);
+    auto block = getBlock(*data);
+    auto dim = *data;
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::DimAligned>(
+                coord(dim.getDefPoint()),
+                coord(dim.getTextPoint()),
+                static_cast<lc::TextConst::AttachmentPoint>(dim.getAlign()),
+                dim.getDir(),
+                dim.getTextLineFactor(),
+                static_cast<lc::TextConst::LineSpacingStyle>(dim.getTextLineStyle()),
+                dim.getText(),
+                coord(dim.getDef1Point()),
+                coord(dim.getDef2Point()),
+                layer,
+                mf,
+                block
+               );
+    });
 }
 
 void DXFimpl::addDimLinear(const DRW_DimLinear* data) {
-    LOG_WARNING << "addDimLinear";
+    _importedCount["DimLinear"]++;
     auto layer = getLayer(*data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimLinear = std::make_shared<lc::entity::DimLinear>(
-                           coord(data->getDefPoint()),
-                           coord(data->getTextPoint()),
-                           static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
-                           data->getDir(),
-                           data->getTextLineFactor(),
-                           static_cast<lc::TextConst::LineSpacingStyle>(data->getTextLineStyle()),
-                           data->getText(),
-                           coord(data->getDef1Point()),
-                           coord(data->getDef2Point()),
-                           data->getAngle(),
-                           data->getOblique(),
-                           layer,
-                           mf,
-                           getBlock(*data)
-                       );
-
-    _entityBuilder->appendEntity(lcDimLinear);
+    auto mf = getMetaInfo(*data);
+    auto block = getBlock(*data);
+    auto dim = *data;
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::DimLinear>(
+                coord(dim.getDefPoint()),
+                coord(dim.getTextPoint()),
+                static_cast<lc::TextConst::AttachmentPoint>(dim.getAlign()),
+                dim.getDir(),
+                dim.getTextLineFactor(),
+                static_cast<lc::TextConst::LineSpacingStyle>(dim.getTextLineStyle()),
+                dim.getText(),
+                coord(dim.getDef1Point()),
+                coord(dim.getDef2Point()),
+                dim.getAngle(),
+                dim.getOblique(),
+                layer,
+                mf,
+                block
+               );
+    });
 }
 
 void DXFimpl::addDimRadial(const DRW_DimRadial* data) {
-    LOG_WARNING << "addDimRadial";
+    _importedCount["DimRadial"]++;
     auto layer = getLayer(*data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(*data);
-    auto  lcDimRadial = std::make_shared<lc::entity::DimRadial>(
-                            coord(data->getCenterPoint()),
-                            coord(data->getTextPoint()),
-                            static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
-                            data->getDir(),
-                            data->getTextLineFactor(),
-                            static_cast<lc::TextConst::LineSpacingStyle>(data->getTextLineStyle()),
-                            data->getText(),
-                            coord(data->getDiameterPoint()),
-                            data->getLeaderLength(),
-                            layer,
-                            mf,
-                            getBlock(*data)
-                        );
-
-    _entityBuilder->appendEntity(lcDimRadial);
+    auto mf = getMetaInfo(*data);
+    auto block = getBlock(*data);
+    auto dim = *data;
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::DimRadial>(
+                coord(dim.getCenterPoint()),
+                coord(dim.getTextPoint()),
+                static_cast<lc::TextConst::AttachmentPoint>(dim.getAlign()),
+                dim.getDir(),
+                dim.getTextLineFactor(),
+                static_cast<lc::TextConst::LineSpacingStyle>(dim.getTextLineStyle()),
+                dim.getText(),
+                coord(dim.getDiameterPoint()),
+                dim.getLeaderLength(),
+                layer,
+                mf,
+                block
+               );
+    });
 }
 
 void DXFimpl::addDimDiametric(const DRW_DimDiametric* data) {
-    LOG_WARNING << "addDimDiametric";
+    _importedCount["DimDiametric"]++;
     auto layer = getLayer(*data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimDiametric = std::make_shared<lc::entity::DimDiametric>(
-                              coord(data->getDiameter1Point()),
-                              coord(data->getTextPoint()),
-                              static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
-                              data->getDir(),
-                              data->getTextLineFactor(),
-                              static_cast<lc::TextConst::LineSpacingStyle>(data->getTextLineStyle()),
-                              data->getText(),
-                              coord(data->getDiameter2Point()),
-                              data->getLeaderLength(),
-                              layer,
-                              mf,
-                              getBlock(*data)
-                          );
-
-    _entityBuilder->appendEntity(lcDimDiametric);
+    auto mf = getMetaInfo(*data);
+    auto block = getBlock(*data);
+    auto dim = *data;
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::DimDiametric>(
+                coord(dim.getDiameter1Point()),
+                coord(dim.getTextPoint()),
+                static_cast<lc::TextConst::AttachmentPoint>(dim.getAlign()),
+                dim.getDir(),
+                dim.getTextLineFactor(),
+                static_cast<lc::TextConst::LineSpacingStyle>(dim.getTextLineStyle()),
+                dim.getText(),
+                coord(dim.getDiameter2Point()),
+                dim.getLeaderLength(),
+                layer,
+                mf,
+                block
+               );
+    });
 }
 
 void DXFimpl::addDimAngular(const DRW_DimAngular* data) {
-    LOG_WARNING << "addDimAngular";
+    _importedCount["DimAngular"]++;
     auto layer = getLayer(*data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimAngular = std::make_shared<lc::entity::DimAngular>(
-                            coord(data->getDefPoint()),
-                            coord(data->getTextPoint()),
-                            static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
-                            data->getDir(),
-                            data->getTextLineFactor(),
-                            static_cast<lc::TextConst::LineSpacingStyle>(data->getTextLineStyle()),
-                            data->getText(),
-                            coord(data->getFirstLine1()),
-                            coord(data->getFirstLine2()),
-                            coord(data->getSecondLine1()),
-                            coord(data->getSecondLine2()),
-                            layer,
-                            mf,
-                            getBlock(*data)
-                        );
-
-    _entityBuilder->appendEntity(lcDimAngular);
+    auto mf = getMetaInfo(*data);
+    auto block = getBlock(*data);
+    auto dim = *data;
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::DimAngular>(
+                coord(dim.getDefPoint()),
+                coord(dim.getTextPoint()),
+                static_cast<lc::TextConst::AttachmentPoint>(dim.getAlign()),
+                dim.getDir(),
+                dim.getTextLineFactor(),
+                static_cast<lc::TextConst::LineSpacingStyle>(dim.getTextLineStyle()),
+                dim.getText(),
+                coord(dim.getFirstLine1()),
+                coord(dim.getFirstLine2()),
+                coord(dim.getSecondLine1()),
+                coord(dim.getSecondLine2()),
+                layer,
+                mf,
+                block
+               );
+    });
 }
 
 void DXFimpl::addDimAngular3P(const DRW_DimAngular3p* data) {
-    LOG_WARNING << "addDimAngular3P";
+    _unsupportedCount["DimAngular3P"]++;
 }
 
 void DXFimpl::addDimOrdinate(const DRW_DimOrdinate* data) {
-    LOG_WARNING << "addOrdinate";
+    _unsupportedCount["DimOrdinate"]++;
 }
 
 void DXFimpl::addLWPolyline(const DRW_LWPolyline& data) {
-    LOG_WARNING << "addLWPolyline";
+    _importedCount["LWPolyline"]++;
     auto layer = getLayer(data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(data);
+    auto mf = getMetaInfo(data);
 
     std::vector<lc::entity::LWVertex2D> points;
     for (const auto& i : data.vertlist) {
@@ -449,26 +569,32 @@ void DXFimpl::addLWPolyline(const DRW_LWPolyline& data) {
     }
 
     auto isCLosed = (unsigned int) data.flags & 0x01u;
-    auto lcLWPolyline = std::make_shared<lc::entity::LWPolyline>(
-                            points,
-                            data.width,
-                            data.elevation,
-                            data.thickness,
-                            isCLosed,
-                            coord(data.extPoint),
-                            layer,
-                            mf,
-                            getBlock(data)
-                        );
-
-    _entityBuilder->appendEntity(lcLWPolyline);
+    auto width = data.width;
+    auto elevation = data.elevation;
+    auto thickness = data.thickness;
+    auto extrusion = coord(data.extPoint);
+    auto block = getBlock(data);
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::LWPolyline>(
+                points,
+                width,
+                elevation,
+                thickness,
+                isCLosed,
+                extrusion,
+                layer,
+                mf,
+                block
+               );
+    });
 }
 
 //Handle polyline as lwpolyline
 void DXFimpl::addPolyline(const DRW_Polyline& data) {
-    LOG_WARNING << "addPolyline";
+    _importedCount["Polyline"]++;
     auto layer = getLayer(data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(data);
+    auto mf = getMetaInfo(data);
 
     std::vector<lc::entity::LWVertex2D> points;
     for (const auto& i : data.vertlist) {
@@ -476,26 +602,28 @@ void DXFimpl::addPolyline(const DRW_Polyline& data) {
     }
 
     auto isCLosed = (unsigned int) data.flags & 0x01u;
-
-    auto lcLWPolyline = std::make_shared<lc::entity::LWPolyline>(
-                            points,
-                            0.0,
-                            0.0,
-                            0.0,
-                            isCLosed,
-                            coord(data.extPoint),
-                            layer,
-                            mf,
-                            getBlock(data)
-                        );
-
-    _entityBuilder->appendEntity(lcLWPolyline);
+    auto extrusion = coord(data.extPoint);
+    auto block = getBlock(data);
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::LWPolyline>(
+                points,
+                0.0,
+                0.0,
+                0.0,
+                isCLosed,
+                extrusion,
+                layer,
+                mf,
+                block
+               );
+    });
 }
 
 void DXFimpl::addMText(const DRW_MText& data) {
-    LOG_WARNING << "addMText";
+    _importedCount["MText"]++;
     auto layer = getLayer(data);
-    std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(data);
+    auto mf = getMetaInfo(data);
     lc::TextConst::HAlign halign;
     lc::TextConst::VAlign valign;
     //lc::TextConst::AttachmentPoint attachmentPoint = lc::TextConst::AttachmentPoint(data.textgen);
@@ -546,28 +674,30 @@ void DXFimpl::addMText(const DRW_MText& data) {
         lineSpacingStyle = lc::TextConst::LineSpacingStyle::Exact;
     }*/
 
-    auto lcText = std::make_shared<lc::entity::Text>(coord(data.basePoint),
-                  data.text, data.height,
-                  data.angle * M_PI / 180, data.style,
-                  lc::TextConst::DrawingDirection(drawingDir),
-                  lc::TextConst::HAlign(halign),
-                  lc::TextConst::VAlign(valign),
-                  false,
-                  false,
-                  false,
-                  false,
-                  layer,
-                  mf,
-                  getBlock(data)
-                                                    );
-
-    _entityBuilder->appendEntity(lcText);
+    auto block = getBlock(data);
+
+    _pipeline->push([=]() {
+        return std::make_shared<lc::entity::Text>(coord(data.basePoint),
+                data.text, data.height,
+                data.angle * M_PI / 180, data.style,
+                lc::TextConst::DrawingDirection(drawingDir),
+                lc::TextConst::HAlign(halign),
+                lc::TextConst::VAlign(valign),
+                false,
+                false,
+                false,
+                false,
+                layer,
+                mf,
+                block
+                                                 );
+    });
 }
 
 void DXFimpl::addHatch(const DRW_Hatch* data) {
     // Loop->objlist contains the 3 entities (copied) that define the hatch areas are the entities selected during hatch
     // loopList seems to contain the same entities, why??
-    LOG_WARNING << "addHatch ";
+    _importedCount["Hatch"]++;
     auto layer = getLayer(*data);
     auto mf = getMetaInfo(*data);
     lc::geo::Region reg;
@@ -577,26 +707,26 @@ void DXFimpl::addHatch(const DRW_Hatch* data) {
                                                       );
     lcHatch->setPatternName(data->name);
     lcHatch->setSolid(data->solid);
-    LOG_WARNING << "name " << data->name;
-    LOG_WARNING << "solid " << data->solid;
+    LOG_TRACE << "name " << data->name;
+    LOG_TRACE << "solid " << data->solid;
     if(!data->solid) {
         //Load pattern from dxf
         lcHatch->setPattern(lc::persistence::PatternProvider::Instance()->getPattern(data->name));
     }
-    LOG_WARNING << "associative " << data->associative;           /*!< associativity, code 71, associatve=1, non-assoc.=0 */
+    LOG_TRACE << "associative " << data->associative;           /*!< associativity, code 71, associatve=1, non-assoc.=0 */
     //lcHatch->setHatchStyle(data->hstyle);
     //lcHatch->setHatchPattern(data->hpattern);
-    LOG_WARNING << "double flag " << data->doubleflag;            /*!< hatch pattern double flag, code 77, double=1, single=0 */
-    LOG_WARNING << "loopsnum " <<data->loopsnum;              /*!< namber of boundary paths (loops), code 91 */
+    LOG_TRACE << "double flag " << data->doubleflag;            /*!< hatch pattern double flag, code 77, double=1, single=0 */
+    LOG_TRACE << "loopsnum " <<data->loopsnum;              /*!< namber of boundary paths (loops), code 91 */
     lcHatch->setAngle(data->angle);
     lcHatch->setScale(data->scale);
-    LOG_WARNING << "deflines " << data->deflines;              /*!< number of pattern definition lines, code 78 */
+    LOG_TRACE << "deflines " << data->deflines;              /*!< number of pattern definition lines, code 78 */
     for (auto x : data->looplist) {
         std::vector<lc::entity::CADEntity_CSPtr> loopData;
         for(auto k : x->objlist) {
             if(k->eType == DRW::ETYPE::LWPOLYLINE) { //done
                 auto data = std::dynamic_pointer_cast<DRW_LWPolyline>(k);
-                LOG_WARNING << "Polyline";
+                LOG_TRACE << "Polyline";
                 std::vector<lc::entity::LWVertex2D> points;
                 for (const auto& i : data->vertlist) {
                     points.emplace_back(lc::geo::Coordinate(i->x, i->y), i->bulge, i->stawidth, i->endwidth);
@@ -614,7 +744,7 @@ void DXFimpl::addHatch(const DRW_Hatch* data) {
                 loopData.push_back(lcLWPolyline);
             } else if(k->eType == DRW::ETYPE::LINE) { //done
                 auto data = std::dynamic_pointer_cast<DRW_Line>(k);
-                LOG_WARNING << "line";
+                LOG_TRACE << "line";
                 lc::builder::LineBuilder builder;
                 builder.setStart(coord(data->basePoint));
                 builder.setEnd(coord(data->secPoint));
@@ -623,7 +753,7 @@ void DXFimpl::addHatch(const DRW_Hatch* data) {
             } else if(k->eType == DRW::ETYPE::ARC) { //done
                 auto data = std::dynamic_pointer_cast<DRW_Arc>(k);
                 lc::builder::ArcBuilder builder;
-                LOG_WARNING << data->staangle <<','<< data->endangle;
+                LOG_TRACE << data->staangle <<','<< data->endangle;
                 builder.setCenter(coord(data->basePoint));
                 builder.setRadius(data->radious);
                 builder.setStartAngle(data->staangle);
@@ -672,7 +802,7 @@ void DXFimpl::addHatch(const DRW_Hatch* data) {
         reg.addLoop(loop);
     }
     lcHatch->setRegion(reg);
-    _entityBuilder->appendEntity(lcHatch);
+    pushEntity(lcHatch);
 }
 
 lc::meta::Block_CSPtr DXFimpl::getBlock(const DRW_Entity& data) const {
@@ -691,23 +821,38 @@ lc::meta::Block_CSPtr DXFimpl::getBlock(const DRW_Entity& data) const {
     return block;
 }
 
-lc::meta::Layer_CSPtr DXFimpl::getLayer(const DRW_Entity& data) const {
-    lc::meta::Layer_CSPtr layer = _document->layerByName(data.layer);
+lc::meta::Layer_CSPtr DXFimpl::getLayer(const DRW_Entity& data) {
+    auto it = _layers.find(data.layer);
+    lc::meta::Layer_CSPtr layer = it == _layers.end() ? nullptr : it->second;
 
     if (layer==nullptr) {
         auto col = icol.intToColor(255);
         auto lw = getLcLineWidth<lc::meta::MetaLineWidthByValue>(DRW_LW_Conv::lineWidth::width00);
-        auto lp = _document->linePatternByName("CONTINUOUS");
+        auto lp = linePatternByName("CONTINUOUS");
         auto isFrozen = false;
         // we need it anyway so,
         layer = std::make_shared<lc::meta::Layer>(data.layer, lw->width(), col->color(), lp, isFrozen);
         auto al = std::make_shared<lc::operation::AddLayer>(_document, layer);
         _builder->append(al);
+        _layers[data.layer] = layer;
     }
     return layer;
 }
 
-lc::meta::MetaInfo_SPtr DXFimpl::getMetaInfo(const DRW_Entity& data) const {
+lc::meta::MetaInfo_CSPtr DXFimpl::getMetaInfo(const DRW_Entity& data) const {
+    auto key = std::make_tuple(static_cast<int>(data.lWeight), data.color, data.lineType);
+    auto it = _metaInfoCache.find(key);
+
+    if (it != _metaInfoCache.end()) {
+        return it->second;
+    }
+
+    auto mf = createMetaInfo(data);
+    _metaInfoCache.emplace(std::move(key), mf);
+    return mf;
+}
+
+lc::meta::MetaInfo_CSPtr DXFimpl::createMetaInfo(const DRW_Entity& data) const {
     std::shared_ptr<lc::meta::MetaInfo> mf = nullptr;
 
     // Try to find a entities meta line weight
@@ -744,7 +889,7 @@ lc::meta::MetaInfo_SPtr DXFimpl::getMetaInfo(const DRW_Entity& data) const {
         linePattern = std::make_shared<lc::meta::DxfLinePatternByBlock>();
     }
     else if (!(lc::tools::StringHelper::cmpCaseInsensetive()(data.lineType, SKIP_BYLAYER) || lc::tools::StringHelper::cmpCaseInsensetive()(data.lineType, SKIP_CONTINUOUS))) {
-        linePattern = _document->linePatternByName(data.lineType);
+        linePattern = linePatternByName(data.lineType);
     }
 
     if(linePattern != nullptr) {
@@ -755,7 +900,7 @@ lc::meta::MetaInfo_SPtr DXFimpl::getMetaInfo(const DRW_Entity& data) const {
         mf->add(linePattern);
     }
 
-    return mf;
+    return lc::meta::MetaPool::instance().intern(mf);
 }
 
 lc::geo::Coordinate DXFimpl::coord(DRW_Coord const& coord) const {
@@ -772,7 +917,18 @@ std::vector<lc::geo::Coordinate> DXFimpl::coords(std::vector<std::shared_ptr<DRW
 }
 
 void DXFimpl::addLType(const DRW_LType& data) {
-    std::make_shared<lc::operation::AddLinePattern>(_document, std::make_shared<lc::meta::DxfLinePatternByValue>(data.name, data.desc, data.path, data.length))->execute();
+    auto linePattern = std::make_shared<lc::meta::DxfLinePatternByValue>(data.name, data.desc, data.path, data.length);
+    _linePatterns[data.name] = linePattern;
+    _builder->append(std::make_shared<lc::operation::AddLinePattern>(_document, linePattern));
+}
+
+lc::meta::DxfLinePatternByValue_CSPtr DXFimpl::linePatternByName(const std::string& name) const {
+    auto it = _linePatterns.find(name);
+    if (it != _linePatterns.end()) {
+        return it->second;
+    }
+
+    return nullptr;
 }
 
 /**
@@ -781,17 +937,16 @@ void DXFimpl::addLType(const DRW_LType& data) {
  * if linkImage isn't called as last, we miss a image during import
  */
 void DXFimpl::addImage(const DRW_Image* data) {
-    LOG_WARNING << "addImage";
+    _importedCount["Image"]++;
     imageMapCache.emplace_back(*data);
 }
 
 void DXFimpl::linkImage(const DRW_ImageDef *data) {
-    LOG_WARNING << "linkImage";
     for(auto image = imageMapCache.cbegin(); image != imageMapCache.cend() /* not hoisted */; /* no increment */ ) {
         if (image->ref == data->handle) {
-            auto layer = _document->layerByName(image->layer);
+            auto layer = getLayer(*image);
 
-            std::shared_ptr<lc::meta::MetaInfo> mf = getMetaInfo(*image);
+            auto mf = getMetaInfo(*image);
             const lc::geo::Coordinate base(coord(image->basePoint));
             const lc::geo::Coordinate uv(coord(image->secPoint));
             const lc::geo::Coordinate vv(coord(image->vVector));
@@ -805,7 +960,7 @@ void DXFimpl::linkImage(const DRW_ImageDef *data) {
                                mf,
                                getBlock(*image)
                            );
-            _entityBuilder->appendEntity(lcImage);
+            pushEntity(lcImage);
 
             image = imageMapCache.erase( image ) ; // advances iter
         } else {
@@ -815,29 +970,41 @@ void DXFimpl::linkImage(const DRW_ImageDef *data) {
 }
 
 void DXFimpl::addInsert(const DRW_Insert& data) {
-    LOG_WARNING << "addInsert";
-    lc::builder::InsertBuilder builder;
-    builder.setMetaInfo(getMetaInfo(data));
-    builder.setBlock(getBlock(data));
+    _importedCount["Insert"]++;
+    auto mf = getMetaInfo(data);
+    auto parentBlock = getBlock(data);
     auto layer = getLayer(data);
-    builder.setLayer(layer);
-    builder.setCoordinate(coord(data.basePoint));
+    auto position = coord(data.basePoint);
 
-    auto block=_document->blockByName(data.name);
-    if (block==nullptr) {
+    lc::meta::Block_CSPtr block;
+    auto it = _blocks.find(data.name);
+    if (it != _blocks.end()) {
+        block = it->second;
+    }
+    else {
         // It requests block like V21_PAKNING , it is already defined or from other file??
         // These blocks were not declared in loading file
         block = std::make_shared<lc::meta::Block>(data.name, geo::Coordinate());
+        _builder->append(std::make_shared<lc::operation::AddBlock>(_document, block));
+        _blocks[data.name] = block;
     }
-    _builder->append(std::make_shared<lc::operation::AddBlock>(_document, block));
 
     // May need to check if the block already exists: not sure
     _handleBlock.insert(std::pair<int, lc::meta::Block_CSPtr>(data.parentHandle, block));
 
-    builder.setDisplayBlock(block);
-    builder.setDocument(_document);
-
-    _entityBuilder->appendEntity(builder.build());
+    // Inserts connect to the document, they are created by the thread owning it
+    auto document = _document;
+    _pipeline->pushDeferred([=]() {
+        lc::builder::InsertBuilder builder;
+        builder.setMetaInfo(mf);
+        builder.setBlock(parentBlock);
+        builder.setLayer(layer);
+        builder.setCoordinate(position);
+        builder.setDisplayBlock(block);
+        builder.setDocument(document);
+
+        return builder.build();
+    });
 }
 
 /*********************************************
@@ -858,8 +1025,6 @@ void DXFimpl::writeLayer(const std::shared_ptr<const lc::meta::Layer>& layer) {
     auto col = layer->color();
     lay.name = layer->name();
     lay.color = icol_inst.colorToInt(col);
-    auto wid = layer->lineWidth().width();
-    std::cout << wid;
 //    auto val = widthToInt();
 
 //    lay.lWeight = static_cast<DRW_LW_Conv::lineWidth>();
@@ -910,113 +1075,174 @@ bool DXFimpl::writeDXF(const std::string& filename, lc::persistence::File::Type
 
     bool isBinary = type >= lc::persistence::File::LIBDXFRW_DXB_R12 && type < lc::persistence::File::LIBDXFRW_DXB_R2013;
 
+    prepareRecords();
+
     bool success = dxfW->write(this, exportVersion, isBinary);
     delete dxfW;
 
+    _modelSpaceRecords.clear();
+    _blockRecords.clear();
+
     return success;
 }
 
-void DXFimpl::writePoint(const lc::entity::Point_CSPtr& p) {
-    DRW_Point point;
-    getEntityAttributes(&point, p);
-    point.basePoint.x = p->x();
-    point.basePoint.y = p->y();
-    dxfW->writePoint(&point);
-}
+namespace {
+// Entities are cheap to convert, smaller chunks would spend more time in the pool than in the conversion
+const size_t MIN_RECORD_CHUNK_SIZE = 256;
 
-void DXFimpl::writeLine(const lc::entity::Line_CSPtr& l) {
-    DRW_Line line;
-    getEntityAttributes(&line, l);
-    line.basePoint.x = l->start().x();
-    line.basePoint.y = l->start().y();
-    line.secPoint.x = l->end().x();
-    line.secPoint.y = l->end().y();
-    dxfW->writeLine(&line);
-}
+/**
+ * @brief Build the DXF record of an entity
+ */
+class RecordBuilder : public lc::EntityDispatch {
+public:
+    RecordBuilder(const lc::persistence::DXFimpl& dxf, const lc::iColor& colors) :
+        _dxf(dxf),
+        _colors(colors) {
+    }
 
-void DXFimpl::writeCircle(const lc::entity::Circle_CSPtr& c) {
-    DRW_Circle circle;
-    getEntityAttributes(&circle, c);
-    circle.basePoint.x = c->center().x();
-    circle.basePoint.y = c->center().y();
-    circle.radious = c->radius();
-    dxfW->writeCircle(&circle);
-}
+    std::unique_ptr<DRW_Entity> build(const lc::entity::CADEntity_CSPtr& entity) {
+        _record.reset();
 
-void DXFimpl::writeArc(const lc::entity::Arc_CSPtr& a) {
-    DRW_Arc arc;
-    getEntityAttributes(&arc, a);
-    arc.basePoint.x = a->center().x();
-    arc.basePoint.y = a->center().y();
-    arc.radious = a->radius();
-    if (a->CCW()) {
-        arc.staangle = a->startAngle();
-        arc.endangle = a->endAngle();
-    } else {
-        arc.staangle = a->endAngle();
-        arc.endangle = a->startAngle();
+        // Insert doesn't support dispatch
+        if(entity->entityTag() != lc::entity::EntityTag::Generic) {
+            auto insert = std::dynamic_pointer_cast<const lc::entity::Insert>(entity);
+            if(insert != nullptr) {
+                writeInsert(insert);
+            }
+        }
+        else {
+            entity->dispatch(*this);
+        }
+
+        return std::move(_record);
     }
-    dxfW->writeArc(&arc);
-}
 
-void DXFimpl::writeEllipse(const lc::entity::Ellipse_CSPtr& s) {
-    DRW_Ellipse el;
-    getEntityAttributes(&el, s);
-    el.basePoint.x = s->center().x();
-    el.basePoint.y = s->center().y();
-    el.secPoint.x = s->majorP().x();
-    el.secPoint.y = s->majorP().y();
-    el.ratio = 1/s->ratio();
-    if (s->isReversed()) {
-        el.staparam = s->endAngle();
-        el.endparam = s->startAngle();
-    } else {
-        el.staparam = s->startAngle();
-        el.endparam = s->endAngle();
+    void visit(lc::entity::Point_CSPtr p) override {
+        auto point = record<DRW_Point>(p);
+        point->basePoint.x = p->x();
+        point->basePoint.y = p->y();
     }
-    dxfW->writeEllipse(&el);
-}
 
-void DXFimpl::writeSpline(const lc::entity::Spline_CSPtr& s) {
-    DRW_Spline sp;
+    void visit(lc::entity::Line_CSPtr l) override {
+        auto line = record<DRW_Line>(l);
+        line->basePoint.x = l->start().x();
+        line->basePoint.y = l->start().y();
+        line->secPoint.x = l->end().x();
+        line->secPoint.y = l->end().y();
+    }
 
-    getEntityAttributes(&sp, s);
+    void visit(lc::entity::Circle_CSPtr c) override {
+        auto circle = record<DRW_Circle>(c);
+        circle->basePoint.x = c->center().x();
+        circle->basePoint.y = c->center().y();
+        circle->radious = c->radius();
+    }
 
-    sp.knotslist = s->knotPoints();
-    sp.normalVec = DRW_Coord(s->nX(), s->nY(), s->nZ());
-    sp.tgEnd = DRW_Coord(s->endTanX(), s->endTanY(), s->endTanZ());
-    sp.tgStart = DRW_Coord(s->startTanX(), s->startTanY(), s->startTanZ());
-    sp.degree = s->degree();
+    void visit(lc::entity::Arc_CSPtr a) override {
+        auto arc = record<DRW_Arc>(a);
+        arc->basePoint.x = a->center().x();
+        arc->basePoint.y = a->center().y();
+        arc->radious = a->radius();
+        if (a->CCW()) {
+            arc->staangle = a->startAngle();
+            arc->endangle = a->endAngle();
+        } else {
+            arc->staangle = a->endAngle();
+            arc->endangle = a->startAngle();
+        }
+    }
 
-    for(const auto& cp : s->controlPoints()) {
-        sp.controllist.push_back(std::make_shared<DRW_Coord>(cp.x(), cp.y(), cp.z()));
+    void visit(lc::entity::Ellipse_CSPtr s) override {
+        auto el = record<DRW_Ellipse>(s);
+        el->basePoint.x = s->center().x();
+        el->basePoint.y = s->center().y();
+        el->secPoint.x = s->majorP().x();
+        el->secPoint.y = s->majorP().y();
+        el->ratio = 1/s->ratio();
+        if (s->isReversed()) {
+            el->staparam = s->endAngle();
+            el->endparam = s->startAngle();
+        } else {
+            el->staparam = s->startAngle();
+            el->endparam = s->endAngle();
+        }
     }
 
-    for(const auto& fp : s->fitPoints()) {
-        sp.fitlist.push_back(std::make_shared<DRW_Coord>(fp.x(), fp.y(), fp.z()));
+    void visit(lc::entity::Spline_CSPtr s) override {
+        auto sp = record<DRW_Spline>(s);
+
+        sp->knotslist = s->knotPoints();
+        sp->normalVec = DRW_Coord(s->nX(), s->nY(), s->nZ());
+        sp->tgEnd = DRW_Coord(s->endTanX(), s->endTanY(), s->endTanZ());
+        sp->tgStart = DRW_Coord(s->startTanX(), s->startTanY(), s->startTanZ());
+        sp->degree = s->degree();
+
+        for(const auto& cp : s->controlPoints()) {
+            sp->controllist.push_back(std::make_shared<DRW_Coord>(cp.x(), cp.y(), cp.z()));
+        }
+
+        for(const auto& fp : s->fitPoints()) {
+            sp->fitlist.push_back(std::make_shared<DRW_Coord>(fp.x(), fp.y(), fp.z()));
+        }
+
+        sp->flags = s->flags();
+        sp->nknots = sp->knotslist.size();
+        sp->nfit = sp->fitlist.size();
+        sp->ncontrol = sp->controllist.size();
     }
 
-    sp.flags = s->flags();
-    sp.nknots = sp.knotslist.size();
-    sp.nfit = sp.fitlist.size();
-    sp.ncontrol = sp.controllist.size();
+    void visit(lc::entity::Text_CSPtr t) override {
+        auto tex = record<DRW_Text>(t);
+        tex->basePoint.x = t->insertion_point().x();
+        tex->basePoint.y = t->insertion_point().y();
+        tex->text = t->text_value();
+        tex->textgen = t->textgeneration();
+        tex->height = t->height();
+        tex->angle = t->angle() * 180 / M_PI;
+        tex->alignH = DRW_Text::HAlign(t->halign());
+        tex->alignV = DRW_Text::VAlign(t->valign());
+    }
 
-    dxfW->writeSpline(&sp);
-}
+    /// @todo export dimensions, polylines, images and hatches
+    void visit(lc::entity::DimAligned_CSPtr) override {}
+    void visit(lc::entity::DimAngular_CSPtr) override {}
+    void visit(lc::entity::DimDiametric_CSPtr) override {}
+    void visit(lc::entity::DimLinear_CSPtr) override {}
+    void visit(lc::entity::DimRadial_CSPtr) override {}
+    void visit(lc::entity::LWPolyline_CSPtr) override {}
+    void visit(lc::entity::Image_CSPtr) override {}
+    void visit(lc::entity::Hatch_CSPtr) override {}
+
+private:
+    template<typename T>
+    T* record(const lc::entity::CADEntity_CSPtr& entity) {
+        auto result = new T();
+        _record.reset(result);
+        _dxf.getEntityAttributes(result, entity, _colors);
+        return result;
+    }
 
-void DXFimpl::writeInsert(const lc::entity::Insert_CSPtr& i) {
-    DRW_Insert insert;
-    getEntityAttributes(&insert, i);
+    void writeInsert(const lc::entity::Insert_CSPtr& i) {
+        auto insert = record<DRW_Insert>(i);
+        insert->name = i->displayBlock()->name();
+        insert->basePoint.x = i->position().x();
+        insert->basePoint.y = i->position().y();
+        insert->basePoint.z = i->position().z();
+    }
 
-    insert.name = i->displayBlock()->name();
-    insert.basePoint.x = i->position().x();
-    insert.basePoint.y = i->position().y();
-    insert.basePoint.z = i->position().z();
+    const lc::persistence::DXFimpl& _dxf;
+    const lc::iColor& _colors;
+    std::unique_ptr<DRW_Entity> _record;
+};
+}
 
-    dxfW->writeInsert(&insert);
+std::unique_ptr<DRW_Entity> DXFimpl::entityRecord(const lc::entity::CADEntity_CSPtr& entity,
+                                                  const lc::iColor& colors) const {
+    return RecordBuilder(*this, colors).build(entity);
 }
 
-void DXFimpl::getEntityAttributes(DRW_Entity* ent, const lc::entity::CADEntity_CSPtr& entity) {
+void DXFimpl::getEntityAttributes(DRW_Entity* ent, const lc::entity::CADEntity_CSPtr& entity,
+                                  const lc::iColor& colors) const {
     auto layer_  = entity->layer();
 
     auto lpByValue = entity->metaInfo<lc::meta::DxfLinePatternByValue>(lc::meta::DxfLinePattern::LCMETANAME());
@@ -1034,9 +1260,7 @@ void DXFimpl::getEntityAttributes(DRW_Entity* ent, const lc::entity::CADEntity_C
         ent->color = BYBLOCK_COLOR;
     }
     else if(metaColorByValue != nullptr) {
-        lc::iColor col;
-        auto color_ = col.colorToInt(metaColorByValue->color());
-        ent->color = color_;
+        ent->color = colors.colorToInt(metaColorByValue->color());
     }
 
     if(lpByValue != nullptr) {
@@ -1054,6 +1278,76 @@ void DXFimpl::getEntityAttributes(DRW_Entity* ent, const lc::entity::CADEntity_C
     }
 }
 
+void DXFimpl::prepareRecords() {
+    // Entities of the model space followed by the entities of each block, all converted in one pass
+    auto entities = _document->entityContainer().asVector();
+    for(const auto& block : _document->blocks()) {
+        auto blockEntities = _document->entitiesByBlock(block).asVector();
+        entities.insert(entities.end(), blockEntities.begin(), blockEntities.end());
+    }
+
+    std::vector<std::unique_ptr<DRW_Entity>> records(entities.size());
+
+    lc::tools::ThreadPool::instance().parallelFor(entities.size(), MIN_RECORD_CHUNK_SIZE, [&](size_t begin, size_t end) {
+        // The color table is built once per sub-range instead of once per entity
+        lc::iColor colors;
+        RecordBuilder builder(*this, colors);
+
+        for(size_t i = begin; i < end; i++) {
+            records[i] = builder.build(entities[i]);
+        }
+    });
+
+    _modelSpaceRecords.clear();
+    _blockRecords.clear();
+    _modelSpaceRecords.reserve(entities.size());
+
+    for(size_t i = 0; i < entities.size(); i++) {
+        if(records[i] == nullptr) {
+            continue;
+        }
+
+        auto block = entities[i]->block();
+        if(block == nullptr) {
+            _modelSpaceRecords.push_back(std::move(records[i]));
+        }
+        else {
+            _blockRecords[block->name()].push_back(std::move(records[i]));
+        }
+    }
+}
+
+void DXFimpl::writeRecord(DRW_Entity* record) {
+    switch(record->eType) {
+    case DRW::POINT:
+        dxfW->writePoint(static_cast<DRW_Point*>(record));
+        break;
+    case DRW::LINE:
+        dxfW->writeLine(static_cast<DRW_Line*>(record));
+        break;
+    case DRW::CIRCLE:
+        dxfW->writeCircle(static_cast<DRW_Circle*>(record));
+        break;
+    case DRW::ARC:
+        dxfW->writeArc(static_cast<DRW_Arc*>(record));
+        break;
+    case DRW::ELLIPSE:
+        dxfW->writeEllipse(static_cast<DRW_Ellipse*>(record));
+        break;
+    case DRW::SPLINE:
+        dxfW->writeSpline(static_cast<DRW_Spline*>(record));
+        break;
+    case DRW::TEXT:
+        dxfW->writeText(static_cast<DRW_Text*>(record));
+        break;
+    case DRW::INSERT:
+        dxfW->writeInsert(static_cast<DRW_Insert*>(record));
+        break;
+    default:
+        break;
+    }
+}
+
 void DXFimpl::writeLTypes() {
     DRW_LType ltype;
     // Standard linetypes for LibreCAD / AutoCAD
@@ -1335,88 +1629,9 @@ void DXFimpl::writeAppId() {
     dxfW->writeAppId(&ai);
 }
 
-void DXFimpl::writeDimension(const lc::entity::Dimension_CSPtr& d) {
-}
-
-void DXFimpl::writeLWPolyline(const lc::entity::LWPolyline_CSPtr& p) {
-}
-
-void DXFimpl::writeImage(const lc::entity::Image_CSPtr& i) {
-}
-
-void DXFimpl::writeText(const lc::entity::Text_CSPtr& t) {
-    DRW_Text tex;
-    getEntityAttributes(&tex, t);
-
-    tex.basePoint.x = t->insertion_point().x();
-    tex.basePoint.y = t->insertion_point().y();
-    tex.text = t->text_value();
-    tex.textgen = t->textgeneration();
-    tex.height = t->height();
-    tex.angle = t->angle() * 180 / M_PI;
-    tex.alignH = DRW_Text::HAlign(t->halign());
-    tex.alignV = DRW_Text::VAlign(t->valign());
-
-    dxfW->writeText(&tex);
-}
-
 void DXFimpl::writeEntities() {
-    for(const auto& e :_document->entityContainer().asVector()) {
-        if(e->block() != nullptr) {
-            continue;
-        }
-
-        writeEntity(e);
-    }
-}
-
-void DXFimpl::writeEntity(const lc::entity::CADEntity_CSPtr& entity) {
-    auto line = std::dynamic_pointer_cast<const lc::entity::Line>(entity);
-    if (line != nullptr) {
-        writeLine(line);
-        return;
-    }
-
-    auto circle = std::dynamic_pointer_cast<const lc::entity::Circle>(entity);
-    if (circle != nullptr) {
-        writeCircle(circle);
-        return;
-    }
-
-    auto arc = std::dynamic_pointer_cast<const lc::entity::Arc>(entity);
-    if (arc != nullptr) {
-        writeArc(arc);
-        return;
-    }
-
-    auto image = std::dynamic_pointer_cast<const lc::entity::Image>(entity);
-    if (image != nullptr) {
-        writeImage(image);
-        return;
-    }
-
-    auto lwPolyline = std::dynamic_pointer_cast<const lc::entity::LWPolyline>(entity);
-    if (lwPolyline != nullptr) {
-        writeLWPolyline(lwPolyline);
-        return;
-    }
-
-    auto text = std::dynamic_pointer_cast<const lc::entity::Text>(entity);
-    if (text != nullptr) {
-        writeText(text);
-        return;
-    }
-
-    auto ellipse = std::dynamic_pointer_cast<const lc::entity::Ellipse>(entity);
-    if (ellipse != nullptr) {
-        writeEllipse(ellipse);
-        return;
-    }
-
-    auto insert = std::dynamic_pointer_cast<const lc::entity::Insert>(entity);
-    if (insert != nullptr) {
-        writeInsert(insert);
-        return;
+    for(const auto& record : _modelSpaceRecords) {
+        writeRecord(record.get());
     }
 }
 
@@ -1458,8 +1673,11 @@ void DXFimpl::writeBlock(const lc::meta::Block_CSPtr& block) {
 
     dxfW->writeBlock(&drwBlock);
 
-    for(const auto& entity : _document->entitiesByBlock(block).asVector()) {
-        writeEntity(entity);
+    auto records = _blockRecords.find(block->name());
+    if(records != _blockRecords.end()) {
+        for(const auto& record : records->second) {
+            writeRecord(record.get());
+        }
     }
 }
 
@@ -6,6 +6,7 @@
 #include <iostream>
 #include "../file.h"
 #include "../generic/helpers.h"
+#include "../generic/importpipeline.h"
 
 #include <cad/storage/document.h>
 #include <cad/storage/storagemanager.h>
@@ -18,7 +19,10 @@
 #include <cad/meta/metacolor.h>
 #include <cad/base/metainfo.h>
 #include <cad/meta/icolor.h>
+#include <map>
+#include <memory>
 #include <tuple>
+#include <vector>
 #include <cad/meta/block.h>
 #include <cad/operations/builder.h>
 
@@ -124,6 +128,34 @@ public:
 
     void endBlock() override;
 
+    /**
+     * @brief Wait until the entities read by the callbacks are converted and added to the entity builder
+     * Must be called once the file is read, before executing the builder.
+     * Most entities are converted on worker threads while the file is being parsed.
+     */
+    void finishImport();
+
+    /**
+     * @brief Signal that the file was completely read
+     * Used when the file is read on another thread than the one owning the document.
+     */
+    void closeImport();
+
+    /**
+     * @brief Add the entities converted so far to the entity builder
+     * Must be called from the thread owning the document.
+     * @param wait Wait until all the entities are converted, closeImport() must be called by the reading thread
+     * @param count Set to the amount of added entities
+     * @return true once all the entities of the file were added
+     */
+    bool takeEntities(bool wait, size_t* count = nullptr);
+
+    /**
+     * @brief Log the amount of imported and skipped entities of each type
+     * Entities aren't logged individually during the import.
+     */
+    void logImportSummary() const;
+
 
     // WRITE FUNCTIONALITY
     bool writeDXF(const std::string& filename, lc::persistence::File::Type type);
@@ -148,31 +180,15 @@ public:
 
     void writeAppId() override;
 
-    void getEntityAttributes(DRW_Entity* ent, const lc::entity::CADEntity_CSPtr& entity);
-
-    void writeEntity(const lc::entity::CADEntity_CSPtr& entity);
-
-    void writePoint(const lc::entity::Point_CSPtr& p);
-
-    void writeLine(const lc::entity::Line_CSPtr& l);
-
-    void writeCircle(const lc::entity::Circle_CSPtr& c);
-
-    void writeArc(const lc::entity::Arc_CSPtr& a);
-
-    void writeEllipse(const lc::entity::Ellipse_CSPtr& s);
-
-    void writeSpline(const lc::entity::Spline_CSPtr& s);
-
-    void writeDimension(const lc::entity::Dimension_CSPtr& d);
-
-    void writeLWPolyline(const lc::entity::LWPolyline_CSPtr& p);
+    void getEntityAttributes(DRW_Entity* ent, const lc::entity::CADEntity_CSPtr& entity, const lc::iColor& colors) const;
 
-    void writeImage(const lc::entity::Image_CSPtr& i);
-
-    void writeText(const lc::entity::Text_CSPtr& t);
-
-    void writeInsert(const lc::entity::Insert_CSPtr& i);
+    /**
+     * @brief Build the DXF record of an entity
+     * Only reads the entity, records of different entities can be built on several threads at once.
+     * @return nullptr if the entity type can't be exported
+     */
+    std::unique_ptr<DRW_Entity> entityRecord(const lc::entity::CADEntity_CSPtr& entity,
+                                             const lc::iColor& colors) const;
 
     void writeLayer(const std::shared_ptr<const lc::meta::Layer>& layer);
 
@@ -226,12 +242,33 @@ private:
 
     dxfRW* dxfW;
 
-    lc::meta::MetaInfo_SPtr getMetaInfo(DRW_Entity const& data) const;
+    /**
+     * @brief Build the records of all the entities of the document before writing the file
+     * The document is read once, the records are built on the kernel thread pool
+     * and kept in document order for writeEntities() and writeBlocks().
+     */
+    void prepareRecords();
+
+    /**
+     * @brief Write a record built by entityRecord()
+     */
+    void writeRecord(DRW_Entity* record);
+
+    std::vector<std::unique_ptr<DRW_Entity>> _modelSpaceRecords;
+    std::map<std::string, std::vector<std::unique_ptr<DRW_Entity>>> _blockRecords;
+
+    /**
+     * @brief Return the meta info of an entity
+     * Entities with the same color, line width and line type share the same instance.
+     */
+    lc::meta::MetaInfo_CSPtr getMetaInfo(DRW_Entity const& data) const;
+
+    lc::meta::MetaInfo_CSPtr createMetaInfo(DRW_Entity const& data) const;
 
     lc::meta::Block_CSPtr getBlock(DRW_Entity const& data) const;
 
     // this function adds layer too if not found: issue with some files
-    lc::meta::Layer_CSPtr getLayer(DRW_Entity const& data) const;
+    lc::meta::Layer_CSPtr getLayer(DRW_Entity const& data);
 
     /**
     * Convert from a DRW_Coord to a geo::Coordinate
@@ -240,12 +277,31 @@ private:
 
     std::vector<lc::geo::Coordinate> coords(std::vector<std::shared_ptr<DRW_Coord>> coordList) const;
 
+    /**
+    * Add an entity converted on the parsing thread, keeping the order of the file
+    */
+    void pushEntity(lc::entity::CADEntity_CSPtr entity);
+
+    /**
+    * Return a line pattern of the file, or of the document if the file doesn't define it
+    * Line patterns of the file are added with the other operations of the builder, when it's executed.
+    * Like layers and blocks, they are resolved from the tables of the import, the document isn't read while parsing.
+    */
+    lc::meta::DxfLinePatternByValue_CSPtr linePatternByName(const std::string& name) const;
+
 private:
     lc::iColor icol;
 
     std::vector<DRW_Image> imageMapCache;
-    //std::map<std::string, lc::meta::Block_CSPtr> _blocks;
     std::map<int, lc::meta::Block_CSPtr> _handleBlock;
+    mutable std::map<std::tuple<int, int, std::string>, lc::meta::MetaInfo_CSPtr> _metaInfoCache;
+    std::map<std::string, unsigned int> _importedCount;
+    std::map<std::string, unsigned int> _unsupportedCount;
+    // Meta types of the document when the import started, followed by the ones read from the file
+    std::map<std::string, lc::meta::Layer_CSPtr, lc::tools::StringHelper::cmpCaseInsensetive> _layers;
+    std::map<std::string, lc::meta::Block_CSPtr, lc::tools::StringHelper::cmpCaseInsensetive> _blocks;
+    std::map<std::string, lc::meta::DxfLinePatternByValue_CSPtr, lc::tools::StringHelper::cmpCaseInsensetive> _linePatterns;
+    std::unique_ptr<ImportPipeline> _pipeline;
 
     const static std::map<int, lc::Units> _dxfToLCUnits;
     const static std::map<lc::Units, int> _lcUnitsToDXF;
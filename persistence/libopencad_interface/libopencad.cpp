@@ -3,6 +3,7 @@
 
 #include "../generic/helpers.h"
 #include <cad/meta/icolor.h>
+#include <cad/meta/metapool.h>
 #include <cad/operations/layerops.h>
 
 lc::persistence::LibOpenCad::LibOpenCad(lc::storage::Document_SPtr document, lc::operation::Builder_SPtr builder) :
@@ -158,7 +159,7 @@ void lc::persistence::LibOpenCad::addLWPolyline(lc::meta::Layer_SPtr layer, cons
     _entityBuilder->appendEntity(lcLWPolyline);
 }
 
-lc::meta::MetaInfo_SPtr lc::persistence::LibOpenCad::metaInfo(const CADGeometry* geometry) {
+lc::meta::MetaInfo_CSPtr lc::persistence::LibOpenCad::metaInfo(const CADGeometry* geometry) {
     auto metaInfo = meta::MetaInfo::create();
 
     auto color = geometry->getColor();
@@ -166,7 +167,7 @@ lc::meta::MetaInfo_SPtr lc::persistence::LibOpenCad::metaInfo(const CADGeometry*
 
     metaInfo->add(std::make_shared<lc::meta::MetaLineWidthByValue>(geometry->getThickness()));
 
-    return metaInfo;
+    return meta::MetaPool::instance().intern(metaInfo);
 }
 
 lc::geo::Coordinate lc::persistence::LibOpenCad::toLcPostiton(const CADVector& position) {
@@ -35,7 +35,7 @@ private:
     void addEllipse(lc::meta::Layer_SPtr layer, const CADEllipse* ellipse);
     void addLWPolyline(lc::meta::Layer_SPtr layer, const CADLWPolyline* lwPolyline);
 
-    meta::MetaInfo_SPtr metaInfo(const CADGeometry* geometry);
+    meta::MetaInfo_CSPtr metaInfo(const CADGeometry* geometry);
     geo::Coordinate toLcPostiton(const CADVector& position);
 
     storage::Document_SPtr _document;
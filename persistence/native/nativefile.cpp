@@ -0,0 +1,450 @@
+#include "nativefile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <cad/storage/binarystream.h>
+#include <cad/storage/entitycodec.h>
+#include <cad/tools/threadpool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace lc;
+using namespace lc::persistence;
+
+namespace {
+const char NATIVE_MAGIC[4] = {'L', 'C', 'N', 'F'};
+const uint32_t NATIVE_VERSION = 1;
+const size_t HEADER_SIZE = sizeof(NATIVE_MAGIC) + sizeof(uint32_t);
+const size_t FOOTER_SIZE = sizeof(uint64_t) + sizeof(NATIVE_MAGIC);
+
+/**
+ * Amount of entities per chunk, small enough to load little more than a viewport, large enough to keep the index small
+ */
+const size_t CHUNK_SIZE = 1024;
+
+/**
+ * Interleave the bits of two 16 bits values, nearby points get nearby keys
+ */
+uint32_t mortonKey(uint32_t x, uint32_t y) {
+    auto spread = [](uint32_t v) {
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+
+    return spread(x) | (spread(y) << 1);
+}
+
+uint32_t quantize(double value, double min, double size) {
+    if (size <= 0) {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(std::min(1., std::max(0., (value - min) / size)) * 0xFFFF);
+}
+
+void writeArea(storage::BinaryWriter& writer, const geo::Area& area) {
+    writer.writeDouble(area.minP().x());
+    writer.writeDouble(area.minP().y());
+    writer.writeDouble(area.maxP().x());
+    writer.writeDouble(area.maxP().y());
+}
+
+geo::Area readArea(storage::BinaryReader& reader) {
+    auto minX = reader.readDouble();
+    auto minY = reader.readDouble();
+    auto maxX = reader.readDouble();
+    auto maxY = reader.readDouble();
+    return geo::Area(geo::Coordinate(minX, minY), geo::Coordinate(maxX, maxY));
+}
+
+/**
+ * Line patterns first, then layers and blocks, the order in which they must be added to a document
+ */
+int metaTypeOrder(const meta::DocumentMetaType_CSPtr& metaType) {
+    if (std::dynamic_pointer_cast<const meta::DxfLinePatternByValue>(metaType)) {
+        return 0;
+    }
+
+    if (std::dynamic_pointer_cast<const meta::Layer>(metaType)) {
+        return 1;
+    }
+
+    return 2;
+}
+}
+
+/**
+ * @brief Read only memory mapping of a file
+ */
+class NativeFile::MappedFile {
+public:
+    explicit MappedFile(const std::string& path) :
+        _data(nullptr),
+        _size(0) {
+#ifdef _WIN32
+        _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Unable to open " + path);
+        }
+
+        LARGE_INTEGER size;
+        GetFileSizeEx(_file, &size);
+        _size = static_cast<size_t>(size.QuadPart);
+
+        _mapping = _size == 0 ? nullptr : CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping != nullptr) {
+            _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+#else
+        auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open " + path);
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            _size = static_cast<size_t>(info.st_size);
+            auto data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            _data = data == MAP_FAILED ? nullptr : static_cast<const char*>(data);
+        }
+
+        ::close(fd);
+#endif
+
+        if (_data == nullptr) {
+            unmap();
+            throw std::runtime_error("Unable to map " + path);
+        }
+    }
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    const char* data() const {
+        return _data;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+private:
+    void unmap() {
+#ifdef _WIN32
+        if (_data != nullptr) {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping != nullptr) {
+            CloseHandle(_mapping);
+        }
+        CloseHandle(_file);
+#else
+        if (_data != nullptr) {
+            munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+    }
+
+#ifdef _WIN32
+    HANDLE _file;
+    HANDLE _mapping;
+#endif
+    const char* _data;
+    size_t _size;
+};
+
+NativeFile::NativeFile(const storage::Document_SPtr& document, const std::string& path) :
+    _document(document),
+    _file(new MappedFile(path)),
+    _entityCount(0),
+    _loadedChunks(0) {
+
+    auto data = _file->data();
+    auto size = _file->size();
+
+    if (size < HEADER_SIZE + FOOTER_SIZE ||
+        std::memcmp(data, NATIVE_MAGIC, sizeof(NATIVE_MAGIC)) != 0 ||
+        std::memcmp(data + size - sizeof(NATIVE_MAGIC), NATIVE_MAGIC, sizeof(NATIVE_MAGIC)) != 0) {
+        throw std::runtime_error(path + " is not a LibreCAD file");
+    }
+
+    storage::BinaryReader header(data + sizeof(NATIVE_MAGIC), sizeof(uint32_t));
+    if (header.readUInt32() != NATIVE_VERSION) {
+        throw std::runtime_error("Unsupported LibreCAD file version");
+    }
+
+    storage::BinaryReader footer(data + size - FOOTER_SIZE, sizeof(uint64_t));
+    auto indexOffset = footer.readUInt64();
+    if (indexOffset < HEADER_SIZE || indexOffset > size - FOOTER_SIZE) {
+        throw std::runtime_error(path + " is corrupted");
+    }
+
+    storage::BinaryReader index(data + indexOffset, size - FOOTER_SIZE - indexOffset);
+    _bounds = readArea(index);
+    _entityCount = index.readVarUInt();
+
+    storage::EntityDecoder decoder(document);
+    for (auto count = index.readVarUInt(); count > 0; count--) {
+        decoder.readMetaType(index);
+    }
+    _metaTypes = decoder.takeNewMetaTypes();
+
+    _chunks.resize(index.readVarUInt());
+    for (auto& chunk : _chunks) {
+        chunk.blockEntities = index.readBool();
+        chunk.area = readArea(index);
+        chunk.offset = index.readVarUInt();
+        chunk.size = index.readVarUInt();
+        chunk.count = index.readVarUInt();
+        chunk.loaded = false;
+
+        if (chunk.offset < HEADER_SIZE || chunk.size > indexOffset - chunk.offset) {
+            throw std::runtime_error(path + " is corrupted");
+        }
+    }
+}
+
+NativeFile::~NativeFile() = default;
+
+void NativeFile::save(const storage::Document_SPtr& document, const std::string& path) {
+    // Entities of blocks first, inserts can only be drawn once they are known
+    std::vector<std::pair<bool, std::vector<entity::CADEntity_CSPtr>>> chunks;
+
+    for (const auto& block : document->blocks()) {
+        auto entities = document->entitiesByBlock(block).asVector();
+
+        for (size_t begin = 0; begin < entities.size(); begin += CHUNK_SIZE) {
+            auto end = std::min(entities.size(), begin + CHUNK_SIZE);
+            chunks.emplace_back(true, std::vector<entity::CADEntity_CSPtr>(entities.begin() + begin, entities.begin() + end));
+        }
+    }
+
+    auto entities = document->entityContainer().asVector();
+    std::vector<geo::Area> areas;
+    areas.reserve(entities.size());
+    geo::Area bounds;
+
+    for (size_t i = 0; i < entities.size(); i++) {
+        areas.push_back(entities[i]->boundingBox());
+        bounds = i == 0 ? areas[i] : bounds.merge(areas[i]);
+    }
+
+    std::vector<std::pair<uint32_t, size_t>> order;
+    order.reserve(entities.size());
+    for (size_t i = 0; i < entities.size(); i++) {
+        auto center = areas[i].minP() + (areas[i].maxP() - areas[i].minP()) / 2.;
+        order.emplace_back(mortonKey(
+                               quantize(center.x(), bounds.minP().x(), bounds.width()),
+                               quantize(center.y(), bounds.minP().y(), bounds.height())
+                           ), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    for (size_t begin = 0; begin < order.size(); begin += CHUNK_SIZE) {
+        auto end = std::min(order.size(), begin + CHUNK_SIZE);
+        chunks.emplace_back(false, std::vector<entity::CADEntity_CSPtr>());
+
+        for (auto i = begin; i < end; i++) {
+            chunks.back().second.push_back(entities[order[i].second]);
+        }
+    }
+
+    // Write to a temporary file, an existing file is only replaced once the new one is complete
+    auto tmpPath = path + ".tmp";
+    std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        throw std::runtime_error("Unable to open " + tmpPath);
+    }
+
+    storage::BinaryWriter writer;
+    writer.writeBytes(NATIVE_MAGIC, sizeof(NATIVE_MAGIC));
+    writer.writeUInt32(NATIVE_VERSION);
+    stream.write(writer.buffer().data(), writer.buffer().size());
+    uint64_t offset = writer.buffer().size();
+
+    uint64_t entityCount = 0;
+    uint64_t chunkCount = 0;
+    storage::BinaryWriter chunkIndex;
+    for (const auto& chunk : chunks) {
+        writer.clear();
+        storage::EntityEncoder encoder(writer);
+        uint64_t count = 0;
+        geo::Area area;
+
+        for (const auto& entity : chunk.second) {
+            if (!encoder.write(entity)) {
+                continue;
+            }
+
+            auto box = entity->boundingBox();
+            area = count == 0 ? box : area.merge(box);
+            count++;
+        }
+
+        if (count == 0) {
+            continue;
+        }
+
+        stream.write(writer.buffer().data(), writer.buffer().size());
+
+        chunkIndex.writeBool(chunk.first);
+        writeArea(chunkIndex, area);
+        chunkIndex.writeVarUInt(offset);
+        chunkIndex.writeVarUInt(writer.buffer().size());
+        chunkIndex.writeVarUInt(count);
+
+        offset += writer.buffer().size();
+        entityCount += count;
+        chunkCount++;
+    }
+
+    auto metaTypes = document->allMetaTypes();
+    std::vector<meta::DocumentMetaType_CSPtr> sortedMetaTypes;
+    for (const auto& metaType : metaTypes) {
+        sortedMetaTypes.push_back(metaType.second);
+    }
+    std::stable_sort(sortedMetaTypes.begin(), sortedMetaTypes.end(), [](const meta::DocumentMetaType_CSPtr& a, const meta::DocumentMetaType_CSPtr& b) {
+        return metaTypeOrder(a) < metaTypeOrder(b);
+    });
+
+    storage::BinaryWriter metaTypeWriter;
+    storage::EntityEncoder metaTypeEncoder(metaTypeWriter);
+    uint64_t metaTypeCount = 0;
+    for (const auto& metaType : sortedMetaTypes) {
+        if (metaTypeEncoder.writeMetaType(metaType)) {
+            metaTypeCount++;
+        }
+    }
+
+    storage::BinaryWriter index;
+    writeArea(index, bounds);
+    index.writeVarUInt(entityCount);
+    index.writeVarUInt(metaTypeCount);
+    index.writeBytes(metaTypeWriter.buffer().data(), metaTypeWriter.buffer().size());
+    index.writeVarUInt(chunkCount);
+    index.writeBytes(chunkIndex.buffer().data(), chunkIndex.buffer().size());
+    index.writeUInt64(offset);
+    index.writeBytes(NATIVE_MAGIC, sizeof(NATIVE_MAGIC));
+    stream.write(index.buffer().data(), index.buffer().size());
+
+    stream.close();
+    if (!stream) {
+        throw std::runtime_error("Unable to write " + tmpPath);
+    }
+
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Unable to replace " + path);
+    }
+}
+
+const std::vector<meta::DocumentMetaType_CSPtr>& NativeFile::metaTypes() const {
+    return _metaTypes;
+}
+
+geo::Area NativeFile::bounds() const {
+    return _bounds;
+}
+
+size_t NativeFile::entityCount() const {
+    return _entityCount;
+}
+
+std::vector<entity::CADEntity_CSPtr> NativeFile::loadBlocks() {
+    std::vector<size_t> chunks;
+
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        if (!_chunks[i].loaded && _chunks[i].blockEntities) {
+            chunks.push_back(i);
+        }
+    }
+
+    return decode(chunks);
+}
+
+std::vector<entity::CADEntity_CSPtr> NativeFile::load(const geo::Area& area) {
+    std::vector<size_t> chunks;
+
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        if (!_chunks[i].loaded && (_chunks[i].blockEntities || _chunks[i].area.overlaps(area))) {
+            chunks.push_back(i);
+        }
+    }
+
+    return decode(chunks);
+}
+
+std::vector<entity::CADEntity_CSPtr> NativeFile::loadAll() {
+    std::vector<size_t> chunks;
+
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        if (!_chunks[i].loaded) {
+            chunks.push_back(i);
+        }
+    }
+
+    return decode(chunks);
+}
+
+bool NativeFile::loaded() const {
+    return _loadedChunks == _chunks.size();
+}
+
+std::vector<entity::CADEntity_CSPtr> NativeFile::decode(const std::vector<size_t>& chunks) {
+    auto document = _document.lock();
+    if (document == nullptr || chunks.empty()) {
+        return {};
+    }
+
+    std::vector<std::vector<entity::CADEntity_CSPtr>> decoded(chunks.size());
+
+    // Chunks don't share any state, each one gets its own decoder
+    tools::ThreadPool::instance().parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            const auto& chunk = _chunks[chunks[i]];
+            storage::BinaryReader reader(_file->data() + chunk.offset, chunk.size);
+            storage::EntityDecoder decoder(document);
+
+            for (const auto& metaType : _metaTypes) {
+                decoder.addMetaType(metaType);
+            }
+
+            decoded[i].reserve(chunk.count);
+            for (auto count = chunk.count; count > 0; count--) {
+                decoded[i].push_back(decoder.read(reader));
+            }
+        }
+    });
+
+    std::vector<entity::CADEntity_CSPtr> entities;
+    size_t count = 0;
+    for (const auto& chunkEntities : decoded) {
+        count += chunkEntities.size();
+    }
+    entities.reserve(count);
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        _chunks[chunks[i]].loaded = true;
+        _loadedChunks++;
+        entities.insert(entities.end(), decoded[i].begin(), decoded[i].end());
+    }
+
+    return entities;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cad/storage/document.h>
+#include <cad/storage/entityloader.h>
+#include <cad/geometry/geoarea.h>
+
+namespace lc {
+namespace persistence {
+/**
+ * @brief Native LibreCAD file format
+ *
+ * The file contains the layers, line patterns and blocks of the document, followed by the entities
+ * serialised with the kernel entity codec. Entities are sorted along a Z-order curve and grouped in chunks
+ * of nearby entities, each chunk can be decoded on its own. The index at the end of the file stores the
+ * offset, size and bounding box of each chunk, which allows to decode only the chunks visible in an area.
+ *
+ * The file is memory mapped, opening it only reads the index and the meta types. The entities of blocks are
+ * materialised with loadBlocks(), the other ones on demand with load() as the viewport or the queries reach them.
+ * loadAll() decodes the remaining chunks in parallel, before the document is exported.
+ */
+class NativeFile : public storage::EntityLoader {
+public:
+    /**
+     * @brief Open a native file
+     * Throws a std::runtime_error if the file can't be opened or isn't a native file.
+     * @param document Document the entities are loaded for, it isn't modified
+     * @param path Path of the file
+     */
+    NativeFile(const storage::Document_SPtr& document, const std::string& path);
+
+    ~NativeFile() override;
+
+    NativeFile(const NativeFile&) = delete;
+    NativeFile& operator=(const NativeFile&) = delete;
+
+    /**
+     * @brief Write a document to a native file
+     */
+    static void save(const storage::Document_SPtr& document, const std::string& path);
+
+    /**
+     * @brief Return the layers, line patterns and blocks of the file which are not part of the document
+     * They must be added to the document before the entities.
+     */
+    const std::vector<meta::DocumentMetaType_CSPtr>& metaTypes() const;
+
+    /**
+     * @brief Return the area covered by the entities of the model space
+     */
+    geo::Area bounds() const override;
+
+    /**
+     * @brief Return the amount of entities in the file
+     */
+    size_t entityCount() const;
+
+    /**
+     * @brief Decode the entities of the blocks which were not loaded yet
+     * They are needed by the inserts of any area, the file loads them first.
+     */
+    std::vector<entity::CADEntity_CSPtr> loadBlocks();
+
+    /**
+     * @brief Decode the entities of the chunks overlapping an area which were not loaded yet
+     */
+    std::vector<entity::CADEntity_CSPtr> load(const geo::Area& area) override;
+
+    /**
+     * @brief Decode the entities of all the chunks which were not loaded yet
+     */
+    std::vector<entity::CADEntity_CSPtr> loadAll() override;
+
+    /**
+     * @brief Check if all the chunks were decoded
+     */
+    bool loaded() const override;
+
+private:
+    struct Chunk {
+        geo::Area area;
+        bool blockEntities;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t count;
+        bool loaded;
+    };
+
+    class MappedFile;
+
+    std::vector<entity::CADEntity_CSPtr> decode(const std::vector<size_t>& chunks);
+
+    // Weak, the document keeps the file alive as long as it isn't completely loaded
+    std::weak_ptr<storage::Document> _document;
+    std::unique_ptr<MappedFile> _file;
+    std::vector<meta::DocumentMetaType_CSPtr> _metaTypes;
+    std::vector<Chunk> _chunks;
+    geo::Area _bounds;
+    size_t _entityCount;
+    size_t _loadedChunks;
+};
+}
+}
@@ -48,6 +48,7 @@ void PatternProvider::loadPattern(std::string filename) {
     x.name = filename;
     x.boundingBox = entityContainer.boundingBox();
     x.entities = entityContainer.asVector();
+    x.compiled = std::make_shared<const lc::objects::CompiledPattern>(x.entities, x.boundingBox.maxP());
     _patterns[filename] = x;
     LOG_INFO << "Pattern Loaded " << filename << std::endl;
 }
@@ -55,6 +56,7 @@ void PatternProvider::loadPattern(std::string filename) {
 const Pattern& PatternProvider::getPattern(std::string filename) {
     //Upper case it
     std::transform(filename.begin(), filename.end(),filename.begin(), ::tolower);
+    std::lock_guard<std::mutex> lock(_mutex);
     try {
         auto pos = _patterns.find(filename);
         if (pos == _patterns.end()) {
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <map>
+#include <mutex>
 #include <cad/base/cadentity.h>
 #include <cad/storage/documentimpl.h>
 #include <cad/storage/storagemanagerimpl.h>
@@ -10,6 +11,11 @@ namespace lc {
 namespace persistence {
 typedef struct lc::objects::Pattern Pattern;
 
+/**
+ * @brief Load the hatch patterns on first use
+ * Each pattern is loaded and compiled once, the compiled pattern is shared by all the hatches using it.
+ * getPattern() can be called from several threads.
+ */
 class PatternProvider {
 public:
     static PatternProvider* Instance();
@@ -23,6 +29,7 @@ private:
     static PatternProvider* instance;
     std::map<std::string, std::string> _patternLocation;
     std::map<std::string, Pattern> _patterns;
+    std::mutex _mutex;
 };
 
 }
@@ -43,3 +43,42 @@ TEST(IntersectTest, LineLine2) {
     }
 }
 
+
+TEST(IntersectTest, IntersectMany) {
+    // Grid of 40 horizontal and 40 vertical lines, with a far away line which doesn't intersect anything
+    std::vector<lc::entity::CADEntity_CSPtr> entities;
+    for (int i = 0; i < 40; i++) {
+        entities.push_back(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(-1, i), lc::geo::Coordinate(40, i), nullptr, nullptr));
+        entities.push_back(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(i + 0.5, -1), lc::geo::Coordinate(i + 0.5, 40), nullptr, nullptr));
+    }
+    entities.push_back(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(100, 100), lc::geo::Coordinate(110, 110), nullptr, nullptr));
+
+    auto result = lc::maths::IntersectMany(entities).result();
+    EXPECT_EQ(40 * 40, result.size());
+    EXPECT_EQ(result, lc::maths::IntersectMany(entities).result()) << "Result should be deterministic";
+
+    lc::maths::Intersect intersect(lc::maths::Intersect::OnEntity, LCTOLERANCE);
+    for (size_t outer = 0; outer < entities.size(); outer++) {
+        for (size_t inner = outer + 1; inner < entities.size(); inner++) {
+            visitorDispatcher<bool, lc::GeoEntityVisitor>(intersect, *entities[outer].get(), *entities[inner].get());
+        }
+    }
+    EXPECT_EQ(intersect.result(), result) << "Result differs from the intersection of all the pairs";
+
+    EXPECT_EQ(40 * 40 + 2 * 40, lc::maths::IntersectMany(entities, lc::maths::Intersect::OnPath).result().size());
+}
+
+TEST(IntersectTest, IntersectAgainstOthers) {
+    std::vector<lc::entity::CADEntity_CSPtr> entities;
+    std::vector<lc::entity::CADEntity_CSPtr> others;
+    for (int i = 0; i < 10; i++) {
+        entities.push_back(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(-1, i), lc::geo::Coordinate(10, i), nullptr, nullptr));
+        others.push_back(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(i + 0.5, -1), lc::geo::Coordinate(i + 0.5, 10), nullptr, nullptr));
+    }
+
+    // Intersections within a set are ignored
+    others.push_back(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(-1, -1), lc::geo::Coordinate(10, -1), nullptr, nullptr));
+
+    lc::maths::IntersectAgainstOthers intersect(entities, others, lc::maths::Intersect::OnEntity, LCTOLERANCE);
+    EXPECT_EQ(10 * 10, intersect.result().size());
+}
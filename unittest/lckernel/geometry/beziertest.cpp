@@ -2,6 +2,7 @@
 #include "cad/geometry/geobezier.h"
 #include "cad/geometry/geobezierbase.h"
 #include "cad/geometry/geobeziercubic.h"
+#include "cad/geometry/geobeziertree.h"
 
 #include "cad/math/intersectionhandler.h"
 #include "cad/geometry/geovector.h"
@@ -10,6 +11,32 @@
 #define PI 3.14159265
 #define TRD PI/180
 
+namespace {
+/**
+ * Recursive subdivision on exact bounding boxes, the reference for the results of BezierTree
+ */
+void bezierBezierReference(const lc::geo::BB_CSPtr& B1, const lc::geo::BB_CSPtr& B2, std::vector<lc::geo::Coordinate>& ret) {
+    auto bb1 = B1->boundingBox();
+    auto bb2 = B2->boundingBox();
+
+    if(!bb1.overlaps(bb2)) {
+        return;
+    }
+
+    if(bb1.height() + bb2.height() <= BBHEURISTIC2 && bb1.width() + bb2.width() <= BBHEURISTIC2) {
+        ret.push_back(B1->getCP().at(1));
+        return;
+    }
+
+    auto b1split = B1->splitHalf();
+    auto b2split = B2->splitHalf();
+    bezierBezierReference(b1split[0], b2split[0], ret);
+    bezierBezierReference(b1split[1], b2split[0], ret);
+    bezierBezierReference(b1split[0], b2split[1], ret);
+    bezierBezierReference(b1split[1], b2split[1], ret);
+}
+}
+
 TEST(BEZIER_QUADRATIC, LENGTH) {
     auto p1 = lc::geo::Coordinate(50,230);
     auto p2 = lc::geo::Coordinate(50,50);
@@ -195,3 +222,72 @@ TEST(SPLINE, SPLINELINE) {
 
     ASSERT_EQ(result, expectedres);
 }
+
+TEST(BEZIER_CUBIC, SPLITHALF) {
+    auto bezier_ = lc::geo::CubicBezier(lc::geo::Coordinate(100,-500), lc::geo::Coordinate(300,1500),
+                                        lc::geo::Coordinate(600,-1500), lc::geo::Coordinate(1000,500));
+
+    lc::geo::BezierPoints first;
+    lc::geo::BezierPoints second;
+    lc::geo::BezierPoints(bezier_.getCP()).splitHalf(first, second);
+
+    auto expected = bezier_.splitHalf();
+    for(size_t i = 0; i < 4; i++) {
+        EXPECT_NEAR(expected[0]->getCP()[i].x(), first.points[i].x(), LCTOLERANCE);
+        EXPECT_NEAR(expected[0]->getCP()[i].y(), first.points[i].y(), LCTOLERANCE);
+        EXPECT_NEAR(expected[1]->getCP()[i].x(), second.points[i].x(), LCTOLERANCE);
+        EXPECT_NEAR(expected[1]->getCP()[i].y(), second.points[i].y(), LCTOLERANCE);
+    }
+}
+
+TEST(BEZIER_CUBIC, BEZIER) {
+    auto bezier_ = std::make_shared<lc::geo::CubicBezier>(lc::geo::Coordinate(0,0), lc::geo::Coordinate(0,100),
+                                                          lc::geo::Coordinate(100,0), lc::geo::Coordinate(100,100));
+    auto bezier_2 = std::make_shared<lc::geo::CubicBezier>(lc::geo::Coordinate(0,100), lc::geo::Coordinate(30,60),
+                                                           lc::geo::Coordinate(70,40), lc::geo::Coordinate(100,0));
+
+    auto ret = lc::maths::Intersection::bezierBezier(bezier_, bezier_2);
+    ASSERT_FALSE(ret.empty());
+    for(const auto& point : ret) {
+        EXPECT_NEAR(50, point.x(), BBHEURISTIC2);
+        EXPECT_NEAR(50, point.y(), BBHEURISTIC2);
+    }
+
+    auto bezier_3 = std::make_shared<lc::geo::CubicBezier>(lc::geo::Coordinate(0,200), lc::geo::Coordinate(30,160),
+                                                           lc::geo::Coordinate(70,140), lc::geo::Coordinate(100,100.1));
+    ASSERT_EQ(0, lc::maths::Intersection::bezierBezier(bezier_, bezier_3).size());
+}
+
+TEST(BEZIER_CUBIC, BEZIERPOINTS) {
+    std::vector<std::pair<lc::geo::BB_CSPtr, lc::geo::BB_CSPtr>> beziers = {
+        {
+            std::make_shared<lc::geo::CubicBezier>(lc::geo::Coordinate(0,0), lc::geo::Coordinate(0,100),
+                                                   lc::geo::Coordinate(100,0), lc::geo::Coordinate(100,100)),
+            std::make_shared<lc::geo::CubicBezier>(lc::geo::Coordinate(0,100), lc::geo::Coordinate(30,60),
+                                                   lc::geo::Coordinate(70,40), lc::geo::Coordinate(100,0))
+        },
+        {
+            std::make_shared<lc::geo::CubicBezier>(lc::geo::Coordinate(0,0), lc::geo::Coordinate(50,200),
+                                                   lc::geo::Coordinate(100,-100), lc::geo::Coordinate(150,50)),
+            std::make_shared<lc::geo::CubicBezier>(lc::geo::Coordinate(0,50), lc::geo::Coordinate(60,-80),
+                                                   lc::geo::Coordinate(90,180), lc::geo::Coordinate(150,0))
+        },
+        {
+            std::make_shared<lc::geo::Bezier>(lc::geo::Coordinate(0,0), lc::geo::Coordinate(50,100), lc::geo::Coordinate(100,0)),
+            std::make_shared<lc::geo::Bezier>(lc::geo::Coordinate(0,40), lc::geo::Coordinate(50,-60), lc::geo::Coordinate(100,40))
+        }
+    };
+
+    // The reported points are the second control point of the parts of the first curve, as before the trees
+    for(const auto& pair : beziers) {
+        std::vector<lc::geo::Coordinate> expected;
+        bezierBezierReference(pair.first, pair.second, expected);
+
+        auto ret = lc::maths::Intersection::bezierBezier(pair.first, pair.second);
+        ASSERT_EQ(expected.size(), ret.size());
+        for(size_t i = 0; i < ret.size(); i++) {
+            EXPECT_NEAR(expected[i].x(), ret[i].x(), LCTOLERANCE);
+            EXPECT_NEAR(expected[i].y(), ret[i].y(), LCTOLERANCE);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include "kerneltests.h"
+
+DocumentEventCounter::DocumentEventCounter(lc::storage::Document_SPtr document) :
+    commits(0),
+    batches(0),
+    singleAdds(0),
+    added(0),
+    removed(0),
+    _document(std::move(document)) {
+    _document->commitProcessEvent().connect<DocumentEventCounter, &DocumentEventCounter::onCommitProcessEvent>(this);
+    _document->batchEntityEvent().connect<DocumentEventCounter, &DocumentEventCounter::onBatchEntityEvent>(this);
+    _document->addEntityEvent().connect<DocumentEventCounter, &DocumentEventCounter::onAddEntityEvent>(this);
+}
+
+DocumentEventCounter::~DocumentEventCounter() {
+    _document->commitProcessEvent().disconnect<DocumentEventCounter, &DocumentEventCounter::onCommitProcessEvent>(this);
+    _document->batchEntityEvent().disconnect<DocumentEventCounter, &DocumentEventCounter::onBatchEntityEvent>(this);
+    _document->addEntityEvent().disconnect<DocumentEventCounter, &DocumentEventCounter::onAddEntityEvent>(this);
+}
+
+void DocumentEventCounter::onCommitProcessEvent(const lc::event::CommitProcessEvent& event) {
+    commits++;
+    operation = event.operation();
+}
+
+void DocumentEventCounter::onBatchEntityEvent(const lc::event::BatchEntityEvent& event) {
+    batches++;
+    added += event.added().size();
+    removed += event.removed().size();
+    lastAdded = event.added();
+}
+
+void DocumentEventCounter::onAddEntityEvent(const lc::event::AddEntityEvent& event) {
+    singleAdds++;
+}
+
+lc::entity::CADEntity_CSPtr createLine(double x, lc::meta::Layer_CSPtr layer) {
+    return createLine(lc::geo::Coordinate(x, 0), lc::geo::Coordinate(x, 100), std::move(layer));
+}
+
+lc::entity::CADEntity_CSPtr createLine(const lc::geo::Coordinate& start,
+                                       const lc::geo::Coordinate& end,
+                                       lc::meta::Layer_CSPtr layer) {
+    if (layer == nullptr) {
+        layer = std::make_shared<const lc::meta::Layer>();
+    }
+
+    return std::make_shared<lc::entity::Line>(start, end, layer);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cad/storage/document.h>
+#include <cad/operations/documentoperation.h>
+#include <cad/primitive/line.h>
+
+/**
+ * @brief Count the events emitted by a document
+ * The counter is connected to the document during its whole lifetime.
+ * The entities of the last batch event are kept in their order.
+ */
+class DocumentEventCounter {
+public:
+    explicit DocumentEventCounter(lc::storage::Document_SPtr document);
+
+    ~DocumentEventCounter();
+
+    int commits;
+    int batches;
+    int singleAdds;
+    size_t added;
+    size_t removed;
+    std::vector<lc::entity::CADEntity_CSPtr> lastAdded;
+    lc::operation::DocumentOperation_SPtr operation;
+
+private:
+    void onCommitProcessEvent(const lc::event::CommitProcessEvent& event);
+
+    void onBatchEntityEvent(const lc::event::BatchEntityEvent& event);
+
+    void onAddEntityEvent(const lc::event::AddEntityEvent& event);
+
+    lc::storage::Document_SPtr _document;
+};
+
+/**
+ * @brief Count the emissions of a signal without argument
+ */
+class SignalCounter {
+public:
+    SignalCounter() :
+        count(0) {
+    }
+
+    void onSignal() {
+        count++;
+    }
+
+    int count;
+};
+
+/**
+ * @brief Create a vertical line of length 100 starting at (x, 0)
+ * @param layer Layer of the line, a new layer is created if nullptr
+ */
+lc::entity::CADEntity_CSPtr createLine(double x, lc::meta::Layer_CSPtr layer = nullptr);
+
+lc::entity::CADEntity_CSPtr createLine(const lc::geo::Coordinate& start,
+                                       const lc::geo::Coordinate& end,
+                                       lc::meta::Layer_CSPtr layer = nullptr);
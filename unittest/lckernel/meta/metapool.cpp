@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <cad/meta/metapool.h>
+
+using namespace lc;
+using namespace meta;
+
+namespace {
+MetaInfo_SPtr createMetaInfo(double red, double width) {
+    auto metaInfo = MetaInfo::create();
+    metaInfo->add(std::make_shared<const MetaColorByValue>(red, 0., 0.));
+    metaInfo->add(std::make_shared<const MetaLineWidthByValue>(width));
+    return metaInfo;
+}
+}
+
+TEST(MetaPool, internMetaInfo) {
+    auto a = MetaPool::instance().intern(createMetaInfo(1., 0.5));
+    auto b = MetaPool::instance().intern(createMetaInfo(1., 0.5));
+    auto c = MetaPool::instance().intern(createMetaInfo(0., 0.5));
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a->lineWidth(), c->lineWidth());
+    EXPECT_EQ(a, MetaPool::instance().intern(a));
+    EXPECT_EQ(nullptr, MetaPool::instance().intern(MetaInfo::create()));
+}
+
+TEST(MetaPool, exactValues) {
+    // The IDs of these meta types are equal
+    auto opaque = MetaPool::instance().intern(std::make_shared<const MetaColorByValue>(1., 0., 0., 1.));
+    auto transparent = MetaPool::instance().intern(std::make_shared<const MetaColorByValue>(1., 0., 0., 0.5));
+    EXPECT_NE(opaque, transparent);
+    EXPECT_DOUBLE_EQ(0.5, std::dynamic_pointer_cast<const MetaColorByValue>(transparent)->alpha());
+
+    auto width = MetaPool::instance().intern(std::make_shared<const MetaLineWidthByValue>(0.1));
+    auto closeWidth = MetaPool::instance().intern(std::make_shared<const MetaLineWidthByValue>(0.1000001));
+    EXPECT_NE(width, closeWidth);
+    EXPECT_EQ(width, MetaPool::instance().intern(std::make_shared<const MetaLineWidthByValue>(0.1)));
+
+    auto a = MetaPool::instance().intern(MetaInfo::create()->add(opaque));
+    auto b = MetaPool::instance().intern(MetaInfo::create()->add(std::make_shared<const MetaColorByValue>(1., 0., 0., 0.5)));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(transparent, b->color());
+}
+
+TEST(MetaPool, linePatternNotMerged) {
+    auto patternA = std::make_shared<const DxfLinePatternByValue>("DASHED", "", std::vector<double>{1., -1.}, 2.);
+    auto patternB = std::make_shared<const DxfLinePatternByValue>("DASHED", "", std::vector<double>{2., -2.}, 4.);
+
+    auto a = MetaPool::instance().intern(MetaInfo::create()->add(patternA));
+    auto b = MetaPool::instance().intern(MetaInfo::create()->add(patternB));
+
+    EXPECT_NE(a, b);
+    EXPECT_EQ(patternB, b->linePattern());
+}
+
+TEST(MetaInfo, slots) {
+    auto metaInfo = createMetaInfo(1., 0.5);
+
+    ASSERT_NE(nullptr, metaInfo->color());
+    EXPECT_EQ(metaInfo->at(MetaColor::LCMETANAME()), metaInfo->color());
+    EXPECT_DOUBLE_EQ(0.5, std::dynamic_pointer_cast<const MetaLineWidthByValue>(metaInfo->lineWidth())->width());
+    EXPECT_EQ(nullptr, metaInfo->linePattern());
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <cad/objects/compiledpattern.h>
+#include <cad/geometry/georegion.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/arc.h>
+
+using namespace lc;
+using namespace objects;
+
+namespace {
+entity::CADEntity_CSPtr line(double x1, double y1, double x2, double y2) {
+    return std::make_shared<entity::Line>(geo::Coordinate(x1, y1), geo::Coordinate(x2, y2), nullptr);
+}
+
+double length(const geo::Vector& segment) {
+    return (segment.end() - segment.start()).magnitude();
+}
+}
+
+TEST(CompiledPatternTest, ContinuousLines) {
+    CompiledPattern pattern({line(0, 0, 10, 0)}, geo::Coordinate(10, 5));
+
+    ASSERT_EQ(1, pattern.families().size());
+    EXPECT_TRUE(pattern.families()[0].dashes.empty());
+    EXPECT_TRUE(pattern.tileEntities().empty());
+
+    auto segments = pattern.segments(geo::Area(geo::Coordinate(0, 0), geo::Coordinate(20, 20)), 1, 0);
+
+    // One line every 5 units, from y=0 to y=20
+    ASSERT_EQ(5, segments.size());
+    for (const auto& segment : segments) {
+        EXPECT_NEAR(20, length(segment), LCTOLERANCE);
+        EXPECT_NEAR(segment.start().y(), segment.end().y(), LCTOLERANCE);
+    }
+}
+
+TEST(CompiledPatternTest, Dashes) {
+    CompiledPattern pattern({line(0, 0, 4, 0)}, geo::Coordinate(10, 10));
+
+    ASSERT_EQ(1, pattern.families().size());
+    ASSERT_EQ(2, pattern.families()[0].dashes.size());
+    EXPECT_NEAR(4, pattern.families()[0].dashes[0], LCTOLERANCE);
+    EXPECT_NEAR(-6, pattern.families()[0].dashes[1], LCTOLERANCE);
+
+    auto segments = pattern.segments(geo::Area(geo::Coordinate(0, -1), geo::Coordinate(25, 1)), 1, 0);
+
+    ASSERT_EQ(3, segments.size());
+    for (const auto& segment : segments) {
+        EXPECT_NEAR(4, length(segment), LCTOLERANCE);
+    }
+
+    // Scaled pattern, dashes of 8 every 20 units
+    segments = pattern.segments(geo::Area(geo::Coordinate(0, -1), geo::Coordinate(25, 1)), 2, 0);
+    ASSERT_EQ(2, segments.size());
+    EXPECT_NEAR(8, length(segments[0]), LCTOLERANCE);
+    EXPECT_NEAR(5, length(segments[1]), LCTOLERANCE);
+}
+
+TEST(CompiledPatternTest, RotatedLines) {
+    CompiledPattern pattern({line(0, 0, 10, 0)}, geo::Coordinate(10, 10));
+
+    auto segments = pattern.segments(geo::Area(geo::Coordinate(-50, -50), geo::Coordinate(50, 50)), 1, M_PI / 2);
+
+    ASSERT_FALSE(segments.empty());
+    for (const auto& segment : segments) {
+        EXPECT_NEAR(segment.start().x(), segment.end().x(), LCTOLERANCE);
+        EXPECT_NEAR(0, std::remainder(segment.start().x(), 10), LCTOLERANCE);
+    }
+}
+
+TEST(CompiledPatternTest, DiagonalLines) {
+    // Slope of 1/2 on a square tile repeats every 2 tiles
+    CompiledPattern pattern({line(0, 0, 10, 5)}, geo::Coordinate(10, 10));
+
+    ASSERT_EQ(1, pattern.families().size());
+    ASSERT_EQ(2, pattern.families()[0].dashes.size());
+
+    auto dashLength = pattern.families()[0].dashes[0];
+    auto gapLength = -pattern.families()[0].dashes[1];
+    EXPECT_NEAR(std::sqrt(125), dashLength, LCTOLERANCE);
+    EXPECT_NEAR(std::sqrt(500) - std::sqrt(125), gapLength, LCTOLERANCE);
+}
+
+TEST(CompiledPatternTest, Region) {
+    CompiledPattern pattern({line(0, 0, 10, 0)}, geo::Coordinate(10, 5));
+
+    auto circle = std::make_shared<entity::Arc>(geo::Coordinate(5, 5), 3, 0, 2 * M_PI, true, nullptr);
+    geo::Region region({circle});
+
+    auto segments = pattern.segments(region, geo::Area(geo::Coordinate(-5, -5), geo::Coordinate(15, 15)), 1, 0);
+
+    ASSERT_EQ(1, segments.size());
+    EXPECT_NEAR(5, segments[0].start().y(), LCTOLERANCE);
+    EXPECT_NEAR(6, length(segments[0]), LCTOLERANCE);
+}
+
+TEST(CompiledPatternTest, TileEntities) {
+    auto arc = std::make_shared<entity::Arc>(geo::Coordinate(5, 5), 2, 0, M_PI, true, nullptr);
+
+    // Slope which doesn't repeat on the tile grid
+    CompiledPattern pattern({arc, line(0, 0, 1, std::sqrt(2))}, geo::Coordinate(10, 10));
+
+    EXPECT_TRUE(pattern.families().empty());
+    ASSERT_EQ(2, pattern.tileEntities().size());
+
+    auto entities = pattern.tileEntities(geo::Area(geo::Coordinate(0, 0), geo::Coordinate(19, 9)), 1, 0);
+    EXPECT_EQ(4, entities.size());
+}
@@ -3,6 +3,7 @@
 #include <cad/storage/storagemanagerimpl.h>
 #include <cad/operations/entitybuilder.h>
 #include <cad/primitive/line.h>
+#include "../kerneltests.h"
 
 TEST(EntityBuilderTest, Append) {
     auto storageManager = std::make_shared<lc::storage::StorageManagerImpl>();
@@ -325,4 +326,80 @@ TEST(EntityBuilderTest, SelectByLayer) {
 
     EXPECT_TRUE((firstEntity_isExpected1 && secondEntity_isExpected2) ||
                 (firstEntity_isExpected2 && secondEntity_isExpected1));
-}
\ No newline at end of file
+}
+
+TEST(EntityBuilderTest, FlushEntities) {
+    auto storageManager = std::make_shared<lc::storage::StorageManagerImpl>();
+    auto document = std::make_shared<lc::storage::DocumentImpl>(storageManager);
+    auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+    auto layer = std::make_shared<const lc::meta::Layer>();
+
+    DocumentEventCounter counter(document);
+
+    builder->appendEntity(createLine(0, layer));
+    builder->appendEntity(createLine(1, layer));
+    EXPECT_EQ(2, builder->flushEntities());
+    EXPECT_EQ(2, document->entityContainer().asVector().size()) << "Flushed entities are not in the document";
+    EXPECT_EQ(0, builder->flushEntities());
+
+    builder->appendEntity(createLine(2, layer));
+    EXPECT_EQ(1, builder->flushEntities());
+    builder->appendEntity(createLine(3, layer));
+    builder->execute();
+
+    EXPECT_EQ(4, document->entityContainer().asVector().size());
+    EXPECT_EQ(3, counter.batches) << "Expected one batch event per flush and one for the execution";
+    EXPECT_EQ(1, counter.commits);
+
+    builder->undo();
+    EXPECT_EQ(0, document->entityContainer().asVector().size()) << "Undo didn't remove the flushed entities";
+
+    builder->redo();
+    EXPECT_EQ(4, document->entityContainer().asVector().size());
+}
+
+TEST(EntityBuilderTest, LargeSetOrder) {
+    auto storageManager = std::make_shared<lc::storage::StorageManagerImpl>();
+    auto document = std::make_shared<lc::storage::DocumentImpl>(storageManager);
+    auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+    auto layer = std::make_shared<const lc::meta::Layer>();
+
+    DocumentEventCounter counter(document);
+
+    std::vector<lc::entity::CADEntity_CSPtr> lines;
+    for (int i = 0; i < 5000; i++) {
+        lines.push_back(createLine(i, layer));
+        builder->appendEntity(lines.back());
+    }
+
+    builder->appendOperation(std::make_shared<lc::operation::Push>());
+    builder->appendOperation(std::make_shared<lc::operation::Copy>(lc::geo::Coordinate(0, 0)));
+    builder->appendOperation(std::make_shared<lc::operation::Move>(lc::geo::Coordinate(0, 10)));
+    builder->appendOperation(std::make_shared<lc::operation::Loop>(3));
+    builder->execute();
+
+    // Each loop pushes the copies back with the entities they were made from, doubling the set
+    EXPECT_EQ(8 * lines.size(), document->entityContainer().asVector().size());
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        EXPECT_EQ(lines[i], document->entityByID(lines[i]->id())) << "Original entity was modified";
+    }
+
+    // Blocks of the result, in the order of the builder: originals first, then the copies of each pass
+    const double offsets[] = {0, 10, 10, 20, 10, 20, 20, 30};
+    const auto& entities = counter.lastAdded;
+    ASSERT_EQ(8 * lines.size(), entities.size());
+
+    for (size_t block = 0; block < 8; block++) {
+        for (size_t i = 0; i < lines.size(); i++) {
+            auto line = std::static_pointer_cast<const lc::entity::Line>(entities[block * lines.size() + i]);
+            ASSERT_EQ(i, line->start().x()) << "Entity " << i << " of block " << block << " is out of order";
+            ASSERT_EQ(offsets[block], line->start().y()) << "Block " << block << " is out of order";
+            EXPECT_EQ(100, line->end().y() - line->start().y());
+        }
+    }
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        EXPECT_EQ(lines[i], entities[i]);
+    }
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <cad/operations/transaction.h>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/operations/layerops.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/primitive/line.h>
+#include "../kerneltests.h"
+
+using namespace lc;
+using namespace storage;
+
+TEST(TransactionTest, Batch) {
+    auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+    auto layer = document->layerByName("0");
+
+    DocumentEventCounter counter(document);
+
+    document->batch([&]() {
+        for (int i = 0; i < 1000; i++) {
+            auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+            builder->appendEntity(createLine(i, layer));
+            builder->execute();
+        }
+
+        EXPECT_EQ(0, document->entityContainer().asVector().size());
+    });
+
+    EXPECT_EQ(1000, document->entityContainer().asVector().size());
+    EXPECT_EQ(1, counter.commits);
+    EXPECT_EQ(1, counter.batches);
+
+    auto transaction = std::dynamic_pointer_cast<lc::operation::Transaction>(counter.operation);
+    ASSERT_NE(nullptr, transaction);
+    EXPECT_EQ(1000, transaction->operationCount());
+
+    transaction->undo();
+    EXPECT_EQ(0, document->entityContainer().asVector().size());
+
+    transaction->redo();
+    EXPECT_EQ(1000, document->entityContainer().asVector().size());
+}
+
+TEST(TransactionTest, Order) {
+    auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+    auto layer = std::make_shared<meta::Layer>("1");
+
+    auto kept = createLine(0, layer);
+    auto removed = createLine(10, layer);
+
+    document->batch([&]() {
+        std::make_shared<lc::operation::AddLayer>(document, layer)->execute();
+
+        auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+        builder->appendEntity(kept);
+        builder->appendEntity(removed);
+        builder->execute();
+
+        // Removing an entity added in the same transaction
+        builder = std::make_shared<lc::operation::EntityBuilder>(document);
+        builder->appendOperation(std::make_shared<lc::operation::Push>());
+        builder->appendOperation(std::make_shared<lc::operation::Remove>());
+        builder->appendEntity(removed);
+        builder->execute();
+    });
+
+    EXPECT_EQ(layer, document->layerByName("1"));
+
+    auto entities = document->entityContainer().asVector();
+    ASSERT_EQ(1, entities.size());
+    EXPECT_EQ(kept, entities.front());
+}
+
+TEST(TransactionTest, Nested) {
+    auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+    auto layer = document->layerByName("0");
+
+    DocumentEventCounter counter(document);
+
+    document->batch([&]() {
+        document->batch([&]() {
+            auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+            builder->appendEntity(createLine(0, layer));
+            builder->execute();
+        });
+
+        auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+        builder->appendEntity(createLine(10, layer));
+        builder->execute();
+    });
+
+    EXPECT_EQ(2, document->entityContainer().asVector().size());
+    EXPECT_EQ(1, counter.commits);
+}
+
+TEST(TransactionTest, Discard) {
+    auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+    auto layer = document->layerByName("0");
+
+    DocumentEventCounter counter(document);
+
+    EXPECT_THROW(document->batch([&]() {
+        auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+        builder->appendEntity(createLine(0, layer));
+        builder->execute();
+
+        throw std::runtime_error("Script error");
+    }), std::runtime_error);
+
+    EXPECT_EQ(0, document->entityContainer().asVector().size());
+    EXPECT_EQ(0, counter.commits);
+
+    // The document isn't left in a transaction
+    auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+    builder->appendEntity(createLine(0, layer));
+    builder->execute();
+    EXPECT_EQ(1, document->entityContainer().asVector().size());
+    EXPECT_EQ(1, counter.commits);
+}
+
+TEST(TransactionTest, BatchInto) {
+    auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+    auto layer = document->layerByName("0");
+
+    DocumentEventCounter counter(document);
+    auto transaction = std::make_shared<lc::operation::Transaction>(document, "Job");
+
+    for (int i = 0; i < 3; i++) {
+        document->batchInto(transaction, [&]() {
+            document->batch([&]() {
+                auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+                builder->appendEntity(createLine(i, layer));
+                builder->execute();
+            });
+        });
+    }
+
+    EXPECT_EQ(0, document->entityContainer().asVector().size()) << "Operations should wait for the transaction";
+    EXPECT_EQ(0, counter.commits);
+    EXPECT_EQ(3, transaction->operationCount());
+
+    // The document isn't left in a transaction
+    auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+    builder->appendEntity(createLine(10, layer));
+    builder->execute();
+    EXPECT_EQ(1, counter.commits);
+
+    transaction->execute();
+    EXPECT_EQ(4, document->entityContainer().asVector().size());
+    EXPECT_EQ(2, counter.commits);
+    EXPECT_EQ(transaction, counter.operation);
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <cad/base/entityattributes.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+
+using namespace lc;
+
+TEST(EntityAttributesTest, Shared) {
+    auto layer = std::make_shared<const meta::Layer>("Shared");
+    auto otherLayer = std::make_shared<const meta::Layer>("Other");
+
+    auto line = std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 0), layer, nullptr);
+    auto circle = std::make_shared<entity::Circle>(geo::Coordinate(0, 0), 5, layer, nullptr);
+    auto other = std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 0), otherLayer, nullptr);
+
+    EXPECT_EQ(line->attributes(), circle->attributes());
+    EXPECT_NE(line->attributes(), other->attributes());
+    EXPECT_EQ(layer, circle->layer());
+    EXPECT_EQ(otherLayer, other->layer());
+
+    auto moved = line->move(geo::Coordinate(5, 5));
+    EXPECT_EQ(line->attributes(), moved->attributes());
+}
+
+TEST(EntityAttributesTest, Released) {
+    auto count = entity::EntityAttributes::count();
+
+    std::weak_ptr<const meta::Layer> weakLayer;
+    {
+        auto layer = std::make_shared<const meta::Layer>("Released");
+        weakLayer = layer;
+
+        auto line = std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 0), layer, nullptr);
+        EXPECT_EQ(count + 1, entity::EntityAttributes::count());
+    }
+
+    EXPECT_TRUE(weakLayer.expired());
+    EXPECT_EQ(count, entity::EntityAttributes::count());
+}
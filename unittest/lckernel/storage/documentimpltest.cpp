@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/meta/customentitystorage.h>
+#include <cad/operations/blockops.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/builders/insert.h>
+#include <cad/primitive/insert.h>
+#include <cad/primitive/line.h>
+#include "../kerneltests.h"
+
+TEST(DocumentImplTest, ApplyBatch) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+    DocumentEventCounter counter(document);
+
+    std::vector<lc::entity::CADEntity_CSPtr> lines;
+    for (int i = 0; i < 100; i++) {
+        lines.push_back(createLine(i));
+    }
+
+    document->applyBatch(lines, {}, {});
+
+    EXPECT_EQ(100, document->entityContainer().asVector().size());
+    EXPECT_EQ(1, counter.batches) << "Batch should emit a single event";
+    EXPECT_EQ(0, counter.singleAdds) << "Batch should not emit per entity events";
+    EXPECT_EQ(100, counter.added);
+
+    auto moved = lines[1]->move(lc::geo::Coordinate(10, 0));
+    document->applyBatch({}, {lines[0]}, {moved});
+
+    EXPECT_EQ(99, document->entityContainer().asVector().size());
+    EXPECT_EQ(nullptr, document->entityByID(lines[0]->id()));
+    EXPECT_EQ(moved, document->entityByID(lines[1]->id())) << "Entity was not replaced";
+    EXPECT_EQ(2, counter.batches);
+    EXPECT_EQ(101, counter.added);
+    EXPECT_EQ(2, counter.removed) << "Replaced entity should be reported as removed";
+
+    document->applyBatch({}, {}, {});
+    EXPECT_EQ(2, counter.batches) << "Empty batch should not emit an event";
+}
+
+TEST(DocumentImplTest, ApplyBatchDuplicateID) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+
+    auto line = createLine(0);
+    auto moved = line->move(lc::geo::Coordinate(10, 0));
+    document->applyBatch({line, moved}, {}, {});
+
+    EXPECT_EQ(1, document->entityContainer().asVector().size());
+    EXPECT_EQ(moved, document->entityByID(line->id())) << "Last version of an entity should win";
+}
+
+TEST(DocumentImplTest, ApplyBatchWaitingCustomEntities) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+
+    auto customEntityStorage = std::make_shared<lc::meta::CustomEntityStorage>("batchplugin", "entity", lc::geo::Coordinate());
+    std::make_shared<lc::operation::AddBlock>(document, customEntityStorage)->execute();
+
+    auto builder = lc::builder::InsertBuilder();
+    builder.setDisplayBlock(customEntityStorage);
+    builder.setDocument(document);
+    builder.setLayer(std::make_shared<lc::meta::Layer>());
+    auto insert = builder.build();
+
+    EXPECT_EQ(lc::entity::EntityTag::CustomEntityInsert, insert->entityTag());
+    EXPECT_EQ(lc::entity::EntityTag::Generic, createLine(0)->entityTag());
+
+    auto entityBuilder = std::make_shared<lc::operation::EntityBuilder>(document);
+    entityBuilder->appendEntity(insert);
+    entityBuilder->execute();
+    EXPECT_EQ(1, document->waitingCustomEntities("batchplugin").size());
+
+    entityBuilder->undo();
+    EXPECT_EQ(0, document->waitingCustomEntities("batchplugin").size());
+
+    entityBuilder->redo();
+    EXPECT_EQ(1, document->waitingCustomEntities("batchplugin").size());
+}
+
+TEST(DocumentImplTest, QueryArea) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+
+    std::vector<lc::entity::CADEntity_CSPtr> lines;
+    for (int i = 0; i < 1000; i++) {
+        lines.push_back(createLine(i * 10));
+    }
+    document->applyBatch(lines, {}, {});
+
+    lc::geo::Area area(lc::geo::Coordinate(-5, 10), lc::geo::Coordinate(95, 20));
+    auto expected = document->entityContainer().entitiesOverlappingArea(area);
+    ASSERT_EQ(10, expected.size());
+
+    std::vector<lc::entity::CADEntity_CSPtr> visited;
+    auto count = document->eachInArea(area, [&](const lc::entity::CADEntity_CSPtr& entity) {
+        visited.push_back(entity);
+    });
+
+    EXPECT_EQ(10, count);
+    EXPECT_EQ(10, document->countInArea(area));
+    EXPECT_TRUE(std::is_permutation(visited.begin(), visited.end(), expected.begin()));
+
+    auto ids = document->entityIDsInArea(area);
+    auto boundingBoxes = document->boundingBoxesInArea(area);
+    ASSERT_EQ(10, ids.size());
+    ASSERT_EQ(40, boundingBoxes.size());
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        auto entity = document->entityByID(ids[i]);
+        ASSERT_NE(nullptr, entity);
+        EXPECT_EQ(visited[i], entity) << "IDs are not in the order of eachInArea";
+        EXPECT_DOUBLE_EQ(entity->boundingBox().minP().x(), boundingBoxes[4 * i]);
+        EXPECT_DOUBLE_EQ(entity->boundingBox().maxP().y(), boundingBoxes[4 * i + 3]);
+    }
+
+    size_t total = 0;
+    EXPECT_EQ(1000, document->eachEntity([&](const lc::entity::CADEntity_CSPtr&) {
+        total++;
+    }));
+    EXPECT_EQ(1000, total);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/storage/intersectionindex.h>
+#include <cad/primitive/line.h>
+#include "../kerneltests.h"
+
+TEST(IntersectionIndexTest, Intersections) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+    auto& index = document->intersectionIndex();
+
+    auto horizontal = createLine(lc::geo::Coordinate(0, 50), lc::geo::Coordinate(100, 50));
+    auto vertical = createLine(lc::geo::Coordinate(50, 0), lc::geo::Coordinate(50, 100));
+    auto far = createLine(lc::geo::Coordinate(500, 0), lc::geo::Coordinate(500, 100));
+    document->applyBatch({horizontal, vertical, far}, {}, {});
+
+    auto points = index.intersections(horizontal, vertical);
+    ASSERT_EQ(1, points.size());
+    EXPECT_NEAR(50, points[0].x(), LCTOLERANCE);
+    EXPECT_NEAR(50, points[0].y(), LCTOLERANCE);
+    EXPECT_EQ(1, index.size());
+
+    EXPECT_EQ(1, index.intersections(vertical, horizontal).size());
+    EXPECT_EQ(1, index.size()) << "Pair was cached twice";
+
+    EXPECT_EQ(1, index.intersectionsWithDocument(horizontal).size());
+    EXPECT_EQ(0, index.intersectionsWithDocument(far).size());
+    EXPECT_EQ(1, index.intersectMany({horizontal, vertical, far}).size());
+}
+
+TEST(IntersectionIndexTest, Invalidation) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+    auto& index = document->intersectionIndex();
+
+    auto horizontal = createLine(lc::geo::Coordinate(0, 50), lc::geo::Coordinate(100, 50));
+    auto vertical = createLine(lc::geo::Coordinate(50, 0), lc::geo::Coordinate(50, 100));
+    document->insertEntity(horizontal);
+    document->insertEntity(vertical);
+
+    EXPECT_EQ(1, index.intersectionsWithDocument(vertical).size());
+    EXPECT_EQ(1, index.size());
+
+    auto moved = vertical->move(lc::geo::Coordinate(200, 0));
+    document->applyBatch({}, {}, {moved});
+    EXPECT_EQ(0, index.size()) << "Replaced entity was not invalidated";
+    EXPECT_EQ(0, index.intersectionsWithDocument(horizontal).size());
+
+    auto crossing = createLine(lc::geo::Coordinate(20, 0), lc::geo::Coordinate(20, 100));
+    document->insertEntity(crossing);
+    EXPECT_EQ(1, index.intersectionsWithDocument(horizontal).size()) << "Added entity was not found";
+
+    document->removeEntity(crossing);
+    EXPECT_EQ(0, index.size());
+    EXPECT_EQ(0, index.intersectionsWithDocument(horizontal).size());
+}
+
+TEST(IntersectionIndexTest, EntityOutsideDocument) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+    auto& index = document->intersectionIndex();
+
+    auto horizontal = createLine(lc::geo::Coordinate(0, 50), lc::geo::Coordinate(100, 50));
+    document->insertEntity(horizontal);
+
+    auto preview = createLine(lc::geo::Coordinate(50, 0), lc::geo::Coordinate(50, 100));
+    EXPECT_EQ(1, index.intersections(horizontal, preview).size());
+    EXPECT_EQ(1, index.intersectionsWithDocument(preview).size());
+    EXPECT_EQ(0, index.size()) << "Entity outside of the document should not be cached";
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <cad/storage/memoryreport.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/lwpolyline.h>
+
+using namespace lc;
+
+TEST(MemoryReportTest, Entities) {
+    auto layer = std::make_shared<const meta::Layer>("Report");
+    storage::EntityContainer<entity::CADEntity_CSPtr> container;
+
+    for (int i = 0; i < 10; i++) {
+        container.insert(std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), layer, nullptr));
+    }
+    container.insert(std::make_shared<entity::Circle>(geo::Coordinate(0, 0), 5, layer, nullptr));
+
+    std::vector<entity::LWVertex2D> vertices;
+    vertices.emplace_back(geo::Coordinate(0, 0));
+    vertices.emplace_back(geo::Coordinate(10, 0));
+    vertices.emplace_back(geo::Coordinate(10, 10));
+    auto polyline = std::make_shared<entity::LWPolyline>(vertices, 0, 0, 0, false, geo::Coordinate(0, 0, 1), layer, nullptr);
+    container.insert(polyline);
+
+    storage::MemoryReport report(container);
+    const auto& entities = report.entities();
+
+    ASSERT_EQ(1, entities.count("Line"));
+    EXPECT_EQ(10, entities.at("Line").count);
+    EXPECT_EQ(10 * sizeof(entity::Line), entities.at("Line").bytes);
+
+    ASSERT_EQ(1, entities.count("Circle"));
+    EXPECT_EQ(sizeof(entity::Circle), entities.at("Circle").bytes);
+
+    ASSERT_EQ(1, entities.count("LWPolyline"));
+    EXPECT_LT(sizeof(entity::LWPolyline) + 2 * sizeof(entity::Line), entities.at("LWPolyline").bytes);
+
+    EXPECT_EQ(12, report.entityCount());
+    EXPECT_EQ(1, report.attributesCount());
+    EXPECT_NE(std::string::npos, report.toString().find("Line"));
+}
@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/storage/entitycodec.h>
+#include <cad/storage/operationjournal.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/entityops.h>
+#include <cad/operations/blockops.h>
+#include <cad/operations/layerops.h>
+#include <cad/meta/metacolor.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+#include "../kerneltests.h"
+
+namespace {
+std::shared_ptr<lc::storage::DocumentImpl> createDocument() {
+    return std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+}
+
+lc::entity::CADEntity_CSPtr addLine(const lc::storage::Document_SPtr& document, double x) {
+    auto line = createLine(x, document->layerByName("0"));
+
+    auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+    builder->appendEntity(line);
+    builder->execute();
+
+    return line;
+}
+
+std::string journalPath() {
+    return testing::TempDir() + "librecad_operationjournal_test.lcj";
+}
+}
+
+TEST(EntityCodecTest, RoundTrip) {
+    auto document = createDocument();
+    auto layer = std::make_shared<const lc::meta::Layer>("Walls", lc::meta::MetaLineWidthByValue(0.5), lc::Color(255, 0, 0));
+    auto metaInfo = lc::meta::MetaInfo::create();
+    metaInfo->add(std::make_shared<const lc::meta::MetaColorByValue>(0., 1., 0., 1.));
+
+    std::vector<lc::entity::CADEntity_CSPtr> entities = {
+        std::make_shared<lc::entity::Line>(lc::geo::Coordinate(1, 2), lc::geo::Coordinate(3, 4), layer, metaInfo),
+        std::make_shared<lc::entity::Circle>(lc::geo::Coordinate(5, 6), 7, layer, metaInfo),
+        std::make_shared<lc::entity::Arc>(lc::geo::Coordinate(0, 0), 2, 0.5, 1.5, false, layer)
+    };
+
+    lc::storage::BinaryWriter writer;
+    lc::storage::EntityEncoder encoder(writer);
+    for (const auto& entity : entities) {
+        EXPECT_TRUE(encoder.write(entity));
+    }
+
+    lc::storage::BinaryReader reader(writer.buffer().data(), writer.buffer().size());
+    lc::storage::EntityDecoder decoder(document);
+    std::vector<lc::entity::CADEntity_CSPtr> decoded;
+    for (size_t i = 0; i < entities.size(); i++) {
+        decoded.push_back(decoder.read(reader));
+    }
+    EXPECT_TRUE(reader.atEnd());
+
+    auto newMetaTypes = decoder.takeNewMetaTypes();
+    ASSERT_EQ(1, newMetaTypes.size());
+    EXPECT_EQ("Walls", newMetaTypes[0]->name());
+
+    for (size_t i = 0; i < entities.size(); i++) {
+        EXPECT_EQ(entities[i]->id(), decoded[i]->id());
+        EXPECT_EQ("Walls", decoded[i]->layer()->name());
+    }
+
+    // Shared objects are decoded once
+    EXPECT_EQ(decoded[0]->layer(), decoded[2]->layer());
+    EXPECT_EQ(decoded[0]->metaInfo(), decoded[1]->metaInfo());
+    auto color = decoded[0]->metaInfo<lc::meta::MetaColorByValue>(lc::meta::MetaColor::LCMETANAME());
+    ASSERT_NE(nullptr, color);
+    EXPECT_DOUBLE_EQ(1., color->green());
+
+    auto line = std::dynamic_pointer_cast<const lc::entity::Line>(decoded[0]);
+    ASSERT_NE(nullptr, line);
+    EXPECT_EQ(lc::geo::Coordinate(3, 4), line->end());
+
+    auto arc = std::dynamic_pointer_cast<const lc::entity::Arc>(decoded[2]);
+    ASSERT_NE(nullptr, arc);
+    EXPECT_DOUBLE_EQ(1.5, arc->endAngle());
+    EXPECT_FALSE(arc->CCW());
+    EXPECT_EQ(nullptr, arc->metaInfo());
+}
+
+TEST(OperationJournalTest, Replay) {
+    auto path = journalPath();
+    auto document = createDocument();
+    addLine(document, 0);
+
+    {
+        lc::storage::OperationJournal journal(document, path);
+
+        auto line = addLine(document, 10);
+        addLine(document, 20);
+
+        auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+        builder->appendEntity(line);
+        builder->appendOperation(std::make_shared<lc::operation::Push>());
+        builder->appendOperation(std::make_shared<lc::operation::Move>(lc::geo::Coordinate(0, 5)));
+        builder->execute();
+
+        // Changes made outside of an operation
+        builder->undo();
+        builder->redo();
+
+        journal.flush();
+    }
+
+    // Checkpoint, three operations, undo and redo with one record each
+    auto restored = createDocument();
+    EXPECT_EQ(6, lc::storage::OperationJournal::replay(restored, path));
+
+    auto expected = document->entityContainer().asVector();
+    ASSERT_EQ(expected.size(), restored->entityContainer().asVector().size());
+
+    for (const auto& entity : expected) {
+        auto line = std::dynamic_pointer_cast<const lc::entity::Line>(restored->entityByID(entity->id()));
+        ASSERT_NE(nullptr, line);
+        EXPECT_EQ(std::static_pointer_cast<const lc::entity::Line>(entity)->start(), line->start());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(OperationJournalTest, BatchRecord) {
+    auto path = journalPath();
+    auto document = createDocument();
+    auto layer = document->layerByName("0");
+
+    std::vector<lc::entity::CADEntity_CSPtr> lines;
+    for (int i = 0; i < 10; i++) {
+        lines.push_back(createLine(i, layer));
+    }
+
+    {
+        lc::storage::OperationJournal journal(document, path);
+
+        document->applyBatch(lines, {}, {});
+
+        auto moved = lines[0]->move(lc::geo::Coordinate(0, 5));
+        document->applyBatch({}, {lines[1]}, {moved});
+
+        journal.flush();
+    }
+
+    // Checkpoint and one record per batch, the replace isn't split in a removal and an insertion
+    auto restored = createDocument();
+    EXPECT_EQ(3, lc::storage::OperationJournal::replay(restored, path));
+    EXPECT_EQ(9, restored->entityContainer().asVector().size());
+    auto line = std::dynamic_pointer_cast<const lc::entity::Line>(restored->entityByID(lines[0]->id()));
+    ASSERT_NE(nullptr, line);
+    EXPECT_EQ(lc::geo::Coordinate(0, 5), line->start());
+    EXPECT_EQ(nullptr, restored->entityByID(lines[1]->id()));
+
+    std::remove(path.c_str());
+}
+
+TEST(OperationJournalTest, Checkpoint) {
+    auto path = journalPath();
+    auto document = createDocument();
+
+    {
+        lc::storage::OperationJournal journal(document, path, 2);
+
+        for (int i = 0; i < 5; i++) {
+            addLine(document, i);
+        }
+
+        journal.flush();
+    }
+
+    // Initial checkpoint, replaced after the second and fourth transactions, followed by the fifth transaction
+    auto restored = createDocument();
+    EXPECT_EQ(2, lc::storage::OperationJournal::replay(restored, path));
+    EXPECT_EQ(5, restored->entityContainer().asVector().size());
+
+    std::remove(path.c_str());
+}
+
+TEST(OperationJournalTest, MetaTypes) {
+    auto path = journalPath();
+    auto document = createDocument();
+    auto walls = std::make_shared<const lc::meta::Layer>("Walls", lc::meta::MetaLineWidthByValue(0.5), lc::Color(255, 0, 0));
+    std::make_shared<lc::operation::AddLayer>(document, walls)->execute();
+
+    auto line = createLine(0, walls);
+    auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+    builder->appendEntity(line);
+    builder->execute();
+
+    {
+        lc::storage::OperationJournal journal(document, path);
+
+        // Empty layer, and a layer replaced together with its entities
+        auto doors = std::make_shared<const lc::meta::Layer>("Doors", lc::meta::MetaLineWidthByValue(0.25), lc::Color(0, 0, 255));
+        std::make_shared<lc::operation::AddLayer>(document, doors)->execute();
+
+        auto blueWalls = std::make_shared<const lc::meta::Layer>("Walls", lc::meta::MetaLineWidthByValue(0.5), lc::Color(0, 0, 255));
+        std::make_shared<lc::operation::ReplaceLayer>(document, walls, blueWalls)->execute();
+
+        auto door = std::make_shared<const lc::meta::Block>("Door", lc::geo::Coordinate(1, 2));
+        auto window = std::make_shared<const lc::meta::Block>("Window");
+        std::make_shared<lc::operation::AddBlock>(document, door)->execute();
+        std::make_shared<lc::operation::AddBlock>(document, window)->execute();
+        std::make_shared<lc::operation::RemoveBlock>(document, window)->execute();
+
+        journal.flush();
+    }
+
+    auto restored = createDocument();
+    EXPECT_EQ(6, lc::storage::OperationJournal::replay(restored, path));
+
+    ASSERT_NE(nullptr, restored->layerByName("Doors"));
+    EXPECT_DOUBLE_EQ(1., restored->layerByName("Doors")->color().blue());
+
+    auto restoredWalls = restored->layerByName("Walls");
+    ASSERT_NE(nullptr, restoredWalls);
+    EXPECT_DOUBLE_EQ(1., restoredWalls->color().blue());
+
+    auto restoredLine = restored->entityByID(line->id());
+    ASSERT_NE(nullptr, restoredLine);
+    EXPECT_EQ(restoredWalls, restoredLine->layer()) << "Entities should use the layer of the document";
+
+    auto door = restored->blockByName("Door");
+    ASSERT_NE(nullptr, door);
+    EXPECT_EQ(lc::geo::Coordinate(1, 2), door->base());
+    EXPECT_EQ(nullptr, restored->blockByName("Window"));
+
+    std::remove(path.c_str());
+}
+
+TEST(OperationJournalTest, MetaTypesCheckpoint) {
+    auto path = journalPath();
+    auto document = createDocument();
+
+    // The first layer of the document is replaced by its journaled version
+    auto redLayer = std::make_shared<const lc::meta::Layer>("0", lc::meta::MetaLineWidthByValue(1.0), lc::Color(255, 0, 0));
+    std::make_shared<lc::operation::ReplaceLayer>(document, document->layerByName("0"), redLayer)->execute();
+    std::make_shared<lc::operation::AddLayer>(document, std::make_shared<const lc::meta::Layer>("Empty"))->execute();
+    std::make_shared<lc::operation::AddBlock>(document, std::make_shared<const lc::meta::Block>("Door"))->execute();
+
+    {
+        lc::storage::OperationJournal journal(document, path);
+        journal.flush();
+    }
+
+    auto restored = createDocument();
+    EXPECT_EQ(1, lc::storage::OperationJournal::replay(restored, path));
+    EXPECT_DOUBLE_EQ(0., restored->layerByName("0")->color().green());
+    EXPECT_NE(nullptr, restored->layerByName("Empty"));
+    EXPECT_NE(nullptr, restored->blockByName("Door"));
+
+    std::remove(path.c_str());
+}
+
+TEST(OperationJournalTest, TruncatedRecord) {
+    auto path = journalPath();
+    auto document = createDocument();
+
+    {
+        lc::storage::OperationJournal journal(document, path);
+        addLine(document, 0);
+        addLine(document, 10);
+        journal.flush();
+    }
+
+    std::string data;
+    {
+        std::ifstream stream(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    // Simulate a crash while writing the last record
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(data.data(), data.size() - 3);
+    }
+
+    auto restored = createDocument();
+    EXPECT_EQ(2, lc::storage::OperationJournal::replay(restored, path));
+    EXPECT_EQ(1, restored->entityContainer().asVector().size());
+
+    // Corrupt the payload of the last record
+    data[data.size() - 1] ^= 0xFF;
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(data.data(), data.size());
+    }
+
+    restored = createDocument();
+    EXPECT_EQ(2, lc::storage::OperationJournal::replay(restored, path));
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/storage/undomanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/primitive/line.h>
+#include "../kerneltests.h"
+
+namespace {
+struct UndoFixture {
+    UndoFixture(unsigned int levels, size_t budget = lc::storage::UndoManagerImpl::DEFAULT_MEMORY_BUDGET) :
+        document(std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>())),
+        undoManager(std::make_shared<lc::storage::UndoManagerImpl>(levels, budget)) {
+        document->commitProcessEvent().connect<lc::storage::UndoManagerImpl, &lc::storage::UndoManagerImpl::on_CommitProcessEvent>(undoManager.get());
+    }
+
+    ~UndoFixture() {
+        document->commitProcessEvent().disconnect<lc::storage::UndoManagerImpl, &lc::storage::UndoManagerImpl::on_CommitProcessEvent>(undoManager.get());
+    }
+
+    lc::entity::CADEntity_CSPtr addLine(double x) {
+        auto line = createLine(x);
+
+        auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+        builder->appendEntity(line);
+        builder->execute();
+
+        return line;
+    }
+
+    void moveEntity(const lc::entity::CADEntity_CSPtr& entity) {
+        auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+        builder->appendEntity(entity);
+        builder->appendOperation(std::make_shared<lc::operation::Push>());
+        builder->appendOperation(std::make_shared<lc::operation::Move>(lc::geo::Coordinate(10, 0)));
+        builder->execute();
+    }
+
+    size_t size() {
+        return document->entityContainer().asVector().size();
+    }
+
+    std::shared_ptr<lc::storage::DocumentImpl> document;
+    lc::storage::UndoManagerImpl_SPtr undoManager;
+};
+}
+
+TEST(UndoManagerImplTest, UndoRedo) {
+    UndoFixture fixture(10);
+
+    fixture.addLine(0);
+    fixture.addLine(1);
+    EXPECT_EQ(2, fixture.size());
+    EXPECT_TRUE(fixture.undoManager->canUndo());
+    EXPECT_FALSE(fixture.undoManager->canRedo());
+
+    fixture.undoManager->undo();
+    EXPECT_EQ(1, fixture.size());
+    EXPECT_TRUE(fixture.undoManager->canRedo());
+
+    fixture.undoManager->redo();
+    EXPECT_EQ(2, fixture.size());
+
+    fixture.undoManager->undo();
+    auto memoryUsage = fixture.undoManager->memoryUsage();
+    fixture.addLine(2);
+    EXPECT_FALSE(fixture.undoManager->canRedo()) << "New operation should clear redo entries";
+    EXPECT_EQ(memoryUsage, fixture.undoManager->memoryUsage()) << "Redo entry memory was not released";
+
+    fixture.undoManager->removeUndoables();
+    EXPECT_FALSE(fixture.undoManager->canUndo());
+    EXPECT_EQ(0, fixture.undoManager->memoryUsage());
+}
+
+TEST(UndoManagerImplTest, Compaction) {
+    UndoFixture fixture(2);
+
+    auto line = fixture.addLine(0);
+    fixture.moveEntity(line);
+    fixture.addLine(1);
+    fixture.addLine(2);
+    EXPECT_EQ(3, fixture.size());
+
+    // The first three small operations are compacted into a single delta
+    fixture.undoManager->undo();
+    EXPECT_EQ(2, fixture.size());
+
+    fixture.undoManager->undo();
+    EXPECT_EQ(0, fixture.size()) << "Compacted operations were not undone";
+    EXPECT_FALSE(fixture.undoManager->canUndo());
+
+    fixture.undoManager->redo();
+    EXPECT_EQ(2, fixture.size());
+
+    auto moved = std::dynamic_pointer_cast<const lc::entity::Line>(fixture.document->entityByID(line->id()));
+    ASSERT_NE(nullptr, moved);
+    EXPECT_EQ(10, moved->start().x()) << "Compacted delta should keep the last version of an entity";
+
+    fixture.undoManager->redo();
+    EXPECT_EQ(3, fixture.size());
+    EXPECT_FALSE(fixture.undoManager->canRedo());
+}
+
+TEST(UndoManagerImplTest, MemoryBudget) {
+    UndoFixture fixture(100, 1);
+    std::vector<lc::operation::Undoable_SPtr> spilled;
+    fixture.undoManager->setSpillHandler([&spilled](const lc::operation::Undoable_SPtr& undoable) {
+        spilled.push_back(undoable);
+    });
+
+    fixture.addLine(0);
+    fixture.addLine(1);
+    fixture.addLine(2);
+
+    EXPECT_EQ(2, spilled.size()) << "Operations out of the budget should be spilled";
+    EXPECT_TRUE(fixture.undoManager->canUndo()) << "Last operation should be kept";
+
+    fixture.undoManager->undo();
+    EXPECT_FALSE(fixture.undoManager->canUndo());
+    EXPECT_EQ(2, fixture.size());
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <cad/tools/kdtree.h>
+
+using namespace lc;
+
+TEST(KdTreeTest, Empty) {
+    tools::KdTree tree;
+    size_t index;
+
+    EXPECT_TRUE(tree.empty());
+    EXPECT_FALSE(tree.nearest(geo::Coordinate(0, 0), 100, index));
+}
+
+TEST(KdTreeTest, MaxDistance) {
+    tools::KdTree tree({geo::Coordinate(10, 0), geo::Coordinate(0, 20)});
+    size_t index;
+
+    EXPECT_FALSE(tree.nearest(geo::Coordinate(0, 0), 5, index));
+
+    ASSERT_TRUE(tree.nearest(geo::Coordinate(0, 0), 15, index));
+    EXPECT_EQ(0, index);
+
+    ASSERT_TRUE(tree.nearest(geo::Coordinate(0, 15), 15, index));
+    EXPECT_EQ(1, index);
+}
+
+TEST(KdTreeTest, Nearest) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-1000, 1000);
+
+    std::vector<geo::Coordinate> points;
+    for (int i = 0; i < 2000; i++) {
+        points.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    tools::KdTree tree(points);
+    EXPECT_EQ(points.size(), tree.size());
+
+    for (int i = 0; i < 200; i++) {
+        geo::Coordinate query(distribution(generator), distribution(generator));
+
+        size_t expected = 0;
+        for (size_t j = 1; j < points.size(); j++) {
+            if (points[j].distanceTo(query) < points[expected].distanceTo(query)) {
+                expected = j;
+            }
+        }
+
+        size_t index;
+        ASSERT_TRUE(tree.nearest(query, 5000, index));
+        EXPECT_EQ(expected, index);
+    }
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cad/tools/poolallocator.h>
+#include <cad/builders/line.h>
+#include <cad/meta/layer.h>
+#include <cad/primitive/line.h>
+
+using namespace lc;
+
+namespace {
+/**
+ * @brief Object with the size of a small entity
+ */
+struct Payload {
+    Payload(double value) : values{value} {
+    }
+
+    double values[8];
+};
+
+/**
+ * @brief Return a field of /proc/self/status in kB, 0 when it isn't available
+ */
+size_t processStatus(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size() + 1, field + ":") == 0) {
+            return std::stoul(line.substr(field.size() + 1));
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Allocate and release objects, and print the time and the memory used
+ * The peak RSS can only be reset on Linux, elsewhere it is the peak of the process.
+ */
+template<typename Make>
+void benchmark(const char* name, Make make) {
+    const int objects = 1000000;
+    const int rounds = 5;
+
+    std::ofstream("/proc/self/clear_refs") << "5";
+    auto startRSS = processStatus("VmRSS");
+    auto start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < rounds; round++) {
+        std::vector<std::shared_ptr<Payload>> values;
+        values.reserve(objects);
+
+        for (int i = 0; i < objects; i++) {
+            values.push_back(make(i));
+        }
+    }
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << static_cast<size_t>(rounds * objects / duration.count()) << " objects/s"
+              << ", RSS start " << startRSS << " kB"
+              << ", peak " << processStatus("VmHWM") << " kB"
+              << ", final " << processStatus("VmRSS") << " kB"
+              << ", reserved by the pool " << tools::Pool::statistics().reservedBytes / 1024 << " kB" << std::endl;
+}
+}
+
+TEST(PoolAllocatorTest, ReuseBlock) {
+    auto block = tools::Pool::allocate(48);
+    tools::Pool::deallocate(block, 48);
+
+    EXPECT_EQ(block, tools::Pool::allocate(40));
+    tools::Pool::deallocate(block, 40);
+}
+
+TEST(PoolAllocatorTest, Statistics) {
+    auto before = tools::Pool::statistics();
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; i++) {
+        blocks.push_back(tools::Pool::allocate(64));
+    }
+
+    auto allocated = tools::Pool::statistics();
+    EXPECT_EQ(before.allocations + 1000, allocated.allocations);
+    EXPECT_EQ(before.deallocations, allocated.deallocations);
+    EXPECT_LE(1000 * 64, allocated.reservedBytes);
+
+    for (auto block : blocks) {
+        tools::Pool::deallocate(block, 64);
+    }
+
+    auto released = tools::Pool::statistics();
+    EXPECT_EQ(before.deallocations + 1000, released.deallocations);
+}
+
+TEST(PoolAllocatorTest, ReleaseSlabs) {
+    // A size class unused by the other tests, 63 blocks per slab
+    const size_t size = 1000;
+    const size_t slabSize = 64 * 1024;
+    auto before = tools::Pool::statistics();
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 63 * 20; i++) {
+        blocks.push_back(tools::Pool::allocate(size));
+    }
+    EXPECT_LE(before.reservedBytes + 19 * slabSize, tools::Pool::statistics().reservedBytes);
+
+    for (auto block : blocks) {
+        tools::Pool::deallocate(block, size);
+    }
+
+    // The thread cache holds up to two slabs, and one free slab is kept
+    EXPECT_GE(before.reservedBytes + 3 * slabSize, tools::Pool::statistics().reservedBytes);
+}
+
+TEST(PoolAllocatorTest, DISABLED_Benchmark) {
+    benchmark("make_shared", [](int i) {
+        return std::make_shared<Payload>(i);
+    });
+
+    benchmark("makePooled", [](int i) {
+        return tools::makePooled<Payload>(i);
+    });
+}
+
+TEST(PoolAllocatorTest, ReleaseFromOtherThread) {
+    std::vector<std::shared_ptr<int>> values;
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(tools::makePooled<int>(i));
+    }
+
+    std::thread thread([&values]() {
+        for (size_t i = 0; i < values.size(); i++) {
+            EXPECT_EQ(static_cast<int>(i), *values[i]);
+        }
+        values.clear();
+    });
+    thread.join();
+
+    EXPECT_TRUE(values.empty());
+    EXPECT_EQ(5, *tools::makePooled<int>(5));
+}
+
+TEST(PoolAllocatorTest, Entities) {
+    auto layer = std::make_shared<meta::Layer>();
+
+    builder::LineBuilder builder;
+    builder.setStart(geo::Coordinate(0, 0));
+    builder.setEnd(geo::Coordinate(100, 0));
+    builder.setLayer(layer);
+
+    auto before = tools::Pool::statistics();
+    auto line = builder.build();
+    auto moved = std::dynamic_pointer_cast<const entity::Line>(line->move(geo::Coordinate(0, 10)));
+    auto after = tools::Pool::statistics();
+
+    // Object and control block of the built line, one block for the moved line
+    EXPECT_EQ(before.allocations + 3, after.allocations);
+
+    ASSERT_NE(nullptr, moved);
+    EXPECT_EQ(geo::Coordinate(0, 10), moved->start());
+    EXPECT_EQ(geo::Coordinate(100, 10), moved->end());
+    EXPECT_EQ(layer, moved->layer());
+
+    line.reset();
+    moved.reset();
+    EXPECT_EQ(after.deallocations + 3, tools::Pool::statistics().deallocations);
+}
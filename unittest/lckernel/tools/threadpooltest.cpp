@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <cad/tools/threadpool.h>
+
+TEST(ThreadPoolTest, ParallelFor) {
+    lc::tools::ThreadPool pool(3);
+    EXPECT_EQ(4, pool.concurrency());
+
+    std::vector<int> values(10000, 0);
+    pool.parallelFor(values.size(), 100, [&values](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            values[i] += i;
+        }
+    });
+
+    for (size_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(i, values[i]) << "Index processed zero or multiple times";
+    }
+}
+
+TEST(ThreadPoolTest, SmallRange) {
+    lc::tools::ThreadPool pool(3);
+    std::atomic<int> calls(0);
+
+    pool.parallelFor(50, 100, [&calls](size_t begin, size_t end) {
+        EXPECT_EQ(0, begin);
+        EXPECT_EQ(50, end);
+        calls++;
+    });
+    EXPECT_EQ(1, calls) << "Small range should not be split";
+
+    pool.parallelFor(0, 100, [&calls](size_t begin, size_t end) {
+        calls++;
+    });
+    EXPECT_EQ(1, calls) << "Empty range should not call the function";
+}
+
+TEST(ThreadPoolTest, Exception) {
+    lc::tools::ThreadPool pool(3);
+
+    EXPECT_THROW(pool.parallelFor(1000, 10, [](size_t begin, size_t end) {
+        if (begin == 0) {
+            throw std::runtime_error("error");
+        }
+    }), std::runtime_error);
+
+    // Pool still usable after an exception
+    std::atomic<size_t> count(0);
+    pool.parallelFor(1000, 10, [&count](size_t begin, size_t end) {
+        count += end - begin;
+    });
+    EXPECT_EQ(1000, count);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "documentcanvas.h"
+#include "drawables/tempentities.h"
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/meta/layer.h>
+#include <cad/primitive/line.h>
+#include "../lckernel/kerneltests.h"
+
+TEST(TempEntitiesTest, CoalesceUpdates) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+    auto docCanvas = std::make_shared<lc::viewer::DocumentCanvas>(document);
+    auto layer = std::make_shared<lc::meta::Layer>();
+
+    lc::viewer::drawable::TempEntities tempEntities(docCanvas);
+    SignalCounter updates;
+    tempEntities.requestUpdateEvent().connect<SignalCounter, &SignalCounter::onSignal>(&updates);
+
+    std::vector<lc::entity::CADEntity_CSPtr> lines;
+    for (int i = 0; i < 100; i++) {
+        lines.push_back(createLine(i, layer));
+        tempEntities.addEntity(lines.back());
+    }
+    tempEntities.setOffset(lc::geo::Coordinate(5, 5));
+
+    EXPECT_EQ(100, tempEntities.size());
+    EXPECT_EQ(1, updates.count) << "Update requested before the view was drawn";
+}
+
+TEST(TempEntitiesTest, ReplaceAndRemove) {
+    auto document = std::make_shared<lc::storage::DocumentImpl>(std::make_shared<lc::storage::StorageManagerImpl>());
+    auto docCanvas = std::make_shared<lc::viewer::DocumentCanvas>(document);
+    auto layer = std::make_shared<lc::meta::Layer>();
+
+    lc::viewer::drawable::TempEntities tempEntities(docCanvas);
+
+    auto first = createLine(0, layer);
+    auto second = createLine(10, layer);
+    auto third = createLine(20, layer);
+    tempEntities.addEntities({first, second, third});
+    EXPECT_EQ(3, tempEntities.size());
+
+    // Same ID, replaces the first line
+    auto moved = first->move(lc::geo::Coordinate(0, 5));
+    tempEntities.addEntity(moved);
+    EXPECT_EQ(3, tempEntities.size());
+
+    tempEntities.removeEntity(first);
+    EXPECT_EQ(2, tempEntities.size());
+
+    tempEntities.removeEntities({second, third});
+    EXPECT_EQ(0, tempEntities.size());
+}
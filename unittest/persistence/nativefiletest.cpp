@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/operations/blockops.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/layerops.h>
+#include <cad/builders/insert.h>
+#include <cad/builders/line.h>
+#include <cad/primitive/insert.h>
+#include <file.h>
+#include <native/nativefile.h>
+#include "../lckernel/kerneltests.h"
+
+using namespace lc;
+
+namespace {
+const char* NATIVE_TEST_FILE = "nativefiletest.lcad";
+
+storage::Document_SPtr createDocument() {
+    return std::make_shared<storage::DocumentImpl>(std::make_shared<storage::StorageManagerImpl>());
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(content.data(), content.size());
+}
+}
+
+TEST(NativeFileTest, SaveOpen) {
+    auto document = createDocument();
+
+    auto layer = std::make_shared<const meta::Layer>("Walls", meta::MetaLineWidthByValue(0.5), Color(255, 0, 0));
+    auto block = std::make_shared<const meta::Block>("Door", geo::Coordinate(1, 2));
+    std::make_shared<operation::AddLayer>(document, layer)->execute();
+    std::make_shared<operation::AddBlock>(document, block)->execute();
+
+    auto entityBuilder = std::make_shared<operation::EntityBuilder>(document);
+    std::vector<entity::CADEntity_CSPtr> lines;
+    for (int i = 0; i < 10; i++) {
+        lines.push_back(createLine(i, layer));
+        entityBuilder->appendEntity(lines.back());
+    }
+
+    builder::LineBuilder lineBuilder;
+    lineBuilder.setStart(geo::Coordinate(0, 0));
+    lineBuilder.setEnd(geo::Coordinate(1, 1));
+    lineBuilder.setLayer(layer);
+    lineBuilder.setBlock(block);
+    auto blockLine = lineBuilder.build();
+    entityBuilder->appendEntity(blockLine);
+
+    builder::InsertBuilder insertBuilder;
+    insertBuilder.setDisplayBlock(block);
+    insertBuilder.setDocument(document);
+    insertBuilder.setLayer(layer);
+    insertBuilder.setCoordinate(geo::Coordinate(5, 5));
+    auto insert = insertBuilder.build();
+    entityBuilder->appendEntity(insert);
+
+    entityBuilder->execute();
+
+    persistence::File::save(document, NATIVE_TEST_FILE, persistence::File::LIBRECAD_NATIVE);
+
+    auto opened = createDocument();
+    EXPECT_EQ(persistence::File::LIBRECAD_NATIVE, persistence::File::open(opened, NATIVE_TEST_FILE, persistence::File::NATIVE));
+    std::remove(NATIVE_TEST_FILE);
+
+    auto openedLayer = opened->layerByName("Walls");
+    ASSERT_NE(nullptr, openedLayer);
+    EXPECT_EQ(layer->color().red(), openedLayer->color().red());
+    EXPECT_EQ(layer->lineWidth().width(), openedLayer->lineWidth().width());
+
+    auto openedBlock = opened->blockByName("Door");
+    ASSERT_NE(nullptr, openedBlock);
+    EXPECT_EQ(block->base(), openedBlock->base());
+
+    // Only the entities of the blocks are loaded by open
+    ASSERT_NE(nullptr, opened->entityLoader());
+    EXPECT_EQ(0, opened->entityContainer().asVector().size());
+    opened->loadAll();
+    EXPECT_EQ(nullptr, opened->entityLoader());
+
+    EXPECT_EQ(11, opened->entityContainer().asVector().size());
+    for (const auto& line : lines) {
+        auto openedLine = std::dynamic_pointer_cast<const entity::Line>(opened->entityByID(line->id()));
+        ASSERT_NE(nullptr, openedLine);
+        EXPECT_EQ(std::static_pointer_cast<const entity::Line>(line)->start(), openedLine->start());
+        EXPECT_EQ(openedLayer, openedLine->layer()) << "Entities should share the layer of the document";
+    }
+
+    auto blockEntities = opened->entitiesByBlock(openedBlock).asVector();
+    ASSERT_EQ(1, blockEntities.size());
+    EXPECT_EQ(blockLine->id(), blockEntities[0]->id());
+    EXPECT_EQ(openedBlock, blockEntities[0]->block());
+    EXPECT_EQ(openedLayer, blockEntities[0]->layer());
+
+    auto openedInsert = std::dynamic_pointer_cast<const entity::Insert>(opened->entityByID(insert->id()));
+    ASSERT_NE(nullptr, openedInsert);
+    EXPECT_EQ(openedBlock, openedInsert->displayBlock());
+    EXPECT_EQ(geo::Coordinate(5, 5), openedInsert->position());
+}
+
+TEST(NativeFileTest, LoadArea) {
+    // 100 x 100 grid of short lines, spread over many chunks
+    auto document = createDocument();
+    std::vector<entity::CADEntity_CSPtr> lines;
+    for (int x = 0; x < 100; x++) {
+        for (int y = 0; y < 100; y++) {
+            lines.push_back(createLine(geo::Coordinate(x * 10, y * 10), geo::Coordinate(x * 10 + 1, y * 10 + 1)));
+        }
+    }
+    document->applyBatch(lines, {}, {});
+    persistence::File::save(document, NATIVE_TEST_FILE, persistence::File::LIBRECAD_NATIVE);
+
+    auto opened = createDocument();
+    persistence::File::open(opened, NATIVE_TEST_FILE, persistence::File::NATIVE);
+    ASSERT_NE(nullptr, opened->entityLoader());
+    EXPECT_EQ(0, opened->entityContainer().asVector().size());
+    EXPECT_EQ(geo::Coordinate(0, 0), opened->entityLoader()->bounds().minP());
+    EXPECT_EQ(geo::Coordinate(991, 991), opened->entityLoader()->bounds().maxP());
+
+    // A corner of the drawing only loads the chunks around it
+    opened->loadArea(geo::Area(geo::Coordinate(0, 0), geo::Coordinate(15, 15)));
+    auto loaded = opened->entityContainer().asVector().size();
+    EXPECT_GT(loaded, 0);
+    EXPECT_LT(loaded, lines.size());
+    EXPECT_NE(nullptr, opened->entityByID(lines[0]->id()));
+
+    // Area queries load the entities they reach
+    EXPECT_EQ(4, opened->countInArea(geo::Area(geo::Coordinate(975, 975), geo::Coordinate(1000, 1000))));
+    EXPECT_GT(opened->entityContainer().asVector().size(), loaded);
+
+    // Saving writes the entities which were never loaded
+    persistence::File::save(opened, NATIVE_TEST_FILE, persistence::File::LIBRECAD_NATIVE);
+    EXPECT_EQ(nullptr, opened->entityLoader());
+    EXPECT_EQ(lines.size(), opened->entityContainer().asVector().size());
+
+    auto reopened = createDocument();
+    persistence::File::open(reopened, NATIVE_TEST_FILE, persistence::File::NATIVE);
+    std::remove(NATIVE_TEST_FILE);
+
+    EXPECT_EQ(lines.size(), reopened->eachEntity([](const entity::CADEntity_CSPtr&) {}));
+}
+
+TEST(NativeFileTest, CorruptFile) {
+    auto document = createDocument();
+    document->applyBatch({createLine(0), createLine(1)}, {}, {});
+    persistence::File::save(document, NATIVE_TEST_FILE, persistence::File::LIBRECAD_NATIVE);
+    auto content = readFile(NATIVE_TEST_FILE);
+    ASSERT_FALSE(content.empty());
+
+    auto opened = createDocument();
+
+    writeFile(NATIVE_TEST_FILE, "This is not a LibreCAD file");
+    EXPECT_THROW(persistence::NativeFile(opened, NATIVE_TEST_FILE), std::runtime_error);
+
+    writeFile(NATIVE_TEST_FILE, content.substr(0, content.size() / 2));
+    EXPECT_THROW(persistence::NativeFile(opened, NATIVE_TEST_FILE), std::runtime_error);
+
+    // Index offset pointing after the end of the file
+    auto corrupted = content;
+    corrupted[corrupted.size() - 5] = '\x7f';
+    writeFile(NATIVE_TEST_FILE, corrupted);
+    EXPECT_THROW(persistence::File::open(opened, NATIVE_TEST_FILE, persistence::File::NATIVE), std::runtime_error);
+    std::remove(NATIVE_TEST_FILE);
+
+    EXPECT_EQ(0, opened->entityContainer().asVector().size()) << "Corrupt file should leave the document untouched";
+}
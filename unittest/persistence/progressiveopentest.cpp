@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/operations/blockops.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/layerops.h>
+#include <cad/builders/insert.h>
+#include <cad/builders/line.h>
+#include <cad/primitive/insert.h>
+#include <file.h>
+#include "../lckernel/kerneltests.h"
+
+using namespace lc;
+
+namespace {
+const char* PROGRESSIVE_TEST_FILE = "progressiveopentest.dxf";
+
+storage::Document_SPtr createDocument() {
+    return std::make_shared<storage::DocumentImpl>(std::make_shared<storage::StorageManagerImpl>());
+}
+}
+
+TEST(ProgressiveOpenTest, OpenDXF) {
+    auto document = createDocument();
+
+    auto layer = std::make_shared<const meta::Layer>("Walls", meta::MetaLineWidthByValue(0.5), Color(255, 0, 0));
+    auto block = std::make_shared<const meta::Block>("Door", geo::Coordinate(1, 2));
+    std::make_shared<operation::AddLayer>(document, layer)->execute();
+    std::make_shared<operation::AddBlock>(document, block)->execute();
+
+    auto entityBuilder = std::make_shared<operation::EntityBuilder>(document);
+    for (int i = 0; i < 100; i++) {
+        entityBuilder->appendEntity(createLine(i, layer));
+    }
+
+    builder::LineBuilder lineBuilder;
+    lineBuilder.setStart(geo::Coordinate(0, 0));
+    lineBuilder.setEnd(geo::Coordinate(1, 1));
+    lineBuilder.setLayer(layer);
+    lineBuilder.setBlock(block);
+    entityBuilder->appendEntity(lineBuilder.build());
+
+    builder::InsertBuilder insertBuilder;
+    insertBuilder.setDisplayBlock(block);
+    insertBuilder.setDocument(document);
+    insertBuilder.setLayer(layer);
+    insertBuilder.setCoordinate(geo::Coordinate(5, 5));
+    entityBuilder->appendEntity(insertBuilder.build());
+
+    entityBuilder->execute();
+    persistence::File::save(document, PROGRESSIVE_TEST_FILE, persistence::File::LIBDXFRW_DXF_R2000);
+
+    auto opened = createDocument();
+    DocumentEventCounter counter(opened);
+    {
+        persistence::ProgressiveOpen open(opened, PROGRESSIVE_TEST_FILE, persistence::File::LIBDXFRW, 10, 0);
+        while (!open.update()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        EXPECT_EQ(persistence::File::LIBDXFRW_DXF_R2000, open.type());
+    }
+    std::remove(PROGRESSIVE_TEST_FILE);
+
+    EXPECT_EQ(1, counter.commits) << "Open should be a single undo cycle";
+
+    auto openedLayer = opened->layerByName("Walls");
+    auto openedBlock = opened->blockByName("Door");
+    ASSERT_NE(nullptr, openedLayer);
+    ASSERT_NE(nullptr, openedBlock);
+    EXPECT_EQ(geo::Coordinate(1, 2), openedBlock->base()) << "Inserts should use the block of the file";
+
+    auto entities = opened->entityContainer().asVector();
+    ASSERT_EQ(101, entities.size());
+
+    for (const auto& entity : entities) {
+        EXPECT_EQ(openedLayer, entity->layer()) << "Entities should use the layer added to the document";
+
+        auto insert = std::dynamic_pointer_cast<const entity::Insert>(entity);
+        if (insert != nullptr) {
+            EXPECT_EQ(openedBlock, insert->displayBlock());
+        }
+    }
+
+    EXPECT_EQ(1, opened->entitiesByBlock(openedBlock).asVector().size());
+
+    counter.operation->undo();
+    EXPECT_EQ(0, opened->entityContainer().asVector().size()) << "Undo should remove every entity of the file";
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <managers/luajobscheduler.h>
+#include <cad/storage/documentimpl.h>
+#include <cad/storage/storagemanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+
+#include "../lckernel/kerneltests.h"
+
+using namespace lc;
+using namespace lc::lua;
+
+namespace {
+/**
+ * @brief Lua function addLine(x), adds a line to the document given as upvalue
+ */
+int luaAddLine(lua_State* L) {
+    auto document = static_cast<storage::Document_SPtr*>(lua_touserdata(L, lua_upvalueindex(1)));
+    auto x = luaL_checknumber(L, 1);
+
+    auto builder = std::make_shared<operation::EntityBuilder>(*document);
+    builder->appendEntity(createLine(x, (*document)->layerByName("0")));
+    builder->execute();
+
+    return 0;
+}
+
+class JobListener {
+public:
+    JobListener(LuaJobScheduler& scheduler) :
+        finished(0),
+        lastStatus(LuaJobScheduler::JobStatus::Unknown),
+        lastProgress(0),
+        _scheduler(scheduler) {
+        _scheduler.progressEvent().connect<JobListener, &JobListener::onProgress>(this);
+        _scheduler.finishedEvent().connect<JobListener, &JobListener::onFinished>(this);
+    }
+
+    ~JobListener() {
+        _scheduler.progressEvent().disconnect<JobListener, &JobListener::onProgress>(this);
+        _scheduler.finishedEvent().disconnect<JobListener, &JobListener::onFinished>(this);
+    }
+
+    void onProgress(unsigned int id, double progress) {
+        lastProgress = progress;
+    }
+
+    void onFinished(unsigned int id, LuaJobScheduler::JobStatus status) {
+        finished++;
+        lastStatus = status;
+    }
+
+    int finished;
+    LuaJobScheduler::JobStatus lastStatus;
+    double lastProgress;
+
+private:
+    LuaJobScheduler& _scheduler;
+};
+
+class LuaJobSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        document = std::make_shared<storage::DocumentImpl>(std::make_shared<storage::StorageManagerImpl>());
+
+        L = luaL_newstate();
+        luaL_openlibs(L);
+
+        lua_pushlightuserdata(L, &document);
+        lua_pushcclosure(L, &luaAddLine, 1);
+        lua_setglobal(L, "addLine");
+    }
+
+    void TearDown() override {
+        lua_close(L);
+    }
+
+    int globalNumber(const char* name) {
+        lua_getglobal(L, name);
+        auto value = static_cast<int>(lua_tointeger(L, -1));
+        lua_pop(L, 1);
+
+        return value;
+    }
+
+    storage::Document_SPtr document;
+    lua_State* L;
+};
+}
+
+TEST_F(LuaJobSchedulerTest, Preemption) {
+    LuaJobScheduler scheduler(L, 1000);
+    JobListener listener(scheduler);
+
+    scheduler.runString("a = 0 for i = 1, 100000 do a = a + 1 end");
+    scheduler.runString("b = 0 for i = 1, 100000 do b = b + 1 end");
+
+    EXPECT_TRUE(scheduler.step());
+    EXPECT_EQ(2, scheduler.runningJobs());
+
+    // Both jobs ran for a slice without finishing
+    EXPECT_GT(globalNumber("a"), 0);
+    EXPECT_LT(globalNumber("a"), 100000);
+    EXPECT_GT(globalNumber("b"), 0);
+
+    scheduler.runAll();
+    EXPECT_EQ(0, scheduler.runningJobs());
+    EXPECT_EQ(100000, globalNumber("a"));
+    EXPECT_EQ(100000, globalNumber("b"));
+    EXPECT_EQ(2, listener.finished);
+}
+
+TEST_F(LuaJobSchedulerTest, Commit) {
+    LuaJobScheduler scheduler(L);
+    DocumentEventCounter counter(document);
+
+    auto id = scheduler.runString("for i = 1, 10 do addLine(i) coroutine.yield() end", document);
+
+    for (int i = 0; i < 5; i++) {
+        scheduler.step();
+    }
+    EXPECT_EQ(LuaJobScheduler::JobStatus::Running, scheduler.status(id));
+    EXPECT_EQ(0, document->entityContainer().asVector().size()) << "Operations should wait for the end of the job";
+
+    scheduler.runAll();
+    EXPECT_EQ(LuaJobScheduler::JobStatus::Finished, scheduler.status(id));
+    EXPECT_EQ(10, document->entityContainer().asVector().size());
+    EXPECT_EQ(1, counter.commits);
+}
+
+TEST_F(LuaJobSchedulerTest, Cancel) {
+    LuaJobScheduler scheduler(L);
+    JobListener listener(scheduler);
+    DocumentEventCounter counter(document);
+
+    auto id = scheduler.runString("while true do addLine(1) coroutine.yield() end", document);
+
+    scheduler.step();
+    scheduler.cancel(id);
+    EXPECT_FALSE(scheduler.step());
+
+    EXPECT_EQ(LuaJobScheduler::JobStatus::Cancelled, scheduler.status(id));
+    EXPECT_EQ(LuaJobScheduler::JobStatus::Cancelled, listener.lastStatus);
+    EXPECT_EQ(0, document->entityContainer().asVector().size());
+    EXPECT_EQ(0, counter.commits);
+}
+
+TEST_F(LuaJobSchedulerTest, Failure) {
+    LuaJobScheduler scheduler(L);
+    JobListener listener(scheduler);
+    DocumentEventCounter counter(document);
+
+    auto id = scheduler.runString("addLine(1) coroutine.yield() addLine(2) error('Invalid line')", document);
+    scheduler.runAll();
+
+    EXPECT_EQ(LuaJobScheduler::JobStatus::Failed, scheduler.status(id));
+    EXPECT_NE(std::string::npos, scheduler.error(id).find("Invalid line"));
+    EXPECT_EQ(0, document->entityContainer().asVector().size()) << "Operations of a failed job should be discarded";
+    EXPECT_EQ(0, counter.commits);
+
+    // Code which can't be compiled fails without running
+    id = scheduler.runString("addLine(", document);
+    EXPECT_EQ(LuaJobScheduler::JobStatus::Failed, scheduler.status(id));
+    EXPECT_FALSE(scheduler.error(id).empty());
+    EXPECT_EQ(0, scheduler.runningJobs());
+    EXPECT_EQ(2, listener.finished);
+}
+
+TEST_F(LuaJobSchedulerTest, Progress) {
+    LuaJobScheduler scheduler(L);
+    JobListener listener(scheduler);
+
+    auto id = scheduler.runString("jobProgress(0.5) coroutine.yield()");
+
+    scheduler.step();
+    EXPECT_DOUBLE_EQ(0.5, scheduler.progress(id));
+    EXPECT_DOUBLE_EQ(0.5, listener.lastProgress);
+
+    scheduler.runAll();
+    EXPECT_DOUBLE_EQ(1, scheduler.progress(id));
+    EXPECT_EQ(LuaJobScheduler::JobStatus::Unknown, scheduler.status(id + 1));
+}
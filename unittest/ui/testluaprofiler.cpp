@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <utils/luaprofiler.h>
+#include <managers/luajobscheduler.h>
+
+using namespace lc::lua;
+
+namespace {
+const char* PROFILED_CODE = R"(
+    function work(n)
+        local sum = 0
+        for i = 1, n do
+            sum = sum + square(i % 100)
+        end
+        return sum
+    end
+)";
+
+/**
+ * @brief Lua function square(x)
+ */
+int luaSquare(lua_State* L) {
+    auto x = luaL_checknumber(L, 1);
+    lua_pushnumber(L, x * x);
+
+    return 1;
+}
+
+class LuaProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        L = luaL_newstate();
+        luaL_openlibs(L);
+
+        lua_pushcfunction(L, &luaSquare);
+        lua_setglobal(L, "square");
+
+        ASSERT_EQ(LUA_OK, luaL_dostring(L, PROFILED_CODE));
+    }
+
+    void TearDown() override {
+        lua_close(L);
+    }
+
+    lua_State* L;
+};
+}
+
+TEST_F(LuaProfilerTest, Folded) {
+    LuaProfiler profiler(100);
+
+    profiler.start(L);
+    EXPECT_TRUE(profiler.isRunning());
+    ASSERT_EQ(LUA_OK, luaL_dostring(L, "work(200000)"));
+    profiler.stop();
+    EXPECT_FALSE(profiler.isRunning());
+
+    auto folded = profiler.folded();
+    ASSERT_FALSE(folded.empty());
+
+    // Each line is a stack starting with the outermost frame, followed by its time in microseconds
+    std::istringstream stream(folded);
+    std::string line;
+    bool workSampled = false;
+
+    while (std::getline(stream, line)) {
+        auto separator = line.rfind(' ');
+        ASSERT_NE(std::string::npos, separator) << line;
+        EXPECT_GT(std::stoll(line.substr(separator + 1)), 0) << line;
+
+        auto stack = line.substr(0, separator);
+        EXPECT_EQ(0, stack.find("main ")) << line;
+
+        if (stack.find(";work ") != std::string::npos) {
+            workSampled = true;
+        }
+    }
+
+    EXPECT_TRUE(workSampled);
+
+    auto work = std::find_if(profiler.functions().begin(), profiler.functions().end(), [](const std::pair<const std::string, LuaProfiler::FunctionTime>& function) {
+        return function.first.find("work ") == 0;
+    });
+    ASSERT_NE(profiler.functions().end(), work);
+    EXPECT_GT(work->second.inclusive, 0);
+    EXPECT_LE(work->second.exclusive, work->second.inclusive);
+
+    profiler.reset();
+    EXPECT_TRUE(profiler.folded().empty());
+    EXPECT_TRUE(profiler.bindings().empty());
+}
+
+TEST_F(LuaProfilerTest, Bindings) {
+    LuaProfiler profiler;
+
+    profiler.start(L);
+    ASSERT_EQ(LUA_OK, luaL_dostring(L, "work(1000)"));
+    profiler.stop();
+
+    auto it = profiler.bindings().find("[C] square");
+    ASSERT_NE(profiler.bindings().end(), it);
+    EXPECT_EQ(1000, it->second.calls);
+
+    // Calls made after stop() aren't counted
+    ASSERT_EQ(LUA_OK, luaL_dostring(L, "work(1000)"));
+    EXPECT_EQ(1000, profiler.bindings().at("[C] square").calls);
+}
+
+TEST_F(LuaProfilerTest, Jobs) {
+    LuaProfiler profiler(100);
+    LuaJobScheduler scheduler(L, 1000000);
+    scheduler.setProfiler(&profiler);
+
+    // Without profiler running, the job doesn't report its calls
+    scheduler.runString("work(1000)");
+    scheduler.runAll();
+    EXPECT_TRUE(profiler.bindings().empty());
+
+    profiler.start(L);
+    scheduler.runString("work(10000)");
+
+    // The job is sampled, but only yields at the end of its slice
+    EXPECT_FALSE(scheduler.step());
+    profiler.stop();
+
+    EXPECT_EQ(10000, profiler.bindings().at("[C] square").calls);
+    EXPECT_NE(std::string::npos, profiler.folded().find(";work "));
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <managers/luaworkerpool.h>
+#include <cad/primitive/line.h>
+
+#include "../lckernel/kerneltests.h"
+
+using namespace lc;
+using namespace lc::lua;
+
+namespace {
+const char* WORKER_CODE = R"(
+    local layerBuilder = lc.builder.LayerBuilder()
+    layerBuilder:setName("0")
+    layer = layerBuilder:build()
+
+    function line(i)
+        local builder = lc.builder.LineBuilder()
+        builder:setLayer(layer)
+        builder:setStartPoint(lc.geo.Coordinate(i, 0))
+        builder:setEndPoint(lc.geo.Coordinate(i, 100))
+        return builder:build()
+    end
+
+    function evenLines(i)
+        if i % 2 == 0 then
+            return {line(i), line(i)}
+        end
+    end
+
+    function offset(entity)
+        return entity:move(lc.geo.Coordinate(0, 10))
+    end
+
+    function failing(i)
+        if i == 7 then
+            error("Invalid index")
+        end
+        return line(i)
+    end
+)";
+
+double startX(const entity::CADEntity_CSPtr& entity) {
+    auto line = std::dynamic_pointer_cast<const entity::Line>(entity);
+    return line == nullptr ? -1 : line->start().x();
+}
+}
+
+TEST(LuaWorkerPoolTest, Generate) {
+    LuaWorkerPool pool(4);
+    ASSERT_EQ("", pool.load(WORKER_CODE));
+
+    auto entities = pool.generate("line", 100);
+    ASSERT_EQ(100, entities.size());
+    for (size_t i = 0; i < entities.size(); i++) {
+        EXPECT_EQ(i + 1, startX(entities[i])) << "Entities should be in the order of the indexes";
+    }
+
+    // Tables are flattened and nil is skipped
+    entities = pool.generate("evenLines", 10);
+    ASSERT_EQ(10, entities.size());
+    EXPECT_EQ(2, startX(entities[0]));
+    EXPECT_EQ(2, startX(entities[1]));
+    EXPECT_EQ(10, startX(entities[9]));
+}
+
+TEST(LuaWorkerPoolTest, Map) {
+    LuaWorkerPool pool(4);
+    ASSERT_EQ("", pool.load(WORKER_CODE));
+
+    std::vector<entity::CADEntity_CSPtr> lines;
+    for (int i = 0; i < 50; i++) {
+        lines.push_back(createLine(i));
+    }
+
+    auto entities = pool.map("offset", lines);
+    ASSERT_EQ(50, entities.size());
+    for (size_t i = 0; i < entities.size(); i++) {
+        auto line = std::dynamic_pointer_cast<const entity::Line>(entities[i]);
+        ASSERT_NE(nullptr, line);
+        EXPECT_EQ(geo::Coordinate(i, 10), line->start());
+        EXPECT_EQ(lines[i]->id(), line->id());
+    }
+}
+
+TEST(LuaWorkerPoolTest, Errors) {
+    LuaWorkerPool pool(2);
+
+    EXPECT_NE("", pool.load("function broken("));
+    ASSERT_EQ("", pool.load(WORKER_CODE));
+
+    try {
+        pool.generate("failing", 20);
+        FAIL() << "The error of the call should be thrown";
+    }
+    catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string::npos, std::string(e.what()).find("Invalid index"));
+    }
+
+    EXPECT_THROW(pool.generate("unknown", 1), std::runtime_error);
+
+    // Errors which aren't strings
+    ASSERT_EQ("", pool.load("function tableError() error({}) end"));
+    try {
+        pool.generate("tableError", 1);
+        FAIL() << "The error of the call should be thrown";
+    }
+    catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string::npos, std::string(e.what()).find("Unknown error"));
+    }
+    EXPECT_EQ("Unknown error", pool.load("error({})"));
+
+    // The workers are still usable
+    EXPECT_EQ(5, pool.generate("line", 5).size());
+}
+
+TEST(LuaWorkerPoolTest, Sandbox) {
+    LuaWorkerPool pool(2);
+
+    EXPECT_EQ("", pool.load("assert(dofile == nil, 'dofile') assert(loadfile == nil, 'loadfile')"));
+    EXPECT_EQ("", pool.load("assert(io == nil, 'io') assert(os == nil, 'os')"));
+    EXPECT_NE("", pool.load("io.open('/tmp/file')"));
+
+    // Only text chunks can be loaded
+    EXPECT_EQ("", pool.load("assert(load('return 1')() == 1, 'text')"));
+    EXPECT_EQ("", pool.load("assert(load(string.dump(function() end)) == nil, 'binary')"));
+    EXPECT_NE("", pool.load("\x1bLua"));
+}